@@ -0,0 +1,56 @@
+//
+//  CoarseToFineResults.swift
+//  LARBenchmark
+//
+//  Per-frame localization latency and success of coarse-to-fine localization vs. the full
+//  image, and how far the poses settled by the coarse pass are from the full-image poses
+//
+
+import Foundation
+
+struct CoarseToFineResults {
+    let frameCount: Int
+    let levels: Int
+    let minInliers: Int
+    let fullLatencies: [TimeInterval]          // per frame
+    let coarseToFineLatencies: [TimeInterval]
+    let fullSuccessCount: Int
+    let coarseToFineSuccessCount: Int
+    let coarseAcceptedCount: Int               // frames settled by the coarse pass
+    let comparedPoseCount: Int                 // coarse poses of frames the full image localized
+    let meanPositionDifference: Double         // meters, over compared poses
+
+    var formattedSummary: String {
+        var lines = ["=== Coarse-to-Fine Results ==="]
+        lines.append("Frames: \(frameCount), coarse pass on the image halved \(levels)x, accepted with \(minInliers)+ inliers")
+        lines.append("\nFull image:")
+        lines.append("  Localized: \(fullSuccessCount) (\(percent(fullSuccessCount)))")
+        lines.append("  Latency: \(formatLatency(fullLatencies))")
+        lines.append("\nCoarse to fine:")
+        lines.append("  Localized: \(coarseToFineSuccessCount) (\(percent(coarseToFineSuccessCount)))")
+        lines.append("  Settled by the coarse pass: \(coarseAcceptedCount) (\(percent(coarseAcceptedCount)))")
+        lines.append("  Latency: \(formatLatency(coarseToFineLatencies))")
+        let speedup = median(coarseToFineLatencies) > 0 ? median(fullLatencies) / median(coarseToFineLatencies) : 0
+        lines.append("  Median speedup: \(String(format: "%.2f", speedup))x")
+        lines.append("  Coarse vs. full position: \(String(format: "%.3f", meanPositionDifference)) m mean over \(comparedPoseCount) frames")
+        return lines.joined(separator: "\n")
+    }
+
+    private func percent(_ count: Int) -> String {
+        String(format: "%.1f%%", Double(count) / Double(max(frameCount, 1)) * 100)
+    }
+
+    private func median(_ values: [TimeInterval]) -> TimeInterval {
+        percentile(values, 0.5)
+    }
+
+    private func percentile(_ values: [TimeInterval], _ fraction: Double) -> TimeInterval {
+        guard !values.isEmpty else { return 0 }
+        let sorted = values.sorted()
+        return sorted[min(sorted.count - 1, Int(fraction * Double(sorted.count)))]
+    }
+
+    private func formatLatency(_ values: [TimeInterval]) -> String {
+        String(format: "median %.1f ms, p90 %.1f ms", median(values) * 1000.0, percentile(values, 0.9) * 1000.0)
+    }
+}
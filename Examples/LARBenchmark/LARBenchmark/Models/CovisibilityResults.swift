@@ -0,0 +1,52 @@
+//
+//  CovisibilityResults.swift
+//  LARBenchmark
+//
+//  Size of the covisibility graph, and how the landmarks covisible with the previous frame's
+//  inliers compare with the spatial query in candidate count and inlier coverage
+//
+
+import Foundation
+
+struct CovisibilityResults {
+    let mappingFrameCount: Int
+    let keyframeCount: Int
+    let visibilityCount: Int
+    let linkCount: Int
+    let graphBytes: UInt64
+    let buildTime: TimeInterval
+    let keyframeLimit: Int
+    let evaluatedFrameCount: Int     // localized frames that followed a localized frame
+    let regionLandmarkCount: Int     // summed over evaluated frames
+    let covisibleLandmarkCount: Int
+    let expansionTime: TimeInterval  // summed over evaluated frames
+    let inlierCount: Int             // tracker inliers over evaluated frames
+    let keptInlierCount: Int         // of those, among the covisible landmarks
+
+    var reduction: Double {
+        covisibleLandmarkCount > 0 ? Double(regionLandmarkCount) / Double(covisibleLandmarkCount) : 0
+    }
+
+    var inlierRetention: Double {
+        inlierCount > 0 ? Double(keptInlierCount) / Double(inlierCount) : 0
+    }
+
+    var formattedSummary: String {
+        var lines = ["=== Covisibility Graph Results ==="]
+        lines.append("Graph: \(keyframeCount) keyframes from \(mappingFrameCount) frames, \(visibilityCount) landmark links, \(linkCount) keyframe links")
+        lines.append("  Build time: \(formatMilliseconds(buildTime)), memory: \(ByteCountFormatter.string(fromByteCount: Int64(graphBytes), countStyle: .memory))")
+        lines.append("Frames evaluated: \(evaluatedFrameCount) (up to \(keyframeLimit) keyframes per expansion)")
+        lines.append("  Mean candidates: region \(mean(regionLandmarkCount)), covisible \(mean(covisibleLandmarkCount)) (\(String(format: "%.1f", reduction))x fewer)")
+        lines.append("  Mean expansion time: \(formatMilliseconds(expansionTime / Double(max(evaluatedFrameCount, 1))))")
+        lines.append("  Tracker inliers among covisible landmarks: \(keptInlierCount)/\(inlierCount) (\(String(format: "%.1f", inlierRetention * 100))%)")
+        return lines.joined(separator: "\n")
+    }
+
+    private func mean(_ total: Int) -> String {
+        String(format: "%.0f", Double(total) / Double(max(evaluatedFrameCount, 1)))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.2f ms", seconds * 1000.0)
+    }
+}
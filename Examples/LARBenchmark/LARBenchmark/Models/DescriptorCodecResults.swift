@@ -0,0 +1,56 @@
+//
+//  DescriptorCodecResults.swift
+//  LARBenchmark
+//
+//  Descriptor memory and matching recall for each compressed descriptor codec
+//
+
+import Foundation
+
+struct DescriptorCodecResults {
+    struct Measurement {
+        let name: String                // e.g. PQ-32
+        let codeSize: Int               // bytes per landmark descriptor
+        let descriptorSize: Int         // bytes per exact descriptor
+        let exactBytes: UInt64          // all exact descriptors
+        let compressedBytes: UInt64     // all codes plus codebook
+        let queryCount: Int
+        let approximateRecall: Double   // code distances only
+        let rerankedRecall: Double      // after exact re-ranking of the top candidates
+        let exactMatchTime: TimeInterval
+        let approximateMatchTime: TimeInterval
+        let rerankedMatchTime: TimeInterval
+
+        var memoryReduction: Double {
+            compressedBytes > 0 ? Double(exactBytes) / Double(compressedBytes) : 0
+        }
+    }
+
+    let frameCount: Int
+    let rerankDepth: Int
+    let measurements: [Measurement]
+
+    var formattedSummary: String {
+        var lines = ["=== Descriptor Codec Results ==="]
+        lines.append("\(frameCount) frames, re-ranking top \(rerankDepth) candidates")
+        for m in measurements {
+            lines.append("\(m.name): \(m.codeSize) B/descriptor (exact \(m.descriptorSize) B)")
+            lines.append("  Memory: \(formatBytes(m.compressedBytes)) vs \(formatBytes(m.exactBytes)) (\(String(format: "%.1f", m.memoryReduction))x smaller)")
+            lines.append("  Recall@1 over \(m.queryCount) queries: \(formatPercent(m.approximateRecall)) codes only, \(formatPercent(m.rerankedRecall)) re-ranked")
+            lines.append("  Match time: exact \(formatSeconds(m.exactMatchTime)), codes \(formatSeconds(m.approximateMatchTime)), re-ranked \(formatSeconds(m.rerankedMatchTime))")
+        }
+        return lines.joined(separator: "\n")
+    }
+
+    private func formatBytes(_ bytes: UInt64) -> String {
+        String(format: "%.1f MB", Double(bytes) / (1024.0 * 1024.0))
+    }
+
+    private func formatPercent(_ value: Double) -> String {
+        String(format: "%.1f%%", value * 100.0)
+    }
+
+    private func formatSeconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.2f s", seconds)
+    }
+}
@@ -0,0 +1,51 @@
+//
+//  FloorQueryResults.swift
+//  LARBenchmark
+//
+//  Landmarks left by restricting spatial queries to the camera's floor vs. the full region,
+//  and how many of the tracker's inliers the floor band keeps
+//
+
+import Foundation
+
+struct FloorQueryResults {
+    struct Layer {
+        let lower: Double
+        let upper: Double
+    }
+
+    let frameCount: Int
+    let localizedFrameCount: Int
+    let layers: [Layer]
+    let regionLandmarkCount: Int     // summed over localized frames
+    let floorLandmarkCount: Int      // summed over localized frames
+    let regionQueryTime: TimeInterval
+    let floorQueryTime: TimeInterval // includes picking the band
+    let inlierCount: Int             // tracker inliers over localized frames
+    let keptInlierCount: Int
+
+    var formattedSummary: String {
+        var lines = ["=== Floor Query Results ==="]
+        lines.append("Frames: \(frameCount), localized: \(localizedFrameCount)")
+        lines.append("Height layers: \(layers.count)")
+        for (index, layer) in layers.enumerated() {
+            lines.append("  \(index): \(String(format: "%.2f", layer.lower)) to \(String(format: "%.2f", layer.upper)) m")
+        }
+        let reduction = floorLandmarkCount > 0 ? Double(regionLandmarkCount) / Double(floorLandmarkCount) : 0
+        let retention = inlierCount > 0 ? Double(keptInlierCount) / Double(inlierCount) : 0
+        lines.append("\nRegion query:")
+        lines.append("  Mean landmarks: \(mean(regionLandmarkCount)), query \(formatMilliseconds(regionQueryTime / Double(max(localizedFrameCount, 1))))")
+        lines.append("\nFloor query:")
+        lines.append("  Mean landmarks: \(mean(floorLandmarkCount)) (\(String(format: "%.1f", reduction))x fewer), query \(formatMilliseconds(floorQueryTime / Double(max(localizedFrameCount, 1))))")
+        lines.append("  Inliers kept: \(keptInlierCount)/\(inlierCount) (\(String(format: "%.1f", retention * 100))%)")
+        return lines.joined(separator: "\n")
+    }
+
+    private func mean(_ total: Int) -> String {
+        String(format: "%.0f", Double(total) / Double(max(localizedFrameCount, 1)))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.2f ms", seconds * 1000.0)
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  FrustumQueryResults.swift
+//  LARBenchmark
+//
+//  Landmarks returned by the plain spatial query vs. the frustum query, and how many of the
+//  tracker's inliers the frustum query keeps
+//
+
+import Foundation
+
+struct FrustumQueryResults {
+    let frameCount: Int
+    let regionLandmarkCount: Int     // summed over frames
+    let frustumLandmarkCount: Int
+    let regionQueryTime: TimeInterval   // summed over frames
+    let frustumQueryTime: TimeInterval
+    let localizedFrameCount: Int
+    let inlierCount: Int             // tracker inliers over localized frames
+    let keptInlierCount: Int         // of those, inside the frustum query
+
+    var reduction: Double {
+        frustumLandmarkCount > 0 ? Double(regionLandmarkCount) / Double(frustumLandmarkCount) : 0
+    }
+
+    var inlierRetention: Double {
+        inlierCount > 0 ? Double(keptInlierCount) / Double(inlierCount) : 0
+    }
+
+    var formattedSummary: String {
+        var lines = ["=== Frustum Query Results ==="]
+        lines.append("Frames: \(frameCount), localized: \(localizedFrameCount)")
+        lines.append("  Mean landmarks per query: region \(mean(regionLandmarkCount)), frustum \(mean(frustumLandmarkCount)) (\(String(format: "%.1f", reduction))x fewer)")
+        lines.append("  Mean query time: region \(formatMilliseconds(regionQueryTime / Double(max(frameCount, 1)))), frustum \(formatMilliseconds(frustumQueryTime / Double(max(frameCount, 1))))")
+        lines.append("  Tracker inliers kept by the frustum: \(keptInlierCount)/\(inlierCount) (\(String(format: "%.1f", inlierRetention * 100))%)")
+        return lines.joined(separator: "\n")
+    }
+
+    private func mean(_ total: Int) -> String {
+        String(format: "%.0f", Double(total) / Double(max(frameCount, 1)))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.2f ms", seconds * 1000.0)
+    }
+}
@@ -0,0 +1,47 @@
+//
+//  LandmarkQualityResults.swift
+//  LARBenchmark
+//
+//  Landmarks left by per-cell quality budgets vs. the full spatial query, and how many of the
+//  tracker's inliers each budget keeps
+//
+
+import Foundation
+
+struct LandmarkQualityResults {
+    struct Budget {
+        let perCell: Int
+        let landmarkCount: Int       // summed over localized frames
+        let queryTime: TimeInterval  // summed over localized frames
+        let keptInlierCount: Int
+    }
+
+    let frameCount: Int
+    let localizedFrameCount: Int
+    let cellSize: Double
+    let regionLandmarkCount: Int     // summed over localized frames
+    let inlierCount: Int             // tracker inliers over localized frames
+    let budgets: [Budget]
+
+    var formattedSummary: String {
+        var lines = ["=== Landmark Quality Results ==="]
+        lines.append("Frames: \(frameCount), localized: \(localizedFrameCount), \(String(format: "%.1f", cellSize)) m cells")
+        lines.append("  Full query: \(mean(regionLandmarkCount)) landmarks, \(inlierCount) inliers")
+        for budget in budgets {
+            let reduction = budget.landmarkCount > 0 ? Double(regionLandmarkCount) / Double(budget.landmarkCount) : 0
+            let retention = inlierCount > 0 ? Double(budget.keptInlierCount) / Double(inlierCount) : 0
+            lines.append("\nTop \(budget.perCell) per cell:")
+            lines.append("  Mean landmarks: \(mean(budget.landmarkCount)) (\(String(format: "%.1f", reduction))x fewer), query \(formatMilliseconds(budget.queryTime / Double(max(localizedFrameCount, 1))))")
+            lines.append("  Inliers kept: \(budget.keptInlierCount)/\(inlierCount) (\(String(format: "%.1f", retention * 100))%)")
+        }
+        return lines.joined(separator: "\n")
+    }
+
+    private func mean(_ total: Int) -> String {
+        String(format: "%.0f", Double(total) / Double(max(localizedFrameCount, 1)))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.2f ms", seconds * 1000.0)
+    }
+}
@@ -0,0 +1,51 @@
+//
+//  MapDeltaResults.swift
+//  LARBenchmark
+//
+//  Size and apply time of a map delta compared with shipping the full map
+//
+
+import Foundation
+
+struct MapDeltaResults {
+    let baseFile: String            // previous map version, e.g. map.previous.larmap
+    let targetFile: String          // current map version
+    let deltaBytes: UInt64
+    let archiveBytes: UInt64        // full binary archive of the current version
+    let writeTime: TimeInterval     // computing and writing the delta
+    let applyTimes: [TimeInterval]  // seconds, one per iteration
+    let fullLoadTimes: [TimeInterval]  // loading the full current archive, for comparison
+    let matchesTarget: Bool         // applied map has the current version's fingerprint
+
+    var medianApplyTime: TimeInterval { median(applyTimes) }
+    var medianFullLoadTime: TimeInterval { median(fullLoadTimes) }
+
+    var bandwidthReduction: Double {
+        deltaBytes > 0 ? Double(archiveBytes) / Double(deltaBytes) : 0
+    }
+
+    var formattedSummary: String {
+        var lines = ["=== Map Delta Results ==="]
+        lines.append("\(baseFile) → \(targetFile)")
+        lines.append("  Delta: \(formatBytes(deltaBytes)) vs full archive \(formatBytes(archiveBytes)) (\(String(format: "%.1f", bandwidthReduction))x smaller)")
+        lines.append("  Write time: \(formatMilliseconds(writeTime))")
+        lines.append("  Median apply time: \(formatMilliseconds(medianApplyTime)) over \(applyTimes.count) runs")
+        lines.append("  Median full reload time: \(formatMilliseconds(medianFullLoadTime))")
+        lines.append("  Applied map matches current version: \(matchesTarget ? "yes" : "NO")")
+        return lines.joined(separator: "\n")
+    }
+
+    private func median(_ values: [TimeInterval]) -> TimeInterval {
+        guard !values.isEmpty else { return 0 }
+        let sorted = values.sorted()
+        return sorted[sorted.count / 2]
+    }
+
+    private func formatBytes(_ bytes: UInt64) -> String {
+        String(format: "%.2f MB", Double(bytes) / (1024.0 * 1024.0))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.1f ms", seconds * 1000.0)
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  MapLoadResults.swift
+//  LARBenchmark
+//
+//  Load time and memory statistics for each map file format
+//
+
+import Foundation
+
+struct MapLoadResults {
+    struct Measurement {
+        let format: String          // file name, e.g. map.json
+        let fileSize: UInt64        // bytes
+        let landmarkCount: Int
+        let loadTimes: [TimeInterval]  // seconds, one per iteration
+        let peakBytes: UInt64       // peak footprint growth during load
+        let retainedBytes: UInt64   // footprint growth once loading finished
+
+        var medianLoadTime: TimeInterval {
+            guard !loadTimes.isEmpty else { return 0 }
+            let sorted = loadTimes.sorted()
+            return sorted[sorted.count / 2]
+        }
+    }
+
+    struct ThreadScaling {
+        let format: String
+        let threadCounts: [Int]
+        let medianLoadTimes: [TimeInterval]  // seconds, one per thread count
+
+        /// Load time with the first (single) thread count over each load time
+        var speedups: [Double] {
+            guard let baseline = medianLoadTimes.first else { return [] }
+            return medianLoadTimes.map { $0 > 0 ? baseline / $0 : 0 }
+        }
+    }
+
+    let measurements: [Measurement]
+    let threadScaling: [ThreadScaling]
+
+    var formattedSummary: String {
+        var lines = ["=== Map Load Results ==="]
+        for m in measurements {
+            lines.append("\(m.format) (\(formatBytes(m.fileSize)), \(m.landmarkCount) landmarks)")
+            lines.append("  Median load time: \(String(format: "%.1f", m.medianLoadTime * 1000.0)) ms over \(m.loadTimes.count) runs")
+            lines.append("  Peak memory during load: +\(formatBytes(m.peakBytes))")
+            lines.append("  Memory after load: +\(formatBytes(m.retainedBytes))")
+        }
+        for scaling in threadScaling {
+            lines.append("\(scaling.format) parallel decoding")
+            for (i, threads) in scaling.threadCounts.enumerated() {
+                let time = String(format: "%.1f", scaling.medianLoadTimes[i] * 1000.0)
+                let speedup = String(format: "%.2f", scaling.speedups[i])
+                lines.append("  \(threads) threads: \(time) ms (\(speedup)x)")
+            }
+        }
+        return lines.joined(separator: "\n")
+    }
+
+    private func formatBytes(_ bytes: UInt64) -> String {
+        String(format: "%.1f MB", Double(bytes) / (1024.0 * 1024.0))
+    }
+}
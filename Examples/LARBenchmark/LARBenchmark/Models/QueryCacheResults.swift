@@ -0,0 +1,39 @@
+//
+//  QueryCacheResults.swift
+//  LARBenchmark
+//
+//  Incremental spatial query updates along the recorded path vs. querying from scratch
+//
+
+import Foundation
+
+struct QueryCacheResults {
+    let frameCount: Int
+    let incrementalUpdateCount: Int
+    let fullUpdateCount: Int
+    let landmarkCount: Int          // query result sizes, summed over frames
+    let changedLandmarkCount: Int   // added + removed, summed over incremental updates
+    let cachedQueryTime: TimeInterval   // summed over frames
+    let fullQueryTime: TimeInterval
+    let mismatchCount: Int          // frames where the cache disagreed with a full query
+
+    var speedup: Double { cachedQueryTime > 0 ? fullQueryTime / cachedQueryTime : 0 }
+
+    var formattedSummary: String {
+        var lines = ["=== Query Cache Results ==="]
+        lines.append("Frames: \(frameCount), incremental updates: \(incrementalUpdateCount), full: \(fullUpdateCount)")
+        lines.append("  Mean landmarks per query: \(perFrame(landmarkCount))")
+        lines.append("  Mean landmarks changed per incremental update: \(String(format: "%.1f", Double(changedLandmarkCount) / Double(max(incrementalUpdateCount, 1))))")
+        lines.append("  Mean query time: cached \(formatMilliseconds(cachedQueryTime / Double(max(frameCount, 1)))), full \(formatMilliseconds(fullQueryTime / Double(max(frameCount, 1)))) (\(String(format: "%.1f", speedup))x)")
+        lines.append("  Results match full query: \(mismatchCount == 0 ? "yes" : "NO (\(mismatchCount) frames)")")
+        return lines.joined(separator: "\n")
+    }
+
+    private func perFrame(_ total: Int) -> String {
+        String(format: "%.0f", Double(total) / Double(max(frameCount, 1)))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.3f ms", seconds * 1000.0)
+    }
+}
@@ -0,0 +1,57 @@
+//
+//  SIFTResults.swift
+//  LARBenchmark
+//
+//  Single-threaded feature extraction time of the CPU SIFT (SIMD and scalar kernels) vs.
+//  OpenCV's SIFT, how the CPU SIFT scales over all cores and with a keypoint budget, and how
+//  closely their features agree
+//
+
+import Foundation
+
+struct SIFTResults {
+    let imageCount: Int
+    let kernelName: String
+    let simdTime: TimeInterval       // all images
+    let scalarTime: TimeInterval
+    let openCVTime: TimeInterval
+    let threadedTime: TimeInterval
+    let threadCount: Int
+    let budgetTime: TimeInterval
+    let keypointBudget: Int
+    let keptKeypointCount: Int
+    let droppedKeypointCount: Int
+    let keypointCount: Int
+    let openCVKeypointCount: Int
+    let matchedKeypointCount: Int
+    let meanDescriptorDistance: Double
+    let kernelsMatch: Bool
+    let threadsMatch: Bool
+    let steadyStateAllocationCount: Int
+
+    var formattedSummary: String {
+        var lines = ["=== SIFT Results ==="]
+        lines.append("Images: \(imageCount), one core")
+        lines.append("CPU SIFT (\(kernelName)): \(formatFrame(simdTime))")
+        lines.append("CPU SIFT (scalar): \(formatFrame(scalarTime)) (\(String(format: "%.2f", speedup(scalarTime)))x slower)")
+        lines.append("OpenCV SIFT: \(formatFrame(openCVTime)) (\(String(format: "%.2f", speedup(openCVTime)))x slower)")
+        let scaling = threadedTime > 0 ? simdTime / threadedTime : 0
+        lines.append("CPU SIFT on \(threadCount) threads: \(formatFrame(threadedTime)) (\(String(format: "%.2f", scaling))x faster than one)")
+        lines.append("CPU SIFT, \(keypointBudget) keypoint budget: \(formatFrame(budgetTime)) (\(String(format: "%.2f", speedup(budgetTime)))x the time), kept \(keptKeypointCount), dropped \(droppedKeypointCount)")
+        let matched = keypointCount > 0 ? Double(matchedKeypointCount) / Double(keypointCount) : 0
+        lines.append("\nKeypoints: \(keypointCount) vs \(openCVKeypointCount) from OpenCV, \(String(format: "%.1f", matched * 100))% matched")
+        lines.append("Mean descriptor distance: \(String(format: "%.3f", meanDescriptorDistance))")
+        lines.append("Scratch allocations after the first image: \(steadyStateAllocationCount)")
+        lines.append("Kernels agree: \(kernelsMatch ? "yes" : "NO"), threads agree: \(threadsMatch ? "yes" : "NO")")
+        return lines.joined(separator: "\n")
+    }
+
+    private func speedup(_ time: TimeInterval) -> Double {
+        simdTime > 0 ? time / simdTime : 0
+    }
+
+    private func formatFrame(_ total: TimeInterval) -> String {
+        let perImage = total / Double(max(imageCount, 1))
+        return String(format: "%.1f ms/image, %.1f fps", perImage * 1000.0, perImage > 0 ? 1 / perImage : 0)
+    }
+}
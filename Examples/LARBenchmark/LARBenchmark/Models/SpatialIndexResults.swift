@@ -0,0 +1,60 @@
+//
+//  SpatialIndexResults.swift
+//  LARBenchmark
+//
+//  Packed R-tree vs. linear scan query times at growing landmark counts
+//
+
+import Foundation
+
+struct SpatialIndexResults {
+    struct Run {
+        let landmarkCount: Int
+        let queryCount: Int
+        let hitCount: Int
+        let treeBytes: UInt64
+        let buildTime: TimeInterval
+        let treeQueryTime: TimeInterval   // all queries, SIMD kernel
+        let scalarTreeQueryTime: TimeInterval
+        let scanQueryTime: TimeInterval
+        let resultsMatch: Bool
+        let storedOrderPageCount: Int    // descriptor pages hit over all queries
+        let spatialOrderPageCount: Int
+
+        var speedup: Double { treeQueryTime > 0 ? scanQueryTime / treeQueryTime : 0 }
+        var kernelSpeedup: Double { treeQueryTime > 0 ? scalarTreeQueryTime / treeQueryTime : 0 }
+        var pageReduction: Double { spatialOrderPageCount > 0 ? Double(storedOrderPageCount) / Double(spatialOrderPageCount) : 0 }
+    }
+
+    let mapLandmarkCount: Int
+    let diameter: Double
+    let kernelName: String
+    let runs: [Run]
+
+    var formattedSummary: String {
+        var lines = ["=== Spatial Index Results ==="]
+        lines.append("Seed map: \(mapLandmarkCount) landmarks, \(String(format: "%.0f", diameter)) m queries, \(kernelName) kernel")
+        for run in runs {
+            lines.append("\n\(run.landmarkCount) landmarks:")
+            lines.append("  Build: \(formatMilliseconds(run.buildTime)), \(formatBytes(run.treeBytes))")
+            lines.append("  Per query: tree \(formatMicroseconds(run.treeQueryTime / Double(max(run.queryCount, 1)))), scan \(formatMicroseconds(run.scanQueryTime / Double(max(run.queryCount, 1)))) (\(String(format: "%.1f", run.speedup))x)")
+            lines.append("  Tree with scalar kernel: \(formatMicroseconds(run.scalarTreeQueryTime / Double(max(run.queryCount, 1)))) (\(kernelName) \(String(format: "%.1f", run.kernelSpeedup))x)")
+            lines.append("  Mean hits per query: \(run.hitCount / max(run.queryCount, 1))")
+            lines.append("  Descriptor pages per query: map order \(run.storedOrderPageCount / max(run.queryCount, 1)), Morton order \(run.spatialOrderPageCount / max(run.queryCount, 1)) (\(String(format: "%.1f", run.pageReduction))x fewer)")
+            lines.append("  Results match scan: \(run.resultsMatch ? "yes" : "NO")")
+        }
+        return lines.joined(separator: "\n")
+    }
+
+    private func formatBytes(_ bytes: UInt64) -> String {
+        String(format: "%.2f MB", Double(bytes) / (1024.0 * 1024.0))
+    }
+
+    private func formatMilliseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.1f ms", seconds * 1000.0)
+    }
+
+    private func formatMicroseconds(_ seconds: TimeInterval) -> String {
+        String(format: "%.1f µs", seconds * 1_000_000.0)
+    }
+}
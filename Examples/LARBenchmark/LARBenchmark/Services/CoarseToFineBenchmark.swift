@@ -0,0 +1,76 @@
+//
+//  CoarseToFineBenchmark.swift
+//  LARBenchmark
+//
+//  Localizes every replayed frame on the full image and coarse to fine, with a tracker each
+//
+
+import Foundation
+import CoreGraphics
+import LocalizeAR
+import simd
+
+actor CoarseToFineBenchmark {
+    func run(map: LARMap, frames: [FrameData], levels: Int = 1, minInliers: Int = 40,
+             minInlierRatio: Double = 0.25, searchDiameter: Double = 20.0) async throws -> CoarseToFineResults {
+        guard let first = frames.first else {
+            throw DataLoaderError.invalidJSON("No frames to replay")
+        }
+        let imageSize = CGSize(width: first.image.width, height: first.image.height)
+        let full = LARTracker(map: map, imageSize: imageSize)
+        let coarseToFine = LARTracker(map: map, imageSize: imageSize)
+        coarseToFine.enableCoarseToFine(levels: levels, minInliers: minInliers, minInlierRatio: minInlierRatio)
+
+        var fullLatencies: [TimeInterval] = []
+        var coarseToFineLatencies: [TimeInterval] = []
+        var fullSuccessCount = 0
+        var coarseToFineSuccessCount = 0
+        var comparedPoseCount = 0
+        var positionDifference = 0.0
+
+        for (index, frameData) in frames.enumerated() {
+            let extrinsics = frameData.frame.extrinsics
+            let queryX = Double(extrinsics[3][0])
+            let queryZ = Double(extrinsics[3][2])
+
+            var start = Date()
+            let fullResult = full.localize(frameData.image, frame: frameData.frame,
+                                           queryX: queryX, queryZ: queryZ, queryDiameter: searchDiameter)
+            fullLatencies.append(Date().timeIntervalSince(start))
+
+            start = Date()
+            let result = coarseToFine.localize(frameData.image, frame: frameData.frame,
+                                               queryX: queryX, queryZ: queryZ, queryDiameter: searchDiameter)
+            coarseToFineLatencies.append(Date().timeIntervalSince(start))
+
+            if fullResult.success { fullSuccessCount += 1 }
+            if result.success { coarseToFineSuccessCount += 1 }
+            if coarseToFine.lastLocalizationWasCoarse, let expected = fullResult.transform, let actual = result.transform {
+                // Row-major; the translation is the last column.
+                let offset = SIMD3(actual[0][3] - expected[0][3], actual[1][3] - expected[1][3], actual[2][3] - expected[2][3])
+                positionDifference += simd_length(offset)
+                comparedPoseCount += 1
+            }
+
+            if (index + 1) % 20 == 0 {
+                print("  Coarse to fine: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        let results = CoarseToFineResults(
+            frameCount: frames.count,
+            levels: levels,
+            minInliers: minInliers,
+            fullLatencies: fullLatencies,
+            coarseToFineLatencies: coarseToFineLatencies,
+            fullSuccessCount: fullSuccessCount,
+            coarseToFineSuccessCount: coarseToFineSuccessCount,
+            coarseAcceptedCount: coarseToFine.coarseAcceptedCount,
+            comparedPoseCount: comparedPoseCount,
+            meanPositionDifference: comparedPoseCount > 0 ? positionDifference / Double(comparedPoseCount) : 0
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
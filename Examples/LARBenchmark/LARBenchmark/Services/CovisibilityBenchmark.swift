@@ -0,0 +1,81 @@
+//
+//  CovisibilityBenchmark.swift
+//  LARBenchmark
+//
+//  Builds the covisibility graph from the mapping frames, then replays frames and expands
+//  each frame's predecessor's inliers through it, comparing the covisible landmarks with the
+//  spatial query's candidates and the inliers the tracker actually found
+//
+
+import Foundation
+import CoreGraphics
+import LocalizeAR
+
+actor CovisibilityBenchmark {
+    func run(map: LARMap, mappingFrames: [LARFrame], frames: [FrameData],
+             searchDiameter: Double = 20.0, seedCount: Int = 10, keyframeLimit: Int = 8) async throws -> CovisibilityResults {
+        guard let first = frames.first else {
+            throw DataLoaderError.invalidJSON("No frames to replay")
+        }
+
+        var start = Date()
+        guard let graph = LARCovisibilityGraph(map: map, frames: mappingFrames) else {
+            throw DataLoaderError.invalidJSON("Failed to build the covisibility graph")
+        }
+        let buildTime = Date().timeIntervalSince(start)
+
+        let tracker = LARTracker(map: map, imageSize: CGSize(width: first.image.width, height: first.image.height))
+        var previousInliers: [NSNumber] = []
+        var evaluatedFrameCount = 0
+        var regionLandmarkCount = 0
+        var covisibleLandmarkCount = 0
+        var expansionTime: TimeInterval = 0
+        var inlierCount = 0
+        var keptInlierCount = 0
+
+        for (index, frameData) in frames.enumerated() {
+            let extrinsics = frameData.frame.extrinsics
+            let result = tracker.localize(frameData.image, frame: frameData.frame,
+                                          queryX: Double(extrinsics[3][0]), queryZ: Double(extrinsics[3][2]),
+                                          queryDiameter: searchDiameter)
+            let inliers = result.success ? tracker.inlierLandmarkIds() : []
+
+            if !inliers.isEmpty && !previousInliers.isEmpty {
+                start = Date()
+                let covisible = graph.landmarks(covisibleWith: Array(previousInliers.prefix(seedCount)), keyframeLimit: keyframeLimit)
+                expansionTime += Date().timeIntervalSince(start)
+
+                let covisibleIds = Set(covisible.map { Int($0.id) })
+                evaluatedFrameCount += 1
+                regionLandmarkCount += tracker.spatialQueryLandmarkIds().count
+                covisibleLandmarkCount += covisibleIds.count
+                inlierCount += inliers.count
+                keptInlierCount += inliers.filter { covisibleIds.contains($0.intValue) }.count
+            }
+            previousInliers = inliers
+
+            if (index + 1) % 50 == 0 {
+                print("  Covisibility: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        let results = CovisibilityResults(
+            mappingFrameCount: mappingFrames.count,
+            keyframeCount: graph.keyframeCount,
+            visibilityCount: graph.visibilityCount,
+            linkCount: graph.linkCount,
+            graphBytes: graph.memoryBytes,
+            buildTime: buildTime,
+            keyframeLimit: keyframeLimit,
+            evaluatedFrameCount: evaluatedFrameCount,
+            regionLandmarkCount: regionLandmarkCount,
+            covisibleLandmarkCount: covisibleLandmarkCount,
+            expansionTime: expansionTime,
+            inlierCount: inlierCount,
+            keptInlierCount: keptInlierCount
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
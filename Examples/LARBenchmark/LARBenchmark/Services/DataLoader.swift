@@ -17,37 +17,30 @@ enum DataLoaderError: Error {
 }
 
 actor DataLoader {
-    /// Load LARMap from map.json in specified directory
+    /// Load LARMap from the specified directory, preferring the memory-mapped map.larmap
+    /// archive and falling back to map.json
     func loadMap(from directory: URL) async throws -> LARMap {
-        let mapPath = directory.appendingPathComponent("map.json")
+        let archivePath = directory.appendingPathComponent("map.larmap")
+        let jsonPath = directory.appendingPathComponent("map.json")
+        let mapPath = FileManager.default.fileExists(atPath: archivePath.path) ? archivePath : jsonPath
 
         guard FileManager.default.fileExists(atPath: mapPath.path) else {
-            throw DataLoaderError.fileNotFound("map.json not found at \(mapPath.path)")
+            throw DataLoaderError.fileNotFound("map.json not found at \(jsonPath.path)")
         }
 
         // Use ObjC bridge initializer
-        let map = LARMap(contentsOf: mapPath.path)
+        guard let map = LARMap(contentsOf: mapPath.path) else {
+            throw DataLoaderError.invalidJSON("Failed to load \(mapPath.path)")
+        }
 
         print("✓ Loaded map from \(mapPath.path)")
         return map
     }
 
-    /// Load frames and their images from frames.json and image files
+    /// Load frames and their images, preferring the memory-mapped frames.larframes index
+    /// (only the first `limit` frames are materialized) and falling back to frames.json
     func loadFrames(from directory: URL, limit: Int = 400) async throws -> [FrameData] {
-        let framesPath = directory.appendingPathComponent("frames.json")
-
-        guard FileManager.default.fileExists(atPath: framesPath.path) else {
-            throw DataLoaderError.fileNotFound("frames.json not found at \(framesPath.path)")
-        }
-
-        print("Loading frames from \(framesPath.path)...")
-
-        // Use ObjC bridge class method
-        guard let allFrames = LARFrame.loadFrames(fromFile: framesPath.path) else {
-            throw DataLoaderError.invalidJSON("Failed to load frames from \(framesPath.path)")
-        }
-
-        let framesToLoad = Array(allFrames.prefix(limit))
+        let framesToLoad = try await loadFrameMetadata(from: directory, limit: limit)
         print("Loading images for \(framesToLoad.count) frames...")
 
         var frameDataList: [FrameData] = []
@@ -73,6 +66,29 @@ actor DataLoader {
         return frameDataList
     }
 
+    /// Load the first `limit` frames without their images
+    func loadFrameMetadata(from directory: URL, limit: Int = 400) async throws -> [LARFrame] {
+        let indexPath = directory.appendingPathComponent("frames.larframes")
+        let framesPath = directory.appendingPathComponent("frames.json")
+
+        if FileManager.default.fileExists(atPath: indexPath.path),
+           let index = LARFrameIndex(contentsOf: indexPath.path) {
+            print("Loading frames from \(indexPath.path)...")
+            return index.frames(in: NSRange(location: 0, length: limit))
+        }
+        guard FileManager.default.fileExists(atPath: framesPath.path) else {
+            throw DataLoaderError.fileNotFound("frames.json not found at \(framesPath.path)")
+        }
+
+        print("Loading frames from \(framesPath.path)...")
+
+        // Use ObjC bridge class method
+        guard let allFrames = LARFrame.loadFrames(fromFile: framesPath.path) else {
+            throw DataLoaderError.invalidJSON("Failed to load frames from \(framesPath.path)")
+        }
+        return Array(allFrames.prefix(limit))
+    }
+
     /// Generate image filename from frame ID (matches C++ format: 00000001_image.jpeg)
     private func getImageFilename(for frame: LARFrame) -> String {
         let idString = String(format: "%08d", frame.id)
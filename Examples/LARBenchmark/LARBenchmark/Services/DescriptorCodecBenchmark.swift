@@ -0,0 +1,72 @@
+//
+//  DescriptorCodecBenchmark.swift
+//  LARBenchmark
+//
+//  Replays frames against the map with each descriptor codec and measures how often matching
+//  on codes finds the same nearest landmark as exact matching
+//
+
+import Foundation
+import LocalizeAR
+
+actor DescriptorCodecBenchmark {
+    struct Configuration {
+        let name: String
+        let kind: LARDescriptorCodecKind
+        let subspaces: Int
+    }
+
+    static let configurations = [
+        Configuration(name: "SQ8", kind: .scalar8, subspaces: 0),
+        Configuration(name: "PQ-32", kind: .product, subspaces: 32),
+        Configuration(name: "PQ-16", kind: .product, subspaces: 16),
+    ]
+
+    /// Train every codec on `map` and evaluate recall on `frames`
+    func run(map: LARMap, frames: [FrameData], rerankDepth: Int = 8, searchDiameter: Double = 20.0) async throws -> DescriptorCodecResults {
+        var measurements: [DescriptorCodecResults.Measurement] = []
+
+        for configuration in Self.configurations {
+            print("Training \(configuration.name) codebook...")
+            guard let codec = LARDescriptorCodec(map: map, kind: configuration.kind, subspaces: configuration.subspaces),
+                  let evaluator = LARDescriptorRecallEvaluator(map: map, codec: codec, rerankDepth: rerankDepth) else {
+                print("⚠️  Skipping \(configuration.name): codec could not be trained")
+                continue
+            }
+
+            for (index, frameData) in frames.enumerated() {
+                // Query around the camera position (translation column of the extrinsics).
+                let extrinsics = frameData.frame.extrinsics
+                let query = LARSpatialQuery(x: Double(extrinsics[3][0]), z: Double(extrinsics[3][2]), diameter: searchDiameter)
+                evaluator.evaluate(frameData.image, query: query)
+
+                if (index + 1) % 50 == 0 {
+                    print("  \(configuration.name): \(index + 1)/\(frames.count) frames")
+                }
+                try Task.checkCancellation()
+            }
+
+            measurements.append(DescriptorCodecResults.Measurement(
+                name: configuration.name,
+                codeSize: codec.codeSize,
+                descriptorSize: codec.descriptorSize,
+                exactBytes: evaluator.exactBytes,
+                compressedBytes: evaluator.compressedBytes,
+                queryCount: evaluator.queryCount,
+                approximateRecall: evaluator.approximateRecall,
+                rerankedRecall: evaluator.rerankedRecall,
+                exactMatchTime: evaluator.exactMatchSeconds,
+                approximateMatchTime: evaluator.approximateMatchSeconds,
+                rerankedMatchTime: evaluator.rerankedMatchSeconds
+            ))
+        }
+
+        guard !measurements.isEmpty else {
+            throw DataLoaderError.invalidJSON("Map has no landmark descriptors to compress")
+        }
+
+        let results = DescriptorCodecResults(frameCount: frames.count, rerankDepth: rerankDepth, measurements: measurements)
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  FloorQueryBenchmark.swift
+//  LARBenchmark
+//
+//  Replays frames and compares spatial queries restricted to the height layer of the camera
+//  (taken from the frame's VIO pose) with the full region, checking how many of the landmarks
+//  localization relied on lie inside the band
+//
+
+import Foundation
+import CoreGraphics
+import LocalizeAR
+
+actor FloorQueryBenchmark {
+    func run(map: LARMap, frames: [FrameData], searchDiameter: Double = 20.0) async throws -> FloorQueryResults {
+        guard let first = frames.first else {
+            throw DataLoaderError.invalidJSON("No frames to replay")
+        }
+        let tracker = LARTracker(map: map, imageSize: CGSize(width: first.image.width, height: first.image.height))
+
+        var localizedFrameCount = 0
+        var regionLandmarkCount = 0
+        var floorLandmarkCount = 0
+        var regionQueryTime: TimeInterval = 0
+        var floorQueryTime: TimeInterval = 0
+        var inlierCount = 0
+        var keptInlierCount = 0
+
+        for (index, frameData) in frames.enumerated() {
+            let extrinsics = frameData.frame.extrinsics
+            let region = LARSpatialQuery(x: Double(extrinsics[3][0]), z: Double(extrinsics[3][2]), diameter: searchDiameter)
+            let result = tracker.localize(frameData.image, frame: frameData.frame,
+                                          queryX: region.x, queryZ: region.z, queryDiameter: searchDiameter)
+            if result.success {
+                localizedFrameCount += 1
+                let inliers = tracker.inlierLandmarkIds().map { $0.intValue }
+                inlierCount += inliers.count
+
+                var start = Date()
+                regionLandmarkCount += map.landmarks(for: region).count
+                regionQueryTime += Date().timeIntervalSince(start)
+
+                start = Date()
+                let floor = map.floorQuery(for: region, cameraHeight: Double(extrinsics[3][1]))
+                let kept = Set(map.landmarks(for: floor).map { Int($0.id) })
+                floorQueryTime += Date().timeIntervalSince(start)
+                floorLandmarkCount += kept.count
+                keptInlierCount += inliers.filter { kept.contains($0) }.count
+            }
+
+            if (index + 1) % 50 == 0 {
+                print("  Floor query: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        let layers = (0..<map.heightLayerCount).map { index -> FloorQueryResults.Layer in
+            var lower = 0.0
+            var upper = 0.0
+            map.heightLayer(at: index, lower: &lower, upper: &upper)
+            return FloorQueryResults.Layer(lower: lower, upper: upper)
+        }
+        let results = FloorQueryResults(
+            frameCount: frames.count,
+            localizedFrameCount: localizedFrameCount,
+            layers: layers,
+            regionLandmarkCount: regionLandmarkCount,
+            floorLandmarkCount: floorLandmarkCount,
+            regionQueryTime: regionQueryTime,
+            floorQueryTime: floorQueryTime,
+            inlierCount: inlierCount,
+            keptInlierCount: keptInlierCount
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
@@ -0,0 +1,75 @@
+//
+//  FrustumQueryBenchmark.swift
+//  LARBenchmark
+//
+//  Replays frames and compares the landmarks a plain spatial query returns with those a
+//  frustum query returns for the frame's camera pose, checking the frustum doesn't drop the
+//  landmarks localization actually relies on
+//
+
+import Foundation
+import CoreGraphics
+import LocalizeAR
+
+actor FrustumQueryBenchmark {
+    func run(map: LARMap, frames: [FrameData], searchDiameter: Double = 20.0) async throws -> FrustumQueryResults {
+        guard let first = frames.first else {
+            throw DataLoaderError.invalidJSON("No frames to replay")
+        }
+        let tracker = LARTracker(map: map, imageSize: CGSize(width: first.image.width, height: first.image.height))
+
+        var regionLandmarkCount = 0
+        var frustumLandmarkCount = 0
+        var regionQueryTime: TimeInterval = 0
+        var frustumQueryTime: TimeInterval = 0
+        var localizedFrameCount = 0
+        var inlierCount = 0
+        var keptInlierCount = 0
+
+        for (index, frameData) in frames.enumerated() {
+            // Recorded frames are in map coordinates, so the VIO pose is the map pose.
+            let extrinsics = frameData.frame.extrinsics
+            let region = LARSpatialQuery(x: Double(extrinsics[3][0]), z: Double(extrinsics[3][2]), diameter: searchDiameter)
+            let cameraTransform = simd_double4x4(
+                simd_double4(extrinsics[0]), simd_double4(extrinsics[1]),
+                simd_double4(extrinsics[2]), simd_double4(extrinsics[3]))
+            let frustum = LARFrustumQuery(region: region, cameraTransform: cameraTransform, intrinsics: frameData.frame.intrinsics)
+
+            var start = Date()
+            regionLandmarkCount += map.landmarks(for: region).count
+            regionQueryTime += Date().timeIntervalSince(start)
+
+            start = Date()
+            let visible = Set(map.landmarks(for: frustum).map { Int($0.id) })
+            frustumQueryTime += Date().timeIntervalSince(start)
+            frustumLandmarkCount += visible.count
+
+            let result = tracker.localize(frameData.image, frame: frameData.frame,
+                                          queryX: region.x, queryZ: region.z, queryDiameter: searchDiameter)
+            if result.success {
+                localizedFrameCount += 1
+                let inliers = tracker.inlierLandmarkIds().map { $0.intValue }
+                inlierCount += inliers.count
+                keptInlierCount += inliers.filter { visible.contains($0) }.count
+            }
+
+            if (index + 1) % 50 == 0 {
+                print("  Frustum query: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        let results = FrustumQueryResults(
+            frameCount: frames.count,
+            regionLandmarkCount: regionLandmarkCount,
+            frustumLandmarkCount: frustumLandmarkCount,
+            regionQueryTime: regionQueryTime,
+            frustumQueryTime: frustumQueryTime,
+            localizedFrameCount: localizedFrameCount,
+            inlierCount: inlierCount,
+            keptInlierCount: keptInlierCount
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
@@ -0,0 +1,69 @@
+//
+//  LandmarkQualityBenchmark.swift
+//  LARBenchmark
+//
+//  Replays frames and compares quality-budgeted queries (top landmarks per grid cell) with
+//  the full spatial query, checking how many of the landmarks localization relied on survive
+//  each budget
+//
+
+import Foundation
+import CoreGraphics
+import LocalizeAR
+
+actor LandmarkQualityBenchmark {
+    func run(map: LARMap, frames: [FrameData], searchDiameter: Double = 20.0,
+             cellSize: Double = 2.0, budgets: [Int] = [2, 5, 10]) async throws -> LandmarkQualityResults {
+        guard let first = frames.first else {
+            throw DataLoaderError.invalidJSON("No frames to replay")
+        }
+        let tracker = LARTracker(map: map, imageSize: CGSize(width: first.image.width, height: first.image.height))
+
+        var localizedFrameCount = 0
+        var regionLandmarkCount = 0
+        var inlierCount = 0
+        var landmarkCounts = Array(repeating: 0, count: budgets.count)
+        var queryTimes = Array(repeating: TimeInterval(0), count: budgets.count)
+        var keptInlierCounts = Array(repeating: 0, count: budgets.count)
+
+        for (index, frameData) in frames.enumerated() {
+            let extrinsics = frameData.frame.extrinsics
+            let region = LARSpatialQuery(x: Double(extrinsics[3][0]), z: Double(extrinsics[3][2]), diameter: searchDiameter)
+            let result = tracker.localize(frameData.image, frame: frameData.frame,
+                                          queryX: region.x, queryZ: region.z, queryDiameter: searchDiameter)
+            if result.success {
+                localizedFrameCount += 1
+                regionLandmarkCount += tracker.spatialQueryLandmarkIds().count
+                let inliers = tracker.inlierLandmarkIds().map { $0.intValue }
+                inlierCount += inliers.count
+
+                for (budgetIndex, perCell) in budgets.enumerated() {
+                    let start = Date()
+                    let kept = Set(map.landmarks(for: region, perCell: perCell, cellSize: cellSize).map { Int($0.id) })
+                    queryTimes[budgetIndex] += Date().timeIntervalSince(start)
+                    landmarkCounts[budgetIndex] += kept.count
+                    keptInlierCounts[budgetIndex] += inliers.filter { kept.contains($0) }.count
+                }
+            }
+
+            if (index + 1) % 50 == 0 {
+                print("  Landmark quality: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        let results = LandmarkQualityResults(
+            frameCount: frames.count,
+            localizedFrameCount: localizedFrameCount,
+            cellSize: cellSize,
+            regionLandmarkCount: regionLandmarkCount,
+            inlierCount: inlierCount,
+            budgets: budgets.indices.map { i in
+                LandmarkQualityResults.Budget(perCell: budgets[i], landmarkCount: landmarkCounts[i],
+                                              queryTime: queryTimes[i], keptInlierCount: keptInlierCounts[i])
+            }
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
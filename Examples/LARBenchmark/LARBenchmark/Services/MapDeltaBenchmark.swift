@@ -0,0 +1,87 @@
+//
+//  MapDeltaBenchmark.swift
+//  LARBenchmark
+//
+//  Measures the over-the-air update path: delta size against the full map, and the time to
+//  apply it against reloading the whole map
+//
+
+import Foundation
+import LocalizeAR
+
+actor MapDeltaBenchmark {
+    /// The previous version of the map is expected next to the current one
+    static let baseFiles = ["map.previous.larmap", "map.previous.json"]
+    static let targetFiles = ["map.larmap", "map.json"]
+
+    func run(directory: URL, iterations: Int = 3) async throws -> MapDeltaResults {
+        let fileManager = FileManager.default
+        guard let baseFile = Self.baseFiles.first(where: { fileManager.fileExists(atPath: directory.appendingPathComponent($0).path) }) else {
+            throw DataLoaderError.fileNotFound("No previous map version (\(Self.baseFiles.joined(separator: " or "))) in \(directory.path)")
+        }
+        guard let targetFile = Self.targetFiles.first(where: { fileManager.fileExists(atPath: directory.appendingPathComponent($0).path) }) else {
+            throw DataLoaderError.fileNotFound("No map.larmap or map.json in \(directory.path)")
+        }
+        let basePath = directory.appendingPathComponent(baseFile).path
+        let targetPath = directory.appendingPathComponent(targetFile).path
+
+        let scratch = fileManager.temporaryDirectory.appendingPathComponent("LARBenchmark-delta-\(UUID().uuidString)")
+        try fileManager.createDirectory(at: scratch, withIntermediateDirectories: true)
+        defer { try? fileManager.removeItem(at: scratch) }
+        let deltaPath = scratch.appendingPathComponent("map.lardelta").path
+        let archivePath = scratch.appendingPathComponent("map.larmap").path
+
+        guard let target = LARMap(contentsOf: targetPath), let base = LARMap(contentsOf: basePath) else {
+            throw DataLoaderError.invalidJSON("Failed to load \(baseFile) or \(targetFile)")
+        }
+        guard target.writeArchive(to: archivePath) else {
+            throw DataLoaderError.invalidJSON("Failed to write an archive of \(targetPath)")
+        }
+
+        let writeStart = Date()
+        guard target.writeDelta(from: base, to: deltaPath) else {
+            throw DataLoaderError.invalidJSON("Failed to write a delta from \(basePath)")
+        }
+        let writeTime = Date().timeIntervalSince(writeStart)
+
+        var applyTimes: [TimeInterval] = []
+        var fullLoadTimes: [TimeInterval] = []
+        var matchesTarget = true
+        for iteration in 0..<iterations {
+            try autoreleasepool {
+                guard let base = LARMap(contentsOf: basePath) else {
+                    throw DataLoaderError.invalidJSON("Failed to load \(basePath)")
+                }
+                let start = Date()
+                guard base.applyDelta(at: deltaPath) else {
+                    throw DataLoaderError.invalidJSON("Failed to apply the delta to \(basePath)")
+                }
+                applyTimes.append(Date().timeIntervalSince(start))
+                matchesTarget = matchesTarget && base.fingerprint == target.fingerprint
+            }
+            autoreleasepool {
+                let start = Date()
+                _ = LARMap(contentsOf: archivePath)
+                fullLoadTimes.append(Date().timeIntervalSince(start))
+            }
+            print("Delta run \(iteration + 1)/\(iterations): apply \(String(format: "%.1f", applyTimes.last! * 1000.0)) ms")
+            try Task.checkCancellation()
+        }
+
+        let attributes = { (path: String) -> UInt64 in
+            ((try? fileManager.attributesOfItem(atPath: path))?[.size] as? NSNumber)?.uint64Value ?? 0
+        }
+        let results = MapDeltaResults(
+            baseFile: baseFile,
+            targetFile: targetFile,
+            deltaBytes: attributes(deltaPath),
+            archiveBytes: attributes(archivePath),
+            writeTime: writeTime,
+            applyTimes: applyTimes,
+            fullLoadTimes: fullLoadTimes,
+            matchesTarget: matchesTarget
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
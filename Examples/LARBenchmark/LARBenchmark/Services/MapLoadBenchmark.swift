@@ -0,0 +1,109 @@
+//
+//  MapLoadBenchmark.swift
+//  LARBenchmark
+//
+//  Measures map load time and peak memory for each map format found in a directory
+//
+
+import Foundation
+import LocalizeAR
+
+actor MapLoadBenchmark {
+    /// Archives are also loaded lazily, deferring descriptors until a query reaches them
+    static let formats: [(file: String, lazy: Bool)] = [
+        ("map.json", false),
+        ("map.larmap", false),
+        ("map.larmap", true),
+    ]
+    static let threadCounts = [1, 2, 4, 8]
+
+    /// Load every available map format `iterations` times, tracking time and peak footprint,
+    /// then time eager loads at each thread count
+    func run(directory: URL, iterations: Int = 3) async throws -> MapLoadResults {
+        var measurements: [MapLoadResults.Measurement] = []
+
+        for (file, lazy) in Self.formats {
+            let format = lazy ? "\(file) (lazy)" : file
+            let path = directory.appendingPathComponent(file).path
+            guard let attributes = try? FileManager.default.attributesOfItem(atPath: path) else {
+                continue
+            }
+            let fileSize = (attributes[.size] as? NSNumber)?.uint64Value ?? 0
+
+            var loadTimes: [TimeInterval] = []
+            var peakBytes: UInt64 = 0
+            var retainedBytes: UInt64 = 0
+            var landmarkCount = 0
+
+            for iteration in 0..<iterations {
+                // Each map is released before the next load so runs start from the same baseline.
+                try autoreleasepool {
+                    let baseline = MemorySampler.currentFootprint()
+                    let sampler = MemorySampler()
+                    sampler.start()
+
+                    let start = Date()
+                    guard let map = LARMap(contentsOf: path, lazy: lazy) else {
+                        throw DataLoaderError.fileNotFound("Could not load \(path)")
+                    }
+                    let elapsed = Date().timeIntervalSince(start)
+
+                    let peak = sampler.stop()
+                    let retained = MemorySampler.currentFootprint()
+
+                    loadTimes.append(elapsed)
+                    peakBytes = max(peakBytes, peak > baseline ? peak - baseline : 0)
+                    retainedBytes = max(retainedBytes, retained > baseline ? retained - baseline : 0)
+                    landmarkCount = map.landmarks.count
+
+                    print("\(format) run \(iteration + 1)/\(iterations): \(String(format: "%.1f", elapsed * 1000.0)) ms")
+                    try Task.checkCancellation()
+                }
+            }
+
+            measurements.append(MapLoadResults.Measurement(
+                format: format,
+                fileSize: fileSize,
+                landmarkCount: landmarkCount,
+                loadTimes: loadTimes,
+                peakBytes: peakBytes,
+                retainedBytes: retainedBytes
+            ))
+        }
+
+        // Speedup of parallel decoding, from the same files loaded eagerly
+        var scaling: [MapLoadResults.ThreadScaling] = []
+        for (file, lazy) in Self.formats where !lazy {
+            let path = directory.appendingPathComponent(file).path
+            guard FileManager.default.fileExists(atPath: path) else { continue }
+
+            var medianTimes: [TimeInterval] = []
+            for threads in Self.threadCounts {
+                var loadTimes: [TimeInterval] = []
+                for _ in 0..<iterations {
+                    autoreleasepool {
+                        let start = Date()
+                        _ = LARMap(contentsOf: path, threads: threads)
+                        loadTimes.append(Date().timeIntervalSince(start))
+                    }
+                    try Task.checkCancellation()
+                }
+                medianTimes.append(loadTimes.sorted()[loadTimes.count / 2])
+                print("\(file) with \(threads) threads: \(String(format: "%.1f", medianTimes.last! * 1000.0)) ms")
+            }
+            scaling.append(MapLoadResults.ThreadScaling(
+                format: file,
+                threadCounts: Self.threadCounts,
+                medianLoadTimes: medianTimes
+            ))
+        }
+
+        guard !measurements.isEmpty else {
+            throw DataLoaderError.fileNotFound("No map.json or map.larmap in \(directory.path)")
+        }
+
+        let results = MapLoadResults(measurements: measurements, threadScaling: scaling)
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
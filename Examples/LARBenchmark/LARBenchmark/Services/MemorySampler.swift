@@ -0,0 +1,51 @@
+//
+//  MemorySampler.swift
+//  LARBenchmark
+//
+//  Tracks the peak memory footprint of the process over an interval
+//
+
+import Foundation
+import Darwin
+
+/// Samples the process memory footprint (the figure jetsam acts on) on a background queue
+/// and records the highest value seen between `start()` and `stop()`.
+final class MemorySampler {
+    private let queue = DispatchQueue(label: "com.larbenchmark.memorysampler", qos: .userInteractive)
+    private var timer: DispatchSourceTimer?
+    private var peak: UInt64 = 0
+
+    /// Current physical footprint of this process in bytes
+    static func currentFootprint() -> UInt64 {
+        var info = task_vm_info_data_t()
+        var count = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<natural_t>.size)
+        let result = withUnsafeMutablePointer(to: &info) {
+            $0.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &count)
+            }
+        }
+        return result == KERN_SUCCESS ? info.phys_footprint : 0
+    }
+
+    func start(interval: DispatchTimeInterval = .milliseconds(2)) {
+        queue.sync { peak = Self.currentFootprint() }
+        let timer = DispatchSource.makeTimerSource(queue: queue)
+        timer.schedule(deadline: .now(), repeating: interval)
+        timer.setEventHandler { [weak self] in
+            guard let self = self else { return }
+            self.peak = max(self.peak, Self.currentFootprint())
+        }
+        self.timer = timer
+        timer.resume()
+    }
+
+    /// Stop sampling and return the peak footprint in bytes
+    func stop() -> UInt64 {
+        timer?.cancel()
+        timer = nil
+        return queue.sync {
+            peak = max(peak, Self.currentFootprint())
+            return peak
+        }
+    }
+}
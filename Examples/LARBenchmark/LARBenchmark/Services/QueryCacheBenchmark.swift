@@ -0,0 +1,59 @@
+//
+//  QueryCacheBenchmark.swift
+//  LARBenchmark
+//
+//  Walks the recorded camera path and keeps a landmark query cache up to date, comparing the
+//  incremental update with a full query at every frame
+//
+
+import Foundation
+import LocalizeAR
+
+actor QueryCacheBenchmark {
+    func run(map: LARMap, frames: [LARFrame], searchDiameter: Double = 20.0) async throws -> QueryCacheResults {
+        let cache = LARLandmarkQueryCache(map: map)
+        var landmarkCount = 0
+        var changedLandmarkCount = 0
+        var cachedQueryTime: TimeInterval = 0
+        var fullQueryTime: TimeInterval = 0
+        var mismatchCount = 0
+
+        for (index, frame) in frames.enumerated() {
+            let extrinsics = frame.extrinsics
+            let query = LARSpatialQuery(x: Double(extrinsics[3][0]), z: Double(extrinsics[3][2]), diameter: searchDiameter)
+
+            var start = Date()
+            if cache.update(for: query) {
+                changedLandmarkCount += cache.addedLandmarks.count + cache.removedLandmarks.count
+            }
+            cachedQueryTime += Date().timeIntervalSince(start)
+
+            start = Date()
+            let full = map.landmarks(for: query)
+            fullQueryTime += Date().timeIntervalSince(start)
+
+            landmarkCount += cache.landmarkCount
+            if Set(cache.landmarks.map { $0.id }) != Set(full.map { $0.id }) {
+                mismatchCount += 1
+            }
+
+            if (index + 1) % 100 == 0 {
+                print("  Query cache: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        let results = QueryCacheResults(
+            frameCount: frames.count,
+            incrementalUpdateCount: cache.incrementalUpdateCount,
+            fullUpdateCount: cache.fullUpdateCount,
+            landmarkCount: landmarkCount,
+            changedLandmarkCount: changedLandmarkCount,
+            cachedQueryTime: cachedQueryTime,
+            fullQueryTime: fullQueryTime,
+            mismatchCount: mismatchCount
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
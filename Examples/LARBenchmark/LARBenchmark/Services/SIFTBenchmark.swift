@@ -0,0 +1,51 @@
+//
+//  SIFTBenchmark.swift
+//  LARBenchmark
+//
+//  Extracts SIFT features from the replayed frames with the CPU SIFT and OpenCV's SIFT
+//
+
+import Foundation
+import LocalizeAR
+
+actor SIFTBenchmark {
+    func run(frames: [FrameData]) async throws -> SIFTResults {
+        let benchmark = LARSIFTBenchmark()
+
+        for (index, frameData) in frames.enumerated() {
+            benchmark.add(frameData.image)
+
+            if (index + 1) % 20 == 0 {
+                print("  SIFT: \(index + 1)/\(frames.count) frames")
+            }
+            try Task.checkCancellation()
+        }
+
+        guard benchmark.imageCount > 0 else {
+            throw DataLoaderError.invalidJSON("No frames to extract features from")
+        }
+
+        let results = SIFTResults(
+            imageCount: benchmark.imageCount,
+            kernelName: benchmark.kernelName,
+            simdTime: benchmark.simdSeconds,
+            scalarTime: benchmark.scalarSeconds,
+            openCVTime: benchmark.openCVSeconds,
+            threadedTime: benchmark.threadedSeconds,
+            threadCount: benchmark.threadCount,
+            budgetTime: benchmark.budgetSeconds,
+            keypointBudget: benchmark.keypointBudget,
+            keptKeypointCount: benchmark.keptKeypointCount,
+            droppedKeypointCount: benchmark.droppedKeypointCount,
+            keypointCount: benchmark.keypointCount,
+            openCVKeypointCount: benchmark.openCVKeypointCount,
+            matchedKeypointCount: benchmark.matchedKeypointCount,
+            meanDescriptorDistance: benchmark.meanDescriptorDistance,
+            kernelsMatch: benchmark.kernelsMatch,
+            threadsMatch: benchmark.threadsMatch,
+            steadyStateAllocationCount: benchmark.steadyStateAllocationCount
+        )
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
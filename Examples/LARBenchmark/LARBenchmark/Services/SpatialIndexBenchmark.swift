@@ -0,0 +1,53 @@
+//
+//  SpatialIndexBenchmark.swift
+//  LARBenchmark
+//
+//  Times landmark queries on the packed R-tree (SIMD and scalar node tests) against a linear scan, with the map's landmarks
+//  tiled out to city-scale counts
+//
+
+import Foundation
+import LocalizeAR
+
+actor SpatialIndexBenchmark {
+    static let mapFiles = ["map.larmap", "map.json"]
+    static let landmarkCounts = [10_000, 100_000, 500_000]
+
+    func run(directory: URL, queryCount: Int = 1000, diameter: Double = 20) async throws -> SpatialIndexResults {
+        let fileManager = FileManager.default
+        guard let mapFile = Self.mapFiles.first(where: { fileManager.fileExists(atPath: directory.appendingPathComponent($0).path) }) else {
+            throw DataLoaderError.fileNotFound("No map.larmap or map.json in \(directory.path)")
+        }
+        guard let map = LARMap(contentsOf: directory.appendingPathComponent(mapFile).path) else {
+            throw DataLoaderError.invalidJSON("Failed to load \(mapFile)")
+        }
+
+        var runs: [SpatialIndexResults.Run] = []
+        var kernelName = "scalar"
+        for landmarkCount in Self.landmarkCounts {
+            guard let benchmark = LARSpatialIndexBenchmark(map: map, landmarkCount: landmarkCount, queryCount: queryCount, diameter: diameter) else {
+                throw DataLoaderError.invalidJSON("\(mapFile) has no landmarks")
+            }
+            runs.append(SpatialIndexResults.Run(
+                landmarkCount: benchmark.landmarkCount,
+                queryCount: benchmark.queryCount,
+                hitCount: benchmark.hitCount,
+                treeBytes: benchmark.treeBytes,
+                buildTime: benchmark.buildSeconds,
+                treeQueryTime: benchmark.treeQuerySeconds,
+                scalarTreeQueryTime: benchmark.scalarTreeQuerySeconds,
+                scanQueryTime: benchmark.scanQuerySeconds,
+                resultsMatch: benchmark.resultsMatch,
+                storedOrderPageCount: benchmark.storedOrderPageCount,
+                spatialOrderPageCount: benchmark.spatialOrderPageCount
+            ))
+            kernelName = benchmark.kernelName
+            print("Spatial index at \(landmarkCount) landmarks: \(String(format: "%.1f", runs.last!.speedup))x over scan")
+            try Task.checkCancellation()
+        }
+
+        let results = SpatialIndexResults(mapLandmarkCount: map.landmarks.count, diameter: diameter, kernelName: kernelName, runs: runs)
+        print("\n\(results.formattedSummary)")
+        return results
+    }
+}
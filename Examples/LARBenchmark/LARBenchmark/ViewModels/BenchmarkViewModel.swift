@@ -8,6 +8,7 @@
 import Foundation
 import SwiftUI
 import AppKit
+import LocalizeAR
 
 @MainActor
 class BenchmarkViewModel: ObservableObject {
@@ -29,11 +30,26 @@ class BenchmarkViewModel: ObservableObject {
 
     // Results
     @Published var results: BenchmarkResults?
+    @Published var mapLoadResults: MapLoadResults?
+    @Published var descriptorCodecResults: DescriptorCodecResults?
+    @Published var mapDeltaResults: MapDeltaResults?
+    @Published var spatialIndexResults: SpatialIndexResults?
+    @Published var frustumQueryResults: FrustumQueryResults?
+    @Published var queryCacheResults: QueryCacheResults?
+    @Published var covisibilityResults: CovisibilityResults?
+    @Published var landmarkQualityResults: LandmarkQualityResults?
+    @Published var floorQueryResults: FloorQueryResults?
+    @Published var siftResults: SIFTResults?
+    @Published var coarseToFineResults: CoarseToFineResults?
 
     var canStartBenchmark: Bool {
         mapDirectory != nil && framesDirectory != nil && !isRunning
     }
 
+    var canRunMapBenchmark: Bool {
+        mapDirectory != nil && !isRunning
+    }
+
     init() {
         setDefaultDirectories()
     }
@@ -153,6 +169,317 @@ class BenchmarkViewModel: ObservableObject {
         isRunning = false
     }
 
+    /// Measure load time and peak memory of the map formats in the map directory
+    func runMapLoadBenchmark() async {
+        guard let mapDir = mapDirectory else {
+            statusMessage = "Error: Map directory not selected"
+            return
+        }
+
+        isRunning = true
+        mapLoadResults = nil
+        statusMessage = "Benchmarking map loading..."
+
+        do {
+            mapLoadResults = try await MapLoadBenchmark().run(directory: mapDir)
+            statusMessage = "Map load benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Map load benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Measure the delta from the previous map version in the map directory to the current one
+    func runMapDeltaBenchmark() async {
+        guard let mapDir = mapDirectory else {
+            statusMessage = "Error: Map directory not selected"
+            return
+        }
+
+        isRunning = true
+        mapDeltaResults = nil
+        statusMessage = "Benchmarking map delta..."
+
+        do {
+            mapDeltaResults = try await MapDeltaBenchmark().run(directory: mapDir)
+            statusMessage = "Map delta benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Map delta benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Compare landmark queries on the packed R-tree with a linear scan
+    func runSpatialIndexBenchmark() async {
+        guard let mapDir = mapDirectory else {
+            statusMessage = "Error: Map directory not selected"
+            return
+        }
+
+        isRunning = true
+        spatialIndexResults = nil
+        statusMessage = "Benchmarking spatial index..."
+
+        do {
+            spatialIndexResults = try await SpatialIndexBenchmark().run(directory: mapDir)
+            statusMessage = "Spatial index benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Spatial index benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Measure descriptor memory and matching recall of each descriptor codec on the frames
+    func runDescriptorCodecBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        descriptorCodecResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            statusMessage = "Loading frames and images..."
+            let frames = try await loader.loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking descriptor codecs..."
+            descriptorCodecResults = try await DescriptorCodecBenchmark().run(map: map, frames: frames)
+            statusMessage = "Descriptor codec benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Descriptor codec benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Compare plain spatial queries with frustum queries on the frames' camera poses
+    func runFrustumQueryBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        frustumQueryResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            statusMessage = "Loading frames and images..."
+            let frames = try await loader.loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking frustum queries..."
+            frustumQueryResults = try await FrustumQueryBenchmark().run(map: map, frames: frames)
+            statusMessage = "Frustum query benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Frustum query benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Expand each frame's predecessor's inliers through the covisibility graph
+    func runCovisibilityBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        covisibilityResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            // The graph is built from the frames the map was made from when they were saved with
+            // it, otherwise from every recorded frame.
+            statusMessage = "Loading mapping frames..."
+            let mappingFrames: [LARFrame]
+            if let saved = try? await loader.loadFrameMetadata(from: mapDir, limit: .max) {
+                mappingFrames = saved
+            } else {
+                mappingFrames = try await loader.loadFrameMetadata(from: framesDir, limit: .max)
+            }
+
+            statusMessage = "Loading frames and images..."
+            let frames = try await loader.loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking covisibility graph..."
+            covisibilityResults = try await CovisibilityBenchmark().run(map: map, mappingFrames: mappingFrames, frames: frames)
+            statusMessage = "Covisibility benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Covisibility benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Compare per-cell quality budgets with the full spatial query on replayed frames
+    func runLandmarkQualityBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        landmarkQualityResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            statusMessage = "Loading frames and images..."
+            let frames = try await loader.loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking landmark quality budgets..."
+            landmarkQualityResults = try await LandmarkQualityBenchmark().run(map: map, frames: frames)
+            statusMessage = "Landmark quality benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Landmark quality benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Compare queries restricted to the camera's floor with the full spatial query on replayed frames
+    func runFloorQueryBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        floorQueryResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            statusMessage = "Loading frames and images..."
+            let frames = try await loader.loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking floor queries..."
+            floorQueryResults = try await FloorQueryBenchmark().run(map: map, frames: frames)
+            statusMessage = "Floor query benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Floor query benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Compare CPU SIFT extraction (SIMD and scalar kernels) with OpenCV's SIFT on the frame images
+    func runSIFTBenchmark() async {
+        guard let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        siftResults = nil
+
+        do {
+            statusMessage = "Loading frames and images..."
+            let frames = try await DataLoader().loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking SIFT extraction..."
+            siftResults = try await SIFTBenchmark().run(frames: frames)
+            statusMessage = "SIFT benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("SIFT benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Compare coarse-to-fine localization with full-image localization on replayed frames
+    func runCoarseToFineBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        coarseToFineResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            statusMessage = "Loading frames and images..."
+            let frames = try await loader.loadFrames(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking coarse-to-fine localization..."
+            coarseToFineResults = try await CoarseToFineBenchmark().run(map: map, frames: frames)
+            statusMessage = "Coarse-to-fine benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Coarse-to-fine benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
+    /// Replay the recorded path through the landmark query cache
+    func runQueryCacheBenchmark() async {
+        guard let mapDir = mapDirectory,
+              let framesDir = framesDirectory else {
+            statusMessage = "Error: Directories not selected"
+            return
+        }
+
+        isRunning = true
+        queryCacheResults = nil
+
+        do {
+            statusMessage = "Loading map..."
+            let loader = DataLoader()
+            let map = try await loader.loadMap(from: mapDir)
+
+            statusMessage = "Loading frames..."
+            let frames = try await loader.loadFrameMetadata(from: framesDir, limit: frameLimit)
+
+            statusMessage = "Benchmarking query cache..."
+            queryCacheResults = try await QueryCacheBenchmark().run(map: map, frames: frames)
+            statusMessage = "Query cache benchmark completed!"
+        } catch {
+            statusMessage = "Error: \(error.localizedDescription)"
+            print("Query cache benchmark error: \(error)")
+        }
+
+        isRunning = false
+    }
+
     /// Stop the benchmark (not implemented yet - would need cancellation support)
     func stopBenchmark() {
         // TODO: Implement cancellation
@@ -143,9 +143,207 @@ struct ContentView: View {
                     .buttonStyle(.borderedProminent)
                     .disabled(!viewModel.canStartBenchmark && !viewModel.isRunning)
                     .controlSize(.large)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runMapLoadBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "externaldrive")
+                            Text("Benchmark Map Loading")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canRunMapBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runMapDeltaBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "arrow.triangle.2.circlepath")
+                            Text("Benchmark Map Delta")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canRunMapBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runSpatialIndexBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "square.grid.3x3")
+                            Text("Benchmark Spatial Index")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canRunMapBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runDescriptorCodecBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "rectangle.compress.vertical")
+                            Text("Benchmark Descriptor Codecs")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runFrustumQueryBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "camera.viewfinder")
+                            Text("Benchmark Frustum Query")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runQueryCacheBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "figure.walk")
+                            Text("Benchmark Query Cache")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runCovisibilityBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "point.3.connected.trianglepath.dotted")
+                            Text("Benchmark Covisibility Graph")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runLandmarkQualityBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "star.leadinghalf.filled")
+                            Text("Benchmark Landmark Quality")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runFloorQueryBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "building.2")
+                            Text("Benchmark Floor Query")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runSIFTBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "cpu")
+                            Text("Benchmark CPU SIFT")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
+
+                    Button(action: {
+                        Task {
+                            await viewModel.runCoarseToFineBenchmark()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "arrow.down.right.and.arrow.up.left")
+                            Text("Benchmark Coarse-to-Fine")
+                        }
+                        .frame(maxWidth: .infinity)
+                    }
+                    .buttonStyle(.bordered)
+                    .disabled(!viewModel.canStartBenchmark)
                 }
                 .padding()
 
+                if let mapLoadResults = viewModel.mapLoadResults {
+                    ReportView(title: "Map Load Results", report: mapLoadResults.formattedSummary)
+                }
+
+                if let mapDeltaResults = viewModel.mapDeltaResults {
+                    ReportView(title: "Map Delta Results", report: mapDeltaResults.formattedSummary)
+                }
+
+                if let spatialIndexResults = viewModel.spatialIndexResults {
+                    ReportView(title: "Spatial Index Results", report: spatialIndexResults.formattedSummary)
+                }
+
+                if let frustumQueryResults = viewModel.frustumQueryResults {
+                    ReportView(title: "Frustum Query Results", report: frustumQueryResults.formattedSummary)
+                }
+
+                if let queryCacheResults = viewModel.queryCacheResults {
+                    ReportView(title: "Query Cache Results", report: queryCacheResults.formattedSummary)
+                }
+
+                if let covisibilityResults = viewModel.covisibilityResults {
+                    ReportView(title: "Covisibility Graph Results", report: covisibilityResults.formattedSummary)
+                }
+
+                if let landmarkQualityResults = viewModel.landmarkQualityResults {
+                    ReportView(title: "Landmark Quality Results", report: landmarkQualityResults.formattedSummary)
+                }
+
+                if let floorQueryResults = viewModel.floorQueryResults {
+                    ReportView(title: "Floor Query Results", report: floorQueryResults.formattedSummary)
+                }
+
+                if let siftResults = viewModel.siftResults {
+                    ReportView(title: "SIFT Results", report: siftResults.formattedSummary)
+                }
+
+                if let coarseToFineResults = viewModel.coarseToFineResults {
+                    ReportView(title: "Coarse-to-Fine Results", report: coarseToFineResults.formattedSummary)
+                }
+
+                if let descriptorCodecResults = viewModel.descriptorCodecResults {
+                    ReportView(title: "Descriptor Codec Results", report: descriptorCodecResults.formattedSummary)
+                }
+
                 // Results
                 if let results = viewModel.results {
                     BenchmarkResultsView(results: results)
@@ -158,6 +356,29 @@ struct ContentView: View {
     }
 }
 
+struct ReportView: View {
+    let title: String
+    let report: String
+
+    var body: some View {
+        VStack(alignment: .leading, spacing: 12) {
+            Text(title)
+                .font(.title2)
+                .fontWeight(.bold)
+
+            Divider()
+
+            Text(report)
+                .font(.system(.body, design: .monospaced))
+                .textSelection(.enabled)
+                .frame(maxWidth: .infinity, alignment: .leading)
+        }
+        .padding()
+        .background(Color(NSColor.controlBackgroundColor))
+        .cornerRadius(8)
+    }
+}
+
 struct DirectorySelectionRow: View {
     let title: String
     let directory: URL?
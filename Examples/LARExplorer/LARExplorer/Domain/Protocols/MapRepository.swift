@@ -98,6 +98,12 @@ protocol MapRepository: AnyObject {
     /// Get a specific landmark by ID
     func landmark(id: Int) -> LandmarkData?
 
+    /// Get the `count` landmarks nearest to a point in map coordinates, nearest first
+    func nearestLandmarks(to point: SIMD3<Double>, count: Int) -> [LandmarkData]
+
+    /// Get the landmarks within `radius` meters of a point in map coordinates, nearest first
+    func landmarks(within radius: Double, of point: SIMD3<Double>) -> [LandmarkData]
+
     /// Get the total number of landmarks
     var landmarkCount: Int { get }
 
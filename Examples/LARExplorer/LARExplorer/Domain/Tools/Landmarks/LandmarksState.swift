@@ -9,12 +9,22 @@ import Foundation
 
 // MARK: - State
 
+/// A landmark near the selected one, for spotting duplicates and sparse structure
+struct LandmarkNeighbor: Equatable {
+    let id: Int
+    /// Distance to the selected landmark in meters
+    let distance: Double
+}
+
 /// Pure value type representing the state of landmark inspection
 /// This is a simple read-only selection tool
 struct LandmarksState: Equatable {
     /// The selected landmark ID (nil if none selected)
     var selectedLandmarkId: Int?
 
+    /// Nearest landmarks to the selection, nearest first
+    var neighbors: [LandmarkNeighbor] = []
+
     /// Initial state factory
     static let initial = LandmarksState()
 
@@ -33,6 +43,9 @@ enum LandmarksAction: Equatable {
 
     /// Clear the current selection
     case clearSelection
+
+    /// Show the nearest landmarks to the selection
+    case showNeighbors([LandmarkNeighbor])
 }
 
 // MARK: - Reducer
@@ -45,9 +58,15 @@ extension LandmarksAction {
         switch self {
         case .selectLandmark(let id):
             newState.selectedLandmarkId = id
+            newState.neighbors = []
 
         case .clearSelection:
             newState.selectedLandmarkId = nil
+            newState.neighbors = []
+
+        case .showNeighbors(let neighbors):
+            guard newState.hasSelection else { break }
+            newState.neighbors = neighbors
         }
 
         return newState
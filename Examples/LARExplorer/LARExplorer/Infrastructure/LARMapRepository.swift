@@ -173,13 +173,25 @@ final class LARMapRepository: MapRepository, ObservableObject {
     func landmark(id: Int) -> LandmarkData? {
         guard let map = mapService?.mapData else { return nil }
 
-        guard let landmark = map.landmarks.first(where: { Int($0.id) == id }) else {
+        guard let landmark = map.landmark(id: id) else {
             return nil
         }
 
         return landmarkData(from: landmark)
     }
 
+    func nearestLandmarks(to point: SIMD3<Double>, count: Int) -> [LandmarkData] {
+        guard let map = mapService?.mapData else { return [] }
+
+        return map.nearestLandmarks(to: point, count: count).map { landmarkData(from: $0) }
+    }
+
+    func landmarks(within radius: Double, of point: SIMD3<Double>) -> [LandmarkData] {
+        guard let map = mapService?.mapData else { return [] }
+
+        return map.landmarks(within: radius, of: point).map { landmarkData(from: $0) }
+    }
+
     var landmarkCount: Int {
         mapService?.mapData?.landmarks.count ?? 0
     }
@@ -95,7 +95,10 @@ class MapService: ObservableObject {
             return false
         }
 
-        mapProcessor.saveMap(directory)
+        guard mapProcessor.saveMap(directory) else {
+            errorMessage = "Failed to save map to \(directory)"
+            return false
+        }
         return true
     }
 
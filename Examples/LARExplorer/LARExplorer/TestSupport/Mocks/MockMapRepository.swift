@@ -49,6 +49,8 @@ final class MockMapRepository: MapRepository {
     var removeEdgeCalls: [EdgeOperation] = []
     var allLandmarksCalls: Int = 0
     var landmarkCalls: [Int] = []
+    var nearestLandmarksCalls: [SIMD3<Double>] = []
+    var landmarksWithinCalls: [SIMD3<Double>] = []
     var originCalls: Int = 0
     var updateOriginCalls: [simd_float4x4] = []
     var locationCalls: [SIMD3<Double>] = []
@@ -128,6 +130,24 @@ final class MockMapRepository: MapRepository {
         return stubbedLandmarks[id]
     }
 
+    func nearestLandmarks(to point: SIMD3<Double>, count: Int) -> [LandmarkData] {
+        nearestLandmarksCalls.append(point)
+        return Array(landmarksByDistance(from: point).prefix(max(count, 0)))
+    }
+
+    func landmarks(within radius: Double, of point: SIMD3<Double>) -> [LandmarkData] {
+        landmarksWithinCalls.append(point)
+        return landmarksByDistance(from: point).filter { distance(from: point, to: $0) <= radius }
+    }
+
+    private func landmarksByDistance(from point: SIMD3<Double>) -> [LandmarkData] {
+        stubbedLandmarks.values.sorted { distance(from: point, to: $0) < distance(from: point, to: $1) }
+    }
+
+    private func distance(from point: SIMD3<Double>, to landmark: LandmarkData) -> Double {
+        simd_distance(point, SIMD3<Double>(landmark.position))
+    }
+
     func origin() -> simd_float4x4 {
         originCalls += 1
         return stubbedOrigin
@@ -176,6 +196,8 @@ final class MockMapRepository: MapRepository {
         removeEdgeCalls.removeAll()
         allLandmarksCalls = 0
         landmarkCalls.removeAll()
+        nearestLandmarksCalls.removeAll()
+        landmarksWithinCalls.removeAll()
         originCalls = 0
         updateOriginCalls.removeAll()
         locationCalls.removeAll()
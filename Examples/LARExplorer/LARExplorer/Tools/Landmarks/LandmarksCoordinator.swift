@@ -26,6 +26,9 @@ final class LandmarksCoordinator: ToolCoordinator, ObservableObject {
 
     let kind: ToolKind = .landmarks
 
+    /// Number of nearest landmarks listed for a selection
+    static let neighborCount = 8
+
     // MARK: - Initialization
 
     init(mapRepository: MapRepository, renderingService: RenderingService) {
@@ -64,10 +67,24 @@ final class LandmarksCoordinator: ToolCoordinator, ObservableObject {
     func dispatch(_ action: LandmarksAction) {
         state = action.reduce(state)
         updateRendering()
+        handleSideEffect(action)
     }
 
     // MARK: - Private Methods
 
+    private func handleSideEffect(_ action: LandmarksAction) {
+        guard case .selectLandmark(let id) = action,
+              let landmark = mapRepository.landmark(id: id) else { return }
+
+        // Ask for one extra, since the selection is its own nearest landmark
+        let position = SIMD3<Double>(landmark.position)
+        let neighbors = mapRepository.nearestLandmarks(to: position, count: Self.neighborCount + 1)
+            .filter { $0.id != id }
+            .prefix(Self.neighborCount)
+            .map { LandmarkNeighbor(id: $0.id, distance: simd_distance(position, SIMD3<Double>($0.position))) }
+        dispatch(.showNeighbors(Array(neighbors)))
+    }
+
     private func updateRendering() {
         if let selectedId = state.selectedLandmarkId {
             renderingService.highlightLandmarks([selectedId], style: .selected)
@@ -62,6 +62,18 @@ struct LandmarksInspectorView: View {
                 labelValueRow("Height", String(format: "%.2f m", landmark.boundsUpper.y - landmark.boundsLower.y))
             }
 
+            if !coordinator.state.neighbors.isEmpty {
+                Divider()
+
+                Text("Nearest Landmarks")
+                    .font(.subheadline)
+                    .bold()
+
+                ForEach(coordinator.state.neighbors, id: \.id) { neighbor in
+                    labelValueRow("\(neighbor.id)", String(format: "%.2f m", neighbor.distance))
+                }
+            }
+
             Divider()
 
             // Actions
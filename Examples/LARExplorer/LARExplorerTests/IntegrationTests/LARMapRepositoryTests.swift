@@ -76,6 +76,22 @@ struct LARMapRepositoryTests {
         #expect(landmark == nil)
     }
 
+    @Test func nearestLandmarks_withNoMap_returnsEmpty() {
+        let repository = LARMapRepository()
+
+        let landmarks = repository.nearestLandmarks(to: SIMD3<Double>(1, 2, 3), count: 5)
+
+        #expect(landmarks.isEmpty)
+    }
+
+    @Test func landmarksWithinRadius_withNoMap_returnsEmpty() {
+        let repository = LARMapRepository()
+
+        let landmarks = repository.landmarks(within: 10, of: SIMD3<Double>(1, 2, 3))
+
+        #expect(landmarks.isEmpty)
+    }
+
     // MARK: - Edge Existence Tests
 
     @Test func edgeExists_withNoMap_returnsFalse() {
@@ -58,4 +58,44 @@ struct LandmarksStateTests {
 
         #expect(newState == state)
     }
+
+    // MARK: - Neighbor Tests
+
+    @Test func showNeighbors_withSelection_setsNeighbors() {
+        var state = LandmarksState.initial
+        state.selectedLandmarkId = 42
+        let neighbors = [LandmarkNeighbor(id: 7, distance: 0.5), LandmarkNeighbor(id: 8, distance: 1.5)]
+
+        let newState = LandmarksAction.showNeighbors(neighbors).reduce(state)
+
+        #expect(newState.neighbors == neighbors)
+    }
+
+    @Test func showNeighbors_withoutSelection_isIgnored() {
+        let state = LandmarksState.initial
+
+        let newState = LandmarksAction.showNeighbors([LandmarkNeighbor(id: 7, distance: 0.5)]).reduce(state)
+
+        #expect(newState.neighbors.isEmpty)
+    }
+
+    @Test func selectLandmark_clearsNeighbors() {
+        var state = LandmarksState.initial
+        state.selectedLandmarkId = 1
+        state.neighbors = [LandmarkNeighbor(id: 7, distance: 0.5)]
+
+        let newState = LandmarksAction.selectLandmark(id: 2).reduce(state)
+
+        #expect(newState.neighbors.isEmpty)
+    }
+
+    @Test func clearSelection_clearsNeighbors() {
+        var state = LandmarksState.initial
+        state.selectedLandmarkId = 1
+        state.neighbors = [LandmarkNeighbor(id: 7, distance: 0.5)]
+
+        let newState = LandmarksAction.clearSelection.reduce(state)
+
+        #expect(newState.neighbors.isEmpty)
+    }
 }
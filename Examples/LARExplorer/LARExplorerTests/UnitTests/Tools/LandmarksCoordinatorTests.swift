@@ -95,6 +95,31 @@ struct LandmarksCoordinatorTests {
         #expect(renderingService.clearLandmarkHighlightsCalled)
     }
 
+    // MARK: - Neighbor Tests
+
+    @Test func dispatch_selectLandmark_listsNearestLandmarks() {
+        let (coordinator, mapRepository, _) = makeSUT()
+        mapRepository.stubbedLandmarks = [
+            42: LandmarkData(id: 42, position: SIMD3<Float>(0, 0, 0), isMatched: false, isUsable: true),
+            1: LandmarkData(id: 1, position: SIMD3<Float>(2, 0, 0), isMatched: false, isUsable: true),
+            2: LandmarkData(id: 2, position: SIMD3<Float>(0, 1, 0), isMatched: false, isUsable: true),
+        ]
+
+        coordinator.dispatch(.selectLandmark(id: 42))
+
+        #expect(coordinator.state.neighbors.map(\.id) == [2, 1])
+        #expect(coordinator.state.neighbors.first?.distance == 1)
+    }
+
+    @Test func dispatch_selectLandmark_withUnknownId_hasNoNeighbors() {
+        let (coordinator, mapRepository, _) = makeSUT()
+
+        coordinator.dispatch(.selectLandmark(id: 42))
+
+        #expect(coordinator.state.neighbors.isEmpty)
+        #expect(mapRepository.nearestLandmarksCalls.isEmpty)
+    }
+
     // MARK: - Scene Click Tests
 
     @Test func handleSceneClick_withLandmarkHit_selectsLandmark() {
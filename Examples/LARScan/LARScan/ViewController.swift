@@ -70,6 +70,7 @@ class ViewController: UIViewController, ARSCNViewDelegate, ARSessionDelegate, CL
 		mapper = LARLiveMapper(directory: createSessionDirctory()!)
 		Task {
 			let map = await mapper.data.map
+			map.openJournal(in: mapper.mapper.directory.path)
 
 			// Initialize navigation coordinator with new API
 			let navigation = LARNavigationCoordinator(map: map)
@@ -98,6 +99,8 @@ class ViewController: UIViewController, ARSCNViewDelegate, ARSessionDelegate, CL
 		locationManager.delegate = self
 		mapView.userTrackingMode = .follow
 
+		NotificationCenter.default.addObserver(self, selector: #selector(applicationDidEnterBackground), name: UIApplication.didEnterBackgroundNotification, object: nil)
+
 		// Show statistics such as fps and timing information
 		sceneView.showsStatistics = true
 		sceneView.debugOptions = [ .showWorldOrigin, .showFeaturePoints ]
@@ -180,7 +183,33 @@ class ViewController: UIViewController, ARSCNViewDelegate, ARSessionDelegate, CL
 	// MARK: - IBAction
 	
 	@IBAction func saveButtonPressed(_ button: UIButton) {
-		Task.detached(priority: .low) { [weak mapper] in await mapper?.mapper.writeMetadata() }
+		Task.detached(priority: .low) { [weak mapper] in
+			guard let mapper else { return }
+			// Only appends what changed; the journal compacts itself once it grows large or old.
+			// Waits for a frame the mapper is adding, so it never records half of one.
+			let map = await mapper.data.map
+			map.saveJournal()
+		}
+	}
+	
+	// Snapshots the journal and rewrites frames and GPS observations, which aren't journaled,
+	// once per trip to the background rather than on every save.
+	@objc func applicationDidEnterBackground() {
+		let application = UIApplication.shared
+		let backgroundTask = application.beginBackgroundTask(withName: "Save map", expirationHandler: nil)
+		Task.detached(priority: .utility) { [weak mapper] in
+			if let mapper {
+				let map = await mapper.data.map
+				map.saveJournal()
+				map.compactJournal()
+				await mapper.mapper.writeMetadata()
+				// The snapshot is written on the journal's own thread.
+				while map.isCompactingJournal {
+					try? await Task.sleep(nanoseconds: 100_000_000)
+				}
+			}
+			await MainActor.run { application.endBackgroundTask(backgroundTask) }
+		}
 	}
 	
 	@IBAction func openButtonPressed(_ button: UIButton) {
@@ -664,6 +693,8 @@ class ViewController: UIViewController, ARSCNViewDelegate, ARSessionDelegate, CL
 			// TODO: consider detaching
 			await mapper.mapper.readMetadata()
 			let map = await mapper.data.map
+			// Anchor and edge edits made after the last full save live in the journal.
+			map.openJournal(in: selectedURL.path)
 			// Initialize navigation coordinator with new API
 			let navigation = LARNavigationCoordinator(map: map)
 			navigation.configure(sceneNode: mapNode, mapView: mapView)
@@ -0,0 +1,43 @@
+//
+//  LARCovisibilityGraph.h
+//  LocalizeAR
+//
+//  Which keyframes of a mapping session see which landmarks, for narrowing matching down to
+//  the landmarks covisible with a few known matches.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARFrame.h"
+#import "LARMap.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LARCovisibilityGraph: NSObject
+
+@property(nonatomic,readonly) LARMap* map;
+@property(nonatomic,readonly) NSInteger keyframeCount;
+// Landmark-keyframe links, and links between keyframes that share enough landmarks.
+@property(nonatomic,readonly) NSInteger visibilityCount;
+@property(nonatomic,readonly) NSInteger linkCount;
+@property(nonatomic,readonly) uint64_t memoryBytes;
+
+// Picks keyframes from `frames` (the frames the map was built from, in capture order) wherever
+// the camera moved or turned enough, and links each to the landmarks in its view frustum.
+// Returns nil if the map has no landmark index yet (a map being built that hasn't published
+// its landmarks) or a frame has invalid intrinsics.
+- (nullable instancetype)initWithMap:(LARMap*)map frames:(NSArray<LARFrame*>*)frames NS_SWIFT_NAME( init(map:frames:) );
+
+// The landmarks seen from at most `keyframeLimit` keyframes: first those that see the most of
+// the landmarks with `landmarkIds` (e.g. the last frame's inliers), then the keyframes most
+// covisible with them. The seed landmarks are always included; unknown ids are ignored.
+- (NSArray<LARLandmark*>*)landmarksCovisibleWith:(NSArray<NSNumber*>*)landmarkIds keyframeLimit:(NSInteger)keyframeLimit NS_SWIFT_NAME( landmarks(covisibleWith:keyframeLimit:) );
+
+// Rescores the map's landmarks with how widely spread the keyframes that see them are, which
+// landmarksForQuery:perCell:cellSize: then ranks by. Lasts until the map's index is replaced.
+- (void)scoreLandmarks;
+
+@end
+
+NS_ASSUME_NONNULL_END
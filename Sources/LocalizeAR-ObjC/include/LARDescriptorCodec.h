@@ -0,0 +1,85 @@
+//
+//  LARDescriptorCodec.h
+//  LocalizeAR
+//
+//  Compressed landmark descriptors (8-bit scalar or product quantization) trained per map.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARImage.h"         // canonical def: lar/tracking/image.h
+#import "LARSpatialQuery.h"  // canonical def: lar/core/spatial/spatial_query.h
+#import "LARMap.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, LARDescriptorCodecKind) {
+    // One byte per dimension against per-dimension min/max.
+    LARDescriptorCodecKindScalar8 = 1,
+    // One byte per subspace, the index of its nearest of 256 k-means centroids.
+    LARDescriptorCodecKindProduct = 2,
+};
+
+@interface LARDescriptorCodec: NSObject
+
+@property(nonatomic,readonly) LARDescriptorCodecKind kind;
+@property(nonatomic,readonly) NSInteger subspaces;
+// Bytes per encoded descriptor vs. per exact descriptor of the training map.
+@property(nonatomic,readonly) NSInteger codeSize;
+@property(nonatomic,readonly) NSInteger descriptorSize;
+@property(nonatomic,readonly) double compressionRatio;
+
+// Trains a codebook on the descriptors of `map`. `subspaces` must divide the descriptor length
+// and is ignored for scalar codecs. Returns nil if the map has no descriptors.
+- (nullable instancetype)initWithMap:(LARMap*)map kind:(LARDescriptorCodecKind)kind subspaces:(NSInteger)subspaces NS_SWIFT_NAME( init(map:kind:subspaces:) );
+
+// A codec read back from `serializedCodebook`; nil if the data is malformed. Its
+// descriptorSize is 0, since the codebook doesn't record the exact descriptors' element type.
+- (nullable instancetype)initWithSerializedCodebook:(NSData*)data NS_SWIFT_NAME( init(serializedCodebook:) );
+// The codebook as archives store it.
+@property(nonatomic,readonly) NSData* serializedCodebook;
+
+// Writes `map` as a binary archive that carries this codec's codes next to the exact
+// descriptors, which remain available for re-ranking.
+- (BOOL)writeArchiveOfMap:(LARMap*)map to:(NSString*)filepath NS_SWIFT_NAME( writeArchive(of:to:) );
+
+// Encodes one descriptor, given as one byte or one float per dimension, into codeSize bytes;
+// decodes a code back to one float per dimension. Nil if the length doesn't fit.
+- (nullable NSData*)encodeDescriptor:(NSData*)descriptor NS_SWIFT_NAME( encode(_:) );
+- (nullable NSData*)decodeCode:(NSData*)code NS_SWIFT_NAME( decode(_:) );
+
+// Ids of the `count` landmarks of the archive at `filepath` whose codes are nearest to
+// `descriptor` (one byte or one float per dimension), re-scoring the best `rerank` with exact
+// descriptors, nearest first. Searches the given archive rows, or all if `rows` is nil. Nil if
+// the archive has no codes (see writeArchiveOfMap:to:).
++ (nullable NSArray<NSNumber*>*)nearestLandmarksTo:(NSData*)descriptor inArchiveAt:(NSString*)filepath count:(NSInteger)count rerank:(NSInteger)rerank rows:(nullable NSArray<NSNumber*>*)rows NS_SWIFT_NAME( nearestLandmarks(to:inArchiveAt:count:rerank:rows:) );
+
+@end
+
+// Compares nearest-landmark matching on codes against exact matching for SIFT descriptors
+// extracted from replayed images.
+@interface LARDescriptorRecallEvaluator: NSObject
+
+@property(nonatomic,readonly) LARDescriptorCodec* codec;
+@property(nonatomic,readonly) NSInteger rerankDepth;
+@property(nonatomic,readonly) NSInteger queryCount;
+// Fraction of queries whose code match is the exact nearest landmark, without and with
+// exact re-ranking of the best `rerankDepth` candidates.
+@property(nonatomic,readonly) double approximateRecall;
+@property(nonatomic,readonly) double rerankedRecall;
+@property(nonatomic,readonly) double exactMatchSeconds;
+@property(nonatomic,readonly) double approximateMatchSeconds;
+@property(nonatomic,readonly) double rerankedMatchSeconds;
+// Descriptor memory of the map: exact rows vs. codes plus codebook.
+@property(nonatomic,readonly) uint64_t exactBytes;
+@property(nonatomic,readonly) uint64_t compressedBytes;
+
+- (nullable instancetype)initWithMap:(LARMap*)map codec:(LARDescriptorCodec*)codec rerankDepth:(NSInteger)rerankDepth NS_SWIFT_NAME( init(map:codec:rerankDepth:) );
+
+// Extracts SIFT features from `image` and matches them against the landmarks `query` sees.
+- (void)evaluateImage:(LARImage)image query:(LARSpatialQuery)query NS_SWIFT_NAME( evaluate(image:query:) );
+
+@end
+
+NS_ASSUME_NONNULL_END
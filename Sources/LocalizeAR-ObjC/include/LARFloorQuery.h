@@ -0,0 +1,25 @@
+//
+//  LARFloorQuery.h
+//  LocalizeAR
+//
+//  Spatial query restricted to a band of heights, such as one floor of a building.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARSpatialQuery.h"  // canonical def: lar/core/spatial/spatial_query.h
+
+typedef struct {
+    // Candidate region, as for a plain spatial query.
+    LARSpatialQuery region;
+    // Landmarks outside [minY, maxY] (map y, meters) are dropped. Infinite bounds keep all.
+    double minY;
+    double maxY;
+} LARFloorQuery;
+
+NS_SWIFT_NAME( LARFloorQuery.init(region:minY:maxY:) )
+static inline LARFloorQuery LARFloorQueryMake(LARSpatialQuery region, double minY, double maxY) {
+    LARFloorQuery query = { region, minY, maxY };
+    return query;
+}
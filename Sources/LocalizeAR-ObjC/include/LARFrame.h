@@ -30,7 +30,8 @@ NS_ASSUME_NONNULL_BEGIN
 // Convenience initializer
 - (instancetype)initWithId:(NSInteger)id timestamp:(NSInteger)timestamp intrinsics:(simd_float3x3)intrinsics extrinsics:(simd_float4x4)extrinsics;
 
-// Load frames from JSON file (like C++ lar_localize.cpp)
+// Load frames from JSON file (like C++ lar_localize.cpp) or a binary frame index
+// (see LARFrameIndex, which also reads frames without creating all of them)
 + (nullable NSArray<LARFrame*>*)loadFramesFromFile:(NSString*)path;
 
 @end
@@ -0,0 +1,45 @@
+//
+//  LARFrameIndex.h
+//  LocalizeAR
+//
+//  Memory-mapped binary frame index (frames.larframes), the compact form of frames.json.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "LARFrame.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LARFrameIndex: NSObject
+
+@property(nonatomic,readonly) NSInteger count;
+
+// Maps the index at `filepath`; opening is constant time regardless of the frame count.
+// Returns nil if the file is missing or not a frame index.
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath NS_SWIFT_NAME( init(contentsOf:) );
+// True if the file at `filepath` is a frame index rather than JSON.
++ (BOOL)isFrameIndex:(NSString*)filepath NS_SWIFT_NAME( isFrameIndex(_:) );
+
+// Converters between frames.json and the frame index.
++ (BOOL)convertJSON:(NSString*)jsonPath to:(NSString*)indexPath NS_SWIFT_NAME( convertJSON(_:to:) );
+- (BOOL)writeJSONTo:(NSString*)jsonPath NS_SWIFT_NAME( writeJSON(to:) );
+// Writes `frames` as a frame index at `indexPath`.
++ (BOOL)writeFrames:(NSArray<LARFrame*>*)frames to:(NSString*)indexPath NS_SWIFT_NAME( write(_:to:) );
+
+// Fields of frame `index` read straight from the mapping, without allocating.
+- (NSInteger)frameIdAtIndex:(NSInteger)index NS_SWIFT_NAME( frameId(at:) );
+- (NSInteger)timestampAtIndex:(NSInteger)index NS_SWIFT_NAME( timestamp(at:) );
+- (simd_float3x3)intrinsicsAtIndex:(NSInteger)index NS_SWIFT_NAME( intrinsics(at:) );
+- (simd_float4x4)extrinsicsAtIndex:(NSInteger)index NS_SWIFT_NAME( extrinsics(at:) );
+
+// Frame `index` as a LARFrame, for the trackers.
+- (LARFrame*)frameAtIndex:(NSInteger)index NS_SWIFT_NAME( frame(at:) );
+// Frames [range.location, range.location + range.length), clamped to the index.
+- (NSArray<LARFrame*>*)framesInRange:(NSRange)range NS_SWIFT_NAME( frames(in:) );
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,34 @@
+//
+//  LARFrustumQuery.h
+//  LocalizeAR
+//
+//  Spatial query narrowed to the landmarks a camera pose can plausibly match.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "LARSpatialQuery.h"  // canonical def: lar/core/spatial/spatial_query.h
+
+typedef struct {
+    // Candidate region, as for a plain spatial query.
+    LARSpatialQuery region;
+    // Camera pose in map coordinates with ARKit axes (x right, y up, looking down -z).
+    simd_double4x4 cameraTransform;
+    // Pixel intrinsics of the camera; the image is taken to be twice the principal point.
+    simd_float3x3 intrinsics;
+    // Fraction of the image size added to the field of view on every side.
+    double padding;
+    // Landmarks seen from further than this (radians) off the direction they were mapped from
+    // are dropped.
+    double maxViewAngle;
+} LARFrustumQuery;
+
+// Frustum query with the default padding (15%) and view angle (~70°); the far plane is the
+// region's diameter.
+NS_SWIFT_NAME( LARFrustumQuery.init(region:cameraTransform:intrinsics:) )
+static inline LARFrustumQuery LARFrustumQueryMake(LARSpatialQuery region, simd_double4x4 cameraTransform, simd_float3x3 intrinsics) {
+    LARFrustumQuery query = { region, cameraTransform, intrinsics, 0.15, 1.22 };
+    return query;
+}
@@ -8,6 +8,7 @@
 #pragma once
 
 #ifdef __cplusplus
+    #import <memory>
     #import <lar/core/landmark.h>
 #endif
 
@@ -33,6 +34,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property(readonly) int sightings;
 #ifdef __cplusplus
     - (id)initWithInternal:(lar::Landmark*)landmark;
+    // For landmarks that live in a snapshot rather than the map; `owner` is kept alive with
+    // the wrapper.
+    - (id)initWithInternal:(lar::Landmark*)landmark owner:(std::shared_ptr<const void>)owner;
 #endif
 
 - (BOOL)isUsable;
@@ -0,0 +1,40 @@
+//
+//  LARLandmarkQueryCache.h
+//  LocalizeAR
+//
+//  Keeps the result of the last spatial query and updates it incrementally as the query moves.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARSpatialQuery.h"  // canonical def: lar/core/spatial/spatial_query.h
+#import "LARMap.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LARLandmarkQueryCache: NSObject
+
+@property(nonatomic,readonly) LARMap* map;
+// Landmarks of the last query.
+@property(nonatomic,readonly) NSArray<LARLandmark*>* landmarks;
+@property(nonatomic,readonly) NSInteger landmarkCount;
+// Difference to the previous query's landmarks. After a non-incremental update (the first
+// query, a jump away from the previous region, or the map's landmarks were reloaded or
+// republished) the added landmarks are the whole result, removed is empty, and anything built
+// from earlier results should be rebuilt.
+@property(nonatomic,readonly) NSArray<LARLandmark*>* addedLandmarks;
+@property(nonatomic,readonly) NSArray<LARLandmark*>* removedLandmarks;
+@property(nonatomic,readonly) BOOL lastUpdateWasIncremental;
+@property(nonatomic,readonly) NSInteger incrementalUpdateCount;
+@property(nonatomic,readonly) NSInteger fullUpdateCount;
+
+- (instancetype)initWithMap:(LARMap*)map NS_SWIFT_NAME( init(map:) );
+
+// Moves the cached query to `query`. Returns lastUpdateWasIncremental.
+- (BOOL)updateForQuery:(LARSpatialQuery)query NS_SWIFT_NAME( update(for:) );
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
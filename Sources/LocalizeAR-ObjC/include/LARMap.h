@@ -8,13 +8,20 @@
 #pragma once
 
 #ifdef __cplusplus
+    #import <functional>
+    #import <memory>
+    #import <vector>
     #import <lar/core/map.h>
+    namespace lar::bridge { class LandmarkIndex; }
 #endif
 
 #import <Foundation/Foundation.h>
 #import <CoreLocation/CoreLocation.h>
 #import "LARAnchor.h"
 #import "LARLandmark.h"
+#import "LARSpatialQuery.h"
+#import "LARFrustumQuery.h"
+#import "LARFloorQuery.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -33,7 +40,159 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic,readonly) BOOL originReady;
 @property(nonatomic,readonly) simd_double4x4 origin;
 
-- (id)initWithContentsOf:(NSString*)filepath NS_SWIFT_NAME( init(contentsOf:) );
+// Tiled maps (see initWithTileDirectory:memoryBudget:). All zero for maps loaded whole.
+@property(nonatomic,readonly) BOOL isTiled;
+@property(nonatomic,assign) uint64_t memoryBudget;
+@property(nonatomic,readonly) NSInteger residentTileCount;
+@property(nonatomic,readonly) uint64_t residentTileBytes;
+@property(nonatomic,readonly) uint64_t decodedTileBytes;
+@property(nonatomic,readonly) uint64_t tilePageInCount;
+@property(nonatomic,readonly) uint64_t tileEvictionCount;
+
+// Lazily loaded archives (see initWithContentsOf:lazy:). For eagerly loaded maps every landmark
+// counts as materialized and the byte counters are zero.
+@property(nonatomic,readonly) BOOL isLazy;
+@property(nonatomic,readonly) NSInteger materializedLandmarkCount;
+// Descriptor and orientation bytes of the materialized landmarks.
+@property(nonatomic,readonly) uint64_t materializedLandmarkBytes;
+// Descriptor pages of the archive currently in memory, as reported by the kernel.
+@property(nonatomic,readonly) uint64_t residentDescriptorBytes;
+
+// An empty map; landmarks can be added with addLandmarkWithId:... (e.g. synthetic maps for
+// tests and benchmarks).
+- (instancetype)init;
+// Adds a landmark with visibility bounds `boundsLower`-`boundsUpper` on the x/z plane and
+// `descriptor` as one 8-bit row (none if nil or empty). Ids must be unique. Returns NO for
+// tiled, lazy and unowned maps, whose landmark database is managed elsewhere.
+- (BOOL)addLandmarkWithId:(NSInteger)landmarkId position:(simd_double3)position boundsLower:(simd_double2)boundsLower boundsUpper:(simd_double2)boundsUpper descriptor:(nullable NSData*)descriptor sightings:(int)sightings lastSeen:(long long)lastSeen
+    NS_SWIFT_NAME( addLandmark(id:position:boundsLower:boundsUpper:descriptor:sightings:lastSeen:) );
+// Overwrites the descriptor of landmark `landmarkId` with `descriptor`, which must have the
+// same length, writing into its existing buffer as the core's mapper may (unless a snapshot or
+// a compaction still shares the buffer, which then keeps the old bytes). Returns NO if there is
+// no such landmark or the length differs, and for the maps addLandmarkWithId:... rejects.
+- (BOOL)updateLandmarkWithId:(NSInteger)landmarkId descriptor:(NSData*)descriptor NS_SWIFT_NAME( updateLandmark(id:descriptor:) );
+// Sets the direction landmark `landmarkId` was mapped from (a unit vector towards the cameras
+// that saw it, zero for none), which frustum queries compare the view against. Returns NO as
+// updateLandmarkWithId:descriptor: does.
+- (BOOL)updateLandmarkWithId:(NSInteger)landmarkId orientation:(simd_float3)orientation NS_SWIFT_NAME( updateLandmark(id:orientation:) );
+// Loads either a binary map archive (map.larmap) or map.json, detected from the file contents.
+// Archives are memory-mapped: descriptors are read in place and shared through the page cache.
+// Returns nil if the file is missing, corrupt or a delta.
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath NS_SWIFT_NAME( init(contentsOf:) );
+// Loads with `threads` threads (including the caller) decoding landmarks in parallel; 0 uses one
+// per core, which is what initWithContentsOf: does.
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath threads:(NSInteger)threads NS_SWIFT_NAME( init(contentsOf:threads:) );
+// Loads map.json by parsing the whole document into a DOM and converting that, as maps were
+// loaded before JSON was streamed. Peak memory is the DOM plus the map; kept as the reference
+// the streaming reader is checked against. Returns nil if the file is missing or malformed.
+- (nullable instancetype)initParsingJSONAt:(NSString*)filepath NS_SWIFT_NAME( init(parsingJSONAt:) );
+// Checks every section of the archive at `filepath` against its checksum without decoding it.
++ (BOOL)verifyArchiveAt:(NSString*)filepath NS_SWIFT_NAME( verifyArchive(at:) );
+// Brings a map loaded from an archive up to date with a newer version of it, reloading only the
+// parts whose section checksums changed: anchors, edges and origin are replaced individually,
+// and the landmark database is rebuilt only if landmark sections changed. Changed sections are
+// verified first; on failure the map is left as it was. Not available for tiled or journaled
+// maps. Delegate callbacks aren't sent for reloaded anchors.
+- (BOOL)reloadFromContentsOf:(NSString*)filepath NS_SWIFT_NAME( reload(contentsOf:) );
+// Over-the-air updates. writeDeltaFrom:to: writes the difference that turns `base` into this
+// map (added, removed, moved and changed landmarks by id, plus anchor, edge and origin changes);
+// applyDeltaAt: applies such a delta in place. A delta only applies to the exact version it was
+// made from, identified by `fingerprint`, and is rejected (leaving the map unchanged) if the
+// result doesn't match the fingerprint of the map it was made to produce. The fingerprint
+// covers descriptors, so reading it materializes a lazily loaded map. Not available for tiled
+// or journaled maps.
+- (BOOL)writeDeltaFrom:(LARMap*)base to:(NSString*)filepath NS_SWIFT_NAME( writeDelta(from:to:) );
+- (BOOL)applyDeltaAt:(NSString*)filepath NS_SWIFT_NAME( applyDelta(at:) );
+@property(nonatomic,readonly) uint64_t fingerprint;
+// Binary archive export; JSON stays available as an interchange format.
+// With `lazy`, an archive's landmarks are loaded with only id, position, bounds and stats;
+// descriptors and orientations are filled in by prepareForQuery: the first time a query can see
+// them. Meant for maps that are localized against, not extended. JSON maps always load in full.
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath lazy:(BOOL)lazy NS_SWIFT_NAME( init(contentsOf:lazy:) );
+// Materializes every landmark of a lazily loaded map. Writing or journaling the map does this
+// implicitly.
+- (void)materializeAllLandmarks;
+// Landmark rows are written along a Morton curve over x/z, so the landmarks and descriptors
+// a spatial query reads lie close together in the file (and in memory once it is mapped).
+- (BOOL)writeArchiveTo:(NSString*)filepath NS_SWIFT_NAME( writeArchive(to:) );
+- (BOOL)writeJSONTo:(NSString*)filepath NS_SWIFT_NAME( writeJSON(to:) );
+// Opens a directory written by writeTilesTo:tileSize:. Only anchors, edges and origin are read
+// up front; landmarks are paged in per tile by prepareForQuery: and the least recently used
+// tiles are dropped once more than `memoryBudget` bytes of tiles are resident. A tile counts its
+// mapped file plus the landmarks decoded from it and their index entries.
+- (nullable instancetype)initWithTileDirectory:(NSString*)directory memoryBudget:(uint64_t)memoryBudget NS_SWIFT_NAME( init(tileDirectory:memoryBudget:) );
++ (BOOL)isTileDirectory:(NSString*)directory NS_SWIFT_NAME( isTileDirectory(_:) );
+- (BOOL)writeTilesTo:(NSString*)directory tileSize:(double)tileSize NS_SWIFT_NAME( writeTiles(to:tileSize:) );
+// Incremental saves. Opening a journal directory first restores it into this map (its compacted
+// snapshot, if any, then every newer journal), after which anchor, edge and origin changes are
+// appended as they happen. saveJournal appends landmark changes and flushes; it touches only
+// what changed since the last save, and starts a compaction once the records since the last
+// snapshot pass journalCompactionBytes or the oldest of them journalCompactionInterval seconds.
+// compactJournal writes a fresh snapshot in the background right away (e.g. when the app goes to
+// the background). Both are safe from any thread: they wait for landmark changes the mapper and
+// processor are making. The thresholds apply to the open journal; set them after openJournal.
+- (BOOL)openJournalInDirectory:(NSString*)directory NS_SWIFT_NAME( openJournal(in:) );
+- (BOOL)saveJournal;
+- (BOOL)compactJournal;
+@property(nonatomic,readonly) BOOL isCompactingJournal;
+@property(nonatomic,readonly) uint64_t pendingJournalBytes;
+@property(nonatomic,assign) uint64_t journalCompactionBytes;
+@property(nonatomic,assign) NSTimeInterval journalCompactionInterval;
+// Makes the landmarks `query` can see resident in the core map the tracker localizes against.
+// Trackers call this before localizing, on their own thread; it is a no-op for maps that are
+// neither tiled nor lazy. Replaces the landmark list when tiles come or go; lazy maps only fill
+// in landmarks in place. Nothing else reads the core landmark list off that thread: the queries
+// below run on immutable snapshots.
+- (void)prepareForQuery:(LARSpatialQuery)query NS_SWIFT_NAME( prepare(for:) );
+// Pages in the tiles `query` covers for the queries below, without touching the core map. A
+// no-op for maps that aren't tiled; safe from any thread.
+- (void)pageForQuery:(LARSpatialQuery)query NS_SWIFT_NAME( page(for:) );
+// Landmarks whose visibility bounds intersect the query square. Queries are safe from any
+// thread and answered from an immutable snapshot of the landmarks with a packed R-tree: for
+// maps loaded from a file it is built on the first query after the landmarks change (tiled maps
+// page in the tiles the query covers first); maps being built by a mapper are answered from the
+// last published landmarks (see publishLandmarks), and return nothing before the first publish.
+// Returned landmarks keep their snapshot alive.
+- (NSArray<LARLandmark*>*)landmarksForQuery:(LARSpatialQuery)query NS_SWIFT_NAME( landmarks(for:) );
+// At most `perCell` landmarks of `query` from each `cellSize` meter square of the x/z grid, the
+// ones with the best quality score: how often and how recently they were seen, and how widely
+// spread their viewpoints are once a covisibility graph has scored them (see
+// LARCovisibilityGraph). Caps matching cost on dense maps.
+- (NSArray<LARLandmark*>*)landmarksForQuery:(LARSpatialQuery)query perCell:(NSInteger)perCell cellSize:(double)cellSize NS_SWIFT_NAME( landmarks(for:perCell:cellSize:) );
+// The landmarks of `query.region` that lie inside the camera's padded view frustum and face it.
+- (NSArray<LARLandmark*>*)landmarksForFrustumQuery:(LARFrustumQuery)query NS_SWIFT_NAME( landmarks(for:) );
+// The landmarks of `query.region` whose position lies within the query's height band.
+- (NSArray<LARLandmark*>*)landmarksForFloorQuery:(LARFloorQuery)query NS_SWIFT_NAME( landmarks(for:) );
+// Floor query for a camera at map height `cameraHeight` (e.g. from VIO): the height layer the
+// camera is in, or the nearest one, widened by a margin. Layers are detected from gaps in the
+// landmark heights of the map (of the resident landmarks for tiled and lazy maps, and of the
+// published ones for maps being built). With fewer than two layers the band is unbounded.
+- (LARFloorQuery)floorQueryForRegion:(LARSpatialQuery)region cameraHeight:(double)cameraHeight NS_SWIFT_NAME( floorQuery(for:cameraHeight:) );
+// Number of height layers detected, bottom to top, and the bounds of one of them.
+@property(nonatomic,readonly) NSInteger heightLayerCount;
+- (void)heightLayerAt:(NSInteger)layer lower:(double*)lower upper:(double*)upper NS_SWIFT_NAME( heightLayer(at:lower:upper:) );
+// The `count` landmarks nearest to `point` (map coordinates), nearest first. On tiled maps only
+// resident tiles are searched, since the nearest landmarks can be arbitrarily far away; page the
+// region of interest in first (pageForQuery:) or use landmarksWithinRadius:of:.
+- (NSArray<LARLandmark*>*)nearestLandmarksTo:(simd_double3)point count:(NSInteger)count NS_SWIFT_NAME( nearestLandmarks(to:count:) );
+// Landmarks within `radius` meters of `point` in 3D, nearest first. Tiled maps page in every
+// tile a landmark within the radius could be in.
+- (NSArray<LARLandmark*>*)landmarksWithinRadius:(double)radius of:(simd_double3)point NS_SWIFT_NAME( landmarks(within:of:) );
+// The landmark with `landmarkId`, or nil. Tiled maps only find landmarks in resident tiles.
+- (nullable LARLandmark*)landmarkWithId:(NSInteger)landmarkId NS_SWIFT_NAME( landmark(id:) );
+// Maps being built by a mapper: copies the current landmarks into a new immutable version,
+// indexed like a loaded map, that queries from any thread then read without locking. The
+// previous version stays valid for whoever still holds landmarks from it. Call at a point where
+// the map is consistent, after changing it directly. Until the first publish, queries return
+// nothing. No-op for maps loaded from a file.
+- (void)publishLandmarks NS_SWIFT_NAME( publishLandmarks() );
+// publishLandmarks if nothing was published yet or a landmark change was made since through
+// performLandmarkChange: (including landmarks moved or re-described in place), and nothing
+// otherwise; cheap enough for every frame. LARMapper calls it after loading metadata and for
+// every frame, LARMapProcessor after processing and rescaling.
+- (void)publishLandmarksIfChanged NS_SWIFT_NAME( publishLandmarksIfChanged() );
+// Number of versions published so far.
+@property(nonatomic,readonly) uint64_t publishedLandmarkVersion;
 - (void)globalPointFromRelative:(simd_double3)relative global:(simd_double3*) global NS_SWIFT_NAME(globalPoint(from:global:));
 - (void)globalPointFromAnchor:(LARAnchor*)anchor global:(simd_double3*) global NS_SWIFT_NAME(globalPoint(from:global:));
 - (void)relativePointFrom:(simd_double3)global relative:(simd_double3*) relative NS_SWIFT_NAME(relativePoint(from:relative:));
@@ -47,6 +206,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 #ifdef __cplusplus
     - (id)initWithInternal:(lar::Map*)map;
+    // Runs `change` to the core map's landmarks (a mapper adding a frame, reading metadata or
+    // processing) under the lock journal saves, reloads and snapshot builds take, so none of
+    // them sees the landmarks half changed. Publish afterwards, outside of `change`.
+    - (void)performLandmarkChange:(const std::function<void()>&)change;
+    // Pages in tiles for `query` and returns the packed landmark index of the current snapshot,
+    // building it if needed. For maps being built by a mapper it is the index of the last
+    // published landmarks, and nullptr before the first publish. The index is replaced, never
+    // modified, when the landmarks change or are republished, so holders can compare pointers
+    // to notice; holding it keeps its snapshot, and so its landmarks, alive.
+    - (std::shared_ptr<const lar::bridge::LandmarkIndex>)landmarkIndexForQuery:(LARSpatialQuery)query;
+    // Rescores the landmarks of `index` with one view spread per item (see
+    // CovisibilityGraph::viewSpread). Ignored once the map's index has been replaced.
+    - (void)scoreLandmarksOfIndex:(std::shared_ptr<const lar::bridge::LandmarkIndex>)index viewSpread:(const std::vector<float>&)viewSpread;
 #endif
 
 @end
@@ -26,7 +26,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)process;
 - (void)rescale:(double)scaleFactor;
-- (void)saveMap:(NSString*)directory;
+// Writes map.json and the map.larmap archive next to it into `directory`. Returns NO, having
+// logged why, if either fails.
+- (BOOL)saveMap:(NSString*)directory;
 - (void)updateGlobalAlignment;
 
 @end
@@ -0,0 +1,54 @@
+//
+//  LARSIFTBenchmark.h
+//  LocalizeAR
+//
+//  CPU SIFT with SIMD kernels vs. scalar kernels vs. OpenCV's SIFT on the same images, and the
+//  CPU SIFT spread over every core or limited to a keypoint budget.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARImage.h"  // canonical def: lar/tracking/image.h
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LARSIFTBenchmark: NSObject
+
+@property(nonatomic,readonly) NSInteger imageCount;
+// Totals over all images, single-threaded. The CPU SIFT runs with the SIMD kernels picked
+// for this CPU (`kernelName`) and again with the scalar ones.
+@property(nonatomic,readonly) double simdSeconds;
+@property(nonatomic,readonly) double scalarSeconds;
+@property(nonatomic,readonly) double openCVSeconds;
+// Total with the SIMD kernels and the scale space split into row bands over `threadCount`
+// threads (one per hardware thread).
+@property(nonatomic,readonly) double threadedSeconds;
+@property(nonatomic,readonly) NSInteger threadCount;
+// Total with the SIMD kernels on one thread and at most `keypointBudget` keypoints per image,
+// picked by grid selection, and the keypoints it kept and dropped over all images.
+@property(nonatomic,readonly) double budgetSeconds;
+@property(nonatomic,readonly) NSInteger keypointBudget;
+@property(nonatomic,readonly) NSInteger keptKeypointCount;
+@property(nonatomic,readonly) NSInteger droppedKeypointCount;
+@property(nonatomic,readonly) NSInteger keypointCount;
+@property(nonatomic,readonly) NSInteger openCVKeypointCount;
+// CPU SIFT keypoints that OpenCV also found, and the mean L2 distance between their
+// descriptors (0-255 per dimension).
+@property(nonatomic,readonly) NSInteger matchedKeypointCount;
+@property(nonatomic,readonly) double meanDescriptorDistance;
+// Both kernels, and the threaded run, found the same keypoints in every image.
+@property(nonatomic,readonly) BOOL kernelsMatch;
+@property(nonatomic,readonly) BOOL threadsMatch;
+// CPU SIFT scratch buffer allocations after the first image; 0 unless the image size changed.
+@property(nonatomic,readonly) NSInteger steadyStateAllocationCount;
+@property(nonatomic,readonly) NSString* kernelName;
+
+- (instancetype)init;
+
+// Runs every extractor on `image`. Returns NO if it isn't 8-bit grayscale.
+- (BOOL)addImage:(LARImage)image NS_SWIFT_NAME( add(image:) );
+
+@end
+
+NS_ASSUME_NONNULL_END
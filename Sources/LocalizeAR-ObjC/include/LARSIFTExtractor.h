@@ -0,0 +1,81 @@
+//
+//  LARSIFTExtractor.h
+//  LocalizeAR
+//
+//  CPU SIFT with scratch buffers kept from frame to frame (see src/Features/cpu_sift.h).
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARImage.h"  // canonical def: lar/tracking/image.h
+
+NS_ASSUME_NONNULL_BEGIN
+
+// How a keypoint budget is spent.
+typedef NS_ENUM(NSInteger, LARKeypointSelection) {
+    // Highest responses, as OpenCV's SIFT.
+    LARKeypointSelectionStrongest = 0,
+    // The strongest of every grid cell first, then the second strongest, and so on.
+    LARKeypointSelectionGrid = 1,
+    // Adaptive non-maximal suppression: furthest from any clearly stronger keypoint first.
+    LARKeypointSelectionSuppression = 2,
+};
+
+// A keypoint in image pixels, as OpenCV's cv::KeyPoint: `size` is the diameter of its
+// neighborhood, `angle` is in degrees, and `octave` packs octave and layer as OpenCV does.
+typedef struct {
+    float x;
+    float y;
+    float size;
+    float angle;
+    float response;
+    int octave;
+} LARKeypoint;
+
+@interface LARSIFTExtractor: NSObject
+
+@property(nonatomic,readonly) int imageWidth;
+@property(nonatomic,readonly) int imageHeight;
+@property(nonatomic,readonly) NSInteger threadCount;
+// Keypoints described per image at most, 0 for all.
+@property(nonatomic,readonly) NSInteger keypointBudget;
+@property(nonatomic,readonly) LARKeypointSelection selection;
+// Keypoints of the last extracted image, and those the budget dropped before they were
+// described.
+@property(nonatomic,readonly) NSInteger keypointCount;
+@property(nonatomic,readonly) NSInteger droppedKeypointCount;
+// Descriptors of the last extracted image: keypointCount rows of 128 floats (0-255 per
+// dimension), in keypoint order.
+@property(nonatomic,readonly) NSData* descriptors;
+// Extracts with OpenCV's SIFT instead of the CPU SIFT (see initOpenCVWithKeypointBudget:).
+@property(nonatomic,readonly) BOOL usesOpenCV;
+// Scratch buffer allocations of every extractor in the process so far. Extracting another
+// image of the configured size shouldn't change it once one has been extracted. Only the
+// extractor's workspace is counted, not every heap allocation the process makes.
+@property(class,nonatomic,readonly) uint64_t scratchAllocationCount;
+
+// Sizes the scratch buffers for `imageWidth` x `imageHeight` images. `threads` includes the
+// calling thread; 0 uses one per hardware thread.
+- (instancetype)initWithImageWidth:(int)imageWidth imageHeight:(int)imageHeight threads:(NSInteger)threads NS_SWIFT_NAME( init(imageWidth:imageHeight:threads:) );
+
+// As above, describing at most `keypointBudget` keypoints per image, picked by `selection`.
+- (instancetype)initWithImageWidth:(int)imageWidth imageHeight:(int)imageHeight threads:(NSInteger)threads keypointBudget:(NSInteger)keypointBudget selection:(LARKeypointSelection)selection NS_SWIFT_NAME( init(imageWidth:imageHeight:threads:keypointBudget:selection:) );
+
+// OpenCV's SIFT with the same parameters and strongest-response budget as the CPU SIFT, on
+// one thread and without scratch buffers: a reference to check the CPU SIFT against.
+- (instancetype)initOpenCVWithKeypointBudget:(NSInteger)keypointBudget NS_SWIFT_NAME( init(openCVKeypointBudget:) );
+
+// Resizes the scratch buffers, as images of another size would on their first extraction.
+- (void)configureImageSizeWithWidth:(int)imageWidth height:(int)imageHeight;
+
+// Extracts keypoints and descriptors from an 8-bit grayscale image. Returns NO on failure.
+- (BOOL)extractImage:(LARImage)image NS_SWIFT_NAME( extract(image:) );
+
+// The `index`-th keypoint of the last extracted image; the CPU SIFT sorts them by position.
+// Zeroed outside [0, keypointCount).
+- (LARKeypoint)keypointAtIndex:(NSInteger)index NS_SWIFT_NAME( keypoint(at:) );
+
+@end
+
+NS_ASSUME_NONNULL_END
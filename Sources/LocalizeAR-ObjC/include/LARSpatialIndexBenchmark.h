@@ -0,0 +1,43 @@
+//
+//  LARSpatialIndexBenchmark.h
+//  LocalizeAR
+//
+//  Packed R-tree vs. linear scan over a map's landmark bounds, scaled up to a target count.
+//
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import "LARMap.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LARSpatialIndexBenchmark: NSObject
+
+@property(nonatomic,readonly) NSInteger landmarkCount;
+@property(nonatomic,readonly) NSInteger queryCount;
+// Landmarks found over all queries.
+@property(nonatomic,readonly) NSInteger hitCount;
+@property(nonatomic,readonly) uint64_t treeBytes;
+@property(nonatomic,readonly) double buildSeconds;
+// Totals over all queries. The tree is searched with the SIMD kernel picked for this CPU
+// (`kernelName`) and again with the scalar one.
+@property(nonatomic,readonly) double treeQuerySeconds;
+@property(nonatomic,readonly) double scalarTreeQuerySeconds;
+@property(nonatomic,readonly) double scanQuerySeconds;
+// Both searches found the same landmarks for every query.
+@property(nonatomic,readonly) BOOL resultsMatch;
+@property(nonatomic,readonly) NSString* kernelName;
+// 4 KB descriptor pages the hits of all queries fall on, with the landmarks stored in map
+// order and along a Morton curve (the order map archives are written in).
+@property(nonatomic,readonly) NSInteger storedOrderPageCount;
+@property(nonatomic,readonly) NSInteger spatialOrderPageCount;
+
+// Tiles copies of the landmark bounds of `map` side by side until there are `landmarkCount`,
+// then runs `queryCount` random queries of `diameter` meters through both searches.
+// Returns nil if the map has no landmarks.
+- (nullable instancetype)initWithMap:(LARMap*)map landmarkCount:(NSInteger)landmarkCount queryCount:(NSInteger)queryCount diameter:(double)diameter NS_SWIFT_NAME( init(map:landmarkCount:queryCount:diameter:) );
+
+@end
+
+NS_ASSUME_NONNULL_END
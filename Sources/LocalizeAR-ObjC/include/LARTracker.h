@@ -59,7 +59,24 @@ NS_ASSUME_NONNULL_BEGIN
           outputTransform:(simd_double4x4*)outTransform
     NS_SWIFT_NAME( localize(image:frame:query:outputTransform:) );
 
-// Diagnostic information (available after localization)
+// Coarse-to-fine localization: localize on the image halved `levels` times first and only
+// on the full image if that fails or has fewer than `minInliers` inliers or fewer than
+// `minInlierRatio` of its matches as inliers. The coarse pass has its own tracker. Fewer levels
+// are used on images whose coarse copy would be under 120 pixels on a side, and at most 8.
+// Invalid options (`levels` < 1, a ratio outside [0, 1]) leave coarse-to-fine disabled.
+- (void)enableCoarseToFineWithLevels:(NSInteger)levels minInliers:(NSInteger)minInliers minInlierRatio:(double)minInlierRatio
+    NS_SWIFT_NAME( enableCoarseToFine(levels:minInliers:minInlierRatio:) );
+- (void)disableCoarseToFine;
+
+@property(nonatomic,readonly) BOOL coarseToFineEnabled;
+// The last localization was settled by the coarse pass.
+@property(nonatomic,readonly) BOOL lastLocalizationWasCoarse;
+// Frames settled by the coarse pass, and frames localized again on the full image, since
+// coarse-to-fine localization was enabled.
+@property(nonatomic,readonly) NSInteger coarseAcceptedCount;
+@property(nonatomic,readonly) NSInteger finePassCount;
+
+// Diagnostic information (available after localization), from the pass that produced the result
 - (NSInteger)spatialQueryCount;
 - (NSArray<NSNumber*>*)spatialQueryLandmarkIds;
 - (NSInteger)matchCount;
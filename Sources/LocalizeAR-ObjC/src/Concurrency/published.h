@@ -0,0 +1,69 @@
+//
+//  published.h
+//  LocalizeAR
+//
+//  Single-slot read-copy-update: a writer publishes immutable versions of a value and readers
+//  take whichever version is current, without waiting for the writer.
+//
+//  A reader holds its version through the returned shared_ptr, so a version is freed only
+//  after the last reader that loaded it lets go; publishing never waits for readers. Writers
+//  are serialized among themselves, which also makes loadOrBuild() build at most once per
+//  reset().
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace lar::bridge {
+
+template <typename T>
+class Published {
+public:
+    Published() = default;
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    // The current version, nullptr before the first publish().
+    std::shared_ptr<const T> load() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    // Incremented by every publish() and reset().
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    void publish(std::shared_ptr<const T> next) {
+        std::lock_guard<std::mutex> lock(writer_);
+        store(std::move(next));
+    }
+
+    void reset() { publish(nullptr); }
+
+    // The current version, or the one `build()` returns if there is none yet. Concurrent
+    // callers that find nothing published wait for a single build instead of racing.
+    template <typename Build>
+    std::shared_ptr<const T> loadOrBuild(Build&& build) {
+        if (auto current = load()) return current;
+        std::lock_guard<std::mutex> lock(writer_);
+        if (auto current = load()) return current;
+        std::shared_ptr<const T> built = build();
+        store(built);
+        return built;
+    }
+
+private:
+    void store(std::shared_ptr<const T> next) {
+        std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::shared_ptr<const T> current_;
+    std::atomic<uint64_t> version_{0};
+    std::mutex writer_;
+};
+
+} // namespace lar::bridge
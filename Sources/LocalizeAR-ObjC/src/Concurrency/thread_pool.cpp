@@ -0,0 +1,107 @@
+//
+//  thread_pool.cpp
+//  LocalizeAR
+//
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace lar::bridge {
+
+size_t ThreadPool::hardwareThreads() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = hardwareThreads();
+    workers_.reserve(threads - 1);
+    for (size_t i = 1; i < threads; i++) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+        head_ = 0;
+    }
+    work_available_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    work_available_.notify_one();
+}
+
+size_t ThreadPool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() - head_;
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (head_ < queue_.size()) {
+            runFront(lock);
+        } else if (running_ > 0) {
+            work_finished_.wait(lock);
+        } else {
+            break;
+        }
+    }
+    if (error_) {
+        std::exception_ptr error = std::exchange(error_, nullptr);
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    for (size_t i = 0; i < count; i++) {
+        submit([&body, i] { body(i); });
+    }
+    wait();
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_available_.wait(lock, [this] { return stopping_ || head_ < queue_.size(); });
+        if (stopping_) return;
+        runFront(lock);
+    }
+}
+
+void ThreadPool::runFront(std::unique_lock<std::mutex>& lock) {
+    std::function<void()> task = std::move(queue_[head_++]);
+    if (head_ == queue_.size()) {
+        queue_.clear();
+        head_ = 0;
+    } else if (head_ >= kCompactThreshold && 2 * head_ >= queue_.size()) {
+        // A queue that never drains (tasks submitted while others run) drops its finished
+        // front in place, without reallocating.
+        queue_.erase(queue_.begin(), queue_.begin() + head_);
+        head_ = 0;
+    }
+    running_++;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+        task();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+    if (error && !error_) error_ = error;
+    running_--;
+    work_finished_.notify_all();
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,66 @@
+//
+//  thread_pool.h
+//  LocalizeAR
+//
+//  Fixed-size pool of worker threads for splitting CPU-bound work into tasks.
+//
+//  The thread that calls wait() runs queued tasks too, so a pool of N threads has N-1 workers
+//  and a pool of one thread runs everything inline on the caller.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lar::bridge {
+
+class ThreadPool {
+public:
+    // `threads` includes the calling thread; 0 uses one per hardware thread.
+    explicit ThreadPool(size_t threads = 0);
+    // Discards tasks that haven't started and joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+
+    void submit(std::function<void()> task);
+    // Tasks submitted but not yet started.
+    size_t pending() const;
+    // Runs queued tasks on the calling thread until every submitted task has finished, then
+    // rethrows the first exception a task threw, if any.
+    void wait();
+
+    // Runs `body(i)` for every i in [0, count) across the pool and waits for all of them.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    static size_t hardwareThreads();
+
+private:
+    void workerLoop();
+    // Runs the front task with `lock` released. Expects a non-empty queue.
+    void runFront(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> workers_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable work_finished_;
+    // Tasks queue_[head_...], in submission order. The vector is only cleared once it has
+    // been drained, so it keeps its capacity and steady batches of tasks don't allocate.
+    std::vector<std::function<void()>> queue_;
+    size_t head_ = 0;
+    static constexpr size_t kCompactThreshold = 64;
+    size_t running_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace lar::bridge
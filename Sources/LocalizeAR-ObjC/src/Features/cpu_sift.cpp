@@ -0,0 +1,1051 @@
+//
+//  cpu_sift.cpp
+//  LocalizeAR
+//
+
+#include "cpu_sift.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+
+#include "scratch_allocator.h"
+#include "sift_kernels.h"
+#include "../Concurrency/thread_pool.h"
+
+namespace lar::bridge {
+
+namespace {
+
+// OpenCV's SIFT constants.
+constexpr int kImageBorder = 5;
+constexpr int kMaxInterpolationSteps = 5;
+constexpr float kInitialSigma = 0.5f;
+constexpr int kOrientationBins = 36;
+constexpr float kOrientationSigmaFactor = 1.5f;
+constexpr float kOrientationRadius = 3 * kOrientationSigmaFactor;
+constexpr float kOrientationPeakRatio = 0.8f;
+constexpr int kDescriptorWidth = 4;
+constexpr int kDescriptorBins = 8;
+constexpr float kDescriptorScaleFactor = 3.f;
+constexpr float kDescriptorMagnitudeThreshold = 0.2f;
+constexpr float kDescriptorIntFactor = 512.f;
+// A keypoint is only suppressed by keypoints this much stronger (Brown et al., "Multi-Image
+// Matching using Multi-Scale Oriented Patches").
+constexpr float kSuppressionRobustness = 0.9f;
+
+struct Plane {
+    int width = 0;
+    int height = 0;
+    ScratchVector<float> pixels;
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        pixels.resize(size_t(w) * size_t(h));
+    }
+    float* row(int y) { return pixels.data() + size_t(y) * size_t(width); }
+    const float* row(int y) const { return pixels.data() + size_t(y) * size_t(width); }
+    float at(int y, int x) const { return row(y)[x]; }
+};
+
+// cv::BORDER_REFLECT_101: gfedcb|abcdefgh|gfedcba.
+int reflect101(int p, int length) {
+    if (length == 1) return 0;
+    while (p < 0 || p >= length) p = p < 0 ? -p : 2 * length - 2 - p;
+    return p;
+}
+
+// Right half of the kernel cv::GaussianBlur uses for float images; kernel[t] weighs offset ±t.
+std::vector<float> gaussianKernel(double sigma) {
+    const int size = cvRound(sigma * 4 * 2 + 1) | 1;
+    std::vector<float> full(size);
+    const double scale = -0.5 / (sigma * sigma);
+    double sum = 0;
+    for (int i = 0; i < size; i++) {
+        const double x = i - (size - 1) * 0.5;
+        full[i] = static_cast<float>(std::exp(scale * x * x));
+        sum += full[i];
+    }
+    sum = 1. / sum;
+    for (float& weight : full) weight = static_cast<float>(weight * sum);
+    return std::vector<float>(full.begin() + size / 2, full.end());
+}
+
+// Octaves of a pyramid whose base is `width` x `height`, as in SIFT_Impl::detectAndCompute.
+int octaveCount(int width, int height, bool upscale) {
+    return cvRound(std::log(double(std::min(width, height))) / std::log(2.) - 2) - (upscale ? -1 : 0);
+}
+
+// Rows are split into bands of at least this many rows, a few per thread, so that threads
+// that finish early can pick up more.
+constexpr int kMinBandRows = 32;
+constexpr int kBandsPerThread = 3;
+
+int bandCount(const ThreadPool* pool, int height) {
+    if (!pool || pool->size() == 1) return 1;
+    return std::max(1, std::min(int(pool->size()) * kBandsPerThread, height / kMinBandRows));
+}
+
+// Runs body(band, begin, end) for `bands` consecutive row ranges covering [0, height), on
+// `pool` if there is more than one.
+template <typename Body>
+void forEachBand(ThreadPool* pool, int height, int bands, const Body& body) {
+    const auto run = [&body, height, bands](size_t band) {
+        const int begin = int(int64_t(height) * int64_t(band) / bands);
+        const int end = int(int64_t(height) * int64_t(band + 1) / bands);
+        body(band, begin, end);
+    };
+    if (bands == 1) {
+        run(0);
+    } else {
+        pool->parallelFor(size_t(bands), run);
+    }
+}
+
+// Separable blur of one band of rows, with scratch space reused across layers. The band's
+// rows plus `radius` rows of halo above and below are blurred horizontally first, so bands
+// only read the source and never each other's output.
+class Blur {
+public:
+    // Sizes the outputs; call once per layer before blurring its bands.
+    static void prepare(const Plane& src, Plane& dst, Plane* difference) {
+        dst.resize(src.width, src.height);
+        if (difference) difference->resize(src.width, src.height);
+    }
+
+    // Sizes the scratch space for bands of up to `rows` rows of `width` pixels.
+    void reserve(int width, int rows, int radius) {
+        horizontal_.resize(width, rows + 2 * radius);
+        padded_.resize(size_t(width) + 2 * size_t(radius));
+        rows_.resize(2 * size_t(radius) + 1);
+    }
+
+    // Blurs rows [begin, end) of `src` into `dst`, which must not be `src`, and writes
+    // dst - src to `difference` if set.
+    void operator()(const Plane& src, Plane& dst, const std::vector<float>& kernel, Plane* difference, int begin, int end) {
+        const int radius = static_cast<int>(kernel.size()) - 1;
+        const int width = src.width, height = src.height;
+        // Reflected rows of the halo fall inside it as well (see reflect101).
+        const int first = std::max(0, begin - radius), last = std::min(height, end + radius);
+        horizontal_.resize(width, last - first);
+        padded_.resize(size_t(width) + 2 * size_t(radius));
+        float* padded = padded_.data() + radius;
+        for (int y = first; y < last; y++) {
+            const float* in = src.row(y);
+            std::copy(in, in + width, padded);
+            for (int t = 1; t <= radius; t++) {
+                padded[-t] = in[reflect101(-t, width)];
+                padded[width - 1 + t] = in[reflect101(width - 1 + t, width)];
+            }
+            blurRow(padded, horizontal_.row(y - first), width, kernel.data(), radius);
+        }
+
+        rows_.resize(2 * size_t(radius) + 1);
+        for (int y = begin; y < end; y++) {
+            for (int t = -radius; t <= radius; t++) rows_[t + radius] = horizontal_.row(reflect101(y + t, height) - first);
+            blurColumns(rows_.data(), kernel.data(), radius, width, src.row(y), dst.row(y),
+                        difference ? difference->row(y) : nullptr);
+        }
+    }
+
+private:
+    Plane horizontal_;  // rows [first, last) of the band's halo
+    ScratchVector<float> padded_;
+    ScratchVector<const float*> rows_;
+};
+
+// Source taps of cv::resize(INTER_LINEAR) to twice the size along one axis.
+struct Tap {
+    int first, second;
+    float weight;  // of `second`
+};
+
+void doublingTaps(int length, ScratchVector<Tap>& taps) {
+    taps.resize(2 * size_t(length));
+    for (int d = 0; d < 2 * length; d++) {
+        float f = static_cast<float>((d + 0.5) * 0.5 - 0.5);
+        int s = cvFloor(f);
+        f -= s;
+        if (s < 0) f = 0, s = 0;
+        if (s >= length - 1) f = 0, s = length - 1;
+        taps[d] = { s, std::min(s + 1, length - 1), f };
+    }
+}
+
+// Rows [begin, end) of `src` upsampled 2x into `dst`, which must already have twice its size.
+// `first` and `second` hold source rows widened to `dst`.
+void upsample(const Plane& src, Plane& dst, const ScratchVector<Tap>& columns, const ScratchVector<Tap>& rows, int begin, int end,
+              ScratchVector<float>& first, ScratchVector<float>& second) {
+    first.resize(dst.width);
+    second.resize(dst.width);
+    int first_row = -1, second_row = -1;
+    const auto widen = [&columns](const float* in, ScratchVector<float>& out) {
+        for (size_t x = 0; x < columns.size(); x++) {
+            const Tap& tap = columns[x];
+            out[x] = in[tap.first] * (1.f - tap.weight) + in[tap.second] * tap.weight;
+        }
+    };
+    for (int y = begin; y < end; y++) {
+        const Tap& tap = rows[y];
+        if (tap.first != first_row) {
+            if (tap.first == second_row) {
+                std::swap(first, second);
+            } else {
+                widen(src.row(tap.first), first);
+            }
+            first_row = tap.first;
+        }
+        if (tap.second != second_row) {
+            widen(src.row(tap.second), second);
+            second_row = tap.second;
+        }
+        float* out = dst.row(y);
+        for (int x = 0; x < dst.width; x++) out[x] = first[x] * (1.f - tap.weight) + second[x] * tap.weight;
+    }
+}
+
+// cv::resize(INTER_NEAREST) to half the size, every other pixel, for rows [begin, end) of
+// `dst`, which must already have half the size of `src`.
+void downsample(const Plane& src, Plane& dst, int begin, int end) {
+    for (int y = begin; y < end; y++) {
+        const float* in = src.row(2 * y);
+        float* out = dst.row(y);
+        for (int x = 0; x < dst.width; x++) out[x] = in[2 * x];
+    }
+}
+
+// Gradients sampled around a keypoint, for the batched gradientPolar kernel.
+struct Samples {
+    ScratchVector<float> dx, dy, weight, magnitude, degrees;
+    ScratchVector<float> rbin, cbin;  // descriptor cell coordinates
+    size_t count = 0;
+
+    // Room for `capacity` samples, without the per-sample checks of push_back.
+    void reset(size_t capacity) {
+        count = 0;
+        if (dx.size() >= capacity) return;
+        for (auto* values : { &dx, &dy, &weight, &magnitude, &degrees, &rbin, &cbin }) values->resize(capacity);
+    }
+
+    void add(const Plane& image, int r, int c, float w) {
+        const float* row = image.row(r);
+        dx[count] = row[c + 1] - row[c - 1];
+        dy[count] = image.row(r - 1)[c] - image.row(r + 1)[c];
+        weight[count] = w;
+        count++;
+    }
+
+    void toPolar() { gradientPolar(dx.data(), dy.data(), magnitude.data(), degrees.data(), count); }
+};
+
+// Per-thread space for orientation histograms and descriptors.
+struct Scratch {
+    ScratchVector<float> weights;
+    Samples samples;
+
+    // weights[t + radius] = exp(t * t * scale) for t in [-radius, radius].
+    void separableWeights(int radius, float scale) {
+        weights.resize(2 * size_t(radius) + 1);
+        for (int t = -radius; t <= radius; t++) weights[t + radius] = std::exp(float(t * t) * scale);
+    }
+};
+
+struct Extremum {
+    int row, column, layer;
+};
+
+struct Feature {
+    cv::KeyPoint keypoint;
+    size_t descriptor;  // row in the descriptor buffer
+};
+
+// cv::KeyPointsFilter's sort order.
+bool keypointBefore(const cv::KeyPoint& a, const cv::KeyPoint& b) {
+    if (a.pt.x != b.pt.x) return a.pt.x < b.pt.x;
+    if (a.pt.y != b.pt.y) return a.pt.y < b.pt.y;
+    if (a.size != b.size) return a.size > b.size;
+    if (a.angle != b.angle) return a.angle < b.angle;
+    if (a.response != b.response) return a.response > b.response;
+    if (a.octave != b.octave) return a.octave > b.octave;
+    return a.class_id > b.class_id;
+}
+
+// One octave of the scale space, and the steps of OpenCV's findScaleSpaceExtrema,
+// adjustLocalExtrema, calcOrientationHist and calcSIFTDescriptor on it.
+//
+// Work is split into bands of rows. Each band blurs its rows of a layer once the whole layer
+// below is done, and keeps the extrema found in its rows, which it later turns into features;
+// the per-band results are concatenated in band order.
+class Octave {
+public:
+    Octave(const CpuSift::Options& options, const std::vector<std::vector<float>>& kernels)
+        : options_(options), kernels_(kernels), gaussians_(options.octave_layers + 3), differences_(options.octave_layers + 2) {}
+
+    const Plane& base() const { return gaussians_[0]; }
+
+    // Sizes every buffer whose size only depends on the image for `width` x `height` images.
+    // Later octaves are smaller and reuse them.
+    void reserve(int width, int height, const ThreadPool* pool) {
+        if (options_.upscale) {
+            width *= 2;
+            height *= 2;
+            doubled_.resize(width, height);
+        }
+        for (Plane& plane : gaussians_) plane.resize(width, height);
+        for (Plane& plane : differences_) plane.resize(width, height);
+        // The spare plane trades places with the base, so it needs the base's size too.
+        spare_.resize(width, height);
+        prepareBands(pool, height);
+        int radius = 0;
+        for (const std::vector<float>& kernel : kernels_) radius = std::max(radius, int(kernel.size()) - 1);
+        const int rows = (height + bands_ - 1) / bands_ + 1;
+        for (int band = 0; band < bands_; band++) {
+            work_[band].blur.reserve(width, rows, radius);
+            if (options_.upscale) {
+                work_[band].first.resize(width);
+                work_[band].second.resize(width);
+            }
+        }
+        if (options_.max_features > 0) {
+            // keep() takes layers 1 to octave_layers of every octave.
+            const int layers = options_.octave_layers;
+            kept_.resize(size_t(octaveCount(width, height, options_.upscale)) * layers);
+            for (size_t i = 0; i < kept_.size(); i += layers) {
+                for (int layer = 0; layer < layers; layer++) kept_[i + layer].resize(width, height);
+                width /= 2;
+                height /= 2;
+            }
+        }
+    }
+
+    // Sets the base layer from the input image: upsampled 2x if the options ask for it, then
+    // blurred to the base sigma.
+    void setBase(const Plane& image, ThreadPool* pool) {
+        const Plane* source = &image;
+        if (options_.upscale) {
+            if (columns_.size() != 2 * size_t(image.width)) doublingTaps(image.width, columns_);
+            if (rows_.size() != 2 * size_t(image.height)) doublingTaps(image.height, rows_);
+            doubled_.resize(2 * image.width, 2 * image.height);
+            prepareBands(pool, doubled_.height);
+            forEachBand(pool, doubled_.height, bands_, [&](size_t band, int begin, int end) {
+                upsample(image, doubled_, columns_, rows_, begin, end, work_[band].first, work_[band].second);
+            });
+            source = &doubled_;
+        }
+        Blur::prepare(*source, gaussians_[0], nullptr);
+        prepareBands(pool, source->height);
+        forEachBand(pool, source->height, bands_, [&](size_t band, int begin, int end) {
+            work_[band].blur(*source, gaussians_[0], kernels_[0], nullptr, begin, end);
+        });
+    }
+
+    // Moves on to the next octave, whose base is the layer at twice the current base's sigma
+    // downsampled 2x.
+    void next(ThreadPool* pool) {
+        const Plane& source = *top_;
+        spare_.resize(source.width / 2, source.height / 2);
+        forEachBand(pool, spare_.height, bandCount(pool, spare_.height), [&](size_t, int begin, int end) {
+            downsample(source, spare_, begin, end);
+        });
+        std::swap(gaussians_[0], spare_);
+    }
+
+    // Blurs every layer from the base and collects the extrema of each DoG layer. The extrema
+    // of DoG layer i are searched in the pass that blurs layer i + 3, the first one in which
+    // the DoG layers on both sides of it are complete in every band.
+    void build(float threshold, ThreadPool* pool) {
+        const int layers = options_.octave_layers;
+        const int height = gaussians_[0].height;
+        top_ = &gaussians_[layers];
+        prepareBands(pool, height);
+        for (int band = 0; band < bands_; band++) work_[band].extrema.clear();
+        for (int i = 1; i <= layers + 3; i++) {
+            const bool blur = i < layers + 3;
+            if (blur) Blur::prepare(gaussians_[i - 1], gaussians_[i], &differences_[i - 1]);
+            forEachBand(pool, height, bands_, [&](size_t band, int begin, int end) {
+                Work& work = work_[band];
+                if (blur) work.blur(gaussians_[i - 1], gaussians_[i], kernels_[i], &differences_[i - 1], begin, end);
+                if (i >= 4) findExtrema(i - 3, threshold, begin, end, work.extrema);
+            });
+        }
+    }
+
+    // Features of the extrema found by build(), in octave `octave` of the pyramid (0 is the
+    // upsampled image if there is one). Keypoints are rescaled to the input image when the
+    // pyramid starts at `first_octave` -1. Descriptors are appended to `rows` if `describe`,
+    // and features are appended to `features` in band order.
+    void features(int octave, int first_octave, bool describe, ThreadPool* pool,
+                  ScratchVector<Feature>& features, ScratchVector<float>& rows) {
+        forEachBand(pool, gaussians_[0].height, bands_, [&](size_t band, int, int) {
+            Work& work = work_[band];
+            work.features.clear();
+            work.rows.clear();
+            for (const Extremum& extremum : work.extrema) {
+                work.found.clear();
+                keypoints(octave, extremum, work.scratch, work.found);
+                for (cv::KeyPoint& keypoint : work.found) {
+                    if (first_octave < 0) {
+                        const float scale = 1.f / float(1 << -first_octave);
+                        keypoint.octave = (keypoint.octave & ~255) | ((keypoint.octave + first_octave) & 255);
+                        keypoint.pt *= scale;
+                        keypoint.size *= scale;
+                    }
+                    size_t row = SIZE_MAX;
+                    if (describe) {
+                        row = work.rows.size() / CpuSift::kDescriptorSize;
+                        work.rows.resize(work.rows.size() + CpuSift::kDescriptorSize);
+                        describeKeypoint(keypoint, gaussians_[(keypoint.octave >> 8) & 255], work.scratch,
+                                         work.rows.data() + row * CpuSift::kDescriptorSize);
+                    }
+                    work.features.push_back({ keypoint, row });
+                }
+            }
+        });
+
+        for (int band = 0; band < bands_; band++) {
+            const Work& work = work_[band];
+            const size_t offset = rows.size() / CpuSift::kDescriptorSize;
+            for (Feature feature : work.features) {
+                if (feature.descriptor != SIZE_MAX) feature.descriptor += offset;
+                features.push_back(feature);
+            }
+            rows.insert(rows.end(), work.rows.begin(), work.rows.end());
+        }
+    }
+
+    // Holds on to layers 1 to octave_layers of octave `octave`, which must be the current one,
+    // for describe(). The layers are swapped with planes of the workspace rather than copied.
+    void keep(int octave) {
+        const int layers = options_.octave_layers;
+        const size_t first = size_t(octave) * layers;
+        if (kept_.size() < first + layers) kept_.resize(first + layers);
+        for (int layer = 0; layer < layers; layer++) std::swap(gaussians_[layer + 1], kept_[first + layer]);
+        top_ = &kept_[first + layers - 1];
+        kept_octaves_ = octave + 1;
+    }
+
+    // Descriptors of `features`, whose octaves were all kept, into `rows` in feature order.
+    // Then gives the kept layers back, so that each plane has its full size again for the
+    // next image.
+    void describe(ScratchVector<Feature>& features, int first_octave, ThreadPool* pool, ScratchVector<float>& rows) {
+        const int layers = options_.octave_layers;
+        const int count = int(features.size());
+        rows.resize(features.size() * CpuSift::kDescriptorSize);
+        prepareBands(pool, count);
+        forEachBand(pool, count, bands_, [&](size_t band, int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                Feature& feature = features[i];
+                int octave = feature.keypoint.octave & 255;
+                octave = (octave < 128 ? octave : (-128 | octave)) - first_octave;
+                const int layer = (feature.keypoint.octave >> 8) & 255;
+                feature.descriptor = size_t(i);
+                describeKeypoint(feature.keypoint, kept_[size_t(octave) * layers + layer - 1], work_[band].scratch,
+                                 rows.data() + size_t(i) * CpuSift::kDescriptorSize);
+            }
+        });
+
+        for (int octave = kept_octaves_ - 1; octave >= 0; octave--) {
+            for (int layer = 0; layer < layers; layer++) std::swap(gaussians_[layer + 1], kept_[size_t(octave) * layers + layer]);
+        }
+        kept_octaves_ = 0;
+    }
+
+private:
+    // Scratch space and results of one band.
+    struct Work {
+        Blur blur;
+        Scratch scratch;
+        ScratchVector<float> first, second;  // for upsample
+        ScratchVector<Extremum> extrema;
+        ScratchVector<cv::KeyPoint> found;
+        ScratchVector<Feature> features;
+        ScratchVector<float> rows;
+    };
+
+    void prepareBands(const ThreadPool* pool, int height) {
+        bands_ = bandCount(pool, height);
+        if (work_.size() < size_t(bands_)) work_.resize(bands_);
+    }
+
+    // Keypoints of one extremum, one per orientation peak; none if it doesn't refine.
+    void keypoints(int octave, const Extremum& extremum, Scratch& scratch, ScratchVector<cv::KeyPoint>& found) const {
+        float histogram[kOrientationBins];
+        int row = extremum.row, column = extremum.column, layer = extremum.layer;
+        cv::KeyPoint keypoint;
+        if (!refine(keypoint, octave, layer, row, column)) return;
+        const float scale = keypoint.size * 0.5f / float(1 << octave);
+        const float peak = orientationHistogram(gaussians_[layer], row, column, cvRound(kOrientationRadius * scale),
+                                                kOrientationSigmaFactor * scale, scratch, histogram);
+        const float threshold = peak * kOrientationPeakRatio;
+        for (int j = 0; j < kOrientationBins; j++) {
+            const int left = j > 0 ? j - 1 : kOrientationBins - 1;
+            const int right = j < kOrientationBins - 1 ? j + 1 : 0;
+            if (histogram[j] > histogram[left] && histogram[j] > histogram[right] && histogram[j] >= threshold) {
+                float bin = j + 0.5f * (histogram[left] - histogram[right]) / (histogram[left] - 2 * histogram[j] + histogram[right]);
+                bin = bin < 0 ? kOrientationBins + bin : bin >= kOrientationBins ? bin - kOrientationBins : bin;
+                keypoint.angle = 360.f - (360.f / kOrientationBins) * bin;
+                if (std::abs(keypoint.angle - 360.f) < FLT_EPSILON) keypoint.angle = 0.f;
+                found.push_back(keypoint);
+            }
+        }
+    }
+
+    // calcDescriptors: the descriptor of `keypoint` on `image`, the layer of its packed octave
+    // and layer.
+    static void describeKeypoint(const cv::KeyPoint& keypoint, const Plane& image, Scratch& scratch, float* descriptor) {
+        int octave = keypoint.octave & 255;
+        octave = octave < 128 ? octave : (-128 | octave);
+        const float scale = octave >= 0 ? 1.f / float(1 << octave) : float(1 << -octave);
+        float angle = 360.f - keypoint.angle;
+        if (std::abs(angle - 360.f) < FLT_EPSILON) angle = 0.f;
+        describe(image, cv::Point2f(keypoint.pt.x * scale, keypoint.pt.y * scale), angle, keypoint.size * scale * 0.5f,
+                 scratch, descriptor);
+    }
+
+    // calcSIFTDescriptor: 4x4 cells of 8-bin gradient orientation histograms around `point`
+    // (octave coordinates), rotated by `angle` degrees.
+    static void describe(const Plane& image, cv::Point2f point, float angle, float scale, Scratch& scratch, float* descriptor) {
+        constexpr int d = kDescriptorWidth, n = kDescriptorBins;
+        const cv::Point center(cvRound(point.x), cvRound(point.y));
+        float cos_t = std::cos(angle * float(CV_PI / 180));
+        float sin_t = std::sin(angle * float(CV_PI / 180));
+        const float bins_per_degree = n / 360.f;
+        const float exp_scale = -1.f / (d * d * 0.5f);
+        const float hist_width = kDescriptorScaleFactor * scale;
+        int radius = cvRound(hist_width * 1.4142135623730951f * (d + 1) * 0.5f);
+        radius = std::min(radius, int(std::sqrt(double(image.width) * image.width + double(image.height) * image.height)));
+        cos_t /= hist_width;
+        sin_t /= hist_width;
+        // The rotation keeps distances, so the Gaussian weight of offset (i, j) factors into
+        // one per row and one per column.
+        scratch.separableWeights(radius, exp_scale / (hist_width * hist_width));
+        const ScratchVector<float>& weights = scratch.weights;
+        Samples& samples = scratch.samples;
+
+        // Sample first, then convert all gradients to polar at once, then bin.
+        samples.reset(weights.size() * weights.size());
+        for (int i = -radius; i <= radius; i++) {
+            const float row_weight = weights[i + radius];
+            // Only about half of the square lands in a cell, so walk just the columns that
+            // can, give or take one; the test below stays exact.
+            int first = std::max(-radius, 1 - center.x), last = std::min(radius, image.width - 2 - center.x);
+            const auto clip = [&first, &last](float slope, float offset) {
+                if (std::abs(slope) < 1e-6f) return;
+                float a = (-1 - (d / 2 - 0.5f) - offset) / slope, b = (d - (d / 2 - 0.5f) - offset) / slope;
+                if (a > b) std::swap(a, b);
+                first = std::max(first, int(std::floor(a)) - 1);
+                last = std::min(last, int(std::ceil(b)) + 1);
+            };
+            clip(sin_t, i * cos_t);
+            clip(cos_t, -i * sin_t);
+            for (int j = first; j <= last; j++) {
+                const float c_rot = j * cos_t - i * sin_t;
+                const float r_rot = j * sin_t + i * cos_t;
+                const float rbin = r_rot + d / 2 - 0.5f;
+                const float cbin = c_rot + d / 2 - 0.5f;
+                const int r = center.y + i, c = center.x + j;
+                if (!(rbin > -1 && rbin < d && cbin > -1 && cbin < d && r > 0 && r < image.height - 1 && c > 0 && c < image.width - 1)) continue;
+                samples.rbin[samples.count] = rbin;
+                samples.cbin[samples.count] = cbin;
+                samples.add(image, r, c, row_weight * weights[j + radius]);
+            }
+        }
+        samples.toPolar();
+
+        float histogram[(d + 2) * (d + 2) * (n + 2)] = {};
+        for (size_t k = 0; k < samples.count; k++) {
+            float rbin = samples.rbin[k], cbin = samples.cbin[k];
+            const float magnitude = samples.magnitude[k] * samples.weight[k];
+            float obin = (samples.degrees[k] - angle) * bins_per_degree;
+            const int r0 = cvFloor(rbin), c0 = cvFloor(cbin);
+            int o0 = cvFloor(obin);
+            rbin -= r0;
+            cbin -= c0;
+            obin -= o0;
+            if (o0 < 0) o0 += n;
+            if (o0 >= n) o0 -= n;
+
+            // Trilinear interpolation over cells and orientation bins.
+            const float v_r1 = magnitude * rbin, v_r0 = magnitude - v_r1;
+            const float v_rc11 = v_r1 * cbin, v_rc10 = v_r1 - v_rc11;
+            const float v_rc01 = v_r0 * cbin, v_rc00 = v_r0 - v_rc01;
+            const float v_rco111 = v_rc11 * obin, v_rco110 = v_rc11 - v_rco111;
+            const float v_rco101 = v_rc10 * obin, v_rco100 = v_rc10 - v_rco101;
+            const float v_rco011 = v_rc01 * obin, v_rco010 = v_rc01 - v_rco011;
+            const float v_rco001 = v_rc00 * obin, v_rco000 = v_rc00 - v_rco001;
+            const int idx = ((r0 + 1) * (d + 2) + c0 + 1) * (n + 2) + o0;
+            histogram[idx] += v_rco000;
+            histogram[idx + 1] += v_rco001;
+            histogram[idx + (n + 2)] += v_rco010;
+            histogram[idx + (n + 3)] += v_rco011;
+            histogram[idx + (d + 2) * (n + 2)] += v_rco100;
+            histogram[idx + (d + 2) * (n + 2) + 1] += v_rco101;
+            histogram[idx + (d + 3) * (n + 2)] += v_rco110;
+            histogram[idx + (d + 3) * (n + 2) + 1] += v_rco111;
+        }
+
+        // Orientation bins wrap around.
+        for (int i = 0; i < d; i++) {
+            for (int j = 0; j < d; j++) {
+                const int idx = ((i + 1) * (d + 2) + (j + 1)) * (n + 2);
+                histogram[idx] += histogram[idx + n];
+                histogram[idx + 1] += histogram[idx + n + 1];
+                for (int k = 0; k < n; k++) descriptor[(i * d + j) * n + k] = histogram[idx + k];
+            }
+        }
+
+        constexpr int length = d * d * n;
+        float norm = 0;
+        for (int k = 0; k < length; k++) norm += descriptor[k] * descriptor[k];
+        const float clip = std::sqrt(norm) * kDescriptorMagnitudeThreshold;
+        norm = 0;
+        for (int k = 0; k < length; k++) {
+            descriptor[k] = std::min(descriptor[k], clip);
+            norm += descriptor[k] * descriptor[k];
+        }
+        norm = kDescriptorIntFactor / std::max(std::sqrt(norm), FLT_EPSILON);
+        for (int k = 0; k < length; k++) descriptor[k] = cv::saturate_cast<uchar>(descriptor[k] * norm);
+    }
+
+    // Extrema of DoG layer `layer` in rows [begin, end).
+    void findExtrema(int layer, float threshold, int begin, int end, ScratchVector<Extremum>& extrema) const {
+        const Plane& current = differences_[layer];
+        const float* rows[9];
+        for (int r = std::max(begin, kImageBorder); r < std::min(end, current.height - kImageBorder); r++) {
+            for (int k = 0; k < 3; k++) {
+                rows[k] = differences_[layer - 1].row(r - 1 + k);
+                rows[3 + k] = current.row(r - 1 + k);
+                rows[6 + k] = differences_[layer + 1].row(r - 1 + k);
+            }
+            for (int c = kImageBorder; c < current.width - kImageBorder; c += 64) {
+                const size_t count = std::min(64, current.width - kImageBorder - c);
+                for (uint64_t hits = lar::bridge::findExtrema(rows, c, count, threshold); hits; hits &= hits - 1) {
+                    extrema.push_back({ r, c + __builtin_ctzll(hits), layer });
+                }
+            }
+        }
+    }
+
+    // adjustLocalExtrema: moves to the interpolated extremum (possibly into another layer),
+    // then rejects low contrast and edge responses.
+    bool refine(cv::KeyPoint& keypoint, int octave, int& layer, int& r, int& c) const {
+        const float img_scale = 1.f / 255;
+        const float deriv_scale = img_scale * 0.5f;
+        const float second_deriv_scale = img_scale;
+        const float cross_deriv_scale = img_scale * 0.25f;
+        const int layers = options_.octave_layers;
+
+        float xi = 0, xr = 0, xc = 0;
+        int step = 0;
+        for (; step < kMaxInterpolationSteps; step++) {
+            const Plane& img = differences_[layer];
+            const Plane& prev = differences_[layer - 1];
+            const Plane& next = differences_[layer + 1];
+            const cv::Vec3f dD((img.at(r, c + 1) - img.at(r, c - 1)) * deriv_scale,
+                               (img.at(r + 1, c) - img.at(r - 1, c)) * deriv_scale,
+                               (next.at(r, c) - prev.at(r, c)) * deriv_scale);
+            const float v2 = img.at(r, c) * 2;
+            const float dxx = (img.at(r, c + 1) + img.at(r, c - 1) - v2) * second_deriv_scale;
+            const float dyy = (img.at(r + 1, c) + img.at(r - 1, c) - v2) * second_deriv_scale;
+            const float dss = (next.at(r, c) + prev.at(r, c) - v2) * second_deriv_scale;
+            const float dxy = (img.at(r + 1, c + 1) - img.at(r + 1, c - 1) - img.at(r - 1, c + 1) + img.at(r - 1, c - 1)) * cross_deriv_scale;
+            const float dxs = (next.at(r, c + 1) - next.at(r, c - 1) - prev.at(r, c + 1) + prev.at(r, c - 1)) * cross_deriv_scale;
+            const float dys = (next.at(r + 1, c) - next.at(r - 1, c) - prev.at(r + 1, c) + prev.at(r - 1, c)) * cross_deriv_scale;
+            const cv::Matx33f H(dxx, dxy, dxs, dxy, dyy, dys, dxs, dys, dss);
+            const cv::Vec3f X = solve(H, dD);
+
+            xi = -X[2];
+            xr = -X[1];
+            xc = -X[0];
+            if (std::abs(xi) < 0.5f && std::abs(xr) < 0.5f && std::abs(xc) < 0.5f) break;
+            if (std::abs(xi) > float(INT_MAX / 3) || std::abs(xr) > float(INT_MAX / 3) || std::abs(xc) > float(INT_MAX / 3)) return false;
+
+            c += cvRound(xc);
+            r += cvRound(xr);
+            layer += cvRound(xi);
+            if (layer < 1 || layer > layers || c < kImageBorder || c >= img.width - kImageBorder ||
+                r < kImageBorder || r >= img.height - kImageBorder) {
+                return false;
+            }
+        }
+        if (step >= kMaxInterpolationSteps) return false;
+
+        const Plane& img = differences_[layer];
+        const Plane& prev = differences_[layer - 1];
+        const Plane& next = differences_[layer + 1];
+        const cv::Vec3f dD((img.at(r, c + 1) - img.at(r, c - 1)) * deriv_scale,
+                           (img.at(r + 1, c) - img.at(r - 1, c)) * deriv_scale,
+                           (next.at(r, c) - prev.at(r, c)) * deriv_scale);
+        const float t = dD.dot(cv::Vec3f(xc, xr, xi));
+        const float contrast = img.at(r, c) * img_scale + t * 0.5f;
+        if (std::abs(contrast) * layers < options_.contrast_threshold) return false;
+
+        // Principal curvatures are computed using the trace and det of the Hessian.
+        const float v2 = img.at(r, c) * 2.f;
+        const float dxx = (img.at(r, c + 1) + img.at(r, c - 1) - v2) * second_deriv_scale;
+        const float dyy = (img.at(r + 1, c) + img.at(r - 1, c) - v2) * second_deriv_scale;
+        const float dxy = (img.at(r + 1, c + 1) - img.at(r + 1, c - 1) - img.at(r - 1, c + 1) + img.at(r - 1, c - 1)) * cross_deriv_scale;
+        const float trace = dxx + dyy;
+        const float det = dxx * dyy - dxy * dxy;
+        const float edge = static_cast<float>(options_.edge_threshold);
+        if (det <= 0 || trace * trace * edge >= (edge + 1) * (edge + 1) * det) return false;
+
+        keypoint.pt.x = (c + xc) * float(1 << octave);
+        keypoint.pt.y = (r + xr) * float(1 << octave);
+        keypoint.octave = octave + (layer << 8) + (cvRound((xi + 0.5) * 255) << 16);
+        keypoint.size = static_cast<float>(options_.sigma) * powf(2.f, (layer + xi) / layers) * float(1 << octave) * 2;
+        keypoint.response = std::abs(contrast);
+        return true;
+    }
+
+    // Cramer's rule, as cv::Matx33f::solve does for 3x3 systems; zero if singular.
+    static cv::Vec3f solve(const cv::Matx33f& a, const cv::Vec3f& b) {
+        const double det = a(0, 0) * (a(1, 1) * a(2, 2) - a(2, 1) * a(1, 2))
+                         - a(0, 1) * (a(1, 0) * a(2, 2) - a(2, 0) * a(1, 2))
+                         + a(0, 2) * (a(1, 0) * a(2, 1) - a(2, 0) * a(1, 1));
+        if (static_cast<float>(det) == 0) return cv::Vec3f(0, 0, 0);
+        const float d = 1 / static_cast<float>(det);
+        return cv::Vec3f(
+            d * (b(0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) - a(0, 1) * (b(1) * a(2, 2) - a(1, 2) * b(2)) + a(0, 2) * (b(1) * a(2, 1) - a(1, 1) * b(2))),
+            d * (a(0, 0) * (b(1) * a(2, 2) - a(1, 2) * b(2)) - b(0) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) + a(0, 2) * (a(1, 0) * b(2) - b(1) * a(2, 0))),
+            d * (a(0, 0) * (a(1, 1) * b(2) - b(1) * a(2, 1)) - a(0, 1) * (a(1, 0) * b(2) - b(1) * a(2, 0)) + b(0) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0))));
+    }
+
+    // calcOrientationHist: smoothed histogram of gradient orientations around (r, c), and its
+    // highest bin.
+    static float orientationHistogram(const Plane& image, int r, int c, int radius, float sigma, Scratch& scratch, float* histogram) {
+        scratch.separableWeights(radius, -1.f / (2.f * sigma * sigma));
+        const ScratchVector<float>& weights = scratch.weights;
+        Samples& samples = scratch.samples;
+        samples.reset(weights.size() * weights.size());
+        for (int i = -radius; i <= radius; i++) {
+            const int y = r + i;
+            if (y <= 0 || y >= image.height - 1) continue;
+            for (int j = -radius; j <= radius; j++) {
+                const int x = c + j;
+                if (x <= 0 || x >= image.width - 1) continue;
+                samples.add(image, y, x, weights[i + radius] * weights[j + radius]);
+            }
+        }
+        samples.toPolar();
+
+        float raw[kOrientationBins + 4] = {};
+        float* bins = raw + 2;
+        for (size_t k = 0; k < samples.count; k++) {
+            int bin = cvRound((kOrientationBins / 360.f) * samples.degrees[k]);
+            if (bin >= kOrientationBins) bin -= kOrientationBins;
+            if (bin < 0) bin += kOrientationBins;
+            bins[bin] += samples.weight[k] * samples.magnitude[k];
+        }
+
+        bins[-1] = bins[kOrientationBins - 1];
+        bins[-2] = bins[kOrientationBins - 2];
+        bins[kOrientationBins] = bins[0];
+        bins[kOrientationBins + 1] = bins[1];
+        float peak = 0;
+        for (int i = 0; i < kOrientationBins; i++) {
+            histogram[i] = (bins[i - 2] + bins[i + 2]) * (1.f / 16.f) + (bins[i - 1] + bins[i + 1]) * (4.f / 16.f) + bins[i] * (6.f / 16.f);
+            peak = i == 0 ? histogram[0] : std::max(peak, histogram[i]);
+        }
+        return peak;
+    }
+
+    const CpuSift::Options& options_;
+    const std::vector<std::vector<float>>& kernels_;
+    ScratchVector<Plane> gaussians_;
+    ScratchVector<Plane> differences_;
+    Plane spare_;    // the next octave's base while it is downsampled
+    Plane doubled_;  // the upsampled input
+    ScratchVector<Tap> columns_, rows_;
+    ScratchVector<Work> work_;  // one per band
+    int bands_ = 1;
+    // Layers keep() held on to, octave_layers per octave, and the layer the next octave is
+    // downsampled from.
+    ScratchVector<Plane> kept_;
+    int kept_octaves_ = 0;
+    const Plane* top_ = nullptr;
+};
+
+// Per-layer blur kernels, as in buildGaussianPyramid; kernels[0] takes the image to `sigma`.
+std::vector<std::vector<float>> blurKernels(const CpuSift::Options& options) {
+    const int layers = options.octave_layers;
+    std::vector<std::vector<float>> kernels(layers + 3);
+    const float sigma = static_cast<float>(options.sigma);
+    const float initial = options.upscale ? kInitialSigma * kInitialSigma * 4 : kInitialSigma * kInitialSigma;
+    kernels[0] = gaussianKernel(std::sqrt(std::max(sigma * sigma - initial, 0.01f)));
+    const double k = std::pow(2., 1. / layers);
+    for (int i = 1; i < layers + 3; i++) {
+        const double previous = std::pow(k, double(i - 1)) * options.sigma;
+        const double total = previous * k;
+        kernels[i] = gaussianKernel(std::sqrt(total * total - previous * previous));
+    }
+    return kernels;
+}
+
+// Spends a keypoint budget on deduplicated features, as CpuSift::Selection describes.
+class Selector {
+public:
+    // Keeps `budget` of `features` in keypointBefore order, or more on ties for Strongest, on
+    // a `width` x `height` image.
+    void select(ScratchVector<Feature>& features, size_t budget, const CpuSift::Options& options, int width, int height) {
+        if (features.size() <= budget) return;
+        if (options.selection == CpuSift::Selection::Strongest) {
+            // KeyPointsFilter::retainBest.
+            const auto stronger = [](const Feature& a, const Feature& b) { return a.keypoint.response > b.keypoint.response; };
+            std::nth_element(features.begin(), features.begin() + budget - 1, features.end(), stronger);
+            const float cutoff = features[budget - 1].keypoint.response;
+            // Ties with the weakest kept response are kept too.
+            features.erase(std::partition(features.begin() + budget, features.end(),
+                                          [cutoff](const Feature& f) { return f.keypoint.response >= cutoff; }),
+                           features.end());
+            std::sort(features.begin(), features.end(), [](const Feature& a, const Feature& b) {
+                return keypointBefore(a.keypoint, b.keypoint);
+            });
+            return;
+        }
+
+        candidates_.resize(features.size());
+        for (size_t i = 0; i < features.size(); i++) candidates_[i] = { 0, features[i].keypoint.response, uint32_t(i) };
+        if (options.selection == CpuSift::Selection::Grid) {
+            rankInCells(features, std::max(options.grid_columns, 1), width, height);
+        } else {
+            suppressionRadii(features, width, height);
+        }
+
+        // Highest priority first, then the strongest; features stay in order.
+        std::nth_element(candidates_.begin(), candidates_.begin() + budget - 1, candidates_.end(),
+                         [](const Candidate& a, const Candidate& b) {
+            if (a.priority != b.priority) return a.priority > b.priority;
+            if (a.response != b.response) return a.response > b.response;
+            return a.index < b.index;
+        });
+        std::sort(candidates_.begin(), candidates_.begin() + budget, [](const Candidate& a, const Candidate& b) {
+            return a.index < b.index;
+        });
+        for (size_t i = 0; i < budget; i++) features[i] = features[candidates_[i].index];
+        features.resize(budget);
+    }
+
+private:
+    struct Candidate {
+        float priority;
+        float response;
+        uint32_t index;
+    };
+
+    // Indices of `features`, strongest first.
+    void orderByResponse(const ScratchVector<Feature>& features) {
+        order_.resize(features.size());
+        for (size_t i = 0; i < order_.size(); i++) order_[i] = uint32_t(i);
+        std::sort(order_.begin(), order_.end(), [&features](uint32_t a, uint32_t b) {
+            const float ra = features[a].keypoint.response, rb = features[b].keypoint.response;
+            return ra != rb ? ra > rb : a < b;
+        });
+    }
+
+    // Priority -k for the k-th strongest feature of its grid cell, so that every cell gives
+    // up its best feature before any gives up its second. Cells are `columns` across and
+    // about as tall as they are wide.
+    void rankInCells(const ScratchVector<Feature>& features, int columns, int width, int height) {
+        const int rows = std::max(1, cvRound(double(columns) * height / width));
+        orderByResponse(features);
+        heads_.assign(size_t(columns) * rows, 0);  // features seen per cell
+        for (uint32_t i : order_) {
+            const cv::Point2f& pt = features[i].keypoint.pt;
+            const int x = std::clamp(int(pt.x * columns / width), 0, columns - 1);
+            const int y = std::clamp(int(pt.y * rows / height), 0, rows - 1);
+            candidates_[i].priority = -float(heads_[size_t(y) * columns + x]++);
+        }
+    }
+
+    // Priority r² for adaptive non-maximal suppression, where r is the distance to the
+    // nearest clearly stronger feature (infinite for the strongest ones). Stronger features
+    // are binned into cells of a few features each, and each feature searches rings of cells
+    // around its own until no unsearched cell can be closer than the nearest found.
+    void suppressionRadii(const ScratchVector<Feature>& features, int width, int height) {
+        orderByResponse(features);
+        const float side = std::max(1.f, 2 * std::sqrt(float(width) * float(height) / float(features.size())));
+        const int columns = std::max(1, int(std::ceil(width / side))), rows = std::max(1, int(std::ceil(height / side)));
+        heads_.assign(size_t(columns) * rows, -1);
+        links_.resize(features.size());
+        const auto cellOf = [&](uint32_t i, int& x, int& y) {
+            const cv::Point2f& pt = features[i].keypoint.pt;
+            x = std::clamp(int(pt.x / side), 0, columns - 1);
+            y = std::clamp(int(pt.y / side), 0, rows - 1);
+        };
+
+        size_t inserted = 0;
+        for (size_t k = 0; k < order_.size(); k++) {
+            const uint32_t i = order_[k];
+            const float response = features[i].keypoint.response;
+            for (; inserted < k && features[order_[inserted]].keypoint.response * kSuppressionRobustness > response; inserted++) {
+                int x, y;
+                cellOf(order_[inserted], x, y);
+                int32_t& head = heads_[size_t(y) * columns + x];
+                links_[order_[inserted]] = head;
+                head = int32_t(order_[inserted]);
+            }
+
+            const cv::Point2f& pt = features[i].keypoint.pt;
+            float nearest = FLT_MAX;
+            const auto search = [&](int x, int y) {
+                if (x < 0 || x >= columns || y < 0 || y >= rows) return;
+                for (int32_t j = heads_[size_t(y) * columns + x]; j >= 0; j = links_[j]) {
+                    const cv::Point2f d = features[j].keypoint.pt - pt;
+                    nearest = std::min(nearest, d.x * d.x + d.y * d.y);
+                }
+            };
+            if (inserted > 0) {
+                int cx, cy;
+                cellOf(i, cx, cy);
+                for (int ring = 0; ; ring++) {
+                    // Features `ring` cells away are at least ring - 1 cell sides away.
+                    const float bound = std::max(0, ring - 1) * side;
+                    if (nearest <= bound * bound) break;
+                    if (cx - ring < 0 && cy - ring < 0 && cx + ring >= columns && cy + ring >= rows) break;
+                    for (int x = cx - ring; x <= cx + ring; x++) {
+                        search(x, cy - ring);
+                        if (ring > 0) search(x, cy + ring);
+                    }
+                    for (int y = cy - ring + 1; y <= cy + ring - 1; y++) {
+                        search(cx - ring, y);
+                        if (ring > 0) search(cx + ring, y);
+                    }
+                }
+            }
+            candidates_[i].priority = nearest;
+        }
+    }
+
+    ScratchVector<Candidate> candidates_;
+    ScratchVector<uint32_t> order_;
+    ScratchVector<int32_t> heads_;  // per cell
+    ScratchVector<int32_t> links_;  // per feature
+};
+
+} // namespace
+
+// Every buffer extract() uses, kept from one call to the next.
+struct CpuSift::Workspace {
+    explicit Workspace(const Options& options)
+        : options(options), kernels(blurKernels(options)), octave(this->options, kernels) {}
+
+    const Options options;
+    const std::vector<std::vector<float>> kernels;
+    Octave octave;
+    Selector selector;
+    KeypointCounts counts;
+    Plane image;
+    ScratchVector<Feature> features;
+    ScratchVector<float> rows;  // descriptors of `features`
+    std::vector<float> values;  // for detectAndCompute
+    int width = 0, height = 0;  // configured image size
+};
+
+CpuSift::CpuSift(const Options& options) : options_(options) {
+    if (options.octave_layers < 1 || options.sigma <= 0 || options.contrast_threshold < 0) {
+        throw std::invalid_argument("Invalid SIFT parameters");
+    }
+    if (options.descriptor_type != CV_32F && options.descriptor_type != CV_8U) {
+        throw std::invalid_argument("SIFT descriptors are CV_32F or CV_8U");
+    }
+    if (options.selection == Selection::Grid && options.grid_columns < 1) {
+        throw std::invalid_argument("SIFT grid selection needs at least one column");
+    }
+    const size_t threads = options.threads == 0 ? ThreadPool::hardwareThreads() : options.threads;
+    if (threads > 1) pool_ = std::make_unique<ThreadPool>(threads);
+    workspace_ = std::make_unique<Workspace>(options);
+}
+
+CpuSift::~CpuSift() = default;
+
+size_t CpuSift::threads() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+const CpuSift::KeypointCounts& CpuSift::keypointCounts() const {
+    return workspace_->counts;
+}
+
+void CpuSift::configure(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("SIFT image size must be positive");
+    }
+    Workspace& workspace = *workspace_;
+    workspace.width = width;
+    workspace.height = height;
+    workspace.image.resize(width, height);
+    workspace.octave.reserve(width, height, pool_.get());
+}
+
+void CpuSift::extract(const uint8_t* pixels, int width, int height, size_t bytes_per_row,
+                      std::vector<cv::KeyPoint>& keypoints, std::vector<float>* descriptors) {
+    keypoints.clear();
+    if (width <= 0 || height <= 0) return;
+    Workspace& workspace = *workspace_;
+    if (width != workspace.width || height != workspace.height) configure(width, height);
+    const int layers = options_.octave_layers;
+    const int first_octave = options_.upscale ? -1 : 0;
+
+    Plane& image = workspace.image;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* in = pixels + size_t(y) * bytes_per_row;
+        std::copy(in, in + width, image.row(y));
+    }
+    ThreadPool* pool = pool_.get();
+    Octave& octave = workspace.octave;
+    octave.setBase(image, pool);
+
+    const Plane& base = octave.base();
+    const int octaves = octaveCount(base.width, base.height, options_.upscale);
+    // With a budget, keypoints are only described once they have been selected.
+    const bool deferred = descriptors != nullptr && options_.max_features > 0;
+    const float threshold = std::floor(0.5 * options_.contrast_threshold / layers * 255);
+    ScratchVector<Feature>& features = workspace.features;
+    ScratchVector<float>& rows = workspace.rows;
+    features.clear();
+    rows.clear();
+    for (int o = 0; o < octaves; o++) {
+        if (o > 0) octave.next(pool);
+        octave.build(threshold, pool);
+        octave.features(o, first_octave, descriptors != nullptr && !deferred, pool, features, rows);
+        if (deferred) octave.keep(o);
+    }
+
+    // KeyPointsFilter::removeDuplicatedSorted, then the budget.
+    std::sort(features.begin(), features.end(), [](const Feature& a, const Feature& b) {
+        return keypointBefore(a.keypoint, b.keypoint);
+    });
+    features.erase(std::unique(features.begin(), features.end(), [](const Feature& a, const Feature& b) {
+        return a.keypoint.pt == b.keypoint.pt && a.keypoint.size == b.keypoint.size && a.keypoint.angle == b.keypoint.angle;
+    }), features.end());
+    const size_t found = features.size();
+    if (options_.max_features > 0) workspace.selector.select(features, options_.max_features, options_, width, height);
+    workspace.counts = { features.size(), found - features.size() };
+    if (deferred) octave.describe(features, first_octave, pool, rows);
+
+    keypoints.reserve(features.size());
+    for (const Feature& feature : features) keypoints.push_back(feature.keypoint);
+    if (descriptors) {
+        descriptors->reserve(descriptors->size() + features.size() * kDescriptorSize);
+        for (const Feature& feature : features) {
+            const float* row = rows.data() + feature.descriptor * kDescriptorSize;
+            descriptors->insert(descriptors->end(), row, row + kDescriptorSize);
+        }
+    }
+}
+
+void CpuSift::detectAndCompute(const cv::Mat& image, std::vector<cv::KeyPoint>& keypoints, cv::Mat& descriptors) {
+    if (image.type() != CV_8UC1) {
+        throw std::invalid_argument("SIFT expects an 8-bit grayscale image");
+    }
+    std::vector<float>& values = workspace_->values;
+    values.clear();
+    extract(image.data, image.cols, image.rows, image.step[0], keypoints, &values);
+    cv::Mat(static_cast<int>(keypoints.size()), kDescriptorSize, CV_32F, values.data()).convertTo(descriptors, options_.descriptor_type);
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,110 @@
+//
+//  cpu_sift.h
+//  LocalizeAR
+//
+//  SIFT on the CPU, for hosts without the Metal pipeline (e.g. Linux localization servers).
+//
+//  The scale space is built one octave at a time with the structure of the fused Metal
+//  kernels: each Gaussian layer comes out of a separable blur whose vertical pass also writes
+//  the difference of Gaussians against the layer below, and a DoG layer is searched for
+//  extrema in the same sweep, as soon as the DoG layer above it is complete. Only one octave of layers is alive at a
+//  time, so its keypoints are refined and described before the next octave is built.
+//
+//  Every layer is split into bands of rows that run on a thread pool, if there is more than
+//  one thread: a band blurs its own rows plus a halo of the blur radius above and below, so
+//  bands only wait for each other between layers. Each band keeps the extrema found in its
+//  rows and turns them into features; the bands' features are merged in row order.
+//
+//  A keypoint budget (max_features) bounds the cost of describing and matching keypoints on
+//  textured scenes. The budget is spent after every octave has been searched, on the
+//  deduplicated keypoints, and only the kept ones are described: each octave hands its
+//  Gaussian layers to the workspace instead of describing right away, which costs about 4/3
+//  of octave_layers full-size planes of memory. Besides OpenCV's strongest-response
+//  selection, keypoints can be spread evenly over the image by a grid or by adaptive
+//  non-maximal suppression, so that bland regions still get some.
+//
+//  Every buffer lives in a workspace that the extractor keeps between calls, sized by
+//  configure() (or the first image) for the image size. Once a frame of that size has been
+//  extracted, later frames allocate nothing unless they yield more extrema or keypoints than
+//  any before; scratch_allocator.h counts the allocations. An extractor is therefore not
+//  reentrant: use one per thread.
+//
+//  The inner loops run on the SIMD kernels of sift_kernels.h; everything else follows
+//  OpenCV's SIFT step by step (same parameters, interpolation, orientation histogram and
+//  descriptor layout), so keypoints and descriptors are interchangeable with it.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+
+namespace lar::bridge {
+
+class ThreadPool;
+
+class CpuSift {
+public:
+    // How a keypoint budget is spent.
+    enum class Selection {
+        Strongest,    // highest responses, ties with the last included, as OpenCV's retainBest
+        Grid,         // the best of every grid cell first, then the second best, and so on
+        Suppression,  // adaptive non-maximal suppression: furthest from clearly stronger ones
+    };
+
+    struct Options {
+        int octave_layers = 3;
+        double contrast_threshold = 0.04;
+        double edge_threshold = 10;
+        double sigma = 1.6;
+        size_t max_features = 0;         // keypoint budget, 0 for all
+        Selection selection = Selection::Strongest;
+        int grid_columns = 16;           // for Selection::Grid, with square cells
+        bool upscale = true;             // start from the image upsampled 2x, as OpenCV does
+        int descriptor_type = CV_32F;    // or CV_8U
+        size_t threads = 1;              // including the caller; 0 for one per hardware thread
+    };
+
+    explicit CpuSift(const Options& options);
+    ~CpuSift();
+
+    // Sizes the workspace for `width` x `height` images. Throws std::invalid_argument if the
+    // size isn't positive.
+    void configure(int width, int height);
+
+    // Keypoints sorted by position, and one 128-value descriptor per keypoint appended to
+    // `descriptors` if set, for an 8-bit grayscale image. Reconfigures the workspace if the
+    // image size changed. Doesn't allocate in steady state if the outputs are reused.
+    void extract(const uint8_t* pixels, int width, int height, size_t bytes_per_row,
+                 std::vector<cv::KeyPoint>& keypoints, std::vector<float>* descriptors);
+
+    // As cv::Feature2D::detectAndCompute without a mask. `image` must be CV_8UC1. Allocates
+    // `descriptors` whenever its row count changes.
+    void detectAndCompute(const cv::Mat& image, std::vector<cv::KeyPoint>& keypoints, cv::Mat& descriptors);
+
+    // Keypoints of the last image within the budget and over it, after removing duplicates.
+    struct KeypointCounts {
+        size_t kept = 0;
+        size_t dropped = 0;
+    };
+
+    const Options& options() const { return options_; }
+    size_t threads() const;
+    const KeypointCounts& keypointCounts() const;
+
+    static constexpr int kDescriptorSize = 128;
+
+private:
+    struct Workspace;
+
+    Options options_;
+    std::unique_ptr<ThreadPool> pool_;
+    std::unique_ptr<Workspace> workspace_;
+};
+
+} // namespace lar::bridge
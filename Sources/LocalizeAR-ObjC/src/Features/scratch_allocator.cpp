@@ -0,0 +1,26 @@
+//
+//  scratch_allocator.cpp
+//  LocalizeAR
+//
+
+#include "scratch_allocator.h"
+
+#include <atomic>
+
+namespace lar::bridge {
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+} // namespace
+
+uint64_t scratchAllocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void countScratchAllocation() {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,49 @@
+//
+//  scratch_allocator.h
+//  LocalizeAR
+//
+//  Allocator for the scratch buffers of the feature extractor that counts every allocation it
+//  makes, so tests and benchmarks can check that extraction stops allocating once its buffers
+//  have grown to the configured image size.
+//
+//  The buffers themselves are ordinary vectors that keep their capacity between frames; the
+//  count only tells whether one of them had to grow.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace lar::bridge {
+
+// Allocations made through ScratchAllocator by every thread so far.
+uint64_t scratchAllocations();
+void countScratchAllocation();
+
+template <typename T>
+struct ScratchAllocator {
+    using value_type = T;
+
+    ScratchAllocator() = default;
+    template <typename U>
+    ScratchAllocator(const ScratchAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        countScratchAllocation();
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t) { ::operator delete(p); }
+
+    template <typename U>
+    bool operator==(const ScratchAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ScratchAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+} // namespace lar::bridge
@@ -0,0 +1,127 @@
+//
+//  sift_benchmark.cpp
+//  LocalizeAR
+//
+
+#include "sift_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <opencv2/core/utility.hpp>
+
+#include "scratch_allocator.h"
+
+namespace lar::bridge {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+constexpr float kTolerance = 0.01f;
+
+CpuSift::Options threaded(CpuSift::Options options) {
+    options.threads = 0;
+    return options;
+}
+
+CpuSift::Options budgeted(CpuSift::Options options, size_t budget, CpuSift::Selection selection) {
+    options.max_features = budget;
+    options.selection = selection;
+    return options;
+}
+
+bool same(const cv::KeyPoint& a, const cv::KeyPoint& b) {
+    return std::abs(a.pt.x - b.pt.x) <= kTolerance && std::abs(a.pt.y - b.pt.y) <= kTolerance &&
+           std::abs(a.size - b.size) <= kTolerance && std::abs(a.angle - b.angle) <= kTolerance;
+}
+
+} // namespace
+
+SiftBenchmark::SiftBenchmark(const CpuSift::Options& options, size_t budget, CpuSift::Selection selection)
+    : sift_(options),
+      threaded_(threaded(options)),
+      budgeted_(budgeted(options, budget, selection)),
+      opencv_(cv::SIFT::create(int(options.max_features), options.octave_layers, options.contrast_threshold,
+                               options.edge_threshold, options.sigma, options.descriptor_type)) {
+    result_.kernel = activeSiftKernel();
+    result_.threads = threaded_.threads();
+    result_.budget = budget;
+}
+
+void SiftBenchmark::evaluate(const cv::Mat& image) {
+    if (image.type() != CV_8UC1) {
+        throw std::invalid_argument("SIFT benchmark images must be 8-bit grayscale");
+    }
+    std::vector<cv::KeyPoint> keypoints, scalar_keypoints, threaded_keypoints, budget_keypoints, expected;
+    cv::Mat descriptors, scalar_descriptors, threaded_descriptors, budget_descriptors, expected_descriptors;
+
+    const uint64_t allocations = scratchAllocations();
+    auto start = Clock::now();
+    sift_.detectAndCompute(image, keypoints, descriptors);
+    result_.simd_seconds += secondsSince(start);
+
+    const SiftKernel kernel = activeSiftKernel();
+    useSiftKernel(SiftKernel::Scalar);
+    start = Clock::now();
+    sift_.detectAndCompute(image, scalar_keypoints, scalar_descriptors);
+    result_.scalar_seconds += secondsSince(start);
+    useSiftKernel(kernel);
+
+    start = Clock::now();
+    threaded_.detectAndCompute(image, threaded_keypoints, threaded_descriptors);
+    result_.threaded_seconds += secondsSince(start);
+    if (result_.images > 0) result_.steady_allocations += scratchAllocations() - allocations;
+
+    start = Clock::now();
+    budgeted_.detectAndCompute(image, budget_keypoints, budget_descriptors);
+    result_.budget_seconds += secondsSince(start);
+    result_.kept_keypoints += budgeted_.keypointCounts().kept;
+    result_.dropped_keypoints += budgeted_.keypointCounts().dropped;
+
+    const int opencv_threads = cv::getNumThreads();
+    cv::setNumThreads(1);
+    start = Clock::now();
+    opencv_->detectAndCompute(image, cv::noArray(), expected, expected_descriptors);
+    result_.opencv_seconds += secondsSince(start);
+    cv::setNumThreads(opencv_threads);
+
+    result_.images++;
+    result_.keypoints += keypoints.size();
+    result_.opencv_keypoints += expected.size();
+    result_.scalar_matches = result_.scalar_matches && scalar_keypoints.size() == keypoints.size() &&
+        std::equal(keypoints.begin(), keypoints.end(), scalar_keypoints.begin(), same);
+    result_.threaded_matches = result_.threaded_matches && threaded_keypoints.size() == keypoints.size() &&
+        std::equal(keypoints.begin(), keypoints.end(), threaded_keypoints.begin(), same);
+
+    // Pair keypoints through OpenCV's, ordered by x.
+    std::vector<int> order(expected.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&expected](int a, int b) { return expected[a].pt.x < expected[b].pt.x; });
+    for (size_t i = 0; i < keypoints.size(); i++) {
+        const cv::KeyPoint& keypoint = keypoints[i];
+        auto it = std::lower_bound(order.begin(), order.end(), keypoint.pt.x - kTolerance,
+                                   [&expected](int a, float x) { return expected[a].pt.x < x; });
+        for (; it != order.end() && expected[*it].pt.x <= keypoint.pt.x + kTolerance; ++it) {
+            if (!same(keypoint, expected[*it])) continue;
+            result_.matched_keypoints++;
+            if (!descriptors.empty() && !expected_descriptors.empty()) {
+                cv::Mat row, expected_row;
+                descriptors.row(int(i)).convertTo(row, CV_32F);
+                expected_descriptors.row(*it).convertTo(expected_row, CV_32F);
+                result_.descriptor_distance += cv::norm(row, expected_row, cv::NORM_L2);
+            }
+            break;
+        }
+    }
+}
+
+} // namespace lar::bridge
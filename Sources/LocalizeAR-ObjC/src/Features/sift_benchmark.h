@@ -0,0 +1,69 @@
+//
+//  sift_benchmark.h
+//  LocalizeAR
+//
+//  Times the CPU SIFT with its SIMD kernels, with the scalar kernels, with its bands spread
+//  over every hardware thread, with a keypoint budget, and against OpenCV's SIFT on the same
+//  images, and checks that all of them agree.
+//
+//  Keypoints match if they have the same position, size and angle to within rounding; the
+//  descriptors of matched keypoints are compared by L2 distance (as 8-bit values they range
+//  over 0-255 per dimension, so a distance of a few units is rounding noise). Scratch
+//  allocations are counted from the second image on, when the workspaces should be warm.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/features.hpp>
+
+#include "cpu_sift.h"
+#include "sift_kernels.h"
+
+namespace lar::bridge {
+
+class SiftBenchmark {
+public:
+    struct Result {
+        size_t images = 0;
+        double simd_seconds = 0;      // all images
+        double scalar_seconds = 0;
+        double threaded_seconds = 0;  // SIMD kernels on `threads` threads
+        size_t threads = 1;
+        size_t budget = 0;            // keypoints per image, spent by grid selection by default
+        double budget_seconds = 0;    // SIMD kernels with the keypoint budget, one thread
+        size_t kept_keypoints = 0;    // within the budget over all images
+        size_t dropped_keypoints = 0;
+        double opencv_seconds = 0;
+        size_t keypoints = 0;         // CPU SIFT keypoints over all images
+        size_t opencv_keypoints = 0;
+        size_t matched_keypoints = 0;
+        double descriptor_distance = 0;  // summed over matched keypoints
+        bool scalar_matches = true;   // both kernels gave identical keypoints
+        bool threaded_matches = true; // so did the threaded run
+        uint64_t steady_allocations = 0;  // CPU SIFT scratch allocations after the first image
+        SiftKernel kernel = SiftKernel::Scalar;
+    };
+
+    // The budgeted run spends `budget` keypoints per image by `selection`.
+    explicit SiftBenchmark(const CpuSift::Options& options = {}, size_t budget = 1000,
+                           CpuSift::Selection selection = CpuSift::Selection::Grid);
+
+    // Runs every extractor on `image`, which must be CV_8UC1. Switches the SIFT kernels for
+    // the whole process while the scalar pass runs. OpenCV runs on one thread.
+    void evaluate(const cv::Mat& image);
+
+    const Result& result() const { return result_; }
+
+private:
+    CpuSift sift_;
+    CpuSift threaded_;
+    CpuSift budgeted_;
+    cv::Ptr<cv::SIFT> opencv_;
+    Result result_;
+};
+
+} // namespace lar::bridge
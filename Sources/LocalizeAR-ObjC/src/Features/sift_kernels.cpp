@@ -0,0 +1,377 @@
+//
+//  sift_kernels.cpp
+//  LocalizeAR
+//
+
+#include "sift_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LAR_SIFT_KERNEL_AVX2 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define LAR_SIFT_KERNEL_NEON 1
+#endif
+
+namespace lar::bridge {
+
+namespace {
+
+struct Kernels {
+    void (*blur_row)(const float*, float*, size_t, const float*, size_t);
+    void (*blur_columns)(const float* const*, const float*, size_t, size_t, const float*, float*, float*);
+    uint64_t (*find_extrema)(const float* const*, size_t, size_t, float);
+    void (*gradient_polar)(const float*, const float*, float*, float*, size_t);
+};
+
+// Index of the pixel's own row in the `rows` of findExtrema. Rows 3 to 5 are its layer, which
+// the SIMD kernels test first: most pixels already fail against those 8 neighbors.
+constexpr int kCenterRow = 4;
+
+// cv::fastAtan2's polynomial, in degrees.
+constexpr float kAtan2P1 = 0.9997878412794807f * float(180 / M_PI);
+constexpr float kAtan2P3 = -0.3258083974640975f * float(180 / M_PI);
+constexpr float kAtan2P5 = 0.1555786518463281f * float(180 / M_PI);
+constexpr float kAtan2P7 = -0.04432655554792128f * float(180 / M_PI);
+constexpr float kAtan2Epsilon = float(DBL_EPSILON);
+
+void blurRowScalar(const float* src, float* dst, size_t width, const float* kernel, size_t radius) {
+    for (size_t x = 0; x < width; x++) {
+        float sum = kernel[0] * src[x];
+        for (size_t t = 1; t <= radius; t++) {
+            sum += kernel[t] * (src[x - t] + src[x + t]);
+        }
+        dst[x] = sum;
+    }
+}
+
+// Columns [begin, end) of blurColumns.
+void blurColumnRange(const float* const* rows, const float* kernel, size_t radius, size_t begin, size_t end,
+                     const float* previous, float* gaussian, float* difference) {
+    for (size_t x = begin; x < end; x++) {
+        float sum = kernel[0] * rows[radius][x];
+        for (size_t t = 1; t <= radius; t++) {
+            sum += kernel[t] * (rows[radius - t][x] + rows[radius + t][x]);
+        }
+        gaussian[x] = sum;
+        if (difference) difference[x] = sum - previous[x];
+    }
+}
+
+void blurColumnsScalar(const float* const* rows, const float* kernel, size_t radius, size_t width,
+                       const float* previous, float* gaussian, float* difference) {
+    blurColumnRange(rows, kernel, radius, 0, width, previous, gaussian, difference);
+}
+
+uint64_t findExtremaScalar(const float* const* rows, size_t first, size_t count, float threshold) {
+    uint64_t hits = 0;
+    for (size_t i = 0; i < count; i++) {
+        const size_t c = first + i;
+        const float value = rows[kCenterRow][c];
+        if (!(std::abs(value) > threshold)) continue;
+        float highest = -INFINITY, lowest = INFINITY;
+        for (int row = 0; row < 9; row++) {
+            for (size_t x = c - 1; x <= c + 1; x++) {
+                if (row == kCenterRow && x == c) continue;
+                highest = std::max(highest, rows[row][x]);
+                lowest = std::min(lowest, rows[row][x]);
+            }
+        }
+        const bool hit = (value > 0 && value >= highest) || (value < 0 && value <= lowest);
+        hits |= uint64_t(hit) << i;
+    }
+    return hits;
+}
+
+void gradientPolarScalar(const float* dx, const float* dy, float* magnitude, float* degrees, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const float x = dx[i], y = dy[i];
+        const float ax = std::abs(x), ay = std::abs(y);
+        const float c = std::min(ax, ay) / (std::max(ax, ay) + kAtan2Epsilon), c2 = c * c;
+        float a = (((kAtan2P7 * c2 + kAtan2P5) * c2 + kAtan2P3) * c2 + kAtan2P1) * c;
+        if (ax < ay) a = 90.f - a;
+        if (x < 0) a = 180.f - a;
+        if (y < 0) a = 360.f - a;
+        degrees[i] = a;
+        magnitude[i] = std::sqrt(x * x + y * y);
+    }
+}
+
+#if LAR_SIFT_KERNEL_AVX2
+// Every kernel clears the upper register halves itself before returning; compilers don't on
+// every path, and the SSE code that runs between calls (orientations, descriptors) slows
+// down several times over while they are dirty.
+__attribute__((target("avx2")))
+void blurRowAVX2(const float* src, float* dst, size_t width, const float* kernel, size_t radius) {
+    size_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256 sum = _mm256_mul_ps(_mm256_set1_ps(kernel[0]), _mm256_loadu_ps(src + x));
+        for (size_t t = 1; t <= radius; t++) {
+            const __m256 pair = _mm256_add_ps(_mm256_loadu_ps(src + x - t), _mm256_loadu_ps(src + x + t));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(kernel[t]), pair));
+        }
+        _mm256_storeu_ps(dst + x, sum);
+    }
+    _mm256_zeroupper();
+    if (x < width) blurRowScalar(src + x, dst + x, width - x, kernel, radius);
+}
+
+__attribute__((target("avx2")))
+void blurColumnsAVX2(const float* const* rows, const float* kernel, size_t radius, size_t width,
+                     const float* previous, float* gaussian, float* difference) {
+    size_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256 sum = _mm256_mul_ps(_mm256_set1_ps(kernel[0]), _mm256_loadu_ps(rows[radius] + x));
+        for (size_t t = 1; t <= radius; t++) {
+            const __m256 pair = _mm256_add_ps(_mm256_loadu_ps(rows[radius - t] + x), _mm256_loadu_ps(rows[radius + t] + x));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(kernel[t]), pair));
+        }
+        _mm256_storeu_ps(gaussian + x, sum);
+        if (difference) _mm256_storeu_ps(difference + x, _mm256_sub_ps(sum, _mm256_loadu_ps(previous + x)));
+    }
+    _mm256_zeroupper();
+    blurColumnRange(rows, kernel, radius, x, width, previous, gaussian, difference);
+}
+
+// Running maximum and minimum over the rows in [first_row, last_row] at offsets -1, 0 and +1.
+__attribute__((target("avx2")))
+inline void extendAVX2(const float* const* rows, int first_row, int last_row, size_t c, __m256& highest, __m256& lowest) {
+    for (int row = first_row; row <= last_row; row++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (row == kCenterRow && dx == 0) continue;
+            const __m256 neighbor = _mm256_loadu_ps(rows[row] + c + dx);
+            highest = _mm256_max_ps(highest, neighbor);
+            lowest = _mm256_min_ps(lowest, neighbor);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+inline __m256 extremaAVX2(__m256 value, __m256 strong, __m256 highest, __m256 lowest) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxima = _mm256_and_ps(_mm256_cmp_ps(value, zero, _CMP_GT_OQ), _mm256_cmp_ps(value, highest, _CMP_GE_OQ));
+    const __m256 minima = _mm256_and_ps(_mm256_cmp_ps(value, zero, _CMP_LT_OQ), _mm256_cmp_ps(value, lowest, _CMP_LE_OQ));
+    return _mm256_and_ps(strong, _mm256_or_ps(maxima, minima));
+}
+
+__attribute__((target("avx2")))
+uint64_t findExtremaAVX2(const float* const* rows, size_t first, size_t count, float threshold) {
+    const __m256 limit = _mm256_set1_ps(threshold);
+    const __m256 sign = _mm256_set1_ps(-0.f);
+    uint64_t hits = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const size_t c = first + i;
+        const __m256 value = _mm256_loadu_ps(rows[kCenterRow] + c);
+        const __m256 strong = _mm256_cmp_ps(_mm256_andnot_ps(sign, value), limit, _CMP_GT_OQ);
+        if (!_mm256_movemask_ps(strong)) continue;
+        __m256 highest = _mm256_set1_ps(-INFINITY), lowest = _mm256_set1_ps(INFINITY);
+        extendAVX2(rows, kCenterRow - 1, kCenterRow + 1, c, highest, lowest);
+        if (!_mm256_movemask_ps(extremaAVX2(value, strong, highest, lowest))) continue;
+        extendAVX2(rows, 0, kCenterRow - 2, c, highest, lowest);
+        extendAVX2(rows, kCenterRow + 2, 8, c, highest, lowest);
+        hits |= uint64_t(uint32_t(_mm256_movemask_ps(extremaAVX2(value, strong, highest, lowest)))) << i;
+    }
+    _mm256_zeroupper();
+    if (i < count) hits |= findExtremaScalar(rows, first + i, count - i, threshold) << i;
+    return hits;
+}
+
+__attribute__((target("avx2")))
+void gradientPolarAVX2(const float* dx, const float* dy, float* magnitude, float* degrees, size_t count) {
+    const __m256 sign = _mm256_set1_ps(-0.f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 epsilon = _mm256_set1_ps(kAtan2Epsilon);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 x = _mm256_loadu_ps(dx + i), y = _mm256_loadu_ps(dy + i);
+        const __m256 ax = _mm256_andnot_ps(sign, x), ay = _mm256_andnot_ps(sign, y);
+        const __m256 c = _mm256_div_ps(_mm256_min_ps(ax, ay), _mm256_add_ps(_mm256_max_ps(ax, ay), epsilon));
+        const __m256 c2 = _mm256_mul_ps(c, c);
+        __m256 a = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kAtan2P7), c2), _mm256_set1_ps(kAtan2P5));
+        a = _mm256_add_ps(_mm256_mul_ps(a, c2), _mm256_set1_ps(kAtan2P3));
+        a = _mm256_add_ps(_mm256_mul_ps(a, c2), _mm256_set1_ps(kAtan2P1));
+        a = _mm256_mul_ps(a, c);
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps(90.f), a), _mm256_cmp_ps(ax, ay, _CMP_LT_OQ));
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps(180.f), a), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_mm256_set1_ps(360.f), a), _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+        _mm256_storeu_ps(degrees + i, a);
+        _mm256_storeu_ps(magnitude + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y))));
+    }
+    _mm256_zeroupper();
+    if (i < count) gradientPolarScalar(dx + i, dy + i, magnitude + i, degrees + i, count - i);
+}
+
+bool supportsAVX2() {
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#if LAR_SIFT_KERNEL_NEON
+void blurRowNEON(const float* src, float* dst, size_t width, const float* kernel, size_t radius) {
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        float32x4_t sum = vmulq_n_f32(vld1q_f32(src + x), kernel[0]);
+        for (size_t t = 1; t <= radius; t++) {
+            const float32x4_t pair = vaddq_f32(vld1q_f32(src + x - t), vld1q_f32(src + x + t));
+            sum = vaddq_f32(sum, vmulq_n_f32(pair, kernel[t]));
+        }
+        vst1q_f32(dst + x, sum);
+    }
+    if (x < width) blurRowScalar(src + x, dst + x, width - x, kernel, radius);
+}
+
+void blurColumnsNEON(const float* const* rows, const float* kernel, size_t radius, size_t width,
+                     const float* previous, float* gaussian, float* difference) {
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        float32x4_t sum = vmulq_n_f32(vld1q_f32(rows[radius] + x), kernel[0]);
+        for (size_t t = 1; t <= radius; t++) {
+            const float32x4_t pair = vaddq_f32(vld1q_f32(rows[radius - t] + x), vld1q_f32(rows[radius + t] + x));
+            sum = vaddq_f32(sum, vmulq_n_f32(pair, kernel[t]));
+        }
+        vst1q_f32(gaussian + x, sum);
+        if (difference) vst1q_f32(difference + x, vsubq_f32(sum, vld1q_f32(previous + x)));
+    }
+    blurColumnRange(rows, kernel, radius, x, width, previous, gaussian, difference);
+}
+
+inline void extendNEON(const float* const* rows, int first_row, int last_row, size_t c, float32x4_t& highest, float32x4_t& lowest) {
+    for (int row = first_row; row <= last_row; row++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (row == kCenterRow && dx == 0) continue;
+            const float32x4_t neighbor = vld1q_f32(rows[row] + c + dx);
+            highest = vmaxq_f32(highest, neighbor);
+            lowest = vminq_f32(lowest, neighbor);
+        }
+    }
+}
+
+inline uint32x4_t extremaNEON(float32x4_t value, uint32x4_t strong, float32x4_t highest, float32x4_t lowest) {
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const uint32x4_t maxima = vandq_u32(vcgtq_f32(value, zero), vcgeq_f32(value, highest));
+    const uint32x4_t minima = vandq_u32(vcltq_f32(value, zero), vcleq_f32(value, lowest));
+    return vandq_u32(strong, vorrq_u32(maxima, minima));
+}
+
+uint64_t findExtremaNEON(const float* const* rows, size_t first, size_t count, float threshold) {
+    const float32x4_t limit = vdupq_n_f32(threshold);
+    const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t bits = vld1q_u32(lane_bits);
+    uint64_t hits = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const size_t c = first + i;
+        const float32x4_t value = vld1q_f32(rows[kCenterRow] + c);
+        const uint32x4_t strong = vcgtq_f32(vabsq_f32(value), limit);
+        if (!vmaxvq_u32(strong)) continue;
+        float32x4_t highest = vdupq_n_f32(-INFINITY), lowest = vdupq_n_f32(INFINITY);
+        extendNEON(rows, kCenterRow - 1, kCenterRow + 1, c, highest, lowest);
+        if (!vmaxvq_u32(extremaNEON(value, strong, highest, lowest))) continue;
+        extendNEON(rows, 0, kCenterRow - 2, c, highest, lowest);
+        extendNEON(rows, kCenterRow + 2, 8, c, highest, lowest);
+        hits |= uint64_t(vaddvq_u32(vandq_u32(extremaNEON(value, strong, highest, lowest), bits))) << i;
+    }
+    if (i < count) hits |= findExtremaScalar(rows, first + i, count - i, threshold) << i;
+    return hits;
+}
+
+void gradientPolarNEON(const float* dx, const float* dy, float* magnitude, float* degrees, size_t count) {
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const float32x4_t epsilon = vdupq_n_f32(kAtan2Epsilon);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t x = vld1q_f32(dx + i), y = vld1q_f32(dy + i);
+        const float32x4_t ax = vabsq_f32(x), ay = vabsq_f32(y);
+        const float32x4_t c = vdivq_f32(vminq_f32(ax, ay), vaddq_f32(vmaxq_f32(ax, ay), epsilon));
+        const float32x4_t c2 = vmulq_f32(c, c);
+        float32x4_t a = vaddq_f32(vmulq_n_f32(c2, kAtan2P7), vdupq_n_f32(kAtan2P5));
+        a = vaddq_f32(vmulq_f32(a, c2), vdupq_n_f32(kAtan2P3));
+        a = vaddq_f32(vmulq_f32(a, c2), vdupq_n_f32(kAtan2P1));
+        a = vmulq_f32(a, c);
+        a = vbslq_f32(vcltq_f32(ax, ay), vsubq_f32(vdupq_n_f32(90.f), a), a);
+        a = vbslq_f32(vcltq_f32(x, zero), vsubq_f32(vdupq_n_f32(180.f), a), a);
+        a = vbslq_f32(vcltq_f32(y, zero), vsubq_f32(vdupq_n_f32(360.f), a), a);
+        vst1q_f32(degrees + i, a);
+        vst1q_f32(magnitude + i, vsqrtq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y))));
+    }
+    if (i < count) gradientPolarScalar(dx + i, dy + i, magnitude + i, degrees + i, count - i);
+}
+#endif
+
+const Kernels* kernelsFor(SiftKernel kernel) {
+    static const Kernels scalar{ blurRowScalar, blurColumnsScalar, findExtremaScalar, gradientPolarScalar };
+#if LAR_SIFT_KERNEL_AVX2
+    static const Kernels avx2{ blurRowAVX2, blurColumnsAVX2, findExtremaAVX2, gradientPolarAVX2 };
+#endif
+#if LAR_SIFT_KERNEL_NEON
+    static const Kernels neon{ blurRowNEON, blurColumnsNEON, findExtremaNEON, gradientPolarNEON };
+#endif
+    switch (kernel) {
+#if LAR_SIFT_KERNEL_AVX2
+        case SiftKernel::AVX2: return supportsAVX2() ? &avx2 : nullptr;
+#endif
+#if LAR_SIFT_KERNEL_NEON
+        case SiftKernel::NEON: return &neon;
+#endif
+        case SiftKernel::Scalar: return &scalar;
+        default: return nullptr;
+    }
+}
+
+SiftKernel detect() {
+    for (SiftKernel kernel : { SiftKernel::NEON, SiftKernel::AVX2 }) {
+        if (kernelsFor(kernel)) return kernel;
+    }
+    return SiftKernel::Scalar;
+}
+
+std::atomic<SiftKernel> g_active{ detect() };
+std::atomic<const Kernels*> g_kernels{ kernelsFor(g_active.load()) };
+
+} // namespace
+
+void blurRow(const float* src, float* dst, size_t width, const float* kernel, size_t radius) {
+    g_kernels.load(std::memory_order_relaxed)->blur_row(src, dst, width, kernel, radius);
+}
+
+void blurColumns(const float* const* rows, const float* kernel, size_t radius, size_t width,
+                 const float* previous, float* gaussian, float* difference) {
+    g_kernels.load(std::memory_order_relaxed)->blur_columns(rows, kernel, radius, width, previous, gaussian, difference);
+}
+
+uint64_t findExtrema(const float* const* rows, size_t first, size_t count, float threshold) {
+    return g_kernels.load(std::memory_order_relaxed)->find_extrema(rows, first, count, threshold);
+}
+
+void gradientPolar(const float* dx, const float* dy, float* magnitude, float* degrees, size_t count) {
+    g_kernels.load(std::memory_order_relaxed)->gradient_polar(dx, dy, magnitude, degrees, count);
+}
+
+SiftKernel activeSiftKernel() {
+    return g_active.load();
+}
+
+SiftKernel useSiftKernel(SiftKernel kernel) {
+    if (const Kernels* kernels = kernelsFor(kernel)) {
+        g_kernels.store(kernels);
+        g_active.store(kernel);
+    }
+    return g_active.load();
+}
+
+const char* siftKernelName(SiftKernel kernel) {
+    switch (kernel) {
+        case SiftKernel::AVX2: return "AVX2";
+        case SiftKernel::NEON: return "NEON";
+        default: return "scalar";
+    }
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,49 @@
+//
+//  sift_kernels.h
+//  LocalizeAR
+//
+//  Inner loops of the CPU SIFT: the two passes of a separable Gaussian blur, the second of
+//  which also writes the difference of Gaussians, the 26-neighbor extremum test, and the
+//  gradient magnitudes and orientations that orientation histograms and descriptors are
+//  built from.
+//
+//  As for box_kernels.h, the kernel is chosen once at startup: NEON on arm64, AVX2 on x86-64
+//  CPUs that support it, and a scalar loop otherwise. Every kernel computes in the same order
+//  but they may round differently where a compiler fuses multiply-adds.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lar::bridge {
+
+enum class SiftKernel { Scalar, AVX2, NEON };
+
+// dst[x] = kernel[0] * src[x] + sum over t in 1...radius of kernel[t] * (src[x - t] + src[x + t])
+// for x in [0, width). `src` is read from src[-radius] to src[width + radius - 1]; the caller
+// pads the borders.
+void blurRow(const float* src, float* dst, size_t width, const float* kernel, size_t radius);
+
+// The same sum down a column, with rows[radius + t] the row at offset t. Also writes
+// difference[x] = gaussian[x] - previous[x] if `difference` is set.
+void blurColumns(const float* const* rows, const float* kernel, size_t radius, size_t width,
+                 const float* previous, float* gaussian, float* difference);
+
+// Sets bit i of the result if pixel `first + i` of the middle row of the middle layer is a
+// scale-space extremum: its magnitude is above `threshold` and it is at least as large as all
+// 26 neighbors if positive, at most as large if negative. `rows` holds the rows above, at and
+// below it in the layer below, the layer itself and the layer above, in that order. `count`
+// must be at most 64 and `first` at least 1.
+uint64_t findExtrema(const float* const* rows, size_t first, size_t count, float threshold);
+
+// magnitude[i] = |(dx[i], dy[i])| and degrees[i] = cv::fastAtan2(dy[i], dx[i]), in [0, 360).
+void gradientPolar(const float* dx, const float* dy, float* magnitude, float* degrees, size_t count);
+
+SiftKernel activeSiftKernel();
+// Switches to `kernel` if this CPU supports it and returns the kernel now in use.
+SiftKernel useSiftKernel(SiftKernel kernel);
+const char* siftKernelName(SiftKernel kernel);
+
+} // namespace lar::bridge
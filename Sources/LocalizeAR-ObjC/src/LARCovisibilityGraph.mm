@@ -0,0 +1,93 @@
+//
+//  LARCovisibilityGraph.mm
+//  LocalizeAR
+//
+
+#import <algorithm>
+#import <limits>
+#import <memory>
+#import <vector>
+
+#import "Spatial/covisibility_graph.h"
+#import "Spatial/landmark_index.h"
+#import "LARCovisibilityGraph.h"
+
+@implementation LARCovisibilityGraph {
+    std::shared_ptr<const lar::bridge::LandmarkIndex> _index;
+    std::unique_ptr<lar::bridge::CovisibilityGraph> _graph;
+}
+
+- (nullable instancetype)initWithMap:(LARMap*)map frames:(NSArray<LARFrame*>*)frames {
+    if (self = [super init]) {
+        _map = map;
+        std::vector<lar::bridge::CovisibilityGraph::View> views;
+        views.reserve(frames.count);
+        double min_x = std::numeric_limits<double>::max(), max_x = std::numeric_limits<double>::lowest();
+        double min_z = min_x, max_z = max_x;
+        for (LARFrame* frame in frames) {
+            const lar::Frame& internal = *frame->_internal;
+            lar::bridge::CovisibilityGraph::View view{ lar::bridge::CovisibilityGraph::Transform(internal.extrinsics), internal.intrinsics };
+            const Eigen::Vector3d camera = view.camera_to_map.translation();
+            min_x = std::min(min_x, camera.x());
+            max_x = std::max(max_x, camera.x());
+            min_z = std::min(min_z, camera.z());
+            max_z = std::max(max_z, camera.z());
+            views.push_back(view);
+        }
+
+        // Index every landmark any frame could see.
+        const lar::bridge::CovisibilityGraph::Options options;
+        const double reach = 2 * options.frustum.far_distance;
+        const LARSpatialQuery region = views.empty() ? LARSpatialQuery{ 0, 0, 0 }
+            : LARSpatialQuery{ (min_x + max_x) / 2, (min_z + max_z) / 2, std::max(max_x - min_x, max_z - min_z) + reach };
+        _index = [map landmarkIndexForQuery:region];
+        if (!_index) {
+            NSLog(@"Error building covisibility graph: the map has no landmark index");
+            return nil;
+        }
+        try {
+            _graph = std::make_unique<lar::bridge::CovisibilityGraph>(*_index, views, options);
+        } catch (const std::exception& e) {
+            NSLog(@"Error building covisibility graph: %s", e.what());
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (NSInteger)keyframeCount {
+    return (NSInteger)_graph->keyframeCount();
+}
+
+- (NSInteger)visibilityCount {
+    return (NSInteger)_graph->visibilityCount();
+}
+
+- (NSInteger)linkCount {
+    return (NSInteger)_graph->linkCount();
+}
+
+- (uint64_t)memoryBytes {
+    return _graph->memoryBytes();
+}
+
+- (NSArray<LARLandmark*>*)landmarksCovisibleWith:(NSArray<NSNumber*>*)landmarkIds keyframeLimit:(NSInteger)keyframeLimit {
+    std::vector<uint32_t> seeds;
+    seeds.reserve(landmarkIds.count);
+    for (NSNumber* landmarkId in landmarkIds) {
+        const int64_t item = _graph->item((size_t)landmarkId.longLongValue);
+        if (item >= 0) seeds.push_back((uint32_t)item);
+    }
+    const std::vector<uint32_t> items = _graph->expand(seeds, (size_t)std::max<NSInteger>(keyframeLimit, 0));
+    NSMutableArray<LARLandmark*>* landmarks = [NSMutableArray arrayWithCapacity:items.size()];
+    for (uint32_t item : items) {
+        [landmarks addObject:[[LARLandmark alloc] initWithInternal:_index->landmark(item) owner:_index]];
+    }
+    return [landmarks copy];
+}
+
+- (void)scoreLandmarks {
+    [_map scoreLandmarksOfIndex:_index viewSpread:_graph->viewSpread()];
+}
+
+@end
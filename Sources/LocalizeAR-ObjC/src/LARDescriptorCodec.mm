@@ -0,0 +1,236 @@
+//
+//  LARDescriptorCodec.mm
+//  LocalizeAR
+//
+
+#import <algorithm>
+#import <cstring>
+#import <memory>
+#import <optional>
+#import <vector>
+#import <opencv2/features.hpp>
+
+#import "Matching/descriptor_codec.h"
+#import "Matching/descriptor_recall.h"
+#import "Storage/map_archive.h"
+#import "LARDescriptorCodec.h"
+
+
+@interface LARDescriptorCodec () {
+@public
+    std::optional<lar::bridge::DescriptorCodec> _internal;
+}
+@end
+
+namespace {
+
+// `descriptor` as floats, from one byte or one float per dimension.
+std::vector<float> floatsFrom(NSData* descriptor, int dims) {
+    std::vector<float> values(size_t(dims));
+    if (descriptor.length == size_t(dims)) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(descriptor.bytes);
+        std::copy(bytes, bytes + dims, values.begin());
+    } else if (descriptor.length == size_t(dims) * sizeof(float)) {
+        std::memcpy(values.data(), descriptor.bytes, descriptor.length);
+    } else {
+        throw std::invalid_argument("Descriptor length doesn't match the codec");
+    }
+    return values;
+}
+
+} // namespace
+
+@implementation LARDescriptorCodec {
+    NSInteger _descriptorSize;
+}
+
+- (nullable instancetype)initWithMap:(LARMap*)map kind:(LARDescriptorCodecKind)kind subspaces:(NSInteger)subspaces {
+    if (self = [super init]) {
+        [map materializeAllLandmarks];
+        std::vector<cv::Mat> rows;
+        for (lar::Landmark* landmark : map->_internal->landmarks.all()) {
+            if (!landmark->desc.empty()) rows.push_back(landmark->desc.reshape(1, 1));
+        }
+        try {
+            if (rows.empty()) {
+                throw std::invalid_argument("Map has no landmark descriptors");
+            }
+            cv::Mat samples;
+            cv::vconcat(rows, samples);
+            _descriptorSize = (NSInteger)(samples.cols * samples.elemSize());
+            if (kind == LARDescriptorCodecKindProduct) {
+                _internal = lar::bridge::DescriptorCodec::trainProduct(samples, (int)subspaces);
+            } else {
+                _internal = lar::bridge::DescriptorCodec::trainScalar8(samples);
+            }
+        } catch (const std::exception& e) {
+            NSLog(@"Error training descriptor codec: %s", e.what());
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (nullable instancetype)initWithSerializedCodebook:(NSData*)data {
+    if (self = [super init]) {
+        try {
+            _internal = lar::bridge::DescriptorCodec::deserialize(static_cast<const uint8_t*>(data.bytes), data.length);
+        } catch (const std::exception& e) {
+            NSLog(@"Error reading descriptor codebook: %s", e.what());
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (NSData*)serializedCodebook {
+    const std::vector<uint8_t> codebook = _internal->serialize();
+    return [NSData dataWithBytes:codebook.data() length:codebook.size()];
+}
+
+- (nullable NSData*)encodeDescriptor:(NSData*)descriptor {
+    try {
+        const std::vector<float> values = floatsFrom(descriptor, _internal->dims());
+        NSMutableData* code = [NSMutableData dataWithLength:_internal->codeSize()];
+        _internal->encode(values.data(), static_cast<uint8_t*>(code.mutableBytes));
+        return code;
+    } catch (const std::exception& e) {
+        NSLog(@"Error encoding descriptor: %s", e.what());
+        return nil;
+    }
+}
+
+- (nullable NSData*)decodeCode:(NSData*)code {
+    if (code.length != _internal->codeSize()) {
+        NSLog(@"Error decoding descriptor: code length doesn't match the codec");
+        return nil;
+    }
+    NSMutableData* descriptor = [NSMutableData dataWithLength:size_t(_internal->dims()) * sizeof(float)];
+    _internal->decode(static_cast<const uint8_t*>(code.bytes), static_cast<float*>(descriptor.mutableBytes));
+    return descriptor;
+}
+
++ (nullable NSArray<NSNumber*>*)nearestLandmarksTo:(NSData*)descriptor inArchiveAt:(NSString*)filepath count:(NSInteger)count rerank:(NSInteger)rerank rows:(nullable NSArray<NSNumber*>*)rows {
+    try {
+        // Declared first, since the index aliases the archive's mapping.
+        const lar::bridge::MapArchive archive([filepath UTF8String]);
+        const auto index = archive.descriptorIndex();
+        if (!index) {
+            throw std::runtime_error("Map archive has no descriptor codes");
+        }
+        const std::vector<float> query = floatsFrom(descriptor, index->codec().dims());
+        std::vector<uint32_t> candidates;
+        candidates.reserve(rows.count);
+        for (NSNumber* row in rows) candidates.push_back(row.unsignedIntValue);
+
+        NSMutableArray<NSNumber*>* ids = [NSMutableArray array];
+        for (const auto& match : index->search(query.data(), (size_t)std::max<NSInteger>(count, 0),
+                                               (size_t)std::max<NSInteger>(rerank, 0), candidates)) {
+            [ids addObject:@(archive.ids()[match.index])];
+        }
+        return [ids copy];
+    } catch (const std::exception& e) {
+        NSLog(@"Error searching descriptor codes: %s", e.what());
+        return nil;
+    }
+}
+
+- (LARDescriptorCodecKind)kind {
+    return _internal->kind() == lar::bridge::DescriptorCodecKind::Product ? LARDescriptorCodecKindProduct : LARDescriptorCodecKindScalar8;
+}
+
+- (NSInteger)subspaces {
+    return _internal->subspaces();
+}
+
+- (NSInteger)codeSize {
+    return (NSInteger)_internal->codeSize();
+}
+
+- (NSInteger)descriptorSize {
+    return _descriptorSize;
+}
+
+- (double)compressionRatio {
+    return (double)_descriptorSize / (double)_internal->codeSize();
+}
+
+- (BOOL)writeArchiveOfMap:(LARMap*)map to:(NSString*)filepath {
+    try {
+        lar::bridge::MapArchive::write(*map->_internal, [filepath UTF8String], &*_internal);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing map archive: %s", e.what());
+        return NO;
+    }
+}
+
+@end
+
+
+@implementation LARDescriptorRecallEvaluator {
+    std::unique_ptr<lar::bridge::DescriptorRecallEvaluator> _evaluator;
+    cv::Ptr<cv::SIFT> _sift;
+}
+
+- (nullable instancetype)initWithMap:(LARMap*)map codec:(LARDescriptorCodec*)codec rerankDepth:(NSInteger)rerankDepth {
+    if (self = [super init]) {
+        [map materializeAllLandmarks];
+        try {
+            _evaluator = std::make_unique<lar::bridge::DescriptorRecallEvaluator>(*map->_internal, *codec->_internal, (size_t)rerankDepth);
+        } catch (const std::exception& e) {
+            NSLog(@"Error preparing descriptor recall evaluation: %s", e.what());
+            return nil;
+        }
+        _codec = codec;
+        _rerankDepth = rerankDepth;
+        // Query descriptors in the same element type as the map's, so distances are comparable.
+        const int type = CV_MAT_DEPTH(_evaluator->descriptorType()) == CV_8U ? CV_8U : CV_32F;
+        _sift = cv::SIFT::create(0, 3, 0.04, 10, 1.6, type);
+    }
+    return self;
+}
+
+- (void)evaluateImage:(LARImage)image query:(LARSpatialQuery)query {
+    cv::Mat gray(image.height, image.width, CV_8UC1, const_cast<void*>(image.data), (size_t)image.bytesPerRow);
+    std::vector<cv::KeyPoint> keypoints;
+    cv::Mat descriptors;
+    _sift->detectAndCompute(gray, cv::noArray(), keypoints, descriptors);
+    _evaluator->evaluate(descriptors, query.x, query.z, query.diameter);
+}
+
+- (NSInteger)queryCount {
+    return (NSInteger)_evaluator->result().queries;
+}
+
+- (double)approximateRecall {
+    const auto& result = _evaluator->result();
+    return result.queries ? (double)result.approximate_hits / result.queries : 0;
+}
+
+- (double)rerankedRecall {
+    const auto& result = _evaluator->result();
+    return result.queries ? (double)result.reranked_hits / result.queries : 0;
+}
+
+- (double)exactMatchSeconds {
+    return _evaluator->result().exact_seconds;
+}
+
+- (double)approximateMatchSeconds {
+    return _evaluator->result().approximate_seconds;
+}
+
+- (double)rerankedMatchSeconds {
+    return _evaluator->result().reranked_seconds;
+}
+
+- (uint64_t)exactBytes {
+    return _evaluator->exactBytes();
+}
+
+- (uint64_t)compressedBytes {
+    return _evaluator->compressedBytes();
+}
+
+@end
@@ -138,6 +138,9 @@
     // that touches the base tracker's CV state. Per-frame ops run concurrently — they don't
     // use this queue.
     dispatch_sync(_measurementQueue, ^{
+        // Tiled maps page in the landmarks this query can see (no-op otherwise).
+        [_map prepareForQuery:query];
+
         // cv::Mat wrapping now happens inside lar::FilteredTracker::measurementUpdate (the
         // struct overload), so the bridge just forwards the plain-C structs.
         lar::FilteredTracker::MeasurementResult result = _internal->measurementUpdate(
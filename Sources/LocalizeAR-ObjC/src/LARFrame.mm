@@ -12,6 +12,7 @@
 #import "lar/mapping/frame.h"
 
 
+#import "Storage/frame_index.h"
 #import "LARFrame.h"
 #import "Helpers/LARConversion.h"
 
@@ -84,6 +85,18 @@
         // Convert NSString path to std::string
         std::string filepath = [path UTF8String];
 
+        // Binary frame indexes are read in place, without a JSON parse.
+        if (lar::bridge::FrameIndex::isFrameIndex(filepath)) {
+            lar::bridge::FrameIndex index(filepath);
+            NSMutableArray<LARFrame*>* result = [NSMutableArray arrayWithCapacity:index.size()];
+            for (size_t i = 0; i < index.size(); i++) {
+                LARFrame* objcFrame = [[LARFrame alloc] init];
+                index.copyTo(i, *objcFrame->_internal);
+                [result addObject:objcFrame];
+            }
+            return [result copy];
+        }
+
         // Open and parse JSON file
         std::ifstream file(filepath);
         if (!file.is_open()) {
@@ -0,0 +1,123 @@
+//
+//  LARFrameIndex.mm
+//  LocalizeAR
+//
+
+#import <algorithm>
+#import <memory>
+#import <vector>
+#import "lar/mapping/frame.h"
+
+#import "Storage/frame_index.h"
+#import "LARFrameIndex.h"
+
+
+@implementation LARFrameIndex {
+    std::unique_ptr<lar::bridge::FrameIndex> _index;
+}
+
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath {
+    if (self = [super init]) {
+        try {
+            _index = std::make_unique<lar::bridge::FrameIndex>([filepath UTF8String]);
+        } catch (const std::exception& e) {
+            NSLog(@"Error opening frame index: %s", e.what());
+            return nil;
+        }
+    }
+    return self;
+}
+
++ (BOOL)isFrameIndex:(NSString*)filepath {
+    return lar::bridge::FrameIndex::isFrameIndex([filepath UTF8String]);
+}
+
++ (BOOL)convertJSON:(NSString*)jsonPath to:(NSString*)indexPath {
+    try {
+        lar::bridge::FrameIndex::convertFromJson([jsonPath UTF8String], [indexPath UTF8String]);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error converting frames to a frame index: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)writeJSONTo:(NSString*)jsonPath {
+    try {
+        _index->writeJson([jsonPath UTF8String]);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing frames JSON: %s", e.what());
+        return NO;
+    }
+}
+
++ (BOOL)writeFrames:(NSArray<LARFrame*>*)frames to:(NSString*)indexPath {
+    std::vector<lar::Frame> internal;
+    internal.reserve(frames.count);
+    for (LARFrame* frame in frames) internal.push_back(*frame->_internal);
+    try {
+        lar::bridge::FrameIndex::write(internal, [indexPath UTF8String]);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing frame index: %s", e.what());
+        return NO;
+    }
+}
+
+- (NSInteger)count {
+    return (NSInteger)_index->size();
+}
+
+- (const lar::bridge::frames::FrameRecord*)recordAtIndex:(NSInteger)index {
+    if (index < 0 || (size_t)index >= _index->size()) {
+        [NSException raise:NSRangeException format:@"Frame index %ld out of range [0, %zu)", (long)index, _index->size()];
+    }
+    return &(*_index)[(size_t)index];
+}
+
+- (NSInteger)frameIdAtIndex:(NSInteger)index {
+    return (NSInteger)[self recordAtIndex:index]->id;
+}
+
+- (NSInteger)timestampAtIndex:(NSInteger)index {
+    return (NSInteger)[self recordAtIndex:index]->timestamp;
+}
+
+- (simd_float3x3)intrinsicsAtIndex:(NSInteger)index {
+    const double* m = [self recordAtIndex:index]->intrinsics;
+    return simd_matrix(
+        (simd_float3){ (float)m[0], (float)m[1], (float)m[2] },
+        (simd_float3){ (float)m[3], (float)m[4], (float)m[5] },
+        (simd_float3){ (float)m[6], (float)m[7], (float)m[8] }
+    );
+}
+
+- (simd_float4x4)extrinsicsAtIndex:(NSInteger)index {
+    const double* m = [self recordAtIndex:index]->extrinsics;
+    return simd_matrix(
+        (simd_float4){ (float)m[0], (float)m[1], (float)m[2], (float)m[3] },
+        (simd_float4){ (float)m[4], (float)m[5], (float)m[6], (float)m[7] },
+        (simd_float4){ (float)m[8], (float)m[9], (float)m[10], (float)m[11] },
+        (simd_float4){ (float)m[12], (float)m[13], (float)m[14], (float)m[15] }
+    );
+}
+
+- (LARFrame*)frameAtIndex:(NSInteger)index {
+    [self recordAtIndex:index];
+    LARFrame* frame = [[LARFrame alloc] init];
+    _index->copyTo((size_t)index, *frame->_internal);
+    return frame;
+}
+
+- (NSArray<LARFrame*>*)framesInRange:(NSRange)range {
+    const size_t first = std::min<size_t>(range.location, _index->size());
+    const size_t last = std::min<size_t>(first + range.length, _index->size());
+    NSMutableArray<LARFrame*>* frames = [NSMutableArray arrayWithCapacity:last - first];
+    for (size_t i = first; i < last; i++) {
+        [frames addObject:[self frameAtIndex:(NSInteger)i]];
+    }
+    return [frames copy];
+}
+
+@end
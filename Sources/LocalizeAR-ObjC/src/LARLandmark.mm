@@ -13,7 +13,9 @@
 
 @end
 
-@implementation LARLandmark
+@implementation LARLandmark {
+    std::shared_ptr<const void> _owner;
+}
 
 - (id)initWithInternal:(lar::Landmark*)landmark {
     self = [super init];
@@ -21,6 +23,12 @@
     return self;
 }
 
+- (id)initWithInternal:(lar::Landmark*)landmark owner:(std::shared_ptr<const void>)owner {
+    self = [self initWithInternal:landmark];
+    self->_owner = std::move(owner);
+    return self;
+}
+
 - (void)dealloc {
 //    delete self->_internal;
 }
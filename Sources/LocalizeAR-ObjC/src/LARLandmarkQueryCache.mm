@@ -0,0 +1,92 @@
+//
+//  LARLandmarkQueryCache.mm
+//  LocalizeAR
+//
+
+#import <memory>
+#import <vector>
+
+#import "Spatial/incremental_query.h"
+#import "Spatial/landmark_index.h"
+#import "LARLandmarkQueryCache.h"
+
+
+@implementation LARLandmarkQueryCache {
+    std::shared_ptr<const lar::bridge::LandmarkIndex> _index;
+    std::unique_ptr<lar::bridge::IncrementalQuery> _query;
+    // Empty while the map has no landmarks to query (a map being built before its first publish).
+    NSArray<LARLandmark*>* _scanned;
+    NSArray<LARLandmark*>* _added;
+    NSArray<LARLandmark*>* _removed;
+}
+
+- (instancetype)initWithMap:(LARMap*)map {
+    if (self = [super init]) {
+        _map = map;
+        _scanned = @[];
+        _added = @[];
+        _removed = @[];
+    }
+    return self;
+}
+
+- (BOOL)updateForQuery:(LARSpatialQuery)query {
+    const auto index = [_map landmarkIndexForQuery:query];
+    if (!index) {
+        _index = nullptr;
+        _query = nullptr;
+        _scanned = @[];
+        _added = _scanned;
+        _removed = @[];
+        _lastUpdateWasIncremental = NO;
+        _fullUpdateCount++;
+        return NO;
+    }
+    if (index != _index) {
+        // The landmark database was rebuilt or republished; the previous items point into the old one.
+        _index = index;
+        _query = std::make_unique<lar::bridge::IncrementalQuery>(_index->tree());
+    }
+    _scanned = nil;
+
+    const bool incremental = _query->update(lar::bridge::PackedRTree::Box::around(query.x, query.z, query.diameter));
+    _added = [self landmarksForItems:_query->added()];
+    _removed = incremental ? [self landmarksForItems:_query->removed()] : @[];
+    _lastUpdateWasIncremental = incremental;
+    if (incremental) {
+        _incrementalUpdateCount++;
+    } else {
+        _fullUpdateCount++;
+    }
+    return incremental;
+}
+
+- (void)reset {
+    if (_query) _query->reset();
+}
+
+- (NSArray<LARLandmark*>*)landmarks {
+    return _query ? [self landmarksForItems:_query->items()] : _scanned;
+}
+
+- (NSInteger)landmarkCount {
+    return _query ? (NSInteger)_query->items().size() : (NSInteger)_scanned.count;
+}
+
+- (NSArray<LARLandmark*>*)addedLandmarks {
+    return _added;
+}
+
+- (NSArray<LARLandmark*>*)removedLandmarks {
+    return _removed;
+}
+
+- (NSArray<LARLandmark*>*)landmarksForItems:(const std::vector<uint32_t>&)items {
+    NSMutableArray<LARLandmark*>* landmarks = [NSMutableArray arrayWithCapacity:items.size()];
+    for (uint32_t item : items) {
+        [landmarks addObject:[[LARLandmark alloc] initWithInternal:_index->landmark(item) owner:_index]];
+    }
+    return landmarks;
+}
+
+@end
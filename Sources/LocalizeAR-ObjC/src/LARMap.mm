@@ -7,9 +7,30 @@
 
 #import <iostream>
 #import <fstream>
+#import <algorithm>
+#import <atomic>
+#import <cstring>
+#import <functional>
+#import <limits>
+#import <memory>
+#import <mutex>
+#import <vector>
 #import "lar/core/utils/json.h"
 
 #import "Helpers/LARConversion.h"
+#import "Storage/map_archive.h"
+#import "Storage/map_delta.h"
+#import "Storage/lazy_landmarks.h"
+#import "Storage/map_journal.h"
+#import "Storage/map_json_reader.h"
+#import "Storage/parallel_map_loader.h"
+#import "Storage/tiled_map.h"
+#import "Spatial/frustum_filter.h"
+#import "Spatial/height_layers.h"
+#import "Spatial/landmark_index.h"
+#import "Spatial/landmark_quality.h"
+#import "Spatial/landmark_snapshot.h"
+#import "Concurrency/published.h"
 #import "LARMap.h"
 #import <CoreLocation/CoreLocation.h>
 
@@ -18,21 +39,737 @@
 
 @end
 
-@implementation LARMap;
+@implementation LARMap {
+    // Maps loaded from a file are owned; maps wrapped with initWithInternal: are not.
+    BOOL _ownsInternal;
+    // Backing storage when loaded from a binary archive. Landmark descriptors alias its
+    // mapping, so it has to live as long as the map does.
+    std::shared_ptr<lar::bridge::MapArchive> _archive;
+    // Archive the map was last reloaded from, when reloadFromContentsOf: kept the landmarks
+    // (which still alias _archive) but replaced other parts.
+    std::shared_ptr<lar::bridge::MapArchive> _reloadedArchive;
+    // Set once a delta has been applied; the map then no longer matches any archive section.
+    BOOL _appliedDelta;
+    // Set for maps opened from a tile directory; pages landmarks in prepareForQuery:.
+    std::unique_ptr<lar::bridge::TiledMap> _tiles;
+    // Set for archives opened lazily; materializes descriptors in prepareForQuery:.
+    std::unique_ptr<lar::bridge::LazyLandmarks> _lazy;
+    // Serializes changes to the core's landmark database (tile and lazy residency, reloads,
+    // deltas, journal restores, mapper changes) with building snapshots from it and journal
+    // saves. Recursive, since delegate callbacks made during a change may query the map.
+    std::recursive_mutex _residency;
+    // What every query is answered from (see LandmarkSnapshot). Maps being built publish it with
+    // publishLandmarks; owned maps build it on the first query after their landmarks change.
+    lar::bridge::Published<lar::bridge::LandmarkSnapshot> _snapshot;
+    // Counts landmark changes (performLandmarkChange: and landmarksDidChange), and the count the
+    // last published snapshot was copied at, so publishLandmarksIfChanged notices changes made
+    // in place that leave the landmark count alone.
+    std::atomic<uint64_t> _landmarkChanges;
+    std::atomic<uint64_t> _publishedChanges;
+    // Quality scores for the items of the current landmark index, rebuilt when it changes.
+    lar::bridge::Published<lar::bridge::LandmarkQuality> _landmarkQuality;
+    // Height layers of the current landmark index, redetected when it changes.
+    lar::bridge::Published<lar::bridge::HeightLayers> _heightLayers;
+    // Set by openJournalInDirectory:; shared with the core map callbacks that feed it.
+    std::shared_ptr<lar::bridge::MapJournal> _journal;
+}
+
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath {
+    return [self initWithContentsOf:filepath threads:0];
+}
 
-- (id)initWithContentsOf:(NSString*)filepath {
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath threads:(NSInteger)threads {
     if (self = [super init]) {
-        nlohmann::json json = nlohmann::json::parse(std::ifstream([filepath UTF8String]));
+        std::string path = [filepath UTF8String];
+        auto map = std::make_unique<lar::Map>();
+        try {
+            // JSON is streamed so the full DOM never coexists with the loaded map; archives are
+            // decoded in chunks across the pool.
+            _archive = lar::bridge::ParallelMapLoader((size_t)std::max<NSInteger>(threads, 0)).load(path, *map);
+        } catch (const std::exception& e) {
+            NSLog(@"Error loading map: %s", e.what());
+            return nil;
+        }
+        self->_internal = map.release();
+        self->_ownsInternal = YES;
+    }
+    return self;
+}
+
+- (nullable instancetype)initParsingJSONAt:(NSString*)filepath {
+    if (self = [super init]) {
+        auto map = std::make_unique<lar::Map>();
+        try {
+            std::ifstream file([filepath UTF8String]);
+            if (!file) {
+                throw std::runtime_error("Failed to open map JSON");
+            }
+            lar::from_json(nlohmann::json::parse(file), *map);
+        } catch (const std::exception& e) {
+            NSLog(@"Error loading map: %s", e.what());
+            return nil;
+        }
+        self->_internal = map.release();
+        self->_ownsInternal = YES;
+    }
+    return self;
+}
+
+- (nullable instancetype)initWithContentsOf:(NSString*)filepath lazy:(BOOL)lazy {
+    if (!lazy) return [self initWithContentsOf:filepath];
+    if (self = [super init]) {
+        std::string path = [filepath UTF8String];
+        auto map = std::make_unique<lar::Map>();
+        try {
+            if (lar::bridge::MapArchive::isArchive(path)) {
+                _archive = std::make_shared<lar::bridge::MapArchive>(path);
+                if (_archive->isDelta()) {
+                    throw std::runtime_error("Map delta can't be loaded as a map");
+                }
+                _archive->loadMapData(*map);
+                _lazy = std::make_unique<lar::bridge::LazyLandmarks>(_archive, *map);
+            } else {
+                // JSON has no random access to defer into, so it loads in full.
+                lar::bridge::MapJsonReader::load(path, *map);
+            }
+        } catch (const std::exception& e) {
+            NSLog(@"Error loading map: %s", e.what());
+            return nil;
+        }
+        self->_internal = map.release();
+        self->_ownsInternal = YES;
+    }
+    return self;
+}
+
+- (id)initWithTileDirectory:(NSString*)directory memoryBudget:(uint64_t)memoryBudget {
+    if (self = [super init]) {
+        try {
+            _tiles = std::make_unique<lar::bridge::TiledMap>([directory UTF8String], memoryBudget);
+        } catch (const std::exception& e) {
+            NSLog(@"Error opening tiled map: %s", e.what());
+            return nil;
+        }
         lar::Map* map = new lar::Map();
-        lar::from_json(json, *map);
+        _tiles->loadBase(*map);
         self->_internal = map;
+        self->_ownsInternal = YES;
+    }
+    return self;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self->_internal = new lar::Map();
+        self->_internal->origin = lar::Map::Transform::Identity();
+        self->_internal->origin_ready = false;
+        self->_ownsInternal = YES;
     }
     return self;
 }
 
+- (BOOL)addLandmarkWithId:(NSInteger)landmarkId position:(simd_double3)position boundsLower:(simd_double2)boundsLower boundsUpper:(simd_double2)boundsUpper descriptor:(nullable NSData*)descriptor sightings:(int)sightings lastSeen:(long long)lastSeen {
+    if (!_ownsInternal || _tiles || _lazy || landmarkId < 0) {
+        NSLog(@"Error adding landmark: only maps loaded whole or created empty take landmarks");
+        return NO;
+    }
+    std::vector<lar::Landmark> landmarks(1);
+    lar::Landmark& landmark = landmarks.front();
+    landmark.id = (size_t)landmarkId;
+    landmark.position = [LARConversion vector3dFromSIMD3:position];
+    landmark.orientation = Eigen::Vector3f::Zero();
+    landmark.bounds.lower = { boundsLower.x, boundsLower.y };
+    landmark.bounds.upper = { boundsUpper.x, boundsUpper.y };
+    landmark.sightings = sightings;
+    landmark.last_seen = lastSeen;
+    landmark.is_matched = false;
+    if (descriptor.length > 0) {
+        // Copied, since the map outlives the data.
+        cv::Mat(1, (int)descriptor.length, CV_8UC1, const_cast<void*>(descriptor.bytes)).copyTo(landmark.desc);
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        _internal->landmarks.insert(landmarks);
+    }
+    [self landmarksDidChange];
+    return YES;
+}
+
+- (BOOL)updateLandmarkWithId:(NSInteger)landmarkId descriptor:(NSData*)descriptor {
+    if (!_ownsInternal || _tiles || _lazy || landmarkId < 0) {
+        NSLog(@"Error updating landmark: only maps loaded whole or created empty take landmarks");
+        return NO;
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        lar::Landmark* landmark = [self ownedLandmarkWithId:landmarkId];
+        if (!landmark || landmark->desc.total() * landmark->desc.elemSize() != descriptor.length) {
+            NSLog(@"Error updating landmark: no landmark %ld with a descriptor of %lu bytes", (long)landmarkId, (unsigned long)descriptor.length);
+            return NO;
+        }
+        // Snapshots and compactions copy the cv::Mat header only, so a shared buffer is
+        // detached before it is written.
+        if (!landmark->desc.isContinuous() || !landmark->desc.u || landmark->desc.u->refcount > 1) {
+            landmark->desc = landmark->desc.clone();
+        }
+        std::memcpy(landmark->desc.data, descriptor.bytes, descriptor.length);
+    }
+    [self landmarksDidChange];
+    return YES;
+}
+
+- (BOOL)updateLandmarkWithId:(NSInteger)landmarkId orientation:(simd_float3)orientation {
+    if (!_ownsInternal || _tiles || _lazy || landmarkId < 0) {
+        NSLog(@"Error updating landmark: only maps loaded whole or created empty take landmarks");
+        return NO;
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        lar::Landmark* landmark = [self ownedLandmarkWithId:landmarkId];
+        if (!landmark) {
+            NSLog(@"Error updating landmark: no landmark %ld", (long)landmarkId);
+            return NO;
+        }
+        landmark->orientation = Eigen::Vector3f(orientation.x, orientation.y, orientation.z);
+    }
+    [self landmarksDidChange];
+    return YES;
+}
+
+// The landmark `landmarkId` of the core database, or nullptr. Callers hold _residency.
+- (lar::Landmark*)ownedLandmarkWithId:(NSInteger)landmarkId {
+    for (lar::Landmark* candidate : _internal->landmarks.all()) {
+        if (candidate->id == (size_t)landmarkId) return candidate;
+    }
+    return nullptr;
+}
+
++ (BOOL)isTileDirectory:(NSString*)directory {
+    return lar::bridge::TiledMap::isTiledMap([directory UTF8String]);
+}
+
 - (void)dealloc {
-    // TODO: see how to dealloc
-//    delete self->_internal;
+    // Trackers reference the map but retain this LARMap, so an owned map is unused by now.
+    if (_ownsInternal) {
+        delete self->_internal;
+    }
+}
+
++ (BOOL)verifyArchiveAt:(NSString*)filepath {
+    try {
+        auto corrupt = lar::bridge::MapArchive([filepath UTF8String]).corruptSections();
+        for (auto kind : corrupt) {
+            NSLog(@"Map archive section %u fails its checksum: %@", (unsigned)kind, filepath);
+        }
+        return corrupt.empty();
+    } catch (const std::exception& e) {
+        NSLog(@"Error verifying map archive: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)reloadFromContentsOf:(NSString*)filepath {
+    if (!_archive || _tiles || _journal) {
+        NSLog(@"Error reloading map: only maps loaded from an archive without a journal can be reloaded in part");
+        return NO;
+    }
+    try {
+        auto updated = std::make_shared<lar::bridge::MapArchive>([filepath UTF8String]);
+        const auto& current = _reloadedArchive ? *_reloadedArchive : *_archive;
+        if (updated->isDelta()) {
+            throw std::runtime_error("Map delta can't be loaded as a map; use applyDeltaAt:");
+        }
+        const uint32_t changed = _appliedDelta ? lar::bridge::archive::kAllParts : updated->changedParts(current);
+        if (!updated->corruptSections(changed).empty()) {
+            throw std::runtime_error("Map archive fails its checksums");
+        }
+
+        if (changed & lar::bridge::archive::kLandmarkPart) {
+            {
+                std::lock_guard<std::recursive_mutex> lock(_residency);
+                if (_lazy) {
+                    // Assigned only once constructed, so a rejected archive leaves the old rows.
+                    auto lazy = std::make_unique<lar::bridge::LazyLandmarks>(updated, *_internal);
+                    _lazy = std::move(lazy);
+                } else {
+                    std::vector<lar::Landmark> landmarks;
+                    updated->appendLandmarks(landmarks);
+                    _internal->landmarks = decltype(_internal->landmarks)();
+                    _internal->landmarks.insert(landmarks);
+                }
+                _archive = updated;
+            }
+            [self landmarksDidChange];
+            _reloadedArchive = nullptr;
+            _appliedDelta = NO;
+        } else {
+            _reloadedArchive = updated;
+        }
+        updated->reloadMapData(*_internal, changed);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error reloading map: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)writeDeltaFrom:(LARMap*)base to:(NSString*)filepath {
+    [base materializeAllLandmarks];
+    [self materializeAllLandmarks];
+    try {
+        lar::bridge::MapDelta::write(*base->_internal, *_internal, [filepath UTF8String]);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing map delta: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)applyDeltaAt:(NSString*)filepath {
+    if (_tiles || _journal) {
+        NSLog(@"Error applying map delta: tiled and journaled maps can't be updated with a delta");
+        return NO;
+    }
+    // The landmark database is rebuilt, so lazily loaded landmarks are materialized first.
+    [self materializeAllLandmarks];
+    try {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        lar::bridge::MapDelta::apply([filepath UTF8String], *_internal);
+        _lazy = nullptr;
+    } catch (const std::exception& e) {
+        NSLog(@"Error applying map delta: %s", e.what());
+        return NO;
+    }
+    [self landmarksDidChange];
+    _appliedDelta = YES;
+    return YES;
+}
+
+- (uint64_t)fingerprint {
+    [self materializeAllLandmarks];
+    return lar::bridge::MapDelta::fingerprint(*_internal);
+}
+
+- (BOOL)writeArchiveTo:(NSString*)filepath {
+    [self materializeAllLandmarks];
+    try {
+        lar::bridge::MapArchive::write(*_internal, [filepath UTF8String]);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing map archive: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)writeTilesTo:(NSString*)directory tileSize:(double)tileSize {
+    [self materializeAllLandmarks];
+    try {
+        lar::bridge::TiledMap::write(*_internal, [directory UTF8String], tileSize);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing tiled map: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)openJournalInDirectory:(NSString*)directory {
+    [self materializeAllLandmarks];
+    try {
+        std::string path = [directory UTF8String];
+        {
+            std::lock_guard<std::recursive_mutex> lock(_residency);
+            if (auto snapshot = lar::bridge::MapJournal::restore(path, *_internal)) {
+                _archive = snapshot;
+            }
+        }
+        [self landmarksDidChange];
+        _journal = std::make_shared<lar::bridge::MapJournal>(path, *_internal);
+    } catch (const std::exception& e) {
+        NSLog(@"Error opening map journal: %s", e.what());
+        return NO;
+    }
+    [self installCallbacks];
+    return YES;
+}
+
+- (void)performLandmarkChange:(const std::function<void()>&)change {
+    std::lock_guard<std::recursive_mutex> lock(_residency);
+    change();
+    _landmarkChanges++;
+}
+
+// Both read every landmark of the core map, so they wait for mapper changes in progress.
+- (BOOL)saveJournal {
+    if (!_journal) return NO;
+    try {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        _journal->recordLandmarks(*_internal);
+        _journal->flush();
+        if (_journal->needsCompaction()) _journal->compact(*_internal);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error saving map journal: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)compactJournal {
+    if (!_journal) return NO;
+    try {
+        // Only the copy of the map is taken under the lock; it is written in the background.
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        return _journal->compact(*_internal);
+    } catch (const std::exception& e) {
+        NSLog(@"Error compacting map journal: %s", e.what());
+        return NO;
+    }
+}
+
+- (BOOL)isCompactingJournal {
+    return _journal && _journal->isCompacting();
+}
+
+- (uint64_t)pendingJournalBytes {
+    return _journal ? _journal->pendingBytes() : 0;
+}
+
+- (uint64_t)journalCompactionBytes {
+    return (_journal ? _journal->compactionPolicy() : lar::bridge::MapJournal::CompactionPolicy()).max_bytes;
+}
+
+- (void)setJournalCompactionBytes:(uint64_t)bytes {
+    if (!_journal) return;
+    auto policy = _journal->compactionPolicy();
+    policy.max_bytes = bytes;
+    _journal->setCompactionPolicy(policy);
+}
+
+- (NSTimeInterval)journalCompactionInterval {
+    return (_journal ? _journal->compactionPolicy() : lar::bridge::MapJournal::CompactionPolicy()).max_age_seconds;
+}
+
+- (void)setJournalCompactionInterval:(NSTimeInterval)interval {
+    if (!_journal) return;
+    auto policy = _journal->compactionPolicy();
+    policy.max_age_seconds = interval;
+    _journal->setCompactionPolicy(policy);
+}
+
+- (void)prepareForQuery:(LARSpatialQuery)query {
+    bool changed = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        if (_tiles) changed = _tiles->prepare(query.x, query.z, query.diameter, *_internal);
+        if (_lazy) _lazy->prepare(query.x, query.z, query.diameter);
+    }
+    // Lazy snapshots are decoded from the archive in full, so only paging changes them.
+    if (changed) [self landmarksDidChange];
+}
+
+// Queries read tiled maps from their resident tiles; the core's landmark database is left to
+// prepareForQuery:.
+- (void)pageForQuery:(LARSpatialQuery)query {
+    if (_tiles && _tiles->page(query.x, query.z, query.diameter)) [self landmarksDidChange];
+}
+
+- (NSArray<LARLandmark*>*)landmarksForQuery:(LARSpatialQuery)query {
+    std::vector<lar::Landmark*> found;
+    const auto owner = [self searchQuery:query visitor:[&found](lar::Landmark* landmark) {
+        found.push_back(landmark);
+    }];
+    return [self wrapLandmarks:found owner:owner];
+}
+
+- (NSArray<LARLandmark*>*)landmarksForQuery:(LARSpatialQuery)query perCell:(NSInteger)perCell cellSize:(double)cellSize {
+    const auto index = [self landmarkIndexForQuery:query];
+    if (!index) return @[];
+    std::vector<lar::Landmark*> found;
+    try {
+        const auto quality = [self landmarkQualityFor:index];
+        const auto items = index->tree().search(lar::bridge::PackedRTree::Box::around(query.x, query.z, query.diameter));
+        for (uint32_t item : quality->best(items, cellSize, (size_t)std::max<NSInteger>(perCell, 0))) {
+            found.push_back(index->landmark(item));
+        }
+    } catch (const std::exception& e) {
+        NSLog(@"Error ranking landmarks: %s", e.what());
+    }
+    return [self wrapLandmarks:found owner:index];
+}
+
+- (std::shared_ptr<const lar::bridge::LandmarkQuality>)landmarkQualityFor:(const std::shared_ptr<const lar::bridge::LandmarkIndex>&)index {
+    auto quality = _landmarkQuality.load();
+    if (!quality || quality->index() != index) {
+        // Concurrent callers may both rescore a new index; the scores are the same.
+        quality = std::make_shared<const lar::bridge::LandmarkQuality>(index, lar::bridge::LandmarkQuality::Weights());
+        _landmarkQuality.publish(quality);
+    }
+    return quality;
+}
+
+- (void)scoreLandmarksOfIndex:(std::shared_ptr<const lar::bridge::LandmarkIndex>)index viewSpread:(const std::vector<float>&)viewSpread {
+    try {
+        _landmarkQuality.publish(std::make_shared<const lar::bridge::LandmarkQuality>(index, lar::bridge::LandmarkQuality::Weights(), viewSpread));
+    } catch (const std::exception& e) {
+        NSLog(@"Error scoring landmarks: %s", e.what());
+    }
+}
+
+- (NSArray<LARLandmark*>*)landmarksForFrustumQuery:(LARFrustumQuery)query {
+    std::vector<lar::Landmark*> found;
+    std::shared_ptr<const void> owner;
+    try {
+        lar::bridge::FrustumFilter::Options options;
+        options.padding = query.padding;
+        options.max_view_angle = query.maxViewAngle;
+        options.far_distance = query.region.diameter;
+        const lar::bridge::FrustumFilter frustum(
+            [LARConversion transform3dFromSIMD4x4d:query.cameraTransform],
+            [LARConversion eigenFromSIMD3:query.intrinsics].cast<double>(),
+            options);
+        owner = [self searchQuery:query.region visitor:[&found, &frustum](lar::Landmark* landmark) {
+            if (frustum.accepts(*landmark)) found.push_back(landmark);
+        }];
+    } catch (const std::exception& e) {
+        NSLog(@"Error running frustum query: %s", e.what());
+    }
+    return [self wrapLandmarks:found owner:owner];
+}
+
+- (NSArray<LARLandmark*>*)landmarksForFloorQuery:(LARFloorQuery)query {
+    std::vector<lar::Landmark*> found;
+    const lar::bridge::HeightLayers::Band band{ query.minY, query.maxY };
+    const auto owner = [self searchQuery:query.region visitor:[&found, &band](lar::Landmark* landmark) {
+        if (band.contains(landmark->position.y())) found.push_back(landmark);
+    }];
+    return [self wrapLandmarks:found owner:owner];
+}
+
+- (LARFloorQuery)floorQueryForRegion:(LARSpatialQuery)region cameraHeight:(double)cameraHeight {
+    lar::bridge::HeightLayers::Band band;
+    if (const auto layers = [self heightLayersFor:[self landmarkIndexForQuery:region]]) {
+        band = layers->bandAt(cameraHeight);
+    }
+    return LARFloorQueryMake(region, band.lower, band.upper);
+}
+
+- (NSInteger)heightLayerCount {
+    const auto layers = [self heightLayersFor:[self landmarkIndex]];
+    return layers ? (NSInteger)layers->layers().size() : 0;
+}
+
+- (void)heightLayerAt:(NSInteger)layer lower:(double*)lower upper:(double*)upper {
+    const auto layers = [self heightLayersFor:[self landmarkIndex]];
+    if (!layers || layer < 0 || (size_t)layer >= layers->layers().size()) {
+        *lower = -std::numeric_limits<double>::infinity();
+        *upper = std::numeric_limits<double>::infinity();
+        return;
+    }
+    *lower = layers->layers()[layer].lower;
+    *upper = layers->layers()[layer].upper;
+}
+
+- (std::shared_ptr<const lar::bridge::HeightLayers>)heightLayersFor:(const std::shared_ptr<const lar::bridge::LandmarkIndex>&)index {
+    if (!index) return nullptr;
+    auto layers = _heightLayers.load();
+    if (!layers || layers->index() != index) {
+        // As for quality scores, concurrent callers may both detect the same layers.
+        layers = std::make_shared<const lar::bridge::HeightLayers>(index, lar::bridge::HeightLayers::Options());
+        _heightLayers.publish(layers);
+    }
+    return layers;
+}
+
+- (NSArray<LARLandmark*>*)nearestLandmarksTo:(simd_double3)point count:(NSInteger)count {
+    const auto points = [self landmarkPoints];
+    if (!points) return @[];
+    const Eigen::Vector3d center = [LARConversion vector3dFromSIMD3:point];
+    return [self landmarksForNeighbors:points->nearest(center, (size_t)std::max<NSInteger>(count, 0)) owner:points];
+}
+
+- (NSArray<LARLandmark*>*)landmarksWithinRadius:(double)radius of:(simd_double3)point {
+    // Every landmark within the radius is positioned inside the tiles covering its square.
+    if (_tiles && _tiles->pagePositions(point.x, point.z, 2 * radius)) [self landmarksDidChange];
+    const auto points = [self landmarkPoints];
+    if (!points) return @[];
+    const Eigen::Vector3d center = [LARConversion vector3dFromSIMD3:point];
+    return [self landmarksForNeighbors:points->withinRadius(center, radius) owner:points];
+}
+
+- (nullable LARLandmark*)landmarkWithId:(NSInteger)landmarkId {
+    const auto snapshot = [self landmarkSnapshot];
+    if (!snapshot || landmarkId < 0) return nil;
+    const lar::Landmark* landmark = snapshot->find((size_t)landmarkId);
+    if (!landmark) return nil;
+    return [[LARLandmark alloc] initWithInternal:const_cast<lar::Landmark*>(landmark) owner:snapshot];
+}
+
+- (NSArray<LARLandmark*>*)landmarksForNeighbors:(const std::vector<lar::bridge::LandmarkPointIndex::Neighbor>&)neighbors owner:(std::shared_ptr<const void>)owner {
+    std::vector<lar::Landmark*> landmarks;
+    landmarks.reserve(neighbors.size());
+    for (const auto& neighbor : neighbors) landmarks.push_back(neighbor.first);
+    return [self wrapLandmarks:landmarks owner:owner];
+}
+
+// The wrappers retain `owner`, which keeps the snapshot their landmarks live in alive.
+- (NSArray<LARLandmark*>*)wrapLandmarks:(const std::vector<lar::Landmark*>&)found owner:(const std::shared_ptr<const void>&)owner {
+    NSMutableArray<LARLandmark*>* landmarks = [NSMutableArray arrayWithCapacity:found.size()];
+    for (lar::Landmark* landmark : found) {
+        [landmarks addObject:[[LARLandmark alloc] initWithInternal:landmark owner:owner]];
+    }
+    return [landmarks copy];
+}
+
+// Point index of the current snapshot, nullptr if there is none (a map being built before its
+// first publish).
+- (std::shared_ptr<const lar::bridge::LandmarkPointIndex>)landmarkPoints {
+    const auto snapshot = [self landmarkSnapshot];
+    return snapshot ? std::shared_ptr<const lar::bridge::LandmarkPointIndex>(snapshot, &snapshot->points()) : nullptr;
+}
+
+// The current snapshot: the last published one for maps being built, otherwise built on demand.
+- (std::shared_ptr<const lar::bridge::LandmarkSnapshot>)landmarkSnapshot {
+    if (!_ownsInternal) return _snapshot.load();
+    return _snapshot.loadOrBuild([self] { return [self buildLandmarkSnapshot]; });
+}
+
+// Tiled and lazy maps are decoded straight from their archives' key and orientation columns:
+// the core's database holds only what the tracker last prepared, and lazy descriptors are
+// filled into it in place. Queries read no descriptors, so none are materialized for the
+// snapshot; tiled maps count its landmarks against their memory budget.
+- (std::shared_ptr<const lar::bridge::LandmarkSnapshot>)buildLandmarkSnapshot {
+    const uint64_t version = _snapshot.version() + 1;
+    std::vector<lar::Landmark> landmarks;
+    if (_tiles) {
+        for (const auto& archive : _tiles->residentArchives()) archive->appendSnapshotLandmarks(landmarks);
+        return std::make_shared<const lar::bridge::LandmarkSnapshot>(std::move(landmarks), version);
+    }
+    std::lock_guard<std::recursive_mutex> lock(_residency);
+    if (_lazy) {
+        _archive->appendSnapshotLandmarks(landmarks);
+        return std::make_shared<const lar::bridge::LandmarkSnapshot>(std::move(landmarks), version);
+    }
+    return std::make_shared<const lar::bridge::LandmarkSnapshot>(*_internal, version, _archive);
+}
+
+// Call after changing the core's landmark database, without holding _residency.
+- (void)landmarksDidChange {
+    _landmarkChanges++;
+    if (_ownsInternal) {
+        _snapshot.reset();
+    } else {
+        [self publishLandmarks];
+    }
+}
+
+- (void)publishLandmarks {
+    if (_ownsInternal) return;
+    // Copied under the lock so a change from another thread lands wholly before or after.
+    std::shared_ptr<const lar::bridge::LandmarkSnapshot> snapshot;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_residency);
+        _publishedChanges = _landmarkChanges.load();
+        snapshot = std::make_shared<const lar::bridge::LandmarkSnapshot>(*_internal, _snapshot.version() + 1);
+    }
+    _snapshot.publish(std::move(snapshot));
+}
+
+- (void)publishLandmarksIfChanged {
+    if (_ownsInternal) return;
+    if (!_snapshot.load() || _landmarkChanges.load() != _publishedChanges.load()) [self publishLandmarks];
+}
+
+- (uint64_t)publishedLandmarkVersion {
+    const auto snapshot = _snapshot.load();
+    return snapshot ? snapshot->version() : 0;
+}
+
+- (std::shared_ptr<const lar::bridge::LandmarkIndex>)landmarkIndexForQuery:(LARSpatialQuery)query {
+    [self pageForQuery:query];
+    return [self landmarkIndex];
+}
+
+// The landmark index of the current snapshot, without paging for a query.
+- (std::shared_ptr<const lar::bridge::LandmarkIndex>)landmarkIndex {
+    const auto snapshot = [self landmarkSnapshot];
+    return snapshot ? std::shared_ptr<const lar::bridge::LandmarkIndex>(snapshot, &snapshot->index()) : nullptr;
+}
+
+// Visits the landmarks of `query` and returns the snapshot they live in, as their owner for
+// wrapLandmarks:owner:. Maps being built visit nothing until their first publish.
+- (std::shared_ptr<const void>)searchQuery:(LARSpatialQuery)query visitor:(const std::function<void(lar::Landmark*)>&)visit {
+    const auto index = [self landmarkIndexForQuery:query];
+    if (index) index->search(query.x, query.z, query.diameter, visit);
+    return index;
+}
+
+- (void)materializeAllLandmarks {
+    std::lock_guard<std::recursive_mutex> lock(_residency);
+    if (_lazy) {
+        _lazy->materializeAll();
+    }
+}
+
+- (BOOL)isLazy {
+    return _lazy != nullptr;
+}
+
+- (NSInteger)materializedLandmarkCount {
+    return _lazy ? (NSInteger)_lazy->stats().materialized : (NSInteger)_internal->landmarks.size();
+}
+
+- (uint64_t)materializedLandmarkBytes {
+    return _lazy ? _lazy->stats().materialized_bytes : 0;
+}
+
+- (uint64_t)residentDescriptorBytes {
+    return _lazy ? _lazy->stats().resident_descriptor_bytes : 0;
+}
+
+- (BOOL)isTiled {
+    return _tiles != nullptr;
+}
+
+- (uint64_t)memoryBudget {
+    return _tiles ? _tiles->memoryBudget() : 0;
+}
+
+- (void)setMemoryBudget:(uint64_t)memoryBudget {
+    if (_tiles) {
+        _tiles->setMemoryBudget(memoryBudget);
+    }
+}
+
+- (NSInteger)residentTileCount {
+    return _tiles ? (NSInteger)_tiles->stats().resident_tiles : 0;
+}
+
+- (uint64_t)residentTileBytes {
+    return _tiles ? _tiles->stats().resident_bytes : 0;
+}
+
+- (uint64_t)decodedTileBytes {
+    return _tiles ? _tiles->stats().decoded_bytes : 0;
+}
+
+- (uint64_t)tilePageInCount {
+    return _tiles ? _tiles->stats().page_ins : 0;
+}
+
+- (uint64_t)tileEvictionCount {
+    return _tiles ? _tiles->stats().evictions : 0;
+}
+
+- (BOOL)writeJSONTo:(NSString*)filepath {
+    [self materializeAllLandmarks];
+    try {
+        nlohmann::json json = *_internal;
+        std::ofstream file([filepath UTF8String]);
+        file << json;
+        return file.good();
+    } catch (const std::exception& e) {
+        NSLog(@"Error writing map JSON: %s", e.what());
+        return NO;
+    }
 }
 
 - (void)globalPointFromRelative:(simd_double3)relative global:(simd_double3*) global {
@@ -140,8 +877,14 @@
 
 - (void)setDelegate:(id<LARMapDelegate>)delegate {
     _delegate = delegate;
-    if (delegate && _internal) {
+    [self installCallbacks];
+}
+
+// The core map has a single callback slot per event; they fan out to the delegate and journal.
+- (void)installCallbacks {
+    if ((_delegate || _journal) && _internal) {
         __weak LARMap* weakSelf = self;
+        std::shared_ptr<lar::bridge::MapJournal> journal = _journal;
 
         // Helper to convert C++ anchor vector to NSArray (no copy needed - fresh array)
         auto toObjCArray = [](const auto& anchors) -> NSArray<LARAnchor*>* {
@@ -154,7 +897,10 @@
         };
 
         // Bulk anchor add callback
-        _internal->setDidAddAnchorsCallback([weakSelf, toObjCArray](const std::vector<std::reference_wrapper<lar::Anchor>>& anchors) {
+        _internal->setDidAddAnchorsCallback([weakSelf, journal, toObjCArray](const std::vector<std::reference_wrapper<lar::Anchor>>& anchors) {
+            if (journal) {
+                for (const auto& anchor : anchors) journal->recordAnchor(anchor.get());
+            }
             LARMap* strongSelf = weakSelf;
             if (strongSelf && strongSelf.delegate) {
                 if ([strongSelf.delegate respondsToSelector:@selector(map:didAddAnchors:)]) {
@@ -164,7 +910,10 @@
         });
 
         // Bulk anchor update callback
-        _internal->setDidUpdateAnchorsCallback([weakSelf, toObjCArray](const std::vector<std::reference_wrapper<lar::Anchor>>& anchors) {
+        _internal->setDidUpdateAnchorsCallback([weakSelf, journal, toObjCArray](const std::vector<std::reference_wrapper<lar::Anchor>>& anchors) {
+            if (journal) {
+                for (const auto& anchor : anchors) journal->recordAnchor(anchor.get());
+            }
             LARMap* strongSelf = weakSelf;
             if (strongSelf && strongSelf.delegate) {
                 if ([strongSelf.delegate respondsToSelector:@selector(map:didUpdateAnchors:)]) {
@@ -174,7 +923,10 @@
         });
 
         // Bulk anchor removal callback
-        _internal->setWillRemoveAnchorsCallback([weakSelf, toObjCArray](const std::vector<std::reference_wrapper<const lar::Anchor>>& anchors) {
+        _internal->setWillRemoveAnchorsCallback([weakSelf, journal, toObjCArray](const std::vector<std::reference_wrapper<const lar::Anchor>>& anchors) {
+            if (journal) {
+                for (const auto& anchor : anchors) journal->recordAnchorRemoval(anchor.get().id);
+            }
             LARMap* strongSelf = weakSelf;
             if (strongSelf && strongSelf.delegate) {
                 if ([strongSelf.delegate respondsToSelector:@selector(map:willRemoveAnchors:)]) {
@@ -184,8 +936,11 @@
         });
 
         // Origin update callback
-        _internal->setDidUpdateOriginCallback([weakSelf](const lar::Map::Transform& transform) {
+        _internal->setDidUpdateOriginCallback([weakSelf, journal](const lar::Map::Transform& transform) {
             LARMap* strongSelf = weakSelf;
+            if (journal) {
+                journal->recordOrigin(transform, strongSelf ? (bool)strongSelf->_internal->origin_ready : true);
+            }
             if (strongSelf && strongSelf.delegate) {
                 simd_double4x4 simdTransform = [LARConversion simd4x4FromTransform3d:transform];
                 
@@ -196,7 +951,8 @@
         });
 
         // Edge addition callback
-        _internal->setDidAddEdgeCallback([weakSelf](std::size_t from_id, std::size_t to_id) {
+        _internal->setDidAddEdgeCallback([weakSelf, journal](std::size_t from_id, std::size_t to_id) {
+            if (journal) journal->recordEdge(from_id, to_id);
             LARMap* strongSelf = weakSelf;
             if (strongSelf && strongSelf.delegate) {
                 if ([strongSelf.delegate respondsToSelector:@selector(map:didAddEdgeFrom:to:)]) {
@@ -206,7 +962,8 @@
         });
 
         // Edge removal callback
-        _internal->setDidRemoveEdgeCallback([weakSelf](std::size_t from_id, std::size_t to_id) {
+        _internal->setDidRemoveEdgeCallback([weakSelf, journal](std::size_t from_id, std::size_t to_id) {
+            if (journal) journal->recordEdgeRemoval(from_id, to_id);
             LARMap* strongSelf = weakSelf;
             if (strongSelf && strongSelf.delegate) {
                 if ([strongSelf.delegate respondsToSelector:@selector(map:didRemoveEdgeFrom:to:)]) {
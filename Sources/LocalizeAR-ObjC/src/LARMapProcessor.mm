@@ -13,6 +13,7 @@
 @interface LARMapProcessor ()
 
 @property(nonatomic,readwrite) lar::MapProcessor* _internal;
+@property(nonatomic,strong) LARMapperData* data;
 
 @end
 
@@ -21,6 +22,7 @@
 - (id)initWithMapperData:(LARMapperData*)data {
     self = [super init];
     self._internal = new lar::MapProcessor(data->_internal);
+    self.data = data;
     return self;
 }
 
@@ -29,16 +31,27 @@
 }
 
 - (void)process {
-    self._internal->process();
+    [self.data.map performLandmarkChange:[&] { self._internal->process(); }];
+    // Readers on other threads only see landmarks once they are consistent again.
+    [self.data.map publishLandmarksIfChanged];
 }
 
 - (void)rescale:(double)scaleFactor {
-    self._internal->rescale(scaleFactor);
+    [self.data.map performLandmarkChange:[&] { self._internal->rescale(scaleFactor); }];
+    [self.data.map publishLandmarksIfChanged];
 }
 
-- (void)saveMap:(NSString*)directory {
+- (BOOL)saveMap:(NSString*)directory {
     std::string directory_string = std::string([directory UTF8String]);
-    self._internal->saveMap(directory_string);
+    try {
+        self._internal->saveMap(directory_string);
+    } catch (const std::exception& e) {
+        NSLog(@"Error saving map: %s", e.what());
+        return NO;
+    }
+
+    // Keep a binary archive next to map.json so localization can memory-map it.
+    return [self.data.map writeArchiveTo:[directory stringByAppendingPathComponent:@"map.larmap"]];
 }
 
 
@@ -42,11 +42,14 @@ namespace fs = std::filesystem;
 }
 
 - (void)readMetadata {
-    self->_internal->readMetadata();
+    // Under the map's lock, like every landmark change, so journal saves never see half a change.
+    [self.data.map performLandmarkChange:[&] { self->_internal->readMetadata(); }];
+    // The landmarks were replaced wholesale; queries see them once published.
+    [self.data.map publishLandmarksIfChanged];
 }
 
 - (void)writeMetadata {
-    self->_internal->writeMetadata();
+    [self.data.map performLandmarkChange:[&] { self->_internal->writeMetadata(); }];
 }
 
 - (LARAnchor*)createAnchor:(simd_float4x4)transform {
@@ -97,7 +100,8 @@ namespace fs = std::filesystem;
 
     // Depth/confidence intentionally omitted (LiDAR disabled): pass empty mats so the
     // mapper skips writing depth.pfm/confidence.pfm. The COLMAP pipeline doesn't use them.
-    _internal->addFrame(aFrame, image, cv::Mat(), cv::Mat());
+    [self.data.map performLandmarkChange:[&] { self->_internal->addFrame(aFrame, image, cv::Mat(), cv::Mat()); }];
+    [self.data.map publishLandmarksIfChanged];
 
     CVPixelBufferUnlockBaseAddress(imageBuffer, kCVPixelBufferLock_ReadOnly);
 }
@@ -0,0 +1,107 @@
+//
+//  LARSIFTBenchmark.mm
+//  LocalizeAR
+//
+
+#import <memory>
+
+#import "Features/sift_benchmark.h"
+#import "LARSIFTBenchmark.h"
+
+
+@implementation LARSIFTBenchmark {
+    std::unique_ptr<lar::bridge::SiftBenchmark> _benchmark;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _benchmark = std::make_unique<lar::bridge::SiftBenchmark>();
+    }
+    return self;
+}
+
+- (BOOL)addImage:(LARImage)image {
+    cv::Mat gray(image.height, image.width, CV_8UC1, const_cast<void*>(image.data), (size_t)image.bytesPerRow);
+    try {
+        _benchmark->evaluate(gray);
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error benchmarking SIFT: %s", e.what());
+        return NO;
+    }
+}
+
+- (NSInteger)imageCount {
+    return (NSInteger)_benchmark->result().images;
+}
+
+- (double)simdSeconds {
+    return _benchmark->result().simd_seconds;
+}
+
+- (double)scalarSeconds {
+    return _benchmark->result().scalar_seconds;
+}
+
+- (double)openCVSeconds {
+    return _benchmark->result().opencv_seconds;
+}
+
+- (double)threadedSeconds {
+    return _benchmark->result().threaded_seconds;
+}
+
+- (NSInteger)threadCount {
+    return (NSInteger)_benchmark->result().threads;
+}
+
+- (double)budgetSeconds {
+    return _benchmark->result().budget_seconds;
+}
+
+- (NSInteger)keypointBudget {
+    return (NSInteger)_benchmark->result().budget;
+}
+
+- (NSInteger)keptKeypointCount {
+    return (NSInteger)_benchmark->result().kept_keypoints;
+}
+
+- (NSInteger)droppedKeypointCount {
+    return (NSInteger)_benchmark->result().dropped_keypoints;
+}
+
+- (NSInteger)keypointCount {
+    return (NSInteger)_benchmark->result().keypoints;
+}
+
+- (NSInteger)openCVKeypointCount {
+    return (NSInteger)_benchmark->result().opencv_keypoints;
+}
+
+- (NSInteger)matchedKeypointCount {
+    return (NSInteger)_benchmark->result().matched_keypoints;
+}
+
+- (double)meanDescriptorDistance {
+    const auto& result = _benchmark->result();
+    return result.matched_keypoints ? result.descriptor_distance / result.matched_keypoints : 0;
+}
+
+- (BOOL)kernelsMatch {
+    return _benchmark->result().scalar_matches;
+}
+
+- (BOOL)threadsMatch {
+    return _benchmark->result().threaded_matches;
+}
+
+- (NSInteger)steadyStateAllocationCount {
+    return (NSInteger)_benchmark->result().steady_allocations;
+}
+
+- (NSString*)kernelName {
+    return @(lar::bridge::siftKernelName(_benchmark->result().kernel));
+}
+
+@end
@@ -0,0 +1,143 @@
+//
+//  LARSIFTExtractor.mm
+//  LocalizeAR
+//
+
+#import <memory>
+#import <vector>
+
+#import <opencv2/features.hpp>
+
+#import "Features/cpu_sift.h"
+#import "Features/scratch_allocator.h"
+#import "LARSIFTExtractor.h"
+
+
+@implementation LARSIFTExtractor {
+    std::unique_ptr<lar::bridge::CpuSift> _sift;
+    // Set instead of _sift for the OpenCV reference.
+    cv::Ptr<cv::SIFT> _opencv;
+    NSInteger _openCVKeypointBudget;
+    std::vector<cv::KeyPoint> _keypoints;
+    std::vector<float> _descriptors;
+}
+
++ (uint64_t)scratchAllocationCount {
+    return lar::bridge::scratchAllocations();
+}
+
+- (instancetype)initWithImageWidth:(int)imageWidth imageHeight:(int)imageHeight threads:(NSInteger)threads {
+    return [self initWithImageWidth:imageWidth imageHeight:imageHeight threads:threads keypointBudget:0
+                          selection:LARKeypointSelectionStrongest];
+}
+
+- (instancetype)initWithImageWidth:(int)imageWidth imageHeight:(int)imageHeight threads:(NSInteger)threads keypointBudget:(NSInteger)keypointBudget selection:(LARKeypointSelection)selection {
+    if (self = [super init]) {
+        lar::bridge::CpuSift::Options options;
+        options.threads = (size_t)MAX(threads, 0);
+        options.max_features = (size_t)MAX(keypointBudget, 0);
+        switch (selection) {
+            case LARKeypointSelectionGrid: options.selection = lar::bridge::CpuSift::Selection::Grid; break;
+            case LARKeypointSelectionSuppression: options.selection = lar::bridge::CpuSift::Selection::Suppression; break;
+            default: options.selection = lar::bridge::CpuSift::Selection::Strongest; break;
+        }
+        _selection = selection;
+        _sift = std::make_unique<lar::bridge::CpuSift>(options);
+        [self configureImageSizeWithWidth:imageWidth height:imageHeight];
+    }
+    return self;
+}
+
+- (instancetype)initOpenCVWithKeypointBudget:(NSInteger)keypointBudget {
+    if (self = [super init]) {
+        const lar::bridge::CpuSift::Options options;
+        _openCVKeypointBudget = MAX(keypointBudget, 0);
+        _opencv = cv::SIFT::create((int)_openCVKeypointBudget, options.octave_layers, options.contrast_threshold,
+                                   options.edge_threshold, options.sigma, options.descriptor_type);
+        _selection = LARKeypointSelectionStrongest;
+    }
+    return self;
+}
+
+- (void)configureImageSizeWithWidth:(int)imageWidth height:(int)imageHeight {
+    if (_opencv) {
+        // OpenCV keeps no buffers to size.
+        _imageWidth = imageWidth;
+        _imageHeight = imageHeight;
+        return;
+    }
+    try {
+        _sift->configure(imageWidth, imageHeight);
+        _imageWidth = imageWidth;
+        _imageHeight = imageHeight;
+    } catch (const std::exception& e) {
+        NSLog(@"Error configuring SIFT extractor: %s", e.what());
+    }
+}
+
+- (NSInteger)threadCount {
+    return _opencv ? 1 : (NSInteger)_sift->threads();
+}
+
+- (NSInteger)keypointBudget {
+    return _opencv ? _openCVKeypointBudget : (NSInteger)_sift->options().max_features;
+}
+
+- (NSInteger)droppedKeypointCount {
+    // OpenCV doesn't report what its budget dropped.
+    return _opencv ? 0 : (NSInteger)_sift->keypointCounts().dropped;
+}
+
+- (BOOL)usesOpenCV {
+    return _opencv != nullptr;
+}
+
+- (NSData*)descriptors {
+    return [NSData dataWithBytes:_descriptors.data() length:_descriptors.size() * sizeof(float)];
+}
+
+- (LARKeypoint)keypointAtIndex:(NSInteger)index {
+    if (index < 0 || (size_t)index >= _keypoints.size()) return LARKeypoint{};
+    const cv::KeyPoint& keypoint = _keypoints[(size_t)index];
+    return LARKeypoint{ keypoint.pt.x, keypoint.pt.y, keypoint.size, keypoint.angle, keypoint.response, keypoint.octave };
+}
+
+- (BOOL)extractImage:(LARImage)image {
+    try {
+        _descriptors.clear();
+        if (_opencv) {
+            [self extractWithOpenCV:image];
+        } else {
+            _sift->extract(static_cast<const uint8_t*>(image.data), image.width, image.height, (size_t)image.bytesPerRow,
+                           _keypoints, &_descriptors);
+        }
+        _keypointCount = (NSInteger)_keypoints.size();
+        // extract() reconfigures for other sizes.
+        _imageWidth = image.width;
+        _imageHeight = image.height;
+        return YES;
+    } catch (const std::exception& e) {
+        NSLog(@"Error extracting SIFT features: %s", e.what());
+        return NO;
+    }
+}
+
+- (void)extractWithOpenCV:(LARImage)image {
+    const cv::Mat gray(image.height, image.width, CV_8UC1, const_cast<void*>(image.data), (size_t)image.bytesPerRow);
+    cv::Mat descriptors;
+    const int threads = cv::getNumThreads();
+    cv::setNumThreads(1);
+    try {
+        _opencv->detectAndCompute(gray, cv::noArray(), _keypoints, descriptors);
+    } catch (...) {
+        cv::setNumThreads(threads);
+        throw;
+    }
+    cv::setNumThreads(threads);
+    for (int row = 0; row < descriptors.rows; row++) {
+        const float* values = descriptors.ptr<float>(row);
+        _descriptors.insert(_descriptors.end(), values, values + descriptors.cols);
+    }
+}
+
+@end
@@ -0,0 +1,40 @@
+//
+//  LARSpatialIndexBenchmark.mm
+//  LocalizeAR
+//
+
+#import <lar/core/map.h>
+
+#import "Spatial/landmark_index.h"
+#import "Spatial/spatial_index_benchmark.h"
+#import "LARSpatialIndexBenchmark.h"
+
+
+@implementation LARSpatialIndexBenchmark
+
+- (nullable instancetype)initWithMap:(LARMap*)map landmarkCount:(NSInteger)landmarkCount queryCount:(NSInteger)queryCount diameter:(double)diameter {
+    if (self = [super init]) {
+        try {
+            const auto seed = lar::bridge::LandmarkIndex::boundsOf(map->_internal->landmarks.all());
+            const auto result = lar::bridge::SpatialIndexBenchmark::run(seed, (size_t)landmarkCount, (size_t)queryCount, diameter);
+            _landmarkCount = (NSInteger)result.items;
+            _queryCount = (NSInteger)result.queries;
+            _hitCount = (NSInteger)result.hits;
+            _treeBytes = result.tree_bytes;
+            _buildSeconds = result.build_seconds;
+            _treeQuerySeconds = result.tree_seconds;
+            _scalarTreeQuerySeconds = result.scalar_tree_seconds;
+            _scanQuerySeconds = result.scan_seconds;
+            _resultsMatch = result.matches;
+            _kernelName = @(lar::bridge::boxKernelName(result.kernel));
+            _storedOrderPageCount = (NSInteger)result.stored_order_pages;
+            _spatialOrderPageCount = (NSInteger)result.spatial_order_pages;
+        } catch (const std::exception& e) {
+            NSLog(@"Error benchmarking spatial index: %s", e.what());
+            return nil;
+        }
+    }
+    return self;
+}
+
+@end
@@ -8,6 +8,8 @@
 #import <lar/tracking/tracker.h>
 #import <iostream>
 #import <fstream>
+#import <memory>
+#import <stdexcept>
 #import <vector>
 #import "lar/core/utils/json.h"
 #import "lar/mapping/frame.h"
@@ -15,6 +17,7 @@
 #import "LARTracker.h"
 #import "LARFrame.h"
 #import "Helpers/LARConversion.h"
+#import "Tracking/coarse_to_fine.h"
 
 
 @interface LARTracker ()
@@ -23,7 +26,9 @@
 
 @end
 
-@implementation LARTracker
+@implementation LARTracker {
+    std::unique_ptr<lar::bridge::CoarseToFineLocalizer> _coarseToFine;
+}
 
 - (id)initWithMap:(LARMap*)map {
     self = [super init];
@@ -57,9 +62,13 @@
     // cv::Mat wrapping now happens inside lar::Tracker::localize (the struct overload),
     // so the bridge just forwards the plain-C structs.
     lar::Frame* internalFrame = frame->_internal;
+    // Tiled maps page in the landmarks this query can see (no-op otherwise).
+    [self.map prepareForQuery:query];
 
     Eigen::Matrix4d resultTransform;
-    bool success = self->_internal->localize(image, *internalFrame, query, resultTransform);
+    bool success = _coarseToFine
+        ? _coarseToFine->localize(image, *internalFrame, query, resultTransform)
+        : self->_internal->localize(image, *internalFrame, query, resultTransform);
 
     if (success && outTransform) {
         *outTransform = [LARConversion simd4x4DoubleFromMatrix4d:resultTransform];
@@ -68,15 +77,53 @@
     return success;
 }
 
+- (void)enableCoarseToFineWithLevels:(NSInteger)levels minInliers:(NSInteger)minInliers minInlierRatio:(double)minInlierRatio {
+    lar::bridge::CoarseToFineLocalizer::Options options;
+    options.levels = (int)MIN(levels, (NSInteger)lar::bridge::CoarseToFineLocalizer::kMaxLevels);
+    options.min_inliers = (size_t)MAX(minInliers, 0);
+    options.min_inlier_ratio = minInlierRatio;
+    try {
+        _coarseToFine = std::make_unique<lar::bridge::CoarseToFineLocalizer>(*self->_internal, *self.map->_internal, options);
+    } catch (const std::exception& e) {
+        NSLog(@"Error enabling coarse-to-fine localization: %s", e.what());
+        _coarseToFine.reset();
+    }
+}
+
+- (void)disableCoarseToFine {
+    _coarseToFine.reset();
+}
+
+- (BOOL)coarseToFineEnabled {
+    return _coarseToFine != nullptr;
+}
+
+- (BOOL)lastLocalizationWasCoarse {
+    return _coarseToFine && _coarseToFine->lastWasCoarse();
+}
+
+- (NSInteger)coarseAcceptedCount {
+    return _coarseToFine ? (NSInteger)_coarseToFine->stats().coarse_accepted : 0;
+}
+
+- (NSInteger)finePassCount {
+    return _coarseToFine ? (NSInteger)_coarseToFine->stats().fine_passes : 0;
+}
+
+// The tracker whose state describes the last result.
+- (lar::Tracker*)lastTracker {
+    return _coarseToFine ? &_coarseToFine->last() : self->_internal;
+}
+
 // Diagnostic information methods
 - (NSInteger)spatialQueryCount {
-    return self->_internal->local_landmarks.size();
+    return [self lastTracker]->local_landmarks.size();
 }
 
 - (NSArray<NSNumber*>*)spatialQueryLandmarkIds {
     NSMutableArray<NSNumber*>* landmarkIds = [NSMutableArray array];
     
-    for (const auto& landmark : self->_internal->local_landmarks) {
+    for (const auto& landmark : [self lastTracker]->local_landmarks) {
         if (landmark) { // Check if landmark pointer is valid
             [landmarkIds addObject:@(landmark->id)];
         }
@@ -86,13 +133,13 @@
 }
 
 - (NSInteger)matchCount {
-    return self->_internal->matches.size();
+    return [self lastTracker]->matches.size();
 }
 
 - (NSArray<NSNumber*>*)matchLandmarkIds {
     NSMutableArray<NSNumber*>* landmarkIds = [NSMutableArray array];
     
-    for (const auto& match : self->_internal->matches) {
+    for (const auto& match : [self lastTracker]->matches) {
         if (match.first) { // Check if landmark pointer is valid
             [landmarkIds addObject:@(match.first->id)];
         }
@@ -102,13 +149,13 @@
 }
 
 - (NSInteger)inlierCount {
-    return self->_internal->inliers.size();
+    return [self lastTracker]->inliers.size();
 }
 
 - (NSArray<NSNumber*>*)inlierLandmarkIds {
     NSMutableArray<NSNumber*>* landmarkIds = [NSMutableArray array];
     
-    for (const auto& inlier : self->_internal->inliers) {
+    for (const auto& inlier : [self lastTracker]->inliers) {
         if (inlier.first) { // Check if landmark pointer is valid
             [landmarkIds addObject:@(inlier.first->id)];
         }
@@ -118,7 +165,7 @@
 }
 
 - (double)gravityAngleDifference {
-    return self->_internal->getLastGravityAngleDifference();
+    return [self lastTracker]->getLastGravityAngleDifference();
 }
 
 @end
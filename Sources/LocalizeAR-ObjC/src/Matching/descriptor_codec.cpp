@@ -0,0 +1,297 @@
+//
+//  descriptor_codec.cpp
+//  LocalizeAR
+//
+
+#include "descriptor_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <opencv2/core.hpp>
+
+namespace lar::bridge {
+
+namespace {
+
+struct SerializedHeader {
+    uint32_t kind;
+    uint32_t dims;
+    uint32_t subspaces;
+    uint32_t centroids;
+};
+
+// Float copy of at most `max_rows` evenly spaced rows of `samples`.
+cv::Mat trainingRows(const cv::Mat& samples, int max_rows) {
+    if (samples.empty()) {
+        throw std::invalid_argument("Cannot train a descriptor codec without samples");
+    }
+    cv::Mat rows;
+    if (samples.rows <= max_rows) {
+        samples.convertTo(rows, CV_32F);
+        return rows;
+    }
+    rows.create(max_rows, samples.cols, CV_32F);
+    const double step = double(samples.rows) / max_rows;
+    for (int i = 0; i < max_rows; i++) {
+        samples.row(static_cast<int>(i * step)).convertTo(rows.row(i), CV_32F);
+    }
+    return rows;
+}
+
+float squaredDistance(const float* a, const float* b, int n) {
+    float sum = 0;
+    for (int i = 0; i < n; i++) {
+        const float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+} // namespace
+
+DescriptorCodec::DescriptorCodec(DescriptorCodecKind kind, int dims, int subspaces)
+    : kind_(kind), dims_(dims), subspaces_(subspaces) {}
+
+DescriptorCodec DescriptorCodec::trainScalar8(const cv::Mat& samples) {
+    cv::Mat rows = trainingRows(samples, kMaxTrainingRows);
+    DescriptorCodec codec(DescriptorCodecKind::Scalar8, rows.cols, rows.cols);
+    codec.codebook_.resize(2 * size_t(rows.cols));
+    float* min = codec.codebook_.data();
+    float* step = min + rows.cols;
+    for (int d = 0; d < rows.cols; d++) {
+        double lo, hi;
+        cv::minMaxLoc(rows.col(d), &lo, &hi);
+        min[d] = static_cast<float>(lo);
+        step[d] = hi > lo ? static_cast<float>((hi - lo) / 255.0) : 1.0f;
+    }
+    return codec;
+}
+
+DescriptorCodec DescriptorCodec::trainProduct(const cv::Mat& samples, int subspaces, int iterations) {
+    if (subspaces <= 0 || samples.cols % subspaces != 0) {
+        throw std::invalid_argument("Descriptor length must be divisible by the number of subspaces");
+    }
+    cv::Mat rows = trainingRows(samples, kMaxTrainingRows);
+    DescriptorCodec codec(DescriptorCodecKind::Product, rows.cols, subspaces);
+    const int sub_dims = rows.cols / subspaces;
+    const int clusters = std::min(kCentroids, rows.rows);
+    codec.codebook_.assign(size_t(subspaces) * kCentroids * sub_dims, 0.0f);
+
+    for (int m = 0; m < subspaces; m++) {
+        cv::Mat chunk = rows.colRange(m * sub_dims, (m + 1) * sub_dims).clone();
+        cv::Mat labels, centers;
+        cv::kmeans(chunk, clusters, labels,
+                   cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, iterations, 1e-3),
+                   1, cv::KMEANS_PP_CENTERS, centers);
+        float* out = codec.codebook_.data() + size_t(m) * kCentroids * sub_dims;
+        for (int c = 0; c < clusters; c++) {
+            std::memcpy(out + size_t(c) * sub_dims, centers.ptr<float>(c), sub_dims * sizeof(float));
+        }
+        // With fewer samples than centroids the unused slots repeat the first centroid, so
+        // they're never strictly closer than a trained one.
+        for (int c = clusters; c < kCentroids; c++) {
+            std::memcpy(out + size_t(c) * sub_dims, out, sub_dims * sizeof(float));
+        }
+    }
+    return codec;
+}
+
+DescriptorCodec DescriptorCodec::deserialize(const uint8_t* data, size_t size) {
+    SerializedHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error("Descriptor codebook is truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    const auto kind = static_cast<DescriptorCodecKind>(header.kind);
+    if ((kind != DescriptorCodecKind::Scalar8 && kind != DescriptorCodecKind::Product) ||
+        header.dims == 0 || header.subspaces == 0 || header.dims % header.subspaces != 0 ||
+        (kind == DescriptorCodecKind::Product && header.centroids != uint32_t(kCentroids))) {
+        throw std::runtime_error("Descriptor codebook is malformed");
+    }
+
+    DescriptorCodec codec(kind, int(header.dims), int(header.subspaces));
+    const size_t floats = kind == DescriptorCodecKind::Product
+        ? size_t(header.subspaces) * kCentroids * (header.dims / header.subspaces)
+        : 2 * size_t(header.dims);
+    if (size != sizeof(header) + floats * sizeof(float)) {
+        throw std::runtime_error("Descriptor codebook has the wrong size");
+    }
+    codec.codebook_.resize(floats);
+    std::memcpy(codec.codebook_.data(), data + sizeof(header), floats * sizeof(float));
+    return codec;
+}
+
+std::vector<uint8_t> DescriptorCodec::serialize() const {
+    const SerializedHeader header{
+        static_cast<uint32_t>(kind_), uint32_t(dims_), uint32_t(subspaces_),
+        kind_ == DescriptorCodecKind::Product ? uint32_t(kCentroids) : 0u,
+    };
+    std::vector<uint8_t> bytes(sizeof(header) + codebook_.size() * sizeof(float));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), codebook_.data(), codebook_.size() * sizeof(float));
+    return bytes;
+}
+
+cv::Mat DescriptorCodec::encode(const cv::Mat& descriptors) const {
+    if (descriptors.cols != dims_) {
+        throw std::invalid_argument("Descriptor length doesn't match the codec");
+    }
+    cv::Mat codes(descriptors.rows, static_cast<int>(codeSize()), CV_8U);
+    cv::Mat row;
+    for (int i = 0; i < descriptors.rows; i++) {
+        descriptors.row(i).convertTo(row, CV_32F);
+        encode(row.ptr<float>(), codes.ptr<uint8_t>(i));
+    }
+    return codes;
+}
+
+void DescriptorCodec::encode(const float* descriptor, uint8_t* code) const {
+    if (kind_ == DescriptorCodecKind::Scalar8) {
+        const float* min = codebook_.data();
+        const float* step = min + dims_;
+        for (int d = 0; d < dims_; d++) {
+            const float q = std::round((descriptor[d] - min[d]) / step[d]);
+            code[d] = static_cast<uint8_t>(std::clamp(q, 0.0f, 255.0f));
+        }
+        return;
+    }
+
+    const int sub_dims = dims_ / subspaces_;
+    for (int m = 0; m < subspaces_; m++) {
+        const float* centroids = codebook_.data() + size_t(m) * kCentroids * sub_dims;
+        const float* chunk = descriptor + m * sub_dims;
+        int best = 0;
+        float best_distance = squaredDistance(chunk, centroids, sub_dims);
+        for (int c = 1; c < kCentroids; c++) {
+            const float distance = squaredDistance(chunk, centroids + size_t(c) * sub_dims, sub_dims);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = c;
+            }
+        }
+        code[m] = static_cast<uint8_t>(best);
+    }
+}
+
+void DescriptorCodec::decode(const uint8_t* code, float* descriptor) const {
+    if (kind_ == DescriptorCodecKind::Scalar8) {
+        const float* min = codebook_.data();
+        const float* step = min + dims_;
+        for (int d = 0; d < dims_; d++) {
+            descriptor[d] = min[d] + step[d] * code[d];
+        }
+        return;
+    }
+
+    const int sub_dims = dims_ / subspaces_;
+    for (int m = 0; m < subspaces_; m++) {
+        const float* centroid = codebook_.data() + (size_t(m) * kCentroids + code[m]) * sub_dims;
+        std::memcpy(descriptor + m * sub_dims, centroid, sub_dims * sizeof(float));
+    }
+}
+
+std::vector<float> DescriptorCodec::prepareQuery(const float* query) const {
+    if (kind_ == DescriptorCodecKind::Scalar8) {
+        return std::vector<float>(query, query + dims_);
+    }
+
+    const int sub_dims = dims_ / subspaces_;
+    std::vector<float> table(size_t(subspaces_) * kCentroids);
+    for (int m = 0; m < subspaces_; m++) {
+        const float* centroids = codebook_.data() + size_t(m) * kCentroids * sub_dims;
+        for (int c = 0; c < kCentroids; c++) {
+            table[size_t(m) * kCentroids + c] = squaredDistance(query + m * sub_dims, centroids + size_t(c) * sub_dims, sub_dims);
+        }
+    }
+    return table;
+}
+
+float DescriptorCodec::distance(const std::vector<float>& prepared, const uint8_t* code) const {
+    float sum = 0;
+    if (kind_ == DescriptorCodecKind::Scalar8) {
+        const float* min = codebook_.data();
+        const float* step = min + dims_;
+        for (int d = 0; d < dims_; d++) {
+            const float diff = prepared[d] - (min[d] + step[d] * code[d]);
+            sum += diff * diff;
+        }
+        return sum;
+    }
+
+    const float* table = prepared.data();
+    for (int m = 0; m < subspaces_; m++, table += kCentroids) {
+        sum += table[code[m]];
+    }
+    return sum;
+}
+
+// MARK: - CompressedDescriptorIndex
+
+CompressedDescriptorIndex::CompressedDescriptorIndex(DescriptorCodec codec, cv::Mat codes, cv::Mat exact,
+                                                     std::vector<bool> has_descriptor)
+    : codec_(std::move(codec)), codes_(std::move(codes)), exact_(std::move(exact)),
+      has_descriptor_(std::move(has_descriptor)) {
+    if (codes_.type() != CV_8U || size_t(codes_.cols) != codec_.codeSize()) {
+        throw std::invalid_argument("Descriptor codes don't match the codec");
+    }
+    if (!exact_.empty() && (exact_.rows != codes_.rows || exact_.cols != codec_.dims() ||
+                            (exact_.type() != CV_8U && exact_.type() != CV_32F))) {
+        throw std::invalid_argument("Exact descriptors don't match the codes");
+    }
+    if (!has_descriptor_.empty() && has_descriptor_.size() != size_t(codes_.rows)) {
+        throw std::invalid_argument("Descriptor flags don't match the codes");
+    }
+}
+
+std::vector<CompressedDescriptorIndex::Match> CompressedDescriptorIndex::search(
+    const float* query, size_t k, size_t rerank, const std::vector<uint32_t>& candidates) const {
+    const std::vector<float> prepared = codec_.prepareQuery(query);
+
+    std::vector<Match> scored;
+    if (candidates.empty()) {
+        scored.reserve(size());
+        for (uint32_t i = 0; i < uint32_t(size()); i++) {
+            if (!hasDescriptor(i)) continue;
+            scored.push_back({ i, codec_.distance(prepared, codes_.ptr<uint8_t>(int(i))) });
+        }
+    } else {
+        scored.reserve(candidates.size());
+        for (uint32_t i : candidates) {
+            if (i >= size() || !hasDescriptor(i)) continue;
+            scored.push_back({ i, codec_.distance(prepared, codes_.ptr<uint8_t>(int(i))) });
+        }
+    }
+
+    const auto closer = [](const Match& a, const Match& b) { return a.distance < b.distance; };
+    const size_t depth = std::min(scored.size(), canRerank() ? std::max(k, rerank) : k);
+    std::partial_sort(scored.begin(), scored.begin() + depth, scored.end(), closer);
+    scored.resize(depth);
+
+    if (canRerank() && rerank > k) {
+        for (Match& match : scored) {
+            match.distance = exactDistance(query, match.index);
+        }
+        std::sort(scored.begin(), scored.end(), closer);
+    }
+    scored.resize(std::min(k, scored.size()));
+    return scored;
+}
+
+float CompressedDescriptorIndex::exactDistance(const float* query, uint32_t index) const {
+    const int dims = codec_.dims();
+    if (exact_.type() == CV_32F) {
+        return squaredDistance(query, exact_.ptr<float>(int(index)), dims);
+    }
+    const uint8_t* row = exact_.ptr<uint8_t>(int(index));
+    float sum = 0;
+    for (int d = 0; d < dims; d++) {
+        const float diff = query[d] - float(row[d]);
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,110 @@
+//
+//  descriptor_codec.h
+//  LocalizeAR
+//
+//  Compressed landmark descriptors.
+//
+//  Two codecs with per-map codebooks:
+//  - Scalar8: every dimension quantized to 8 bits against its own min/max (4x for float SIFT).
+//  - Product: the descriptor is split into `subspaces` chunks and each chunk is replaced by the
+//    index of its nearest of 256 k-means centroids, i.e. one byte per subspace (16x for float
+//    SIFT with 32 subspaces).
+//  Queries stay uncompressed: distances are asymmetric (exact query vs. decoded code), and for
+//  product codes come from a per-query lookup table so scanning a code costs `subspaces` adds.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+namespace lar::bridge {
+
+enum class DescriptorCodecKind : uint32_t {
+    Scalar8 = 1,
+    Product = 2,
+};
+
+class DescriptorCodec {
+public:
+    static constexpr int kCentroids = 256;
+    // Rows sampled for training; k-means cost grows linearly with it.
+    static constexpr int kMaxTrainingRows = 20000;
+
+    // `samples` holds one descriptor per row (CV_8U or CV_32F). Throws std::invalid_argument if
+    // it is empty or `dims` isn't divisible by `subspaces`.
+    static DescriptorCodec trainScalar8(const cv::Mat& samples);
+    static DescriptorCodec trainProduct(const cv::Mat& samples, int subspaces, int iterations = 20);
+
+    // Inverse of `serialize`. Throws std::runtime_error on malformed input.
+    static DescriptorCodec deserialize(const uint8_t* data, size_t size);
+    std::vector<uint8_t> serialize() const;
+
+    DescriptorCodecKind kind() const { return kind_; }
+    int dims() const { return dims_; }
+    int subspaces() const { return subspaces_; }
+    // Bytes per encoded descriptor.
+    size_t codeSize() const { return kind_ == DescriptorCodecKind::Product ? size_t(subspaces_) : size_t(dims_); }
+
+    // `descriptors` holds one descriptor per row; returns rows x codeSize() CV_8U codes.
+    cv::Mat encode(const cv::Mat& descriptors) const;
+    void encode(const float* descriptor, uint8_t* code) const;
+    void decode(const uint8_t* code, float* descriptor) const;
+
+    // Per-query state for asymmetric distances. For product codes this is the squared distance
+    // from each query chunk to every centroid; for scalar codes it is the query itself.
+    std::vector<float> prepareQuery(const float* query) const;
+    // Squared L2 distance between the prepared query and an encoded descriptor.
+    float distance(const std::vector<float>& prepared, const uint8_t* code) const;
+
+private:
+    DescriptorCodec(DescriptorCodecKind kind, int dims, int subspaces);
+
+    DescriptorCodecKind kind_;
+    int dims_;
+    int subspaces_;
+    // Scalar8: [min[dims], step[dims]]. Product: [subspaces][kCentroids][dims / subspaces].
+    std::vector<float> codebook_;
+};
+
+// Nearest-neighbour search over encoded descriptors with optional exact re-ranking.
+class CompressedDescriptorIndex {
+public:
+    struct Match {
+        uint32_t index;
+        float distance;
+    };
+
+    // `codes` is n x codec.codeSize() CV_8U. `exact` (n x dims, CV_8U or CV_32F, may be empty)
+    // is only read for re-ranked candidates, so it can alias a memory-mapped archive without
+    // being paged in. `has_descriptor` (n entries, or empty if every row has one) marks the rows
+    // that were encoded; the others hold placeholder codes and are never returned.
+    CompressedDescriptorIndex(DescriptorCodec codec, cv::Mat codes, cv::Mat exact = cv::Mat(),
+                              std::vector<bool> has_descriptor = {});
+
+    const DescriptorCodec& codec() const { return codec_; }
+    size_t size() const { return static_cast<size_t>(codes_.rows); }
+    bool hasDescriptor(uint32_t index) const { return has_descriptor_.empty() || has_descriptor_[index]; }
+    bool canRerank() const { return !exact_.empty(); }
+
+    // The `k` nearest of `candidates` (all rows if empty) by asymmetric distance. When
+    // `rerank` > k and exact descriptors are available, the best `rerank` candidates are
+    // re-scored with exact distances before the top `k` are returned. Sorted by distance.
+    // Candidates that aren't rows of the index are skipped.
+    std::vector<Match> search(const float* query, size_t k, size_t rerank = 0,
+                              const std::vector<uint32_t>& candidates = {}) const;
+
+    // Exact squared L2 distance to row `index` of the exact descriptors.
+    float exactDistance(const float* query, uint32_t index) const;
+
+private:
+    DescriptorCodec codec_;
+    cv::Mat codes_;
+    cv::Mat exact_;
+    std::vector<bool> has_descriptor_;
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,98 @@
+//
+//  descriptor_recall.cpp
+//  LocalizeAR
+//
+
+#include "descriptor_recall.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <lar/core/map.h>
+
+#include "../Spatial/landmark_index.h"
+
+namespace lar::bridge {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+DescriptorRecallEvaluator::DescriptorRecallEvaluator(const lar::Map& map, DescriptorCodec codec, size_t rerank_depth)
+    : rerank_depth_(rerank_depth) {
+    for (lar::Landmark* landmark : map.landmarks.all()) {
+        if (landmark->desc.empty()) continue;
+        if (descriptor_type_ < 0) descriptor_type_ = landmark->desc.type();
+        landmarks_.push_back(landmark);
+    }
+    if (landmarks_.empty()) {
+        throw std::invalid_argument("Map has no landmark descriptors");
+    }
+
+    cv::Mat exact(static_cast<int>(landmarks_.size()), codec.dims(), descriptor_type_);
+    for (size_t i = 0; i < landmarks_.size(); i++) {
+        const cv::Mat& desc = landmarks_[i]->desc;
+        if (desc.total() != size_t(codec.dims()) || desc.type() != descriptor_type_) {
+            throw std::invalid_argument("Landmark descriptors don't match the codec");
+        }
+        desc.reshape(1, 1).copyTo(exact.row(static_cast<int>(i)));
+    }
+
+    cv::Mat codes = codec.encode(exact);
+    exact_bytes_ = uint64_t(exact.total()) * exact.elemSize();
+    compressed_bytes_ = uint64_t(codes.total()) + codec.serialize().size();
+    index_ = std::make_unique<CompressedDescriptorIndex>(std::move(codec), codes, exact);
+    tree_ = PackedRTree(LandmarkIndex::boundsOf(landmarks_));
+}
+
+std::vector<uint32_t> DescriptorRecallEvaluator::candidates(double x, double z, double diameter) const {
+    std::vector<uint32_t> indices = tree_.search(PackedRTree::Box::around(x, z, diameter));
+    // Keep landmark order so ties resolve the same way as a scan would.
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+void DescriptorRecallEvaluator::evaluate(const cv::Mat& queries, double x, double z, double diameter) {
+    const std::vector<uint32_t> visible = candidates(x, z, diameter);
+    if (visible.empty() || queries.empty()) return;
+
+    cv::Mat rows;
+    queries.convertTo(rows, CV_32F);
+    for (int q = 0; q < rows.rows; q++) {
+        const float* query = rows.ptr<float>(q);
+
+        auto start = Clock::now();
+        uint32_t nearest = visible.front();
+        float nearest_distance = index_->exactDistance(query, nearest);
+        for (uint32_t i : visible) {
+            const float distance = index_->exactDistance(query, i);
+            if (distance < nearest_distance) {
+                nearest_distance = distance;
+                nearest = i;
+            }
+        }
+        result_.exact_seconds += secondsSince(start);
+
+        start = Clock::now();
+        const auto approximate = index_->search(query, 1, 0, visible);
+        result_.approximate_seconds += secondsSince(start);
+
+        start = Clock::now();
+        const auto reranked = index_->search(query, 1, rerank_depth_, visible);
+        result_.reranked_seconds += secondsSince(start);
+
+        // Ties in exact distance count as hits.
+        result_.queries++;
+        if (index_->exactDistance(query, approximate.front().index) <= nearest_distance) result_.approximate_hits++;
+        if (index_->exactDistance(query, reranked.front().index) <= nearest_distance) result_.reranked_hits++;
+    }
+}
+
+} // namespace lar::bridge
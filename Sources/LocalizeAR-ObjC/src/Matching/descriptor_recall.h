@@ -0,0 +1,69 @@
+//
+//  descriptor_recall.h
+//  LocalizeAR
+//
+//  Measures how often matching on compressed descriptor codes finds the same nearest landmark
+//  as exact matching, for query descriptors extracted from replayed frames.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+#include "descriptor_codec.h"
+#include "../Spatial/packed_rtree.h"
+
+namespace lar {
+    class Map;
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+class DescriptorRecallEvaluator {
+public:
+    struct Result {
+        size_t queries = 0;
+        // Queries whose nearest landmark by code distance alone is the exact nearest landmark.
+        size_t approximate_hits = 0;
+        // Same, after re-ranking the best `rerank_depth` code matches with exact distances.
+        size_t reranked_hits = 0;
+        double exact_seconds = 0;
+        double approximate_seconds = 0;
+        double reranked_seconds = 0;
+    };
+
+    // Encodes every landmark descriptor of `map` with `codec`. Throws std::invalid_argument if
+    // the map has no descriptors or they don't match the codec.
+    DescriptorRecallEvaluator(const lar::Map& map, DescriptorCodec codec, size_t rerank_depth);
+
+    // Matches each row of `queries` against the landmarks visible from the query square, the
+    // same candidate set a spatial query would hand the matcher.
+    void evaluate(const cv::Mat& queries, double x, double z, double diameter);
+
+    const Result& result() const { return result_; }
+    const DescriptorCodec& codec() const { return index_->codec(); }
+    int descriptorType() const { return descriptor_type_; }
+    // Bytes held by exact descriptors vs. codes plus codebook.
+    uint64_t exactBytes() const { return exact_bytes_; }
+    uint64_t compressedBytes() const { return compressed_bytes_; }
+
+private:
+    std::vector<uint32_t> candidates(double x, double z, double diameter) const;
+
+    std::vector<lar::Landmark*> landmarks_;
+    std::unique_ptr<CompressedDescriptorIndex> index_;
+    PackedRTree tree_;
+    size_t rerank_depth_;
+    int descriptor_type_ = -1;
+    uint64_t exact_bytes_ = 0;
+    uint64_t compressed_bytes_ = 0;
+    Result result_;
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,139 @@
+//
+//  box_kernels.cpp
+//  LocalizeAR
+//
+
+#include "box_kernels.h"
+
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LAR_BOX_KERNEL_AVX2 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define LAR_BOX_KERNEL_NEON 1
+#endif
+
+namespace lar::bridge {
+
+namespace {
+
+using Kernel = uint64_t (*)(const BoxColumns&, size_t, size_t, const FloatBox&);
+
+uint64_t intersectScalar(const BoxColumns& boxes, size_t first, size_t count, const FloatBox& query) {
+    uint64_t hits = 0;
+    for (size_t i = 0; i < count; i++) {
+        const size_t j = first + i;
+        const bool hit = boxes.lower_x[j] <= query.upper_x && query.lower_x <= boxes.upper_x[j] &&
+                         boxes.lower_z[j] <= query.upper_z && query.lower_z <= boxes.upper_z[j];
+        hits |= uint64_t(hit) << i;
+    }
+    return hits;
+}
+
+#if LAR_BOX_KERNEL_AVX2
+__attribute__((target("avx2")))
+uint64_t intersectAVX2(const BoxColumns& boxes, size_t first, size_t count, const FloatBox& query) {
+    const __m256 query_lower_x = _mm256_set1_ps(query.lower_x);
+    const __m256 query_lower_z = _mm256_set1_ps(query.lower_z);
+    const __m256 query_upper_x = _mm256_set1_ps(query.upper_x);
+    const __m256 query_upper_z = _mm256_set1_ps(query.upper_z);
+    uint64_t hits = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const size_t j = first + i;
+        const __m256 x = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(boxes.lower_x + j), query_upper_x, _CMP_LE_OQ),
+            _mm256_cmp_ps(query_lower_x, _mm256_loadu_ps(boxes.upper_x + j), _CMP_LE_OQ));
+        const __m256 z = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(boxes.lower_z + j), query_upper_z, _CMP_LE_OQ),
+            _mm256_cmp_ps(query_lower_z, _mm256_loadu_ps(boxes.upper_z + j), _CMP_LE_OQ));
+        hits |= uint64_t(uint32_t(_mm256_movemask_ps(_mm256_and_ps(x, z)))) << i;
+    }
+    if (i < count) hits |= intersectScalar(boxes, first + i, count - i, query) << i;
+    return hits;
+}
+
+bool supportsAVX2() {
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#if LAR_BOX_KERNEL_NEON
+uint64_t intersectNEON(const BoxColumns& boxes, size_t first, size_t count, const FloatBox& query) {
+    const float32x4_t query_lower_x = vdupq_n_f32(query.lower_x);
+    const float32x4_t query_lower_z = vdupq_n_f32(query.lower_z);
+    const float32x4_t query_upper_x = vdupq_n_f32(query.upper_x);
+    const float32x4_t query_upper_z = vdupq_n_f32(query.upper_z);
+    const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t bits = vld1q_u32(lane_bits);
+    uint64_t hits = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const size_t j = first + i;
+        const uint32x4_t x = vandq_u32(
+            vcleq_f32(vld1q_f32(boxes.lower_x + j), query_upper_x),
+            vcleq_f32(query_lower_x, vld1q_f32(boxes.upper_x + j)));
+        const uint32x4_t z = vandq_u32(
+            vcleq_f32(vld1q_f32(boxes.lower_z + j), query_upper_z),
+            vcleq_f32(query_lower_z, vld1q_f32(boxes.upper_z + j)));
+        hits |= uint64_t(vaddvq_u32(vandq_u32(vandq_u32(x, z), bits))) << i;
+    }
+    if (i < count) hits |= intersectScalar(boxes, first + i, count - i, query) << i;
+    return hits;
+}
+#endif
+
+Kernel kernelFor(BoxKernel kernel) {
+    switch (kernel) {
+#if LAR_BOX_KERNEL_AVX2
+        case BoxKernel::AVX2: return supportsAVX2() ? intersectAVX2 : nullptr;
+#endif
+#if LAR_BOX_KERNEL_NEON
+        case BoxKernel::NEON: return intersectNEON;
+#endif
+        case BoxKernel::Scalar: return intersectScalar;
+        default: return nullptr;
+    }
+}
+
+BoxKernel detect() {
+    for (BoxKernel kernel : { BoxKernel::NEON, BoxKernel::AVX2 }) {
+        if (kernelFor(kernel)) return kernel;
+    }
+    return BoxKernel::Scalar;
+}
+
+} // namespace
+
+uint64_t intersectBoxes(BoxKernel kernel, const BoxColumns& boxes, size_t first, size_t count, const FloatBox& query) {
+    switch (kernel) {
+#if LAR_BOX_KERNEL_AVX2
+        case BoxKernel::AVX2: return intersectAVX2(boxes, first, count, query);
+#endif
+#if LAR_BOX_KERNEL_NEON
+        case BoxKernel::NEON: return intersectNEON(boxes, first, count, query);
+#endif
+        default: return intersectScalar(boxes, first, count, query);
+    }
+}
+
+BoxKernel activeBoxKernel() {
+    static const BoxKernel detected = detect();
+    return detected;
+}
+
+bool supportsBoxKernel(BoxKernel kernel) {
+    return kernelFor(kernel) != nullptr;
+}
+
+const char* boxKernelName(BoxKernel kernel) {
+    switch (kernel) {
+        case BoxKernel::AVX2: return "AVX2";
+        case BoxKernel::NEON: return "NEON";
+        default: return "scalar";
+    }
+}
+
+} // namespace lar::bridge
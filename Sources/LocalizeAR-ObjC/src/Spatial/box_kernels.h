@@ -0,0 +1,42 @@
+//
+//  box_kernels.h
+//  LocalizeAR
+//
+//  Batched box intersection tests over structure-of-arrays box columns.
+//
+//  The fastest kernel this CPU supports is detected once at startup: NEON on arm64, AVX2 on
+//  x86-64 CPUs that support it, and a scalar loop otherwise. Callers pass the kernel they
+//  want, so there is no process-wide switch; a PackedRTree keeps its own. Boxes are single
+//  precision, so a kernel tests 4 (NEON) or 8 (AVX2) boxes per comparison.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lar::bridge {
+
+struct FloatBox {
+    float lower_x, lower_z, upper_x, upper_z;
+};
+
+struct BoxColumns {
+    const float* lower_x;
+    const float* lower_z;
+    const float* upper_x;
+    const float* upper_z;
+};
+
+enum class BoxKernel { Scalar, AVX2, NEON };
+
+// Sets bit i of the result if box `first + i` intersects `query` (edges touching counts).
+// `count` must be at most 64 and `kernel` one this CPU supports.
+uint64_t intersectBoxes(BoxKernel kernel, const BoxColumns& boxes, size_t first, size_t count, const FloatBox& query);
+
+// The fastest kernel this CPU supports, the default for new trees.
+BoxKernel activeBoxKernel();
+bool supportsBoxKernel(BoxKernel kernel);
+const char* boxKernelName(BoxKernel kernel);
+
+} // namespace lar::bridge
@@ -0,0 +1,189 @@
+//
+//  covisibility_graph.cpp
+//  LocalizeAR
+//
+
+#include "covisibility_graph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+#include <lar/core/landmark.h>
+
+#include "landmark_index.h"
+
+namespace lar::bridge {
+
+namespace {
+
+bool movedEnough(const CovisibilityGraph::Transform& from, const CovisibilityGraph::Transform& to,
+                 const CovisibilityGraph::Options& options) {
+    if ((to.translation() - from.translation()).norm() >= options.keyframe_distance) return true;
+    // VIO poses are rigid, so the linear part is the rotation.
+    const Eigen::AngleAxisd turn(Eigen::Matrix3d(from.linear().transpose() * to.linear()));
+    return std::abs(turn.angle()) >= options.keyframe_angle;
+}
+
+// Flips a keyframe -> items adjacency into item -> keyframes.
+void invert(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& values, size_t targets,
+            std::vector<uint32_t>& inverted_offsets, std::vector<uint32_t>& inverted_values) {
+    inverted_offsets.assign(targets + 1, 0);
+    for (uint32_t value : values) inverted_offsets[value + 1]++;
+    std::partial_sum(inverted_offsets.begin(), inverted_offsets.end(), inverted_offsets.begin());
+    inverted_values.resize(values.size());
+    std::vector<uint32_t> cursor(inverted_offsets.begin(), inverted_offsets.end() - 1);
+    for (uint32_t source = 0; source + 1 < offsets.size(); source++) {
+        for (uint32_t i = offsets[source]; i < offsets[source + 1]; i++) {
+            inverted_values[cursor[values[i]]++] = source;
+        }
+    }
+}
+
+} // namespace
+
+CovisibilityGraph::CovisibilityGraph(const LandmarkIndex& index, const std::vector<View>& views, const Options& options)
+    : index_(&index) {
+    items_by_id_.reserve(index.size());
+    for (uint32_t item = 0; item < index.size(); item++) {
+        items_by_id_.emplace(index.landmark(item)->id, item);
+    }
+
+    keyframe_offsets_.push_back(0);
+    const View* last = nullptr;
+    for (const View& view : views) {
+        if (last && !movedEnough(last->camera_to_map, view.camera_to_map, options)) continue;
+        last = &view;
+
+        const FrustumFilter frustum(view.camera_to_map, view.intrinsics, options.frustum);
+        const Eigen::Vector3d camera = view.camera_to_map.translation();
+        keyframe_positions_.push_back(camera);
+        const auto region = PackedRTree::Box::around(camera.x(), camera.z(), 2 * options.frustum.far_distance);
+        const size_t first = keyframe_items_.size();
+        index.tree().search(region, [&](uint32_t item) {
+            if (frustum.accepts(*index.landmark(item))) keyframe_items_.push_back(item);
+        });
+        std::sort(keyframe_items_.begin() + first, keyframe_items_.end());
+        keyframe_offsets_.push_back(static_cast<uint32_t>(keyframe_items_.size()));
+    }
+
+    invert(keyframe_offsets_, keyframe_items_, index.size(), item_offsets_, item_keyframes_);
+    linkKeyframes(options);
+}
+
+void CovisibilityGraph::linkKeyframes(const Options& options) {
+    const size_t keyframes = keyframeCount();
+    std::vector<uint32_t> shared(keyframes, 0);
+    std::vector<uint32_t> touched;
+    std::vector<Link> candidates;
+
+    link_offsets_.assign(1, 0);
+    for (uint32_t keyframe = 0; keyframe < keyframes; keyframe++) {
+        for (uint32_t i = keyframe_offsets_[keyframe]; i < keyframe_offsets_[keyframe + 1]; i++) {
+            const uint32_t item = keyframe_items_[i];
+            for (uint32_t j = item_offsets_[item]; j < item_offsets_[item + 1]; j++) {
+                const uint32_t other = item_keyframes_[j];
+                if (other == keyframe) continue;
+                if (shared[other]++ == 0) touched.push_back(other);
+            }
+        }
+
+        candidates.clear();
+        for (uint32_t other : touched) {
+            if (shared[other] >= options.min_shared_landmarks) candidates.push_back({ other, shared[other] });
+            shared[other] = 0;
+        }
+        touched.clear();
+
+        const size_t kept = std::min(candidates.size(), options.max_neighbors);
+        std::partial_sort(candidates.begin(), candidates.begin() + kept, candidates.end(), [](const Link& a, const Link& b) {
+            return a.shared_landmarks != b.shared_landmarks ? a.shared_landmarks > b.shared_landmarks : a.keyframe < b.keyframe;
+        });
+        links_.insert(links_.end(), candidates.begin(), candidates.begin() + kept);
+        link_offsets_.push_back(static_cast<uint32_t>(links_.size()));
+    }
+}
+
+size_t CovisibilityGraph::memoryBytes() const {
+    const size_t arrays = keyframe_offsets_.capacity() + keyframe_items_.capacity() + item_offsets_.capacity()
+        + item_keyframes_.capacity() + link_offsets_.capacity();
+    // Hash nodes hold the key, the value and a next pointer.
+    const size_t ids = items_by_id_.bucket_count() * sizeof(void*)
+        + items_by_id_.size() * (sizeof(size_t) + sizeof(uint32_t) + sizeof(void*));
+    return arrays * sizeof(uint32_t) + links_.capacity() * sizeof(Link) + ids
+        + keyframe_positions_.capacity() * sizeof(Eigen::Vector3d);
+}
+
+int64_t CovisibilityGraph::item(size_t id) const {
+    const auto it = items_by_id_.find(id);
+    return it == items_by_id_.end() ? -1 : static_cast<int64_t>(it->second);
+}
+
+std::vector<float> CovisibilityGraph::viewSpread() const {
+    std::vector<float> spread(item_offsets_.size() - 1, 0.f);
+    for (uint32_t item = 0; item < spread.size(); item++) {
+        const uint32_t first = item_offsets_[item], last = item_offsets_[item + 1];
+        if (last - first < 2) continue;
+        const Eigen::Vector3d& position = index_->landmark(item)->position;
+        Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+        for (uint32_t j = first; j < last; j++) {
+            sum += (keyframe_positions_[item_keyframes_[j]] - position).normalized();
+        }
+        // The mean of unit vectors shrinks as they fan out; its length is the cosine of
+        // their angular radius for two directions and close to it for more.
+        const double length = std::min(1.0, sum.norm() / (last - first));
+        spread[item] = static_cast<float>(std::acos(length));
+    }
+    return spread;
+}
+
+std::vector<uint32_t> CovisibilityGraph::expand(const std::vector<uint32_t>& seeds, size_t max_keyframes, bool neighbors) const {
+    const size_t keyframes = keyframeCount();
+    std::vector<uint32_t> score(keyframes, 0);
+    std::vector<uint32_t> ranked;
+    std::vector<uint32_t> items;
+    for (uint32_t seed : seeds) {
+        if (seed >= index_->size()) continue;
+        items.push_back(seed);
+        for (uint32_t j = item_offsets_[seed]; j < item_offsets_[seed + 1]; j++) {
+            if (score[item_keyframes_[j]]++ == 0) ranked.push_back(item_keyframes_[j]);
+        }
+    }
+
+    const auto stronger = [&score](uint32_t a, uint32_t b) {
+        return score[a] != score[b] ? score[a] > score[b] : a < b;
+    };
+    const size_t primary = std::min(ranked.size(), max_keyframes);
+    std::partial_sort(ranked.begin(), ranked.begin() + primary, ranked.end(), stronger);
+    ranked.resize(primary);
+
+    if (neighbors && primary < max_keyframes) {
+        // Rank neighbors by how strongly the chosen keyframes link to them. Chosen keyframes
+        // are marked with a score no neighbor total can reach.
+        std::fill(score.begin(), score.end(), 0);
+        for (uint32_t keyframe : ranked) score[keyframe] = UINT32_MAX;
+        std::vector<uint32_t> linked;
+        for (uint32_t keyframe : ranked) {
+            for (uint32_t l = link_offsets_[keyframe]; l < link_offsets_[keyframe + 1]; l++) {
+                const Link& link = links_[l];
+                if (score[link.keyframe] == UINT32_MAX) continue;
+                if (score[link.keyframe] == 0) linked.push_back(link.keyframe);
+                score[link.keyframe] += link.shared_landmarks;
+            }
+        }
+        const size_t extra = std::min(linked.size(), max_keyframes - primary);
+        std::partial_sort(linked.begin(), linked.begin() + extra, linked.end(), stronger);
+        ranked.insert(ranked.end(), linked.begin(), linked.begin() + extra);
+    }
+
+    for (uint32_t keyframe : ranked) {
+        items.insert(items.end(), keyframe_items_.begin() + keyframe_offsets_[keyframe],
+                     keyframe_items_.begin() + keyframe_offsets_[keyframe + 1]);
+    }
+    std::sort(items.begin(), items.end());
+    items.erase(std::unique(items.begin(), items.end()), items.end());
+    return items;
+}
+
+} // namespace lar::bridge
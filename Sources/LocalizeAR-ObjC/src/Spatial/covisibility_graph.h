@@ -0,0 +1,94 @@
+//
+//  covisibility_graph.h
+//  LocalizeAR
+//
+//  Two-level visibility graph over the landmarks of a map: which keyframes see which
+//  landmarks, and which keyframes share landmarks with each other.
+//
+//  Keyframes are picked from the mapping frames whenever the camera has moved or turned
+//  enough since the last one, and a keyframe sees the landmarks inside its view frustum. A
+//  tracker that already has a few matches (e.g. last frame's inliers) can then expand them
+//  through the keyframes that see them, plus those keyframes' strongest covisible neighbors,
+//  instead of matching against everything in the query disc. Links are stored as flat
+//  adjacency arrays in both directions, so the graph is a handful of allocations.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include "frustum_filter.h"
+
+namespace lar::bridge {
+
+class LandmarkIndex;
+
+class CovisibilityGraph {
+public:
+    using Transform = Eigen::Transform<double,3,Eigen::Affine>;
+
+    struct View {
+        Transform camera_to_map;
+        Eigen::Matrix3d intrinsics;
+    };
+
+    struct Options {
+        FrustumFilter::Options frustum;
+        double keyframe_distance = 0.5;    // meters moved before the next keyframe
+        double keyframe_angle = 0.26;      // radians turned before the next keyframe, ~15°
+        uint32_t min_shared_landmarks = 15;  // for two keyframes to be linked
+        size_t max_neighbors = 16;         // strongest links kept per keyframe
+    };
+
+    struct Link {
+        uint32_t keyframe;
+        uint32_t shared_landmarks;
+    };
+
+    // Items are those of `index` (see LandmarkIndex::landmark), which must outlive the graph.
+    // Views are mapping frames in capture order.
+    CovisibilityGraph(const LandmarkIndex& index, const std::vector<View>& views, const Options& options);
+
+    size_t keyframeCount() const { return keyframe_offsets_.size() - 1; }
+    // Landmark-keyframe visibility links, and keyframe-keyframe links.
+    size_t visibilityCount() const { return keyframe_items_.size(); }
+    size_t linkCount() const { return links_.size(); }
+    size_t memoryBytes() const;
+
+    // The item of the landmark with `id`, or -1 if the index has none.
+    int64_t item(size_t id) const;
+
+    // For every item, the angle in radians between the mean of the directions towards the
+    // keyframes that see it and the furthest of them, roughly; 0 for items seen from one
+    // direction or not at all. Wide spreads mean well-triangulated landmarks.
+    std::vector<float> viewSpread() const;
+
+    // Landmarks seen from the keyframes that see the most of `seeds`, at most `max_keyframes`
+    // of them, plus from their strongest neighbors if `neighbors`. Seeds no keyframe sees
+    // are kept as they are. Sorted items without duplicates.
+    std::vector<uint32_t> expand(const std::vector<uint32_t>& seeds, size_t max_keyframes, bool neighbors = true) const;
+
+private:
+    void linkKeyframes(const Options& options);
+
+    const LandmarkIndex* index_;
+    std::unordered_map<size_t, uint32_t> items_by_id_;
+    std::vector<Eigen::Vector3d> keyframe_positions_;
+    // Keyframe k sees keyframe_items_[keyframe_offsets_[k] .. keyframe_offsets_[k + 1]), and
+    // item i is seen by item_keyframes_[item_offsets_[i] .. item_offsets_[i + 1]).
+    std::vector<uint32_t> keyframe_offsets_;
+    std::vector<uint32_t> keyframe_items_;
+    std::vector<uint32_t> item_offsets_;
+    std::vector<uint32_t> item_keyframes_;
+    // Links of keyframe k, strongest first, in links_[link_offsets_[k] .. link_offsets_[k + 1]).
+    std::vector<uint32_t> link_offsets_;
+    std::vector<Link> links_;
+};
+
+} // namespace lar::bridge
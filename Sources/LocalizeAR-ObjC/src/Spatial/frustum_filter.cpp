@@ -0,0 +1,52 @@
+//
+//  frustum_filter.cpp
+//  LocalizeAR
+//
+
+#include "frustum_filter.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include <lar/core/landmark.h>
+
+namespace lar::bridge {
+
+FrustumFilter::FrustumFilter(const Transform& camera_to_map, const Eigen::Matrix3d& intrinsics, const Options& options)
+    : map_to_camera_(camera_to_map.inverse()),
+      camera_position_(camera_to_map.translation()),
+      fx_(intrinsics(0, 0)), fy_(intrinsics(1, 1)), cx_(intrinsics(0, 2)), cy_(intrinsics(1, 2)),
+      near_(options.near_distance), far_(options.far_distance),
+      min_cos_view_(std::cos(options.max_view_angle)) {
+    if (fx_ <= 0 || fy_ <= 0 || cx_ <= 0 || cy_ <= 0) {
+        throw std::invalid_argument("Frustum needs pixel intrinsics with a positive focal length and principal point");
+    }
+    const double width = 2 * cx_;
+    const double height = 2 * cy_;
+    min_u_ = -options.padding * width;
+    max_u_ = (1 + options.padding) * width;
+    min_v_ = -options.padding * height;
+    max_v_ = (1 + options.padding) * height;
+}
+
+bool FrustumFilter::accepts(const Eigen::Vector3d& position, const Eigen::Vector3f& orientation) const {
+    const Eigen::Vector3d point = map_to_camera_ * position;
+    const double depth = -point.z();
+    if (depth < near_ || depth > far_) return false;
+
+    // Image rows grow downwards while camera y points up.
+    const double u = fx_ * point.x() / depth + cx_;
+    const double v = -fy_ * point.y() / depth + cy_;
+    if (u < min_u_ || u > max_u_ || v < min_v_ || v > max_v_) return false;
+
+    const double norm = orientation.norm();
+    if (norm == 0) return true;
+    const Eigen::Vector3d to_camera = (camera_position_ - position).normalized();
+    return to_camera.dot(orientation.cast<double>()) >= min_cos_view_ * norm;
+}
+
+bool FrustumFilter::accepts(const lar::Landmark& landmark) const {
+    return accepts(landmark.position, landmark.orientation);
+}
+
+} // namespace lar::bridge
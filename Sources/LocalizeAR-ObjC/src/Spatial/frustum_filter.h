@@ -0,0 +1,53 @@
+//
+//  frustum_filter.h
+//  LocalizeAR
+//
+//  Keeps the landmarks a camera can plausibly match: inside its padded view frustum and
+//  seen from within a maximum angle of the direction they were mapped from.
+//
+//  The camera pose is expected in map coordinates with ARKit axes (x right, y up, looking
+//  down -z, in the sensor's landscape orientation) and pixel intrinsics to match. VIO poses
+//  are gravity aligned, so the frustum also rejects landmarks far above or below the view,
+//  which a 2D spatial query can't.
+//
+
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+namespace lar {
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+class FrustumFilter {
+public:
+    using Transform = Eigen::Transform<double,3,Eigen::Affine>;
+
+    struct Options {
+        double padding = 0.15;          // fraction of the image size added on every side
+        double max_view_angle = 1.22;   // radians, ~70°; SIFT rarely matches beyond that
+        double near_distance = 0.1;     // meters
+        double far_distance = 20;       // meters along the optical axis
+    };
+
+    // The image is taken to be twice the principal point in size.
+    FrustumFilter(const Transform& camera_to_map, const Eigen::Matrix3d& intrinsics, const Options& options);
+
+    // `orientation` is the unit direction from the landmark towards the cameras that mapped
+    // it; a zero orientation (never set) passes the angle test.
+    bool accepts(const Eigen::Vector3d& position, const Eigen::Vector3f& orientation) const;
+    bool accepts(const lar::Landmark& landmark) const;
+
+private:
+    Transform map_to_camera_;
+    Eigen::Vector3d camera_position_;
+    double fx_, fy_, cx_, cy_;
+    double min_u_, max_u_, min_v_, max_v_;
+    double near_, far_;
+    double min_cos_view_;
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,106 @@
+//
+//  height_layers.cpp
+//  LocalizeAR
+//
+
+#include "height_layers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <lar/core/landmark.h>
+
+#include "landmark_index.h"
+
+namespace lar::bridge {
+
+HeightLayers::HeightLayers(std::shared_ptr<const LandmarkIndex> index, const Options& options)
+    : index_(std::move(index)), options_(options) {
+    if (!(options.bin_size > 0) || !std::isfinite(options.bin_size)) {
+        throw std::invalid_argument("Height bin size must be positive");
+    }
+    if (!(options.min_gap >= 0) || !(options.occupied_fraction >= 0 && options.occupied_fraction <= 1) ||
+        !(options.outlier_fraction >= 0 && options.outlier_fraction < 0.5) || options.max_bins == 0) {
+        throw std::invalid_argument("Invalid height layer options");
+    }
+
+    std::vector<double> heights;
+    heights.reserve(index_->size());
+    for (uint32_t item = 0; item < index_->size(); item++) {
+        const double y = index_->landmark(item)->position.y();
+        if (std::isfinite(y)) heights.push_back(y);
+    }
+    if (heights.empty()) return;
+
+    const size_t clipped = static_cast<size_t>(options.outlier_fraction * double(heights.size()));
+    std::nth_element(heights.begin(), heights.begin() + clipped, heights.end());
+    const double lowest = heights[clipped];
+    std::nth_element(heights.begin(), heights.end() - 1 - clipped, heights.end());
+    const double highest = heights[heights.size() - 1 - clipped];
+
+    // Widened if the range needs more than `max_bins`; the highest height is clamped into the
+    // last bin below.
+    const double bin_size = std::max(options.bin_size, (highest - lowest) / double(options.max_bins));
+    const size_t bins = std::min(options.max_bins, static_cast<size_t>((highest - lowest) / bin_size) + 1);
+    std::vector<size_t> histogram(bins, 0);
+    for (const double y : heights) {
+        if (y < lowest || y > highest) continue;
+        histogram[std::min(bins - 1, static_cast<size_t>((y - lowest) / bin_size))]++;
+    }
+
+    const size_t peak = *std::max_element(histogram.begin(), histogram.end());
+    const double threshold = std::max(1.0, options.occupied_fraction * double(peak));
+    const size_t max_gap = static_cast<size_t>(std::ceil(options.min_gap / bin_size));
+
+    // Runs of occupied bins, bridging gaps shorter than `max_gap`; landmarks in bridged bins
+    // belong to the layer, those in a separating gap to none.
+    size_t first = 0, last = 0, landmarks = 0, pending = 0;
+    bool open = false;
+    const auto close = [&] {
+        layers_.push_back({ lowest + double(first) * bin_size,
+                            lowest + double(last + 1) * bin_size, landmarks });
+    };
+    for (size_t bin = 0; bin < bins; bin++) {
+        if (double(histogram[bin]) < threshold) {
+            pending += histogram[bin];
+            continue;
+        }
+        if (open && bin - last - 1 >= max_gap) {
+            close();
+            open = false;
+        }
+        if (!open) {
+            first = bin;
+            landmarks = 0;
+            pending = 0;
+            open = true;
+        }
+        landmarks += pending + histogram[bin];
+        pending = 0;
+        last = bin;
+    }
+    if (open) close();
+}
+
+int HeightLayers::layerAt(double y) const {
+    int nearest = -1;
+    double nearest_distance = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < layers_.size(); i++) {
+        const double distance = std::max({ 0.0, layers_[i].lower - y, y - layers_[i].upper });
+        if (distance < nearest_distance) {
+            nearest_distance = distance;
+            nearest = static_cast<int>(i);
+        }
+    }
+    return nearest;
+}
+
+HeightLayers::Band HeightLayers::bandAt(double y) const {
+    if (layers_.size() < 2) return {};
+    const Layer& layer = layers_[layerAt(y)];
+    return { layer.lower - options_.margin, layer.upper + options_.margin };
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,69 @@
+//
+//  height_layers.h
+//  LocalizeAR
+//
+//  Floors of a multi-storey map, detected from the heights of its landmarks.
+//
+//  Landmarks on one floor spread from the floor to the ceiling, and the slab to the next
+//  floor holds almost none. Heights are binned, bins with more than a small fraction of the
+//  fullest bin count as occupied, and runs of occupied bins separated by an empty stretch
+//  of at least `min_gap` become separate layers. Non-finite heights are skipped, and the
+//  binned range spans the robust percentiles of the heights rather than their extremes, so a
+//  few stray landmarks far above or below the map can't stretch the histogram; the bins are
+//  widened if that range would still need more than `max_bins`. The camera's height then picks the layer a
+//  query should be restricted to, which a 2D spatial query can't do on its own.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace lar::bridge {
+
+class LandmarkIndex;
+
+class HeightLayers {
+public:
+    struct Options {
+        double bin_size = 0.2;            // meters
+        double min_gap = 0.8;             // meters of empty bins between two floors
+        double occupied_fraction = 0.02;  // of the fullest bin
+        double margin = 0.3;              // meters a band extends beyond its layer
+        double outlier_fraction = 0.001;  // of the heights, ignored at each end of the range
+        size_t max_bins = 4096;
+    };
+
+    struct Layer {
+        double lower;
+        double upper;
+        size_t landmarks;
+    };
+
+    struct Band {
+        double lower = -std::numeric_limits<double>::infinity();
+        double upper = std::numeric_limits<double>::infinity();
+        bool contains(double y) const { return y >= lower && y <= upper; }
+    };
+
+    HeightLayers(std::shared_ptr<const LandmarkIndex> index, const Options& options);
+
+    const std::shared_ptr<const LandmarkIndex>& index() const { return index_; }
+    // Bottom to top.
+    const std::vector<Layer>& layers() const { return layers_; }
+
+    // The layer containing `y`, or the nearest one; -1 without layers.
+    int layerAt(double y) const;
+    // Heights to restrict a query to for a camera at height `y`: its layer plus the margin.
+    // Unbounded if the map has fewer than two layers.
+    Band bandAt(double y) const;
+
+private:
+    std::shared_ptr<const LandmarkIndex> index_;
+    Options options_;
+    std::vector<Layer> layers_;
+};
+
+} // namespace lar::bridge
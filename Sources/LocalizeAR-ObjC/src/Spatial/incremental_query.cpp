@@ -0,0 +1,98 @@
+//
+//  incremental_query.cpp
+//  LocalizeAR
+//
+
+#include "incremental_query.h"
+
+#include <algorithm>
+
+namespace lar::bridge {
+
+namespace {
+
+// Closed boxes covering the part of `next` outside `previous`: full-height strips left and
+// right of it, then the strips below and above it in between. Their edges touch `previous`,
+// so callers drop the items that intersect it.
+std::vector<PackedRTree::Box> ring(const PackedRTree::Box& previous, const PackedRTree::Box& next) {
+    std::vector<PackedRTree::Box> strips;
+    if (next.lower_x < previous.lower_x) {
+        strips.push_back({ next.lower_x, next.lower_z, previous.lower_x, next.upper_z });
+    }
+    if (next.upper_x > previous.upper_x) {
+        strips.push_back({ previous.upper_x, next.lower_z, next.upper_x, next.upper_z });
+    }
+    const double lower_x = std::max(next.lower_x, previous.lower_x);
+    const double upper_x = std::min(next.upper_x, previous.upper_x);
+    if (next.lower_z < previous.lower_z) {
+        strips.push_back({ lower_x, next.lower_z, upper_x, previous.lower_z });
+    }
+    if (next.upper_z > previous.upper_z) {
+        strips.push_back({ lower_x, previous.upper_z, upper_x, next.upper_z });
+    }
+    return strips;
+}
+
+} // namespace
+
+void IncrementalQuery::reset() {
+    has_region_ = false;
+}
+
+void IncrementalQuery::searchFromScratch(const PackedRTree::Box& region) {
+    removed_ = std::move(items_);
+    items_.clear();
+    boxes_.clear();
+    tree_->search(region, [this](uint32_t item, const PackedRTree::Box& box) {
+        items_.push_back(item);
+        boxes_.push_back(box);
+    });
+    added_ = items_;
+    stats_.full_queries++;
+}
+
+bool IncrementalQuery::update(const PackedRTree::Box& region) {
+    added_.clear();
+    removed_.clear();
+    if (!has_region_ || !region_.intersects(region)) {
+        searchFromScratch(region);
+        region_ = region;
+        has_region_ = true;
+        return false;
+    }
+
+    // Items that left: previous items no longer intersecting the region.
+    size_t kept = 0;
+    for (size_t i = 0; i < items_.size(); i++) {
+        if (boxes_[i].intersects(region)) {
+            items_[kept] = items_[i];
+            boxes_[kept] = boxes_[i];
+            kept++;
+        } else {
+            removed_.push_back(items_[i]);
+        }
+    }
+    items_.resize(kept);
+    boxes_.resize(kept);
+
+    // Items that entered intersect the new region but not the old one, so they intersect one
+    // of the ring strips. An item spanning strips is taken from the first one it meets.
+    const std::vector<PackedRTree::Box> strips = ring(region_, region);
+    for (size_t s = 0; s < strips.size(); s++) {
+        tree_->search(strips[s], [&](uint32_t item, const PackedRTree::Box& box) {
+            if (box.intersects(region_) || !box.intersects(region)) return;
+            for (size_t earlier = 0; earlier < s; earlier++) {
+                if (box.intersects(strips[earlier])) return;
+            }
+            items_.push_back(item);
+            boxes_.push_back(box);
+            added_.push_back(item);
+        });
+    }
+
+    region_ = region;
+    stats_.incremental_queries++;
+    return true;
+}
+
+} // namespace lar::bridge
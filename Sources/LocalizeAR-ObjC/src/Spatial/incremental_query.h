@@ -0,0 +1,61 @@
+//
+//  incremental_query.h
+//  LocalizeAR
+//
+//  Spatial query that follows a moving region and reports what entered and left it.
+//
+//  Consecutive tracker queries overlap heavily as the user walks. When the new region
+//  overlaps the previous one, only the strips of the new region outside the old one are
+//  searched, and the previous items are re-tested against the new region, so the cost
+//  scales with the ring that changed rather than the whole region. Consumers that build
+//  structures from the result (e.g. a descriptor index) can apply `added()` and `removed()`
+//  instead of rebuilding.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "packed_rtree.h"
+
+namespace lar::bridge {
+
+class IncrementalQuery {
+public:
+    struct Stats {
+        size_t full_queries = 0;
+        size_t incremental_queries = 0;
+    };
+
+    // The tree must outlive the query.
+    explicit IncrementalQuery(const PackedRTree& tree) : tree_(&tree) {}
+
+    // Moves the query to `region`. Returns true if the result was updated incrementally, in
+    // which case added() and removed() hold the difference to the previous result; otherwise
+    // (first query, or no overlap with the previous region) items() was searched from scratch,
+    // added() equals items() and removed() holds the whole previous result.
+    bool update(const PackedRTree::Box& region);
+    // Forgets the previous region, so the next update searches from scratch.
+    void reset();
+
+    const std::vector<uint32_t>& items() const { return items_; }
+    const std::vector<uint32_t>& added() const { return added_; }
+    const std::vector<uint32_t>& removed() const { return removed_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    void searchFromScratch(const PackedRTree::Box& region);
+
+    const PackedRTree* tree_;
+    bool has_region_ = false;
+    PackedRTree::Box region_{};
+    std::vector<uint32_t> items_;
+    std::vector<PackedRTree::Box> boxes_;   // boxes of items_, for re-testing on the next move
+    std::vector<uint32_t> added_;
+    std::vector<uint32_t> removed_;
+    Stats stats_;
+};
+
+} // namespace lar::bridge
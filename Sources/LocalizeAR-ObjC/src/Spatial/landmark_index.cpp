@@ -0,0 +1,94 @@
+//
+//  landmark_index.cpp
+//  LocalizeAR
+//
+
+#include "landmark_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <lar/core/map.h>
+
+namespace lar::bridge {
+
+std::vector<PackedRTree::Box> LandmarkIndex::boundsOf(const std::vector<lar::Landmark*>& landmarks) {
+    std::vector<PackedRTree::Box> boxes;
+    boxes.reserve(landmarks.size());
+    for (const lar::Landmark* landmark : landmarks) {
+        const auto& bounds = landmark->bounds;
+        boxes.push_back({ bounds.lower.x, bounds.lower.y, bounds.upper.x, bounds.upper.y });
+    }
+    return boxes;
+}
+
+LandmarkIndex::LandmarkIndex(const lar::Map& map)
+    : LandmarkIndex(map.landmarks.all()) {}
+
+LandmarkIndex::LandmarkIndex(std::vector<lar::Landmark*> landmarks)
+    : landmarks_(std::move(landmarks)), tree_(boundsOf(landmarks_)) {}
+
+std::vector<lar::Landmark*> LandmarkIndex::find(double x, double z, double diameter) const {
+    std::vector<lar::Landmark*> found;
+    search(x, z, diameter, [&found](lar::Landmark* landmark) { found.push_back(landmark); });
+    return found;
+}
+
+namespace {
+
+std::vector<Eigen::Vector3d> positionsOf(const std::vector<lar::Landmark*>& landmarks) {
+    std::vector<Eigen::Vector3d> positions;
+    positions.reserve(landmarks.size());
+    for (const lar::Landmark* landmark : landmarks) positions.push_back(landmark->position);
+    return positions;
+}
+
+bool nearer(const LandmarkPointIndex::Neighbor& a, const LandmarkPointIndex::Neighbor& b) {
+    return a.second < b.second;
+}
+
+} // namespace
+
+LandmarkPointIndex::LandmarkPointIndex(const lar::Map& map)
+    : LandmarkPointIndex(map.landmarks.all()) {}
+
+LandmarkPointIndex::LandmarkPointIndex(std::vector<lar::Landmark*> landmarks)
+    : landmarks_(std::move(landmarks)), points_(positionsOf(landmarks_)) {}
+
+std::vector<LandmarkPointIndex::Neighbor> LandmarkPointIndex::resolve(const std::vector<PointIndex::Neighbor>& neighbors) const {
+    std::vector<Neighbor> resolved;
+    resolved.reserve(neighbors.size());
+    for (const auto& neighbor : neighbors) resolved.emplace_back(landmarks_[neighbor.item], neighbor.distance);
+    return resolved;
+}
+
+std::vector<LandmarkPointIndex::Neighbor> LandmarkPointIndex::nearest(const Eigen::Vector3d& point, size_t k) const {
+    return resolve(points_.nearest(point, k));
+}
+
+std::vector<LandmarkPointIndex::Neighbor> LandmarkPointIndex::withinRadius(const Eigen::Vector3d& point, double radius) const {
+    return resolve(points_.withinRadius(point, radius));
+}
+
+std::vector<LandmarkPointIndex::Neighbor> LandmarkPointIndex::scanNearest(const lar::Map& map, const Eigen::Vector3d& point, size_t k) {
+    std::vector<Neighbor> neighbors;
+    for (lar::Landmark* landmark : map.landmarks.all()) {
+        neighbors.emplace_back(landmark, (landmark->position - point).norm());
+    }
+    k = std::min(k, neighbors.size());
+    std::partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end(), nearer);
+    neighbors.resize(k);
+    return neighbors;
+}
+
+std::vector<LandmarkPointIndex::Neighbor> LandmarkPointIndex::scanWithinRadius(const lar::Map& map, const Eigen::Vector3d& point, double radius) {
+    std::vector<Neighbor> neighbors;
+    for (lar::Landmark* landmark : map.landmarks.all()) {
+        const double distance = (landmark->position - point).norm();
+        if (distance <= radius) neighbors.emplace_back(landmark, distance);
+    }
+    std::sort(neighbors.begin(), neighbors.end(), nearer);
+    return neighbors;
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,84 @@
+//
+//  landmark_index.h
+//  LocalizeAR
+//
+//  Read-only spatial index over the landmarks of a map, for localization-only maps.
+//
+//  Mapping keeps using the core's dynamic index, which supports inserts. A map loaded to
+//  localize against doesn't change, so its landmark bounds are bulk-loaded into a packed
+//  R-tree once and queried without pointer chasing. The index holds landmark pointers and has
+//  to be rebuilt whenever the landmark database is.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "packed_rtree.h"
+#include "point_index.h"
+
+namespace lar {
+    class Map;
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+class LandmarkIndex {
+public:
+    explicit LandmarkIndex(const lar::Map& map);
+    explicit LandmarkIndex(std::vector<lar::Landmark*> landmarks);
+
+    // Landmarks whose visibility bounds intersect the query square.
+    std::vector<lar::Landmark*> find(double x, double z, double diameter) const;
+
+    template <typename Visitor>
+    void search(double x, double z, double diameter, Visitor&& visit) const {
+        tree_.search(PackedRTree::Box::around(x, z, diameter), [&](uint32_t item) { visit(landmarks_[item]); });
+    }
+
+    size_t size() const { return landmarks_.size(); }
+    lar::Landmark* landmark(uint32_t item) const { return landmarks_[item]; }
+    // Items of the tree are indices into the landmarks, for landmark().
+    const PackedRTree& tree() const { return tree_; }
+    size_t memoryBytes() const { return tree_.memoryBytes() + landmarks_.capacity() * sizeof(lar::Landmark*); }
+
+    static std::vector<PackedRTree::Box> boundsOf(const std::vector<lar::Landmark*>& landmarks);
+
+private:
+    std::vector<lar::Landmark*> landmarks_;
+    PackedRTree tree_;
+};
+
+// Landmark positions in 3D, for nearest-neighbor and radius queries (map QA, visualization,
+// snapping anchors to structure). Like LandmarkIndex, it must be rebuilt with the database.
+class LandmarkPointIndex {
+public:
+    using Neighbor = std::pair<lar::Landmark*, double>;  // landmark and distance in meters
+
+    explicit LandmarkPointIndex(const lar::Map& map);
+    explicit LandmarkPointIndex(std::vector<lar::Landmark*> landmarks);
+
+    // The `k` landmarks nearest to `point`, nearest first.
+    std::vector<Neighbor> nearest(const Eigen::Vector3d& point, size_t k) const;
+    // Landmarks within `radius` meters of `point`, nearest first.
+    std::vector<Neighbor> withinRadius(const Eigen::Vector3d& point, double radius) const;
+
+    size_t memoryBytes() const { return points_.memoryBytes() + landmarks_.capacity() * sizeof(lar::Landmark*); }
+
+    // The same queries as a linear scan over the map, as a reference for the index.
+    static std::vector<Neighbor> scanNearest(const lar::Map& map, const Eigen::Vector3d& point, size_t k);
+    static std::vector<Neighbor> scanWithinRadius(const lar::Map& map, const Eigen::Vector3d& point, double radius);
+
+private:
+    std::vector<Neighbor> resolve(const std::vector<PointIndex::Neighbor>& neighbors) const;
+
+    std::vector<lar::Landmark*> landmarks_;
+    PointIndex points_;
+};
+
+} // namespace lar::bridge
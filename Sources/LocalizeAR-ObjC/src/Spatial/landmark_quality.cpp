@@ -0,0 +1,86 @@
+//
+//  landmark_quality.cpp
+//  LocalizeAR
+//
+
+#include "landmark_quality.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <lar/core/landmark.h>
+
+#include "landmark_index.h"
+
+namespace lar::bridge {
+
+LandmarkQuality::LandmarkQuality(std::shared_ptr<const LandmarkIndex> index, const Weights& weights,
+                                 const std::vector<float>& view_spread)
+    : index_(std::move(index)), has_view_spread_(!view_spread.empty()) {
+    const size_t count = index_->size();
+    if (has_view_spread_ && view_spread.size() != count) {
+        throw std::invalid_argument("View spreads don't match the landmark index");
+    }
+
+    long long oldest = 0, newest = 0;
+    for (uint32_t item = 0; item < count; item++) {
+        const long long last_seen = index_->landmark(item)->last_seen;
+        oldest = item ? std::min(oldest, last_seen) : last_seen;
+        newest = item ? std::max(newest, last_seen) : last_seen;
+    }
+    const double span = static_cast<double>(newest - oldest);
+    const double spread_weight = has_view_spread_ ? weights.view_spread : 0;
+    const double total = weights.sightings + weights.recency + spread_weight;
+    if (total <= 0) {
+        throw std::invalid_argument("Landmark quality weights must not all be zero");
+    }
+
+    scores_.resize(count);
+    for (uint32_t item = 0; item < count; item++) {
+        const lar::Landmark& landmark = *index_->landmark(item);
+        const double sightings = 1 - std::exp(-std::max(landmark.sightings, 0) / weights.full_sightings);
+        // A map seen in a single session has one last_seen for everything; don't penalize it.
+        const double recency = span > 0 ? (landmark.last_seen - oldest) / span : 1;
+        const double spread = has_view_spread_ ? std::min(1.0, view_spread[item] / weights.full_spread) : 0;
+        scores_[item] = static_cast<float>(
+            (weights.sightings * sightings + weights.recency * recency + spread_weight * spread) / total);
+    }
+}
+
+std::vector<uint32_t> LandmarkQuality::best(std::vector<uint32_t> items, double cell_size, size_t per_cell) const {
+    if (cell_size <= 0) {
+        throw std::invalid_argument("Cell size must be positive");
+    }
+    struct Ranked {
+        int64_t cell_x, cell_z;
+        float score;
+        uint32_t item;
+    };
+    std::vector<Ranked> ranked;
+    ranked.reserve(items.size());
+    for (uint32_t item : items) {
+        const auto& position = index_->landmark(item)->position;
+        ranked.push_back({ static_cast<int64_t>(std::floor(position.x() / cell_size)),
+                           static_cast<int64_t>(std::floor(position.z() / cell_size)),
+                           scores_[item], item });
+    }
+    // Group by cell, best first within a cell, then keep the head of every group.
+    std::sort(ranked.begin(), ranked.end(), [](const Ranked& a, const Ranked& b) {
+        if (a.cell_x != b.cell_x) return a.cell_x < b.cell_x;
+        if (a.cell_z != b.cell_z) return a.cell_z < b.cell_z;
+        return a.score != b.score ? a.score > b.score : a.item < b.item;
+    });
+    items.clear();
+    size_t taken = 0;
+    for (size_t i = 0; i < ranked.size(); i++) {
+        const bool new_cell = i == 0 || ranked[i].cell_x != ranked[i - 1].cell_x || ranked[i].cell_z != ranked[i - 1].cell_z;
+        taken = new_cell ? 0 : taken;
+        if (taken++ < per_cell) items.push_back(ranked[i].item);
+    }
+    std::sort(items.begin(), items.end());
+    return items;
+}
+
+} // namespace lar::bridge
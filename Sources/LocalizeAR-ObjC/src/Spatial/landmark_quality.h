@@ -0,0 +1,55 @@
+//
+//  landmark_quality.h
+//  LocalizeAR
+//
+//  Per-landmark quality score, for spending a fixed matching budget on the landmarks most
+//  likely to produce inliers.
+//
+//  isUseable() only separates landmarks seen often enough from the rest. The score ranks
+//  them instead, from how often they were seen, how recently (relative to the rest of the
+//  map, since last_seen has no fixed unit), and, when a covisibility graph is available, how
+//  widely spread the viewpoints that see them are. Each term lies in [0, 1]; the score is
+//  their weighted mean, so it lies in [0, 1] as well.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lar::bridge {
+
+class LandmarkIndex;
+
+class LandmarkQuality {
+public:
+    struct Weights {
+        double sightings = 0.5;
+        double recency = 0.25;
+        double view_spread = 0.25;    // ignored without view spreads
+        double full_sightings = 10;   // sightings at which the term reaches ~0.63
+        double full_spread = 0.26;    // radians of view spread that score 1, ~15°
+    };
+
+    // Scores the items of `index`. `view_spread` is empty or holds one angle per item (see
+    // CovisibilityGraph::viewSpread).
+    LandmarkQuality(std::shared_ptr<const LandmarkIndex> index, const Weights& weights,
+                    const std::vector<float>& view_spread = {});
+
+    const std::shared_ptr<const LandmarkIndex>& index() const { return index_; }
+    float score(uint32_t item) const { return scores_[item]; }
+    bool hasViewSpread() const { return has_view_spread_; }
+
+    // Of `items`, the `per_cell` best scoring in every `cell_size` meter square of the x/z
+    // grid their positions fall in. Sorted by item.
+    std::vector<uint32_t> best(std::vector<uint32_t> items, double cell_size, size_t per_cell) const;
+
+private:
+    std::shared_ptr<const LandmarkIndex> index_;
+    std::vector<float> scores_;
+    bool has_view_spread_;
+};
+
+} // namespace lar::bridge
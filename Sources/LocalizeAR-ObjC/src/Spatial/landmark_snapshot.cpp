@@ -0,0 +1,90 @@
+//
+//  landmark_snapshot.cpp
+//  LocalizeAR
+//
+
+#include "landmark_snapshot.h"
+
+#include <algorithm>
+
+#include <lar/core/map.h>
+
+#include "morton_order.h"
+
+namespace lar::bridge {
+
+namespace {
+
+// Copied along the Morton curve, so landmarks a query finds together sit together.
+std::vector<lar::Landmark> copyLandmarks(const lar::Map& map) {
+    std::vector<lar::Landmark> landmarks;
+    landmarks.reserve(map.landmarks.size());
+    for (const lar::Landmark* landmark : mortonOrdered(map.landmarks.all())) {
+        landmarks.push_back(*landmark);
+    }
+    return landmarks;
+}
+
+std::vector<lar::Landmark> orderLandmarks(std::vector<lar::Landmark> landmarks) {
+    std::vector<lar::Landmark*> pointers;
+    pointers.reserve(landmarks.size());
+    for (lar::Landmark& landmark : landmarks) pointers.push_back(&landmark);
+    std::vector<lar::Landmark> ordered;
+    ordered.reserve(landmarks.size());
+    for (lar::Landmark* landmark : mortonOrdered(pointers)) {
+        ordered.push_back(std::move(*landmark));
+    }
+    return ordered;
+}
+
+} // namespace
+
+// The indexes hand out non-const pointers because the core's API takes them; nothing writes
+// through them.
+std::vector<lar::Landmark*> LandmarkSnapshot::pointersTo(const std::vector<lar::Landmark>& landmarks) {
+    std::vector<lar::Landmark*> pointers;
+    pointers.reserve(landmarks.size());
+    for (const lar::Landmark& landmark : landmarks) pointers.push_back(const_cast<lar::Landmark*>(&landmark));
+    return pointers;
+}
+
+LandmarkSnapshot::LandmarkSnapshot(const lar::Map& map, uint64_t version, std::shared_ptr<const void> storage)
+    : version_(version),
+      storage_(std::move(storage)),
+      landmarks_(copyLandmarks(map)),
+      index_(pointersTo(landmarks_)) {}
+
+LandmarkSnapshot::LandmarkSnapshot(std::vector<lar::Landmark> landmarks, uint64_t version, std::shared_ptr<const void> storage)
+    : version_(version),
+      storage_(std::move(storage)),
+      landmarks_(orderLandmarks(std::move(landmarks))),
+      index_(pointersTo(landmarks_)) {}
+
+const LandmarkPointIndex& LandmarkSnapshot::points() const {
+    // Owned by points_, which never drops it, so the reference outlives the shared_ptr.
+    return *points_.loadOrBuild([this] {
+        return std::make_shared<const LandmarkPointIndex>(pointersTo(landmarks_));
+    });
+}
+
+const lar::Landmark* LandmarkSnapshot::find(size_t id) const {
+    const auto ids = ids_.loadOrBuild([this] {
+        auto sorted = std::make_shared<std::vector<std::pair<size_t, size_t>>>();
+        sorted->reserve(landmarks_.size());
+        for (size_t i = 0; i < landmarks_.size(); i++) sorted->emplace_back(landmarks_[i].id, i);
+        std::sort(sorted->begin(), sorted->end());
+        return std::shared_ptr<const std::vector<std::pair<size_t, size_t>>>(std::move(sorted));
+    });
+    const auto found = std::lower_bound(ids->begin(), ids->end(), std::make_pair(id, size_t(0)));
+    return found != ids->end() && found->first == id ? &landmarks_[found->second] : nullptr;
+}
+
+size_t LandmarkSnapshot::memoryBytes() const {
+    // Descriptors are shared with the map and not counted.
+    const auto points = points_.load();
+    const auto ids = ids_.load();
+    return landmarks_.capacity() * sizeof(lar::Landmark) + index_.memoryBytes() + (points ? points->memoryBytes() : 0) +
+        (ids ? ids->capacity() * sizeof(std::pair<size_t, size_t>) : 0);
+}
+
+} // namespace lar::bridge
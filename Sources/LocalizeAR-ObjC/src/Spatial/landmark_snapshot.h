@@ -0,0 +1,73 @@
+//
+//  landmark_snapshot.h
+//  LocalizeAR
+//
+//  Immutable copy of the landmarks of a map, with the indexes spatial queries run on.
+//
+//  Every query of a LARMap is answered from the current snapshot, never from the core's
+//  landmark database: the mapper, the processor, tile paging, lazy materialization, reloads
+//  and deltas all change that database in place. Whoever changes it builds a new snapshot (or
+//  drops the current one so the next query builds it) and publishes it (see Published);
+//  readers on other threads query the version they loaded for as long as they hold it. The
+//  snapshot owns its landmarks, so landmark pointers taken from it stay valid as long as the
+//  snapshot does. Descriptors are shared with their source, since cv::Mat copies are reference
+//  counted and the core replaces descriptors rather than writing into them (LARMap detaches a
+//  shared descriptor before rewriting it in place); descriptors that alias a memory-mapped
+//  archive are kept valid by holding on to `storage`. Snapshots of tiled and lazy maps carry
+//  no descriptors at all.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "landmark_index.h"
+#include "../Concurrency/published.h"
+
+namespace lar {
+    class Map;
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+class LandmarkSnapshot {
+public:
+    // Copies the landmarks of `map`. Must not race with anything that mutates `map`.
+    LandmarkSnapshot(const lar::Map& map, uint64_t version, std::shared_ptr<const void> storage = nullptr);
+    // Takes over landmarks decoded for the snapshot (e.g. straight from an archive).
+    LandmarkSnapshot(std::vector<lar::Landmark> landmarks, uint64_t version, std::shared_ptr<const void> storage = nullptr);
+
+    LandmarkSnapshot(const LandmarkSnapshot&) = delete;
+    LandmarkSnapshot& operator=(const LandmarkSnapshot&) = delete;
+
+    uint64_t version() const { return version_; }
+    size_t size() const { return landmarks_.size(); }
+
+    // Both index landmarks owned by the snapshot; they are valid while the snapshot is. The
+    // point index is built on first use.
+    const LandmarkIndex& index() const { return index_; }
+    const LandmarkPointIndex& points() const;
+
+    // The landmark with `id`, or nullptr. The id lookup is built on first use.
+    const lar::Landmark* find(size_t id) const;
+
+    size_t memoryBytes() const;
+
+private:
+    static std::vector<lar::Landmark*> pointersTo(const std::vector<lar::Landmark>& landmarks);
+
+    uint64_t version_;
+    std::shared_ptr<const void> storage_;
+    std::vector<lar::Landmark> landmarks_;
+    LandmarkIndex index_;
+    mutable Published<LandmarkPointIndex> points_;
+    // (id, position in landmarks_) sorted by id.
+    mutable Published<std::vector<std::pair<size_t, size_t>>> ids_;
+};
+
+} // namespace lar::bridge
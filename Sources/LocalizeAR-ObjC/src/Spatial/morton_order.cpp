@@ -0,0 +1,74 @@
+//
+//  morton_order.cpp
+//  LocalizeAR
+//
+
+#include "morton_order.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <lar/core/landmark.h>
+
+namespace lar::bridge {
+
+namespace {
+
+// Spreads the 32 bits of `value` to the even bits of the result.
+uint64_t spread(uint32_t value) {
+    uint64_t bits = value;
+    bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFull;
+    bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFull;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    bits = (bits | (bits << 2)) & 0x3333333333333333ull;
+    bits = (bits | (bits << 1)) & 0x5555555555555555ull;
+    return bits;
+}
+
+uint32_t quantize(double value, double lower, double scale) {
+    const double steps = std::floor((value - lower) * scale);
+    return static_cast<uint32_t>(std::clamp(steps, 0.0, double(UINT32_MAX)));
+}
+
+} // namespace
+
+uint64_t mortonCode(uint32_t x, uint32_t z) {
+    return spread(x) | (spread(z) << 1);
+}
+
+std::vector<uint32_t> mortonOrder(const std::vector<Eigen::Vector2d>& points) {
+    std::vector<uint32_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0u);
+    if (points.empty()) return order;
+
+    Eigen::Vector2d lower = points.front(), upper = points.front();
+    for (const auto& point : points) {
+        lower = lower.cwiseMin(point);
+        upper = upper.cwiseMax(point);
+    }
+    // One scale for both axes keeps the cells square, so neither axis dominates the order.
+    const double size = std::max((upper - lower).maxCoeff(), 1e-9);
+    const double scale = double(UINT32_MAX) / size;
+
+    std::vector<uint64_t> codes(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        codes[i] = mortonCode(quantize(points[i].x(), lower.x(), scale), quantize(points[i].y(), lower.y(), scale));
+    }
+    std::stable_sort(order.begin(), order.end(), [&codes](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
+    return order;
+}
+
+std::vector<lar::Landmark*> mortonOrdered(const std::vector<lar::Landmark*>& landmarks) {
+    std::vector<Eigen::Vector2d> points;
+    points.reserve(landmarks.size());
+    for (const lar::Landmark* landmark : landmarks) {
+        points.emplace_back(landmark->position.x(), landmark->position.z());
+    }
+    std::vector<lar::Landmark*> ordered;
+    ordered.reserve(landmarks.size());
+    for (uint32_t i : mortonOrder(points)) ordered.push_back(landmarks[i]);
+    return ordered;
+}
+
+} // namespace lar::bridge
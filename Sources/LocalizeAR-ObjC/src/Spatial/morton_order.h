@@ -0,0 +1,39 @@
+//
+//  morton_order.h
+//  LocalizeAR
+//
+//  Z-order (Morton) curve over the x/z plane, for laying out landmarks so that those close
+//  together in space are close together in memory and on disk.
+//
+//  Coordinates are quantized to 32 bits each over the extent of the points being ordered
+//  and interleaved into a 64-bit code; sorting by code visits the plane in nested Z-shaped
+//  quadrants. A spatial query then reads a few contiguous runs of landmark records and
+//  descriptor rows instead of rows scattered over the whole file, which matters most when
+//  the archive is memory-mapped and every scattered row faults in its own page.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace lar {
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+// Interleaves the low 32 bits of `x` (even bits) and `z` (odd bits).
+uint64_t mortonCode(uint32_t x, uint32_t z);
+
+// Permutation of the points along the curve: the i-th point visited is points[order[i]].
+// Ties keep their original order.
+std::vector<uint32_t> mortonOrder(const std::vector<Eigen::Vector2d>& points);
+
+// The landmarks sorted along the curve by their x/z position.
+std::vector<lar::Landmark*> mortonOrdered(const std::vector<lar::Landmark*>& landmarks);
+
+} // namespace lar::bridge
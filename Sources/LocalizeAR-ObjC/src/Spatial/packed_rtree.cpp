@@ -0,0 +1,116 @@
+//
+//  packed_rtree.cpp
+//  LocalizeAR
+//
+
+#include "packed_rtree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace lar::bridge {
+
+namespace {
+
+PackedRTree::Box unite(const PackedRTree::Box* boxes, size_t count) {
+    PackedRTree::Box box{
+        std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()
+    };
+    for (size_t i = 0; i < count; i++) {
+        box.lower_x = std::min(box.lower_x, boxes[i].lower_x);
+        box.lower_z = std::min(box.lower_z, boxes[i].lower_z);
+        box.upper_x = std::max(box.upper_x, boxes[i].upper_x);
+        box.upper_z = std::max(box.upper_z, boxes[i].upper_z);
+    }
+    return box;
+}
+
+float roundDown(double value) {
+    const float rounded = static_cast<float>(value);
+    return double(rounded) > value ? std::nextafter(rounded, -std::numeric_limits<float>::infinity()) : rounded;
+}
+
+float roundUp(double value) {
+    const float rounded = static_cast<float>(value);
+    return double(rounded) < value ? std::nextafter(rounded, std::numeric_limits<float>::infinity()) : rounded;
+}
+
+} // namespace
+
+FloatBox PackedRTree::outwards(const Box& box) {
+    return { roundDown(box.lower_x), roundDown(box.lower_z), roundUp(box.upper_x), roundUp(box.upper_z) };
+}
+
+PackedRTree::PackedRTree(const std::vector<Box>& boxes, size_t node_size)
+    : node_size_(node_size), item_count_(boxes.size()) {
+    if (node_size_ < 2 || node_size_ > kMaxNodeSize) {
+        throw std::invalid_argument("R-tree node size must be between 2 and " + std::to_string(kMaxNodeSize));
+    }
+    if (boxes.size() > std::numeric_limits<uint32_t>::max() / 2) {
+        throw std::invalid_argument("Too many items for a packed R-tree");
+    }
+    if (boxes.empty()) return;
+
+    // Sort-Tile-Recursive: order by center x, cut into vertical slices of whole leaves, and
+    // order each slice by center z, so consecutive items (and therefore leaves) are compact.
+    const size_t n = boxes.size();
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    const auto center_x = [&boxes](uint32_t i) { return boxes[i].lower_x + boxes[i].upper_x; };
+    const auto center_z = [&boxes](uint32_t i) { return boxes[i].lower_z + boxes[i].upper_z; };
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return center_x(a) < center_x(b); });
+
+    const size_t leaf_count = (n + node_size_ - 1) / node_size_;
+    const size_t slice_count = static_cast<size_t>(std::ceil(std::sqrt(double(leaf_count))));
+    const size_t slice_size = ((leaf_count + slice_count - 1) / slice_count) * node_size_;
+    for (size_t first = 0; first < n; first += slice_size) {
+        const auto begin = order.begin() + first;
+        const auto end = order.begin() + std::min(n, first + slice_size);
+        std::sort(begin, end, [&](uint32_t a, uint32_t b) { return center_z(a) < center_z(b); });
+    }
+
+    // Levels have ceil(previous / node_size) nodes until a single root remains.
+    size_t total = n;
+    for (size_t count = n; count > 1;) {
+        count = (count + node_size_ - 1) / node_size_;
+        total += count;
+    }
+    boxes_.reserve(total);
+    indices_.reserve(total);
+    for (uint32_t item : order) {
+        boxes_.push_back(boxes[item]);
+        indices_.push_back(item);
+    }
+    level_ends_.push_back(n);
+
+    size_t level_begin = 0;
+    while (level_ends_.back() - level_begin > 1) {
+        const size_t level_end = level_ends_.back();
+        for (size_t first = level_begin; first < level_end; first += node_size_) {
+            const size_t count = std::min(node_size_, level_end - first);
+            boxes_.push_back(unite(boxes_.data() + first, count));
+            indices_.push_back(static_cast<uint32_t>(first));
+        }
+        level_begin = level_end;
+        level_ends_.push_back(boxes_.size());
+    }
+
+    lower_x_.reserve(total);
+    lower_z_.reserve(total);
+    upper_x_.reserve(total);
+    upper_z_.reserve(total);
+    for (const Box& box : boxes_) {
+        const FloatBox rounded = outwards(box);
+        lower_x_.push_back(rounded.lower_x);
+        lower_z_.push_back(rounded.lower_z);
+        upper_x_.push_back(rounded.upper_x);
+        upper_z_.push_back(rounded.upper_z);
+    }
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,142 @@
+//
+//  packed_rtree.h
+//  LocalizeAR
+//
+//  Static R-tree over 2D boxes, bulk-loaded in Sort-Tile-Recursive order and stored in flat
+//  arrays.
+//
+//  Every level of the tree lives in one contiguous box array, leaves (the items, in STR
+//  order) first and the root last. A node's children are the `node_size` consecutive boxes
+//  its index entry points at, so a search walks array offsets instead of pointers and each
+//  node visit reads one or two cache lines. The tree can't be modified; build a new one when
+//  the items change.
+//
+//  Next to the exact boxes, every level is also stored as single-precision columns (all
+//  lower x, then all lower z, ...), rounded outwards, so a node's children are tested
+//  together by the SIMD kernel in box_kernels.h. Leaf hits are confirmed on the exact boxes.
+//  Each tree searches with its own kernel, the fastest one this CPU has unless changed with
+//  setKernel.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "box_kernels.h"
+
+namespace lar::bridge {
+
+class PackedRTree {
+public:
+    struct Box {
+        double lower_x, lower_z, upper_x, upper_z;
+
+        bool intersects(const Box& other) const {
+            return lower_x <= other.upper_x && other.lower_x <= upper_x &&
+                   lower_z <= other.upper_z && other.lower_z <= upper_z;
+        }
+
+        // Square of side `diameter` centered on (x, z), the region of a LARSpatialQuery.
+        static Box around(double x, double z, double diameter) {
+            const double radius = diameter / 2;
+            return { x - radius, z - radius, x + radius, z + radius };
+        }
+    };
+
+    static constexpr size_t kDefaultNodeSize = 16;
+    static constexpr size_t kMaxNodeSize = 64;
+
+    PackedRTree() = default;
+    // Item i of the tree is `boxes[i]`; searches report items by that index.
+    explicit PackedRTree(const std::vector<Box>& boxes, size_t node_size = kDefaultNodeSize);
+
+    size_t size() const { return item_count_; }
+    bool empty() const { return item_count_ == 0; }
+    size_t nodeSize() const { return node_size_; }
+    BoxKernel kernel() const { return kernel_; }
+    // Searches with `kernel` from now on if this CPU supports it, and returns the kernel in
+    // use. Results are identical across kernels, so this only exists to compare their speed;
+    // like any other change to the tree, it must not overlap a search.
+    BoxKernel setKernel(BoxKernel kernel) {
+        if (supportsBoxKernel(kernel)) kernel_ = kernel;
+        return kernel_;
+    }
+    size_t memoryBytes() const {
+        return boxes_.capacity() * sizeof(Box) + indices_.capacity() * sizeof(uint32_t) +
+               (lower_x_.capacity() + lower_z_.capacity() + upper_x_.capacity() + upper_z_.capacity()) * sizeof(float);
+    }
+
+    // Calls `visit(item)` for every item whose box intersects `query`, in no particular order.
+    // A visitor that also takes a `const Box&` is passed the item's box.
+    template <typename Visitor>
+    void search(const Box& query, Visitor&& visit) const;
+
+    std::vector<uint32_t> search(const Box& query) const {
+        std::vector<uint32_t> items;
+        search(query, [&items](uint32_t item) { items.push_back(item); });
+        return items;
+    }
+
+private:
+    // Smallest single-precision box containing `box`.
+    static FloatBox outwards(const Box& box);
+    template <typename Visitor>
+    void report(size_t leaf, Visitor& visit) const {
+        if constexpr (std::is_invocable_v<Visitor&, uint32_t, const Box&>) {
+            visit(indices_[leaf], boxes_[leaf]);
+        } else {
+            visit(indices_[leaf]);
+        }
+    }
+    BoxColumns columns() const { return { lower_x_.data(), lower_z_.data(), upper_x_.data(), upper_z_.data() }; }
+
+    size_t node_size_ = kDefaultNodeSize;
+    size_t item_count_ = 0;
+    BoxKernel kernel_ = activeBoxKernel();
+    std::vector<Box> boxes_;        // all levels, leaves first
+    std::vector<uint32_t> indices_; // leaves: item index; nodes: offset of the first child
+    std::vector<size_t> level_ends_;  // end offset of each level in boxes_
+    std::vector<float> lower_x_, lower_z_, upper_x_, upper_z_;  // boxes_ as rounded columns
+};
+
+template <typename Visitor>
+void PackedRTree::search(const Box& query, Visitor&& visit) const {
+    if (item_count_ == 0) return;
+
+    // Pending nodes as (offset, level). At most node_size - 1 siblings wait per level, which
+    // for kMaxNodeSize and 2^31 items is well under the capacity.
+    struct Pending { uint32_t offset; uint32_t level; };
+    Pending stack[512];
+    size_t top = 0;
+    const size_t root_level = level_ends_.size() - 1;
+    stack[top++] = { uint32_t(boxes_.size() - 1), uint32_t(root_level) };
+
+    const FloatBox rounded = outwards(query);
+    const BoxColumns columns = this->columns();
+    while (top > 0) {
+        const Pending node = stack[--top];
+        if (node.level == 0) {
+            // Only reachable for a single-item tree, whose root is the item.
+            if (boxes_[node.offset].intersects(query)) report(node.offset, visit);
+            continue;
+        }
+        const size_t first = indices_[node.offset];
+        const size_t last = std::min(first + node_size_, level_ends_[node.level - 1]);
+        // Rounding outwards can only add hits, which is harmless for nodes and rechecked for
+        // items.
+        for (uint64_t hits = intersectBoxes(kernel_, columns, first, last - first, rounded); hits != 0; hits &= hits - 1) {
+            const size_t i = first + size_t(__builtin_ctzll(hits));
+            if (node.level > 1) {
+                stack[top++] = { uint32_t(i), node.level - 1 };
+            } else if (boxes_[i].intersects(query)) {
+                report(i, visit);
+            }
+        }
+    }
+}
+
+} // namespace lar::bridge
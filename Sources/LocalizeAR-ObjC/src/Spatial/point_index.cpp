@@ -0,0 +1,114 @@
+//
+//  point_index.cpp
+//  LocalizeAR
+//
+
+#include "point_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+namespace lar::bridge {
+
+PointIndex::PointIndex(const std::vector<Eigen::Vector3d>& points) : points_(points), items_(points.size()) {
+    if (points.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Too many points for a point index");
+    }
+    std::iota(items_.begin(), items_.end(), 0);
+    build(0, points_.size(), 0);
+}
+
+void PointIndex::build(size_t first, size_t last, int axis) {
+    if (last - first <= kLeafSize) return;
+    const size_t middle = first + (last - first) / 2;
+
+    // Partition the points and their items together through an index permutation.
+    std::vector<uint32_t> order(last - first);
+    std::iota(order.begin(), order.end(), uint32_t(first));
+    std::nth_element(order.begin(), order.begin() + (middle - first), order.end(),
+                     [this, axis](uint32_t a, uint32_t b) { return points_[a][axis] < points_[b][axis]; });
+    std::vector<Eigen::Vector3d> points(last - first);
+    std::vector<uint32_t> items(last - first);
+    for (size_t i = 0; i < order.size(); i++) {
+        points[i] = points_[order[i]];
+        items[i] = items_[order[i]];
+    }
+    std::copy(points.begin(), points.end(), points_.begin() + first);
+    std::copy(items.begin(), items.end(), items_.begin() + first);
+
+    build(first, middle, (axis + 1) % 3);
+    build(middle + 1, last, (axis + 1) % 3);
+}
+
+template <typename Visitor>
+void PointIndex::search(const Eigen::Vector3d& point, double bound, Visitor&& visit) const {
+    // Pending ranges with the squared distance from `point` to their side of the split,
+    // which is a lower bound for every point in them. Depth is logarithmic, so a fixed
+    // stack of 2 entries per level is plenty.
+    struct Pending { size_t first, last; int axis; double min_distance; };
+    Pending stack[128];
+    size_t top = 0;
+    if (!points_.empty()) stack[top++] = { 0, points_.size(), 0, 0 };
+
+    while (top > 0) {
+        const Pending range = stack[--top];
+        if (range.min_distance > bound) continue;
+        if (range.last - range.first <= kLeafSize) {
+            for (size_t i = range.first; i < range.last; i++) {
+                const double distance = (points_[i] - point).squaredNorm();
+                if (distance <= bound) bound = visit(i, distance);
+            }
+            continue;
+        }
+        const size_t middle = range.first + (range.last - range.first) / 2;
+        const double distance = (points_[middle] - point).squaredNorm();
+        if (distance <= bound) bound = visit(middle, distance);
+
+        const double offset = point[range.axis] - points_[middle][range.axis];
+        const int next = (range.axis + 1) % 3;
+        const Pending lower{ range.first, middle, next, offset > 0 ? std::max(range.min_distance, offset * offset) : range.min_distance };
+        const Pending upper{ middle + 1, range.last, next, offset < 0 ? std::max(range.min_distance, offset * offset) : range.min_distance };
+        // The side holding the point is searched first, so the bound shrinks early.
+        if (offset > 0) {
+            stack[top++] = lower;
+            stack[top++] = upper;
+        } else {
+            stack[top++] = upper;
+            stack[top++] = lower;
+        }
+    }
+}
+
+std::vector<PointIndex::Neighbor> PointIndex::nearest(const Eigen::Vector3d& point, size_t k, double max_distance) const {
+    std::vector<Neighbor> neighbors;
+    if (k == 0) return neighbors;
+    const auto farther = [](const Neighbor& a, const Neighbor& b) { return a.distance < b.distance; };
+    // Max-heap on squared distance holding the best k so far.
+    std::priority_queue<Neighbor, std::vector<Neighbor>, decltype(farther)> best(farther);
+    search(point, max_distance * max_distance, [&](size_t i, double distance) {
+        if (best.size() == k) best.pop();
+        best.push({ items_[i], distance });
+        return best.size() == k ? best.top().distance : max_distance * max_distance;
+    });
+    neighbors.resize(best.size());
+    for (size_t i = neighbors.size(); i-- > 0; best.pop()) {
+        neighbors[i] = { best.top().item, std::sqrt(best.top().distance) };
+    }
+    return neighbors;
+}
+
+std::vector<PointIndex::Neighbor> PointIndex::withinRadius(const Eigen::Vector3d& point, double radius) const {
+    std::vector<Neighbor> neighbors;
+    const double bound = radius * radius;
+    search(point, bound, [&](size_t i, double distance) {
+        neighbors.push_back({ items_[i], std::sqrt(distance) });
+        return bound;
+    });
+    std::sort(neighbors.begin(), neighbors.end(), [](const Neighbor& a, const Neighbor& b) { return a.distance < b.distance; });
+    return neighbors;
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,56 @@
+//
+//  point_index.h
+//  LocalizeAR
+//
+//  Static 3D k-d tree over points, for nearest-neighbor and radius queries.
+//
+//  The tree is implicit: points are reordered so that each range's median splits it along
+//  x, y and z in turn, and small ranges are scanned linearly. There are no node objects; a
+//  query only walks index ranges. Build a new index when the points change.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace lar::bridge {
+
+class PointIndex {
+public:
+    struct Neighbor {
+        uint32_t item;
+        double distance;
+    };
+
+    static constexpr size_t kLeafSize = 8;
+
+    PointIndex() = default;
+    // Item i of the index is `points[i]`; queries report items by that index.
+    explicit PointIndex(const std::vector<Eigen::Vector3d>& points);
+
+    size_t size() const { return items_.size(); }
+    size_t memoryBytes() const { return points_.capacity() * sizeof(Eigen::Vector3d) + items_.capacity() * sizeof(uint32_t); }
+
+    // The `k` items nearest to `point` within `max_distance`, nearest first.
+    std::vector<Neighbor> nearest(const Eigen::Vector3d& point, size_t k,
+                                  double max_distance = std::numeric_limits<double>::infinity()) const;
+    // Items within `radius` of `point` (inclusive), nearest first.
+    std::vector<Neighbor> withinRadius(const Eigen::Vector3d& point, double radius) const;
+
+private:
+    void build(size_t first, size_t last, int axis);
+    // Visits ranges that may hold items within the current bound; `visit(index, squared
+    // distance)` returns the squared bound to keep searching within.
+    template <typename Visitor>
+    void search(const Eigen::Vector3d& point, double bound, Visitor&& visit) const;
+
+    std::vector<Eigen::Vector3d> points_;   // in tree order
+    std::vector<uint32_t> items_;           // item index of each point
+};
+
+} // namespace lar::bridge
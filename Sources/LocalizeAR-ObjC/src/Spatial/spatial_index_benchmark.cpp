@@ -0,0 +1,147 @@
+//
+//  spatial_index_benchmark.cpp
+//  LocalizeAR
+//
+
+#include "spatial_index_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "morton_order.h"
+
+namespace lar::bridge {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+size_t distinctPages(std::vector<size_t>& pages) {
+    std::sort(pages.begin(), pages.end());
+    return static_cast<size_t>(std::unique(pages.begin(), pages.end()) - pages.begin());
+}
+
+} // namespace
+
+std::vector<PackedRTree::Box> SpatialIndexBenchmark::replicate(const std::vector<PackedRTree::Box>& seed, size_t items) {
+    if (seed.empty()) {
+        throw std::invalid_argument("No boxes to replicate");
+    }
+    PackedRTree::Box extent = seed.front();
+    for (const auto& box : seed) {
+        extent.lower_x = std::min(extent.lower_x, box.lower_x);
+        extent.lower_z = std::min(extent.lower_z, box.lower_z);
+        extent.upper_x = std::max(extent.upper_x, box.upper_x);
+        extent.upper_z = std::max(extent.upper_z, box.upper_z);
+    }
+    const double width = extent.upper_x - extent.lower_x;
+    const double depth = extent.upper_z - extent.lower_z;
+
+    // Copies are laid out on a square grid of map extents.
+    const size_t copies = (items + seed.size() - 1) / seed.size();
+    const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(double(copies))));
+    std::vector<PackedRTree::Box> boxes;
+    boxes.reserve(items);
+    for (size_t copy = 0; boxes.size() < items; copy++) {
+        const double dx = width * double(copy % columns);
+        const double dz = depth * double(copy / columns);
+        for (size_t i = 0; i < seed.size() && boxes.size() < items; i++) {
+            const auto& box = seed[i];
+            boxes.push_back({ box.lower_x + dx, box.lower_z + dz, box.upper_x + dx, box.upper_z + dz });
+        }
+    }
+    return boxes;
+}
+
+SpatialIndexBenchmark::Result SpatialIndexBenchmark::run(const std::vector<PackedRTree::Box>& seed, size_t items,
+                                                         size_t queries, double diameter, uint64_t random_seed) {
+    const std::vector<PackedRTree::Box> boxes = replicate(seed, items);
+    Result result;
+    result.items = boxes.size();
+    result.queries = queries;
+
+    auto start = Clock::now();
+    const PackedRTree tree(boxes);
+    result.build_seconds = secondsSince(start);
+    result.tree_bytes = tree.memoryBytes();
+
+    PackedRTree::Box extent = boxes.front();
+    for (const auto& box : boxes) {
+        extent.lower_x = std::min(extent.lower_x, box.lower_x);
+        extent.lower_z = std::min(extent.lower_z, box.lower_z);
+        extent.upper_x = std::max(extent.upper_x, box.upper_x);
+        extent.upper_z = std::max(extent.upper_z, box.upper_z);
+    }
+    std::mt19937_64 random(random_seed);
+    std::uniform_real_distribution<double> xs(extent.lower_x, extent.upper_x);
+    std::uniform_real_distribution<double> zs(extent.lower_z, extent.upper_z);
+
+    std::vector<PackedRTree::Box> regions;
+    regions.reserve(queries);
+    for (size_t q = 0; q < queries; q++) {
+        regions.push_back(PackedRTree::Box::around(xs(random), zs(random), diameter));
+    }
+
+    // Row of every item when stored along the Morton curve of the box centers.
+    std::vector<Eigen::Vector2d> centers;
+    centers.reserve(boxes.size());
+    for (const auto& box : boxes) {
+        centers.emplace_back((box.lower_x + box.upper_x) / 2, (box.lower_z + box.upper_z) / 2);
+    }
+    const std::vector<uint32_t> order = mortonOrder(centers);
+    std::vector<uint32_t> spatial_row(boxes.size());
+    for (uint32_t row = 0; row < order.size(); row++) spatial_row[order[row]] = row;
+    const auto pageOf = [](size_t row) { return row * kDescriptorRowBytes / kPageBytes; };
+
+    result.kernel = tree.kernel();
+    PackedRTree scalar_tree = tree;
+    scalar_tree.setKernel(BoxKernel::Scalar);
+    std::vector<size_t> stored_pages, spatial_pages;
+    std::vector<uint32_t> from_tree, from_scan;
+    for (size_t q = 0; q < regions.size(); q++) {
+        const auto& query = regions[q];
+        // The scalar kernel searches its own copy of the tree; the kernels still alternate so
+        // neither always runs first after the scan below has evicted the nodes.
+        size_t scalar_hits = 0;
+        const auto searchScalar = [&] {
+            start = Clock::now();
+            scalar_tree.search(query, [&scalar_hits](uint32_t) { scalar_hits++; });
+            result.scalar_tree_seconds += secondsSince(start);
+        };
+        if (q % 2) searchScalar();
+        from_tree.clear();
+        start = Clock::now();
+        tree.search(query, [&from_tree](uint32_t item) { from_tree.push_back(item); });
+        result.tree_seconds += secondsSince(start);
+        if (q % 2 == 0) searchScalar();
+
+        from_scan.clear();
+        start = Clock::now();
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (boxes[i].intersects(query)) from_scan.push_back(static_cast<uint32_t>(i));
+        }
+        result.scan_seconds += secondsSince(start);
+
+        result.hits += from_tree.size();
+        stored_pages.clear();
+        spatial_pages.clear();
+        for (uint32_t item : from_tree) {
+            stored_pages.push_back(pageOf(item));
+            spatial_pages.push_back(pageOf(spatial_row[item]));
+        }
+        result.stored_order_pages += distinctPages(stored_pages);
+        result.spatial_order_pages += distinctPages(spatial_pages);
+        std::sort(from_tree.begin(), from_tree.end());
+        result.matches = result.matches && from_tree == from_scan && scalar_hits == from_scan.size();
+    }
+    return result;
+}
+
+} // namespace lar::bridge
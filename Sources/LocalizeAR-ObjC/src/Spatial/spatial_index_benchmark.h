@@ -0,0 +1,53 @@
+//
+//  spatial_index_benchmark.h
+//  LocalizeAR
+//
+//  Times the packed R-tree against a linear scan of the same boxes, at map sizes beyond the
+//  recorded ones.
+//
+//  The seed boxes (a map's landmark bounds) are tiled side by side until the requested item
+//  count is reached, so the density of a real map is kept while its area grows. Both
+//  searches run the same random queries and their results are compared. The hits are also
+//  mapped to the descriptor pages they would read, in stored and in spatial row order.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "packed_rtree.h"
+
+namespace lar::bridge {
+
+class SpatialIndexBenchmark {
+public:
+    struct Result {
+        size_t items = 0;
+        size_t queries = 0;
+        size_t hits = 0;            // items found over all queries
+        size_t tree_bytes = 0;
+        double build_seconds = 0;
+        double tree_seconds = 0;    // all queries
+        double scalar_tree_seconds = 0;
+        double scan_seconds = 0;
+        BoxKernel kernel = BoxKernel::Scalar;
+        bool matches = true;        // both searches found the same items for every query
+        // Descriptor pages the hits of all queries fall on, with one row per item stored in
+        // the given order and in Morton order (see morton_order.h).
+        size_t stored_order_pages = 0;
+        size_t spatial_order_pages = 0;
+    };
+
+    static constexpr size_t kDescriptorRowBytes = 128;  // a SIFT descriptor as 8-bit values
+    static constexpr size_t kPageBytes = 4096;
+
+    // Throws std::invalid_argument if `seed` is empty.
+    static Result run(const std::vector<PackedRTree::Box>& seed, size_t items, size_t queries,
+                      double diameter, uint64_t random_seed = 1);
+
+    static std::vector<PackedRTree::Box> replicate(const std::vector<PackedRTree::Box>& seed, size_t items);
+};
+
+} // namespace lar::bridge
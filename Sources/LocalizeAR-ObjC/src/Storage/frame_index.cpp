@@ -0,0 +1,162 @@
+//
+//  frame_index.cpp
+//  LocalizeAR
+//
+
+#include "frame_index.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <lar/core/utils/json.h>
+#include <lar/mapping/frame.h>
+
+namespace lar::bridge {
+
+using namespace frames;
+
+namespace {
+
+FrameRecord recordFrom(const lar::Frame& frame) {
+    FrameRecord record{};
+    record.id = frame.id;
+    record.timestamp = static_cast<int64_t>(frame.timestamp);
+    Eigen::Map<Eigen::Matrix3d>(record.intrinsics) = frame.intrinsics;
+    Eigen::Map<Eigen::Matrix4d>(record.extrinsics) = frame.extrinsics;
+    return record;
+}
+
+// Streams records into a temporary file and renames it into place once complete.
+class FrameIndexWriter {
+public:
+    explicit FrameIndexWriter(const std::string& path) : path_(path), temp_path_(path + ".tmp") {
+        out_.open(temp_path_, std::ios::binary | std::ios::trunc);
+        if (!out_) {
+            throw std::runtime_error("Failed to create " + temp_path_);
+        }
+        const Header placeholder{};
+        out_.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+    }
+
+    ~FrameIndexWriter() {
+        if (out_.is_open()) {
+            out_.close();
+            std::remove(temp_path_.c_str());
+        }
+    }
+
+    void add(const lar::Frame& frame) {
+        const FrameRecord record = recordFrom(frame);
+        out_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        count_++;
+    }
+
+    void finish() {
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.record_size = sizeof(FrameRecord);
+        header.frame_count = count_;
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.close();
+        if (!out_) {
+            std::remove(temp_path_.c_str());
+            throw std::runtime_error("Failed to write " + temp_path_);
+        }
+        if (std::rename(temp_path_.c_str(), path_.c_str()) != 0) {
+            std::remove(temp_path_.c_str());
+            throw std::runtime_error("Failed to move frame index into place at " + path_);
+        }
+    }
+
+private:
+    std::string path_;
+    std::string temp_path_;
+    std::ofstream out_;
+    uint64_t count_ = 0;
+};
+
+} // namespace
+
+FrameIndex::FrameIndex(const std::string& path) : file_(std::make_shared<MappedFile>(path)) {
+    if (file_->size() < sizeof(Header)) {
+        throw std::runtime_error("Frame index is truncated: " + path);
+    }
+    const auto* header = reinterpret_cast<const Header*>(file_->data());
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a frame index: " + path);
+    }
+    if (header->version == 0 || header->version > kVersion || header->record_size != sizeof(FrameRecord)) {
+        throw std::runtime_error("Unsupported frame index version " + std::to_string(header->version) + ": " + path);
+    }
+    if (header->frame_count > (file_->size() - sizeof(Header)) / sizeof(FrameRecord)) {
+        throw std::runtime_error("Frame index is truncated: " + path);
+    }
+    count_ = static_cast<size_t>(header->frame_count);
+    records_ = reinterpret_cast<const FrameRecord*>(file_->data() + sizeof(Header));
+    file_->adviseSequential(sizeof(Header), count_ * sizeof(FrameRecord));
+}
+
+bool FrameIndex::isFrameIndex(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    in.read(magic, sizeof(magic));
+    return in.gcount() == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+void FrameIndex::write(const std::vector<lar::Frame>& frames, const std::string& path) {
+    FrameIndexWriter writer(path);
+    for (const lar::Frame& frame : frames) writer.add(frame);
+    writer.finish();
+}
+
+void FrameIndex::convertFromJson(const std::string& json_path, const std::string& index_path) {
+    std::ifstream in(json_path);
+    if (!in) {
+        throw std::runtime_error("Failed to open " + json_path);
+    }
+    const nlohmann::json document = nlohmann::json::parse(in);
+    if (!document.is_array()) {
+        throw std::runtime_error("Frames JSON is not an array: " + json_path);
+    }
+
+    FrameIndexWriter writer(index_path);
+    lar::Frame frame;
+    for (const nlohmann::json& element : document) {
+        element.get_to(frame);
+        writer.add(frame);
+    }
+    writer.finish();
+}
+
+void FrameIndex::writeJson(const std::string& json_path) const {
+    // Frames are converted one at a time, so no DOM of the whole dataset is built.
+    std::ofstream out(json_path);
+    if (!out) {
+        throw std::runtime_error("Failed to create " + json_path);
+    }
+    out << '[';
+    lar::Frame frame;
+    for (size_t i = 0; i < count_; i++) {
+        copyTo(i, frame);
+        if (i > 0) out << ',';
+        out << nlohmann::json(frame).dump();
+    }
+    out << ']';
+    if (!out) {
+        throw std::runtime_error("Failed to write " + json_path);
+    }
+}
+
+void FrameIndex::copyTo(size_t index, lar::Frame& frame) const {
+    const FrameRecord& record = records_[index];
+    frame.id = static_cast<size_t>(record.id);
+    frame.timestamp = record.timestamp;
+    frame.intrinsics = record.intrinsicsMatrix();
+    frame.extrinsics = record.extrinsicsMatrix();
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,88 @@
+//
+//  frame_index.h
+//  LocalizeAR
+//
+//  Binary frame index (frames.larframes), a compact replacement for frames.json.
+//
+//  A 64 byte header followed by one fixed-size record per frame holding its id, timestamp,
+//  intrinsics and extrinsics. The file is memory-mapped and records are read in place, so a
+//  dataset of any length is opened in constant time and iterated without allocating.
+//  Matrices are column-major doubles; all values are little-endian.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "mapped_file.h"
+
+namespace lar {
+    struct Frame;
+}
+
+namespace lar::bridge {
+
+namespace frames {
+
+constexpr char kMagic[8] = { 'L', 'A', 'R', 'F', 'R', 'M', 'S', '\0' };
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;  // sizeof(FrameRecord) of the writer, for forward compatibility
+    uint64_t frame_count;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(Header) == 64, "frame index header must stay 64 bytes");
+
+struct FrameRecord {
+    uint64_t id;
+    int64_t timestamp;
+    double intrinsics[9];   // column-major 3x3
+    double extrinsics[16];  // column-major 4x4
+
+    Eigen::Map<const Eigen::Matrix3d> intrinsicsMatrix() const { return Eigen::Map<const Eigen::Matrix3d>(intrinsics); }
+    Eigen::Map<const Eigen::Matrix4d> extrinsicsMatrix() const { return Eigen::Map<const Eigen::Matrix4d>(extrinsics); }
+};
+static_assert(sizeof(FrameRecord) == 216, "frame records are packed");
+
+} // namespace frames
+
+class FrameIndex {
+public:
+    // Maps the index at `path`. Throws std::runtime_error if it is missing, truncated or not
+    // a supported frame index.
+    explicit FrameIndex(const std::string& path);
+
+    // True if the file at `path` starts with the frame index magic.
+    static bool isFrameIndex(const std::string& path);
+
+    // Writes `frames` to `path` (via a temporary file renamed into place).
+    static void write(const std::vector<lar::Frame>& frames, const std::string& path);
+    // Converts frames.json to a frame index and back. Throw std::runtime_error on I/O or
+    // parse errors.
+    static void convertFromJson(const std::string& json_path, const std::string& index_path);
+    void writeJson(const std::string& json_path) const;
+
+    size_t size() const { return count_; }
+    const frames::FrameRecord& operator[](size_t index) const { return records_[index]; }
+    const frames::FrameRecord* begin() const { return records_; }
+    const frames::FrameRecord* end() const { return records_ + count_; }
+
+    // Copies record `index` into a lar::Frame, for APIs that need one.
+    void copyTo(size_t index, lar::Frame& frame) const;
+
+private:
+    std::shared_ptr<MappedFile> file_;
+    const frames::FrameRecord* records_ = nullptr;
+    size_t count_ = 0;
+};
+
+} // namespace lar::bridge
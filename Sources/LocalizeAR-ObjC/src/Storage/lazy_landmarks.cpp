@@ -0,0 +1,91 @@
+//
+//  lazy_landmarks.cpp
+//  LocalizeAR
+//
+
+#include "lazy_landmarks.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+#include <lar/core/map.h>
+
+namespace lar::bridge {
+
+LazyLandmarks::LazyLandmarks(std::shared_ptr<MapArchive> archive, lar::Map& map)
+    : archive_(std::move(archive)) {
+    // Everything that can reject the archive runs before `map` is touched, so a failed load
+    // leaves its landmarks as they were.
+    const size_t n = archive_->landmarkCount();
+    const uint64_t* ids = archive_->ids();
+    std::unordered_map<size_t, size_t> row_of;
+    row_of.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        if (!row_of.emplace(static_cast<size_t>(ids[i]), i).second) {
+            throw std::runtime_error("Map archive has duplicate landmark ids");
+        }
+    }
+    std::vector<lar::Landmark> landmarks;
+    archive_->appendLandmarkKeys(landmarks);
+
+    const archive::Bounds* bounds = archive_->bounds();
+    std::vector<PackedRTree::Box> boxes(n);
+    for (size_t i = 0; i < n; i++) {
+        boxes[i] = { bounds[i].lower_x, bounds[i].lower_y, bounds[i].upper_x, bounds[i].upper_y };
+    }
+    tree_ = PackedRTree(boxes);
+    materialized_.assign(n, false);
+
+    // The database owns copies, so find each archive row's landmark again by id. Ids are
+    // unique, so every row finds one.
+    map.landmarks = decltype(map.landmarks)();
+    map.landmarks.insert(landmarks);
+    rows_.assign(n, nullptr);
+    for (lar::Landmark* landmark : map.landmarks.all()) {
+        auto it = row_of.find(landmark->id);
+        if (it != row_of.end()) rows_[it->second] = landmark;
+    }
+}
+
+size_t LazyLandmarks::prepare(double x, double z, double diameter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (materialized_count_ == rows_.size()) return 0;
+
+    // The core's query may round its extent outward (cell alignment), so materialize a margin
+    // beyond the square; an unneeded descriptor only costs memory, a missing one a match.
+    size_t count = 0;
+    tree_.search(PackedRTree::Box::around(x, z, diameter * 1.25), [&](uint32_t row) {
+        if (!materialized_[row]) count += materializeRow(row);
+    });
+    return count;
+}
+
+size_t LazyLandmarks::materializeAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (size_t i = 0; i < rows_.size(); i++) {
+        if (!materialized_[i]) count += materializeRow(i);
+    }
+    return count;
+}
+
+size_t LazyLandmarks::materializeRow(size_t row) {
+    lar::Landmark& landmark = *rows_[row];
+    archive_->materialize(row, landmark);
+    materialized_[row] = true;
+    materialized_count_++;
+    materialized_bytes_ += uint64_t(landmark.desc.total()) * landmark.desc.elemSize() + sizeof(landmark.orientation);
+    return 1;
+}
+
+LazyLandmarks::Stats LazyLandmarks::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.landmarks = rows_.size();
+    stats.materialized = materialized_count_;
+    stats.materialized_bytes = materialized_bytes_;
+    stats.resident_descriptor_bytes = archive_->residentDescriptorBytes();
+    return stats;
+}
+
+} // namespace lar::bridge
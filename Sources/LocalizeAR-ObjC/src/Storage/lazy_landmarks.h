@@ -0,0 +1,69 @@
+//
+//  lazy_landmarks.h
+//  LocalizeAR
+//
+//  Landmarks loaded from an archive with only their spatial keys decoded.
+//
+//  Loading inserts every landmark with its id, position, visibility bounds and stats, which is
+//  all the spatial index and the usability filter look at. Descriptors and orientations stay in
+//  the archive until a query first reaches the landmark, so a large map costs memory only for
+//  the parts of it that are actually localized against.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "map_archive.h"
+#include "../Spatial/packed_rtree.h"
+
+namespace lar {
+    class Map;
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+class LazyLandmarks {
+public:
+    struct Stats {
+        size_t landmarks = 0;
+        size_t materialized = 0;
+        // Heap and mapped memory referenced by materialized fields.
+        uint64_t materialized_bytes = 0;
+        // Descriptor pages of the archive currently resident, materialized or not.
+        uint64_t resident_descriptor_bytes = 0;
+    };
+
+    // Replaces the landmarks of `map` with key-only copies of the archive's. The landmark
+    // database must not be rebuilt or added to afterwards (e.g. by mapping), since rows are
+    // tracked by pointer; this is meant for maps loaded to localize against. Throws, leaving
+    // `map` unchanged, if the archive repeats a landmark id.
+    LazyLandmarks(std::shared_ptr<MapArchive> archive, lar::Map& map);
+
+    // Materializes every landmark whose bounds intersect the query square. Returns how many
+    // were materialized by this call.
+    size_t prepare(double x, double z, double diameter);
+    // Materializes everything, e.g. before saving or training on the map.
+    size_t materializeAll();
+
+    Stats stats() const;
+
+private:
+    size_t materializeRow(size_t row);
+
+    std::shared_ptr<MapArchive> archive_;
+    mutable std::mutex mutex_;
+    std::vector<lar::Landmark*> rows_;
+    // Archive rows by bounds, so a query only visits the rows it can see.
+    PackedRTree tree_;
+    std::vector<bool> materialized_;
+    size_t materialized_count_ = 0;
+    uint64_t materialized_bytes_ = 0;
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,611 @@
+//
+//  map_archive.cpp
+//  LocalizeAR
+//
+
+#include "map_archive.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include <lar/core/map.h>
+
+#include "../Matching/descriptor_codec.h"
+#include "../Spatial/morton_order.h"
+
+namespace lar::bridge {
+
+using namespace archive;
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void writePadding(std::ostream& out, uint64_t count) {
+    static const char zeros[kAlignment] = {};
+    while (count > 0) {
+        uint64_t chunk = std::min<uint64_t>(count, kAlignment);
+        out.write(zeros, static_cast<std::streamsize>(chunk));
+        count -= chunk;
+    }
+}
+
+void copyTransform(const Eigen::Transform<double,3,Eigen::Affine>& transform, double out[16]) {
+    std::memcpy(out, transform.matrix().data(), 16 * sizeof(double));
+}
+
+Eigen::Transform<double,3,Eigen::Affine> transformFrom(const double values[16]) {
+    Eigen::Transform<double,3,Eigen::Affine> transform;
+    transform.matrix() = Eigen::Map<const Eigen::Matrix4d>(values);
+    return transform;
+}
+
+std::vector<lar::Landmark*> ordered(const std::vector<lar::Landmark*>& landmarks, LandmarkOrder order) {
+    return order == LandmarkOrder::Spatial ? mortonOrdered(landmarks) : landmarks;
+}
+
+// Forwards writes to another buffer, keeping a running CRC-32 and byte count.
+class ChecksumBuffer : public std::streambuf {
+public:
+    explicit ChecksumBuffer(std::streambuf* target) : target_(target), crc_(crc32(0L, Z_NULL, 0)) {}
+
+    uint32_t checksum() const { return static_cast<uint32_t>(crc_); }
+    uint64_t count() const { return count_; }
+
+protected:
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        const std::streamsize written = target_->sputn(data, count);
+        update(data, written);
+        return written;
+    }
+
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+        const char c = traits_type::to_char_type(ch);
+        if (traits_type::eq_int_type(target_->sputc(c), traits_type::eof())) return traits_type::eof();
+        update(&c, 1);
+        return ch;
+    }
+
+private:
+    void update(const char* data, std::streamsize count) {
+        // zlib takes 32-bit lengths.
+        while (count > 0) {
+            const uInt chunk = static_cast<uInt>(std::min<std::streamsize>(count, 1 << 30));
+            crc_ = crc32(crc_, reinterpret_cast<const Bytef*>(data), chunk);
+            data += chunk;
+            count -= chunk;
+            count_ += chunk;
+        }
+    }
+
+    std::streambuf* target_;
+    uLong crc_;
+    uint64_t count_ = 0;
+};
+
+uint32_t checksumOf(const uint8_t* data, uint64_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    while (size > 0) {
+        const uInt chunk = static_cast<uInt>(std::min<uint64_t>(size, 1 << 30));
+        crc = crc32(crc, data, chunk);
+        data += chunk;
+        size -= chunk;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+uint32_t partOf(SectionKind kind) {
+    switch (kind) {
+        case SectionKind::Anchors: return kAnchorPart;
+        case SectionKind::Edges: return kEdgePart;
+        case SectionKind::Origin: return kOriginPart;
+        default: return kLandmarkPart;
+    }
+}
+
+} // namespace
+
+// MARK: - MapArchiveWriter
+
+void MapArchiveWriter::addSection(SectionKind kind, uint64_t size, Producer producer) {
+    sections_.push_back({ kind, size, std::move(producer) });
+}
+
+void MapArchiveWriter::write(const std::string& path, uint64_t landmark_count) const {
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.section_count = static_cast<uint32_t>(sections_.size());
+    header.landmark_count = landmark_count;
+
+    // Lay out sections after the table, each starting on an aligned offset.
+    std::vector<SectionEntry> table(sections_.size());
+    uint64_t offset = alignUp(sizeof(Header) + table.size() * sizeof(SectionEntry), kAlignment);
+    for (size_t i = 0; i < sections_.size(); i++) {
+        table[i] = SectionEntry{ static_cast<uint32_t>(sections_[i].kind), 0, offset, sections_[i].size, 0 };
+        offset = alignUp(offset + sections_[i].size, kAlignment);
+    }
+
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to create " + temp_path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+
+        uint64_t position = sizeof(Header) + table.size() * sizeof(SectionEntry);
+        for (size_t i = 0; i < sections_.size(); i++) {
+            writePadding(out, table[i].offset - position);
+            ChecksumBuffer buffer(out.rdbuf());
+            std::ostream section_out(&buffer);
+            sections_[i].producer(section_out);
+            if (!section_out || buffer.count() != table[i].size) {
+                throw std::runtime_error("Section size mismatch while writing " + temp_path);
+            }
+            table[i].flags |= kHasChecksum;
+            table[i].checksum = buffer.checksum();
+            position = table[i].offset + table[i].size;
+        }
+
+        // Checksums are only known now; rewrite the table in place.
+        out.seekp(sizeof(Header));
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+        if (!out) {
+            throw std::runtime_error("Failed to write " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Failed to move archive into place at " + path);
+    }
+}
+
+// MARK: - MapArchive
+
+MapArchive::MapArchive(const std::string& path) : file_(std::make_shared<MappedFile>(path)) {
+    if (file_->size() < sizeof(Header)) {
+        throw std::runtime_error("Map archive is truncated: " + path);
+    }
+    header_ = reinterpret_cast<const Header*>(file_->data());
+    table_ = reinterpret_cast<const SectionEntry*>(file_->data() + sizeof(Header));
+    validate();
+
+    if (auto info = section<DescriptorInfo>(SectionKind::DescriptorInfo)) {
+        descriptor_info_ = *info;
+    }
+
+    // Spatial keys are read for every landmark at load; descriptors only for matched ones.
+    for (auto kind : { SectionKind::LandmarkIds, SectionKind::LandmarkPositions, SectionKind::LandmarkBounds }) {
+        if (auto entry = find(kind)) file_->adviseWillNeed(entry->offset, entry->size);
+    }
+    if (auto entry = find(SectionKind::DescriptorCodes)) {
+        file_->adviseWillNeed(entry->offset, entry->size);
+    }
+    if (auto entry = find(SectionKind::Descriptors)) {
+        file_->adviseRandom(entry->offset, entry->size);
+    }
+}
+
+bool MapArchive::isArchive(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    in.read(magic, sizeof(magic));
+    return in.gcount() == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+void MapArchive::validate() const {
+    const std::string& path = file_->path();
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a map archive: " + path);
+    }
+    if (header_->version == 0 || header_->version > kVersion) {
+        throw std::runtime_error("Unsupported map archive version " + std::to_string(header_->version) + ": " + path);
+    }
+    const uint64_t table_end = sizeof(Header) + uint64_t(header_->section_count) * sizeof(SectionEntry);
+    if (table_end > file_->size()) {
+        throw std::runtime_error("Map archive section table is truncated: " + path);
+    }
+    for (uint32_t i = 0; i < header_->section_count; i++) {
+        const SectionEntry& entry = table_[i];
+        if (entry.offset % kAlignment != 0 || entry.offset < table_end ||
+            entry.offset > file_->size() || entry.size > file_->size() - entry.offset) {
+            throw std::runtime_error("Map archive section " + std::to_string(entry.kind) + " is out of bounds: " + path);
+        }
+    }
+
+    // Per-landmark sections must cover every landmark.
+    const uint64_t n = header_->landmark_count;
+    const auto expect = [&](SectionKind kind, uint64_t bytes_per_landmark, bool required) {
+        const SectionEntry* entry = find(kind);
+        if (!entry) {
+            if (required && n > 0) {
+                throw std::runtime_error("Map archive is missing section " + std::to_string(uint32_t(kind)) + ": " + path);
+            }
+            return;
+        }
+        if (entry->size != n * bytes_per_landmark) {
+            throw std::runtime_error("Map archive section " + std::to_string(uint32_t(kind)) + " has the wrong size: " + path);
+        }
+    };
+    expect(SectionKind::LandmarkIds, sizeof(uint64_t), true);
+    expect(SectionKind::LandmarkPositions, 3 * sizeof(double), true);
+    expect(SectionKind::LandmarkOrientations, 3 * sizeof(float), false);
+    expect(SectionKind::LandmarkBounds, sizeof(Bounds), true);
+    expect(SectionKind::LandmarkStats, sizeof(LandmarkStats), false);
+
+    // Records are read in place, so a section must hold exactly one, or whole ones.
+    const auto expectRecords = [&](SectionKind kind, uint64_t record_bytes, bool single) {
+        const SectionEntry* entry = find(kind);
+        if (entry && (single ? entry->size != record_bytes : entry->size % record_bytes != 0)) {
+            throw std::runtime_error("Map archive section " + std::to_string(uint32_t(kind)) + " has the wrong size: " + path);
+        }
+    };
+    expectRecords(SectionKind::DescriptorInfo, sizeof(DescriptorInfo), true);
+    expectRecords(SectionKind::Origin, sizeof(OriginRecord), true);
+    expectRecords(SectionKind::DeltaInfo, sizeof(DeltaInfo), true);
+    expectRecords(SectionKind::Anchors, sizeof(AnchorRecord), false);
+    expectRecords(SectionKind::Edges, sizeof(EdgeRecord), false);
+    expectRecords(SectionKind::RemovedLandmarks, sizeof(uint64_t), false);
+    expectRecords(SectionKind::LandmarkUpdates, sizeof(LandmarkUpdate), false);
+    expectRecords(SectionKind::RemovedAnchors, sizeof(uint64_t), false);
+    expectRecords(SectionKind::RemovedEdges, sizeof(EdgeRecord), false);
+
+    // The writer stores single-channel 8-bit or float rows; any other type would be handed to
+    // the matcher as is.
+    const SectionEntry* info = find(SectionKind::DescriptorInfo);
+    const DescriptorInfo* layout = info ? reinterpret_cast<const DescriptorInfo*>(file_->data() + info->offset) : nullptr;
+    if (layout && layout->type != CV_8U && layout->type != CV_32F) {
+        throw std::runtime_error("Map archive descriptors have unsupported type " + std::to_string(layout->type) + ": " + path);
+    }
+    if (const SectionEntry* rows = find(SectionKind::Descriptors)) {
+        if (!layout) {
+            throw std::runtime_error("Map archive descriptors have no layout info: " + path);
+        }
+        const uint64_t row_bytes = uint64_t(layout->cols) * CV_ELEM_SIZE(layout->type);
+        if (layout->cols <= 0 || layout->row_stride < row_bytes || rows->size != n * layout->row_stride) {
+            throw std::runtime_error("Map archive descriptor section is malformed: " + path);
+        }
+    }
+}
+
+std::unique_ptr<CompressedDescriptorIndex> MapArchive::descriptorIndex() const {
+    const SectionEntry* codebook = find(SectionKind::DescriptorCodebook);
+    const SectionEntry* codes = find(SectionKind::DescriptorCodes);
+    if (!codebook || !codes) return nullptr;
+
+    DescriptorCodec codec = DescriptorCodec::deserialize(file_->data() + codebook->offset, codebook->size);
+    const int n = static_cast<int>(landmarkCount());
+    if (codes->size != uint64_t(n) * codec.codeSize()) {
+        throw std::runtime_error("Map archive descriptor codes have the wrong size: " + file_->path());
+    }
+    // Both views are read-only in practice; cv::Mat just has no const constructor.
+    cv::Mat code_rows(n, static_cast<int>(codec.codeSize()), CV_8U, const_cast<uint8_t*>(file_->data() + codes->offset));
+    cv::Mat exact_rows;
+    if (const SectionEntry* rows = find(SectionKind::Descriptors)) {
+        exact_rows = cv::Mat(n, descriptor_info_.cols, descriptor_info_.type,
+                             const_cast<uint8_t*>(file_->data() + rows->offset), descriptor_info_.row_stride);
+    }
+    // Rows without a descriptor were written as zero codes; only the stats flag tells them apart.
+    std::vector<bool> has_descriptor;
+    if (const LandmarkStats* landmark_stats = stats()) {
+        has_descriptor.resize(size_t(n));
+        for (int i = 0; i < n; i++) has_descriptor[size_t(i)] = (landmark_stats[i].flags & kHasDescriptor) != 0;
+    }
+    return std::make_unique<CompressedDescriptorIndex>(std::move(codec), code_rows, exact_rows, std::move(has_descriptor));
+}
+
+void MapArchive::touchDescriptors(size_t first, size_t last) const {
+    const SectionEntry* rows = find(SectionKind::Descriptors);
+    last = std::min(last, landmarkCount());
+    if (!rows || first >= last) return;
+    const size_t page = static_cast<size_t>(::getpagesize());
+    const volatile uint8_t* begin = file_->data() + rows->offset + first * descriptor_info_.row_stride;
+    const size_t length = (last - first) * descriptor_info_.row_stride;
+    uint8_t sink = 0;
+    for (size_t offset = 0; offset < length; offset += page) sink ^= begin[offset];
+    (void)sink;
+}
+
+size_t MapArchive::residentDescriptorBytes() const {
+    const SectionEntry* rows = find(SectionKind::Descriptors);
+    return rows ? file_->residentBytes(rows->offset, rows->size) : 0;
+}
+
+const SectionEntry* MapArchive::find(SectionKind kind) const {
+    for (uint32_t i = 0; i < header_->section_count; i++) {
+        if (table_[i].kind == static_cast<uint32_t>(kind)) return &table_[i];
+    }
+    return nullptr;
+}
+
+const uint64_t* MapArchive::ids() const { return section<uint64_t>(SectionKind::LandmarkIds); }
+const double* MapArchive::positions() const { return section<double>(SectionKind::LandmarkPositions); }
+const float* MapArchive::orientations() const { return section<float>(SectionKind::LandmarkOrientations); }
+const Bounds* MapArchive::bounds() const { return section<Bounds>(SectionKind::LandmarkBounds); }
+const LandmarkStats* MapArchive::stats() const { return section<LandmarkStats>(SectionKind::LandmarkStats); }
+
+cv::Mat MapArchive::descriptor(size_t index) const {
+    const LandmarkStats* landmark_stats = stats();
+    if (landmark_stats && !(landmark_stats[index].flags & kHasDescriptor)) return cv::Mat();
+    const uint8_t* rows = section<uint8_t>(SectionKind::Descriptors);
+    if (!rows) return cv::Mat();
+
+    // The mapping is PROT_READ; the tracker only ever reads descriptors.
+    void* row = const_cast<uint8_t*>(rows + index * descriptor_info_.row_stride);
+    return cv::Mat(1, descriptor_info_.cols, descriptor_info_.type, row);
+}
+
+void MapArchive::load(lar::Map& map) const {
+    std::vector<lar::Landmark> landmarks;
+    appendLandmarks(landmarks);
+    map.landmarks.insert(landmarks);
+    loadMapData(map);
+}
+
+void MapArchive::appendLandmarks(std::vector<lar::Landmark>& landmarks, size_t first, size_t last) const {
+    last = std::min(last, landmarkCount());
+    const size_t offset = landmarks.size();
+    appendLandmarkKeys(landmarks, first, last);
+    for (size_t i = first; i < last; i++) {
+        materialize(i, landmarks[offset + i - first]);
+    }
+}
+
+void MapArchive::appendLandmarkKeys(std::vector<lar::Landmark>& landmarks, size_t first, size_t last) const {
+    last = std::min(last, landmarkCount());
+    if (first >= last) return;
+    const uint64_t* landmark_ids = ids();
+    const double* landmark_positions = positions();
+    const Bounds* landmark_bounds = bounds();
+    const LandmarkStats* landmark_stats = stats();
+
+    landmarks.reserve(landmarks.size() + (last - first));
+    for (size_t i = first; i < last; i++) {
+        Eigen::Vector3d position(landmark_positions[3*i], landmark_positions[3*i+1], landmark_positions[3*i+2]);
+        lar::Landmark& landmark = landmarks.emplace_back(position, cv::Mat(), landmark_ids[i]);
+        landmark.bounds.lower.x = landmark_bounds[i].lower_x;
+        landmark.bounds.lower.y = landmark_bounds[i].lower_y;
+        landmark.bounds.upper.x = landmark_bounds[i].upper_x;
+        landmark.bounds.upper.y = landmark_bounds[i].upper_y;
+        // Stats are 16 bytes and decide whether the core considers a landmark usable, so they
+        // are part of the keys rather than materialized later.
+        if (landmark_stats) {
+            landmark.last_seen = landmark_stats[i].last_seen;
+            landmark.sightings = landmark_stats[i].sightings;
+            landmark.is_matched = (landmark_stats[i].flags & kMatched) != 0;
+        }
+    }
+}
+
+void MapArchive::appendSnapshotLandmarks(std::vector<lar::Landmark>& landmarks) const {
+    const size_t offset = landmarks.size();
+    appendLandmarkKeys(landmarks);
+    if (const float* landmark_orientations = orientations()) {
+        for (size_t i = 0; i < landmarkCount(); i++) {
+            landmarks[offset + i].orientation = Eigen::Vector3f(landmark_orientations[3*i], landmark_orientations[3*i+1], landmark_orientations[3*i+2]);
+        }
+    }
+}
+
+void MapArchive::materialize(size_t index, lar::Landmark& landmark) const {
+    landmark.desc = descriptor(index);
+    if (const float* landmark_orientations = orientations()) {
+        landmark.orientation = Eigen::Vector3f(landmark_orientations[3*index], landmark_orientations[3*index+1], landmark_orientations[3*index+2]);
+    }
+}
+
+void MapArchive::loadMapData(lar::Map& map) const {
+    reloadMapData(map, kAnchorPart | kEdgePart | kOriginPart);
+}
+
+void MapArchive::reloadMapData(lar::Map& map, uint32_t parts) const {
+    if (parts & kAnchorPart) {
+        map.anchors.clear();
+        size_t anchor_count = 0;
+        if (const AnchorRecord* anchors = section<AnchorRecord>(SectionKind::Anchors, &anchor_count)) {
+            for (size_t i = 0; i < anchor_count; i++) {
+                map.anchors.emplace(anchors[i].id, lar::Anchor(anchors[i].id, transformFrom(anchors[i].transform)));
+            }
+        }
+    }
+
+    if (parts & kEdgePart) {
+        map.edges.clear();
+        size_t edge_count = 0;
+        if (const EdgeRecord* edges = section<EdgeRecord>(SectionKind::Edges, &edge_count)) {
+            using Neighbors = decltype(map.edges)::mapped_type;
+            std::vector<size_t> neighbors;
+            for (size_t i = 0; i < edge_count; i++) {
+                neighbors.push_back(edges[i].to);
+                if (i + 1 == edge_count || edges[i + 1].from != edges[i].from) {
+                    map.edges[edges[i].from] = Neighbors(neighbors.begin(), neighbors.end());
+                    neighbors.clear();
+                }
+            }
+        }
+    }
+
+    if (parts & kOriginPart) {
+        if (const OriginRecord* origin = section<OriginRecord>(SectionKind::Origin)) {
+            map.origin = transformFrom(origin->transform);
+            map.origin_ready = origin->ready != 0;
+        }
+    }
+}
+
+std::vector<SectionKind> MapArchive::corruptSections(uint32_t parts) const {
+    std::vector<SectionKind> corrupt;
+    for (uint32_t i = 0; i < header_->section_count; i++) {
+        const SectionEntry& entry = table_[i];
+        const SectionKind kind = static_cast<SectionKind>(entry.kind);
+        if (!(entry.flags & kHasChecksum) || !(partOf(kind) & parts)) continue;
+        if (checksumOf(file_->data() + entry.offset, entry.size) != static_cast<uint32_t>(entry.checksum)) {
+            corrupt.push_back(kind);
+        }
+    }
+    return corrupt;
+}
+
+uint32_t MapArchive::changedParts(const MapArchive& other) const {
+    uint32_t changed = 0;
+    if (landmarkCount() != other.landmarkCount()) changed |= kLandmarkPart;
+
+    const auto compare = [&](const MapArchive& a, const MapArchive& b) {
+        for (uint32_t i = 0; i < a.header_->section_count; i++) {
+            const SectionEntry& entry = a.table_[i];
+            const SectionEntry* match = b.find(static_cast<SectionKind>(entry.kind));
+            if (!match || !(entry.flags & kHasChecksum) || !(match->flags & kHasChecksum) ||
+                entry.size != match->size || entry.checksum != match->checksum) {
+                changed |= partOf(static_cast<SectionKind>(entry.kind));
+            }
+        }
+    };
+    // Both ways, so sections only one side has count as changes.
+    compare(*this, other);
+    compare(other, *this);
+    return changed;
+}
+
+void MapArchive::write(const lar::Map& map, const std::string& path, const DescriptorCodec* codec,
+                       archive::LandmarkOrder order) {
+    const std::vector<lar::Landmark*> landmarks = ordered(map.landmarks.all(), order);
+    MapArchiveWriter writer;
+    addLandmarkSections(writer, landmarks, codec);
+    addMapSections(writer, map);
+    writer.write(path, landmarks.size());
+}
+
+void MapArchive::writeLandmarks(const std::vector<lar::Landmark*>& landmarks, const std::string& path,
+                                const DescriptorCodec* codec, archive::LandmarkOrder order) {
+    MapArchiveWriter writer;
+    addLandmarkSections(writer, ordered(landmarks, order), codec);
+    writer.write(path, landmarks.size());
+}
+
+void MapArchive::writeMapData(const lar::Map& map, const std::string& path) {
+    MapArchiveWriter writer;
+    addMapSections(writer, map);
+    writer.write(path, 0);
+}
+
+void MapArchive::addLandmarkSections(MapArchiveWriter& writer, const std::vector<lar::Landmark*>& landmarks,
+                                     const DescriptorCodec* codec) {
+    const size_t n = landmarks.size();
+    std::vector<uint64_t> ids(n);
+    std::vector<double> positions(3 * n);
+    std::vector<float> orientations(3 * n);
+    std::vector<Bounds> bounds(n);
+    std::vector<LandmarkStats> stats(n);
+    DescriptorInfo info{ -1, 0, 0 };
+
+    for (size_t i = 0; i < n; i++) {
+        const lar::Landmark& landmark = *landmarks[i];
+        ids[i] = landmark.id;
+        for (int k = 0; k < 3; k++) {
+            positions[3*i+k] = landmark.position[k];
+            orientations[3*i+k] = landmark.orientation[k];
+        }
+        bounds[i] = { landmark.bounds.lower.x, landmark.bounds.lower.y, landmark.bounds.upper.x, landmark.bounds.upper.y };
+        stats[i] = { static_cast<int64_t>(landmark.last_seen), static_cast<int32_t>(landmark.sightings), 0 };
+        if (landmark.is_matched) stats[i].flags |= kMatched;
+
+        if (!landmark.desc.empty()) {
+            const int cols = static_cast<int>(landmark.desc.total());
+            if (landmark.desc.type() != CV_8U && landmark.desc.type() != CV_32F) {
+                throw std::runtime_error("Landmark descriptors must be single-channel 8-bit or float");
+            }
+            if (info.type < 0) {
+                info.type = landmark.desc.type();
+                info.cols = cols;
+                info.row_stride = alignUp(uint64_t(cols) * landmark.desc.elemSize(), 16);
+            } else if (info.type != landmark.desc.type() || info.cols != cols) {
+                throw std::runtime_error("Landmark descriptors must share one type and length");
+            }
+            stats[i].flags |= kHasDescriptor;
+        }
+    }
+
+    writer.addSection(SectionKind::LandmarkIds, std::move(ids));
+    writer.addSection(SectionKind::LandmarkPositions, std::move(positions));
+    writer.addSection(SectionKind::LandmarkOrientations, std::move(orientations));
+    writer.addSection(SectionKind::LandmarkBounds, std::move(bounds));
+    writer.addSection(SectionKind::LandmarkStats, std::move(stats));
+
+    if (info.type >= 0) {
+        writer.addSection(SectionKind::DescriptorInfo, std::vector<DescriptorInfo>{ info });
+        // Rows are streamed straight from the landmarks to avoid a second copy of every descriptor.
+        writer.addSection(SectionKind::Descriptors, n * info.row_stride, [landmarks, info](std::ostream& out) {
+            std::vector<char> row(info.row_stride, 0);
+            for (const lar::Landmark* landmark : landmarks) {
+                std::fill(row.begin(), row.end(), 0);
+                if (!landmark->desc.empty()) {
+                    cv::Mat continuous = landmark->desc.isContinuous() ? landmark->desc : landmark->desc.clone();
+                    std::memcpy(row.data(), continuous.data, continuous.total() * continuous.elemSize());
+                }
+                out.write(row.data(), static_cast<std::streamsize>(row.size()));
+            }
+        });
+    }
+
+    if (codec && info.type >= 0) {
+        if (info.cols != codec->dims()) {
+            throw std::runtime_error("Descriptor codec doesn't match the landmark descriptors");
+        }
+        const std::vector<uint8_t> codebook = codec->serialize();
+        writer.addSection(SectionKind::DescriptorCodebook, codebook);
+        const size_t code_size = codec->codeSize();
+        writer.addSection(SectionKind::DescriptorCodes, n * code_size, [landmarks, codec = *codec, code_size](std::ostream& out) {
+            std::vector<char> code(code_size, 0);
+            cv::Mat row;
+            for (const lar::Landmark* landmark : landmarks) {
+                std::fill(code.begin(), code.end(), 0);
+                if (!landmark->desc.empty()) {
+                    landmark->desc.reshape(1, 1).convertTo(row, CV_32F);
+                    codec.encode(row.ptr<float>(), reinterpret_cast<uint8_t*>(code.data()));
+                }
+                out.write(code.data(), static_cast<std::streamsize>(code.size()));
+            }
+        });
+    }
+}
+
+void MapArchive::addMapSections(MapArchiveWriter& writer, const lar::Map& map) {
+    std::vector<AnchorRecord> anchors;
+    anchors.reserve(map.anchors.size());
+    for (const auto& pair : map.anchors) {
+        AnchorRecord record{ pair.second.id, {} };
+        copyTransform(pair.second.transform, record.transform);
+        anchors.push_back(record);
+    }
+    std::sort(anchors.begin(), anchors.end(), [](const AnchorRecord& a, const AnchorRecord& b) { return a.id < b.id; });
+    writer.addSection(SectionKind::Anchors, std::move(anchors));
+
+    std::vector<EdgeRecord> edges;
+    for (const auto& pair : map.edges) {
+        for (std::size_t to : pair.second) {
+            edges.push_back({ pair.first, to });
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const EdgeRecord& a, const EdgeRecord& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+    writer.addSection(SectionKind::Edges, std::move(edges));
+
+    OriginRecord origin{};
+    copyTransform(map.origin, origin.transform);
+    origin.ready = map.origin_ready ? 1 : 0;
+    writer.addSection(SectionKind::Origin, std::vector<OriginRecord>{ origin });
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,293 @@
+//
+//  map_archive.h
+//  LocalizeAR
+//
+//  Versioned binary map format (map.larmap).
+//
+//  The file is a 64 byte header, a section table and a list of sections, each aligned to a
+//  cache line. Landmark fields are stored column-wise (ids, positions, orientations, bounds,
+//  stats, descriptor rows) so they can be memory-mapped and read in place; descriptor cv::Mats
+//  of a loaded map point straight into the mapping instead of owning heap copies.
+//  Each section table entry carries a CRC-32 of its section, so integrity can be checked and
+//  changed sections found without decoding anything. All values are little-endian.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+#include "mapped_file.h"
+
+namespace lar {
+    class Map;
+    class Landmark;
+}
+
+namespace lar::bridge {
+
+class DescriptorCodec;
+class CompressedDescriptorIndex;
+
+namespace archive {
+
+constexpr char kMagic[8] = { 'L', 'A', 'R', 'M', 'A', 'P', '\0', '\0' };
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlignment = 64;
+
+enum class SectionKind : uint32_t {
+    LandmarkIds = 1,           // uint64_t[n]
+    LandmarkPositions = 2,     // double[3n]
+    LandmarkOrientations = 3,  // float[3n]
+    LandmarkBounds = 4,        // Bounds[n]
+    LandmarkStats = 5,         // LandmarkStats[n]
+    DescriptorInfo = 6,        // DescriptorInfo
+    Descriptors = 7,           // n rows of DescriptorInfo::row_stride bytes
+    Anchors = 8,               // AnchorRecord[]
+    Edges = 9,                 // EdgeRecord[], grouped by `from`
+    Origin = 10,               // OriginRecord
+    DescriptorCodebook = 11,   // DescriptorCodec::serialize()
+    DescriptorCodes = 12,      // n rows of DescriptorCodec::codeSize() bytes
+    // Map deltas (see map_delta.h) only. The landmark sections hold added or replaced
+    // landmarks, Anchors added or changed anchors, Edges added edges.
+    DeltaInfo = 13,            // DeltaInfo
+    RemovedLandmarks = 14,     // uint64_t[]
+    LandmarkUpdates = 15,      // LandmarkUpdate[], landmarks changed apart from their descriptor
+    RemovedAnchors = 16,       // uint64_t[]
+    RemovedEdges = 17,         // EdgeRecord[]
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t landmark_count;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(Header) == 64, "archive header must stay 64 bytes");
+
+enum SectionFlags : uint32_t {
+    kHasChecksum = 1u << 0,  // `checksum` is the CRC-32 of the section; unset in older archives
+};
+
+struct SectionEntry {
+    uint32_t kind;
+    uint32_t flags;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t checksum;
+};
+static_assert(sizeof(SectionEntry) == 32, "section entry must stay 32 bytes");
+
+struct Bounds {
+    double lower_x, lower_y, upper_x, upper_y;
+};
+
+enum LandmarkFlags : uint32_t {
+    kHasDescriptor = 1u << 0,
+    kMatched = 1u << 1,
+};
+
+struct LandmarkStats {
+    int64_t last_seen;
+    int32_t sightings;
+    uint32_t flags;
+};
+
+struct DescriptorInfo {
+    int32_t type;         // OpenCV type of a descriptor row, e.g. CV_32F or CV_8U
+    int32_t cols;
+    uint64_t row_stride;  // bytes between rows, padded to 16 for SIMD loads
+};
+
+struct AnchorRecord {
+    uint64_t id;
+    double transform[16];  // column-major
+};
+
+struct EdgeRecord {
+    uint64_t from;
+    uint64_t to;
+};
+
+struct OriginRecord {
+    double transform[16];  // column-major
+    uint8_t ready;
+    uint8_t reserved[7];
+};
+
+struct DeltaInfo {
+    uint64_t base_fingerprint;    // MapDelta::fingerprint of the map the delta applies to
+    uint64_t target_fingerprint;  // ... and of the map it produces
+    uint64_t base_landmark_count;
+    uint64_t target_landmark_count;
+};
+
+struct LandmarkUpdate {
+    uint64_t id;
+    double position[3];
+    float orientation[3];
+    uint32_t flags;  // LandmarkFlags
+    Bounds bounds;
+    int64_t last_seen;
+    int32_t sightings;
+    uint32_t reserved;
+};
+static_assert(sizeof(LandmarkUpdate) == 96, "landmark updates are packed");
+
+// Order landmark rows are written in. Spatial order (a Morton curve over x/z, see
+// morton_order.h) keeps the rows a spatial query reads close together in the file.
+enum class LandmarkOrder {
+    Database,
+    Spatial,
+};
+
+// Groups of sections that can be reloaded independently.
+enum MapParts : uint32_t {
+    kLandmarkPart = 1u << 0,  // every per-landmark and descriptor section
+    kAnchorPart = 1u << 1,
+    kEdgePart = 1u << 2,
+    kOriginPart = 1u << 3,
+    kAllParts = kLandmarkPart | kAnchorPart | kEdgePart | kOriginPart,
+};
+
+} // namespace archive
+
+// Collects sections and writes them out as a single archive. Sections are streamed to disk
+// so large payloads (descriptors) aren't duplicated in memory while writing.
+class MapArchiveWriter {
+public:
+    using Producer = std::function<void(std::ostream&)>;
+
+    void addSection(archive::SectionKind kind, uint64_t size, Producer producer);
+
+    template <typename T>
+    void addSection(archive::SectionKind kind, std::vector<T> values) {
+        auto shared = std::make_shared<std::vector<T>>(std::move(values));
+        addSection(kind, shared->size() * sizeof(T), [shared](std::ostream& out) {
+            out.write(reinterpret_cast<const char*>(shared->data()), shared->size() * sizeof(T));
+        });
+    }
+
+    // Writes to a temporary file next to `path` and renames it into place, so readers that
+    // have the previous archive mapped keep a consistent view. Sections are checksummed as
+    // they stream out and the table is filled in last.
+    void write(const std::string& path, uint64_t landmark_count) const;
+
+private:
+    struct Section {
+        archive::SectionKind kind;
+        uint64_t size;
+        Producer producer;
+    };
+    std::vector<Section> sections_;
+};
+
+// Read-only view of a memory-mapped archive.
+class MapArchive {
+public:
+    // Throws std::runtime_error if the file is missing, truncated or not a supported archive.
+    explicit MapArchive(const std::string& path);
+
+    // True if the file at `path` starts with the archive magic.
+    static bool isArchive(const std::string& path);
+
+    // Writes every landmark, anchor, edge and the origin of `map` to `path`. With a `codec`,
+    // compressed descriptor codes and the codebook are stored next to the exact descriptors.
+    static void write(const lar::Map& map, const std::string& path, const DescriptorCodec* codec = nullptr,
+                      archive::LandmarkOrder order = archive::LandmarkOrder::Spatial);
+    // Writes only the given landmarks (e.g. one tile of a tiled map).
+    static void writeLandmarks(const std::vector<lar::Landmark*>& landmarks, const std::string& path,
+                               const DescriptorCodec* codec = nullptr,
+                               archive::LandmarkOrder order = archive::LandmarkOrder::Spatial);
+    // Writes anchors, edges and origin of `map` without any landmarks.
+    static void writeMapData(const lar::Map& map, const std::string& path);
+
+    uint32_t version() const { return header_->version; }
+    size_t landmarkCount() const { return static_cast<size_t>(header_->landmark_count); }
+    const MappedFile& file() const { return *file_; }
+
+    bool hasSection(archive::SectionKind kind) const { return find(kind) != nullptr; }
+
+    // Typed view of a section. Returns nullptr (and count 0) if the section is absent.
+    template <typename T>
+    const T* section(archive::SectionKind kind, size_t* count = nullptr) const {
+        const archive::SectionEntry* entry = find(kind);
+        if (count) *count = entry ? static_cast<size_t>(entry->size / sizeof(T)) : 0;
+        return entry ? reinterpret_cast<const T*>(file_->data() + entry->offset) : nullptr;
+    }
+
+    const uint64_t* ids() const;
+    const double* positions() const;
+    const float* orientations() const;
+    const archive::Bounds* bounds() const;
+    const archive::LandmarkStats* stats() const;
+
+    // Zero-copy descriptor row of landmark `index`; empty if it has no descriptor. The Mat
+    // aliases read-only mapped memory and is only valid while this archive is alive.
+    cv::Mat descriptor(size_t index) const;
+
+    // Search index over the stored descriptor codes, or nullptr if the archive has none. Codes
+    // and exact descriptors (for re-ranking) alias the mapping; only the codes are scanned, so
+    // exact rows are paged in just for re-ranked candidates.
+    std::unique_ptr<CompressedDescriptorIndex> descriptorIndex() const;
+
+    // Builds landmarks, anchors, edges and origin into `map`. Descriptors alias the mapping,
+    // so the archive must outlive `map`.
+    void load(lar::Map& map) const;
+    // The two halves of `load`: landmarks are appended to `landmarks` without touching a map,
+    // anchors, edges and origin go straight into `map`. Landmarks can be decoded in row ranges
+    // [first, last), concurrently for disjoint ranges.
+    void appendLandmarks(std::vector<lar::Landmark>& landmarks, size_t first = 0, size_t last = SIZE_MAX) const;
+    void loadMapData(lar::Map& map) const;
+    // Replaces the given parts (archive::MapParts, except kLandmarkPart) of `map` with this
+    // archive's, leaving everything else, including the landmark database, untouched.
+    void reloadMapData(lar::Map& map, uint32_t parts) const;
+    // Lazy loading: appends landmarks with only their spatial keys (id, position, bounds) and
+    // stats decoded; `materialize` later fills in the descriptor and orientation of row `index`.
+    void appendLandmarkKeys(std::vector<lar::Landmark>& landmarks, size_t first = 0, size_t last = SIZE_MAX) const;
+    void materialize(size_t index, lar::Landmark& landmark) const;
+    // Query snapshots: the keys plus orientations, which is everything spatial queries read,
+    // without descriptors.
+    void appendSnapshotLandmarks(std::vector<lar::Landmark>& landmarks) const;
+
+    // Faults in the descriptor pages of rows [first, last) on the calling thread, so a loader
+    // can spread first-touch page faults over several threads.
+    void touchDescriptors(size_t first, size_t last) const;
+    // Bytes of the descriptor section currently resident in memory.
+    size_t residentDescriptorBytes() const;
+
+    // Integrity: sections whose CRC-32 doesn't match their recorded checksum. Sections of
+    // archives written before checksums existed can't be checked and are never reported.
+    std::vector<archive::SectionKind> corruptSections(uint32_t parts = archive::kAllParts) const;
+    // Parts (archive::MapParts) whose sections differ from `other`'s in presence, size or
+    // checksum. Without checksums on both sides a part always counts as changed.
+    uint32_t changedParts(const MapArchive& other) const;
+
+    // Map deltas reuse the container; they can't be loaded as a map.
+    bool isDelta() const { return hasSection(archive::SectionKind::DeltaInfo); }
+
+private:
+    friend class MapDelta;
+
+    static void addLandmarkSections(MapArchiveWriter& writer, const std::vector<lar::Landmark*>& landmarks,
+                                    const DescriptorCodec* codec);
+    static void addMapSections(MapArchiveWriter& writer, const lar::Map& map);
+
+    const archive::SectionEntry* find(archive::SectionKind kind) const;
+    void validate() const;
+
+    std::shared_ptr<MappedFile> file_;
+    const archive::Header* header_ = nullptr;
+    const archive::SectionEntry* table_ = nullptr;
+    archive::DescriptorInfo descriptor_info_{};
+};
+
+} // namespace lar::bridge
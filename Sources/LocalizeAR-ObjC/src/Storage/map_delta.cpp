@@ -0,0 +1,364 @@
+//
+//  map_delta.cpp
+//  LocalizeAR
+//
+
+#include "map_delta.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <lar/core/map.h>
+
+#include "map_archive.h"
+
+namespace lar::bridge {
+
+using namespace archive;
+
+namespace {
+
+using Edge = std::pair<size_t, size_t>;
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+
+bool sameDescriptor(const cv::Mat& a, const cv::Mat& b) {
+    if (a.empty() || b.empty()) return a.empty() == b.empty();
+    if (a.type() != b.type() || a.total() != b.total()) return false;
+    const cv::Mat ca = a.isContinuous() ? a : a.clone();
+    const cv::Mat cb = b.isContinuous() ? b : b.clone();
+    return std::memcmp(ca.data, cb.data, ca.total() * ca.elemSize()) == 0;
+}
+
+bool sameTransform(const Eigen::Transform<double,3,Eigen::Affine>& a, const Eigen::Transform<double,3,Eigen::Affine>& b) {
+    return std::memcmp(a.matrix().data(), b.matrix().data(), 16 * sizeof(double)) == 0;
+}
+
+LandmarkUpdate updateFrom(const lar::Landmark& landmark) {
+    LandmarkUpdate update{};
+    update.id = landmark.id;
+    for (int k = 0; k < 3; k++) {
+        update.position[k] = landmark.position[k];
+        update.orientation[k] = landmark.orientation[k];
+    }
+    update.flags = landmark.is_matched ? uint32_t(kMatched) : 0u;
+    update.bounds = { landmark.bounds.lower.x, landmark.bounds.lower.y, landmark.bounds.upper.x, landmark.bounds.upper.y };
+    update.last_seen = static_cast<int64_t>(landmark.last_seen);
+    update.sightings = static_cast<int32_t>(landmark.sightings);
+    return update;
+}
+
+void applyUpdate(const LandmarkUpdate& update, lar::Landmark& landmark) {
+    landmark.position = Eigen::Vector3d(update.position[0], update.position[1], update.position[2]);
+    landmark.orientation = Eigen::Vector3f(update.orientation[0], update.orientation[1], update.orientation[2]);
+    landmark.bounds.lower.x = update.bounds.lower_x;
+    landmark.bounds.lower.y = update.bounds.lower_y;
+    landmark.bounds.upper.x = update.bounds.upper_x;
+    landmark.bounds.upper.y = update.bounds.upper_y;
+    landmark.last_seen = update.last_seen;
+    landmark.sightings = update.sightings;
+    landmark.is_matched = (update.flags & kMatched) != 0;
+}
+
+std::set<Edge> edgesOf(const lar::Map& map) {
+    std::set<Edge> edges;
+    for (const auto& [from, neighbors] : map.edges) {
+        for (size_t to : neighbors) edges.emplace(from, to);
+    }
+    return edges;
+}
+
+// Hash of one landmark as a delta would reproduce it: the update record plus the descriptor.
+uint64_t landmarkHash(const lar::Landmark& landmark) {
+    const LandmarkUpdate state = updateFrom(landmark);
+    uint64_t hash = fnv1a(kFnvOffset, &state, sizeof(state));
+    if (!landmark.desc.empty()) {
+        const cv::Mat descriptor = landmark.desc.isContinuous() ? landmark.desc : landmark.desc.clone();
+        const int type = descriptor.type();
+        hash = fnv1a(hash, &type, sizeof(type));
+        hash = fnv1a(hash, descriptor.data, descriptor.total() * descriptor.elemSize());
+    }
+    return hash;
+}
+
+// Sums of the landmark hashes, so iteration order doesn't matter.
+uint64_t landmarksHash(const std::vector<lar::Landmark*>& landmarks) {
+    uint64_t sum = 0;
+    for (const lar::Landmark* landmark : landmarks) sum += landmarkHash(*landmark);
+    return sum;
+}
+
+uint64_t landmarksHash(const std::vector<lar::Landmark>& landmarks) {
+    uint64_t sum = 0;
+    for (const lar::Landmark& landmark : landmarks) sum += landmarkHash(landmark);
+    return sum;
+}
+
+// Combines the landmark hash with the anchors, edges and origin.
+uint64_t mapHash(const lar::Map& map, uint64_t landmarks) {
+    uint64_t anchors = 0, edges = 0;
+    for (const auto& [id, anchor] : map.anchors) {
+        const uint64_t key = id;
+        anchors += fnv1a(fnv1a(kFnvOffset, &key, sizeof(key)), anchor.transform.matrix().data(), 16 * sizeof(double));
+    }
+    for (const auto& [from, neighbors] : map.edges) {
+        for (size_t to : neighbors) {
+            const uint64_t edge[2] = { from, to };
+            edges += fnv1a(kFnvOffset, edge, sizeof(edge));
+        }
+    }
+    uint64_t origin = fnv1a(kFnvOffset, map.origin.matrix().data(), 16 * sizeof(double));
+    const uint8_t ready = map.origin_ready ? 1 : 0;
+    origin = fnv1a(origin, &ready, sizeof(ready));
+
+    const uint64_t parts[4] = { landmarks, anchors, edges, origin };
+    return fnv1a(kFnvOffset, parts, sizeof(parts));
+}
+
+bool hasEdge(const lar::Map& map, size_t from, size_t to) {
+    auto it = map.edges.find(from);
+    return it != map.edges.end() && std::find(it->second.begin(), it->second.end(), to) != it->second.end();
+}
+
+template <typename T>
+std::vector<T> sectionValues(const MapArchive& delta, SectionKind kind) {
+    size_t count = 0;
+    const T* values = delta.section<T>(kind, &count);
+    return values ? std::vector<T>(values, values + count) : std::vector<T>();
+}
+
+} // namespace
+
+bool MapDelta::Summary::empty() const {
+    return added_landmarks + replaced_landmarks + updated_landmarks + removed_landmarks +
+           changed_anchors + removed_anchors + added_edges + removed_edges == 0 && !origin_changed;
+}
+
+uint64_t MapDelta::fingerprint(const lar::Map& map) {
+    return mapHash(map, landmarksHash(map.landmarks.all()));
+}
+
+MapDelta::Summary MapDelta::write(const lar::Map& from, const lar::Map& to, const std::string& path) {
+    Summary summary;
+
+    // Landmarks, matched by id.
+    std::unordered_map<size_t, const lar::Landmark*> previous;
+    for (const lar::Landmark* landmark : from.landmarks.all()) previous.emplace(landmark->id, landmark);
+
+    std::vector<lar::Landmark*> upserts;
+    std::vector<LandmarkUpdate> updates;
+    for (lar::Landmark* landmark : to.landmarks.all()) {
+        auto it = previous.find(landmark->id);
+        if (it == previous.end()) {
+            upserts.push_back(landmark);
+            summary.added_landmarks++;
+            continue;
+        }
+        const lar::Landmark& old = *it->second;
+        previous.erase(it);
+        if (!sameDescriptor(old.desc, landmark->desc)) {
+            upserts.push_back(landmark);
+            summary.replaced_landmarks++;
+            continue;
+        }
+        const LandmarkUpdate current = updateFrom(*landmark);
+        const LandmarkUpdate before = updateFrom(old);
+        if (std::memcmp(&current, &before, sizeof(current)) != 0) {
+            updates.push_back(current);
+        }
+    }
+    summary.updated_landmarks = updates.size();
+
+    std::vector<uint64_t> removed_landmarks;
+    removed_landmarks.reserve(previous.size());
+    for (const auto& pair : previous) removed_landmarks.push_back(pair.first);
+    std::sort(removed_landmarks.begin(), removed_landmarks.end());
+    summary.removed_landmarks = removed_landmarks.size();
+
+    // Anchors.
+    std::vector<AnchorRecord> anchors;
+    for (const auto& [id, anchor] : to.anchors) {
+        auto it = from.anchors.find(id);
+        if (it != from.anchors.end() && sameTransform(it->second.transform, anchor.transform)) continue;
+        AnchorRecord record{ id, {} };
+        std::memcpy(record.transform, anchor.transform.matrix().data(), sizeof(record.transform));
+        anchors.push_back(record);
+    }
+    std::vector<uint64_t> removed_anchors;
+    for (const auto& pair : from.anchors) {
+        if (!to.anchors.count(pair.first)) removed_anchors.push_back(pair.first);
+    }
+    std::sort(removed_anchors.begin(), removed_anchors.end());
+    summary.changed_anchors = anchors.size();
+    summary.removed_anchors = removed_anchors.size();
+
+    // Edges.
+    const std::set<Edge> old_edges = edgesOf(from), new_edges = edgesOf(to);
+    std::vector<EdgeRecord> added_edges, removed_edges;
+    for (const Edge& edge : new_edges) {
+        if (!old_edges.count(edge)) added_edges.push_back({ edge.first, edge.second });
+    }
+    for (const Edge& edge : old_edges) {
+        if (!new_edges.count(edge)) removed_edges.push_back({ edge.first, edge.second });
+    }
+    summary.added_edges = added_edges.size();
+    summary.removed_edges = removed_edges.size();
+
+    summary.origin_changed = from.origin_ready != to.origin_ready || !sameTransform(from.origin, to.origin);
+
+    const DeltaInfo info{ fingerprint(from), fingerprint(to), from.landmarks.size(), to.landmarks.size() };
+    MapArchiveWriter writer;
+    writer.addSection(SectionKind::DeltaInfo, std::vector<DeltaInfo>{ info });
+    MapArchive::addLandmarkSections(writer, upserts, nullptr);
+    writer.addSection(SectionKind::RemovedLandmarks, std::move(removed_landmarks));
+    writer.addSection(SectionKind::LandmarkUpdates, std::move(updates));
+    writer.addSection(SectionKind::Anchors, std::move(anchors));
+    writer.addSection(SectionKind::RemovedAnchors, std::move(removed_anchors));
+    writer.addSection(SectionKind::Edges, std::move(added_edges));
+    writer.addSection(SectionKind::RemovedEdges, std::move(removed_edges));
+    if (summary.origin_changed) {
+        OriginRecord origin{};
+        std::memcpy(origin.transform, to.origin.matrix().data(), sizeof(origin.transform));
+        origin.ready = to.origin_ready ? 1 : 0;
+        writer.addSection(SectionKind::Origin, std::vector<OriginRecord>{ origin });
+    }
+    writer.write(path, upserts.size());
+    return summary;
+}
+
+MapDelta::Summary MapDelta::apply(const std::string& path, lar::Map& map) {
+    const MapArchive delta(path);
+    const DeltaInfo* info = delta.section<DeltaInfo>(SectionKind::DeltaInfo);
+    if (!info) {
+        throw std::runtime_error("Not a map delta: " + path);
+    }
+    if (!delta.corruptSections().empty()) {
+        throw std::runtime_error("Map delta fails its checksums: " + path);
+    }
+    const uint64_t base_landmarks = landmarksHash(map.landmarks.all());
+    if (map.landmarks.size() != info->base_landmark_count || mapHash(map, base_landmarks) != info->base_fingerprint) {
+        throw std::runtime_error("Map delta was made from a different map version: " + path);
+    }
+
+    Summary summary;
+
+    // Decode everything before touching the map, so a bad delta leaves it unchanged.
+    std::vector<lar::Landmark> upserts;
+    delta.appendLandmarks(upserts);
+    for (lar::Landmark& landmark : upserts) {
+        // Detach from the delta's mapping, which is released on return.
+        landmark.desc = landmark.desc.clone();
+    }
+    const std::vector<uint64_t> removed_landmarks = sectionValues<uint64_t>(delta, SectionKind::RemovedLandmarks);
+    const std::vector<LandmarkUpdate> updates = sectionValues<LandmarkUpdate>(delta, SectionKind::LandmarkUpdates);
+    const std::vector<AnchorRecord> anchors = sectionValues<AnchorRecord>(delta, SectionKind::Anchors);
+    const std::vector<uint64_t> removed_anchors = sectionValues<uint64_t>(delta, SectionKind::RemovedAnchors);
+    const std::vector<EdgeRecord> added_edges = sectionValues<EdgeRecord>(delta, SectionKind::Edges);
+    const std::vector<EdgeRecord> removed_edges = sectionValues<EdgeRecord>(delta, SectionKind::RemovedEdges);
+
+    // What the edits below replace, so a result that misses the target can be rolled back.
+    auto anchors_before = map.anchors;
+    auto edges_before = map.edges;
+    const auto origin_before = map.origin;
+    const bool origin_ready_before = map.origin_ready;
+    decltype(map.landmarks) landmarks_before;
+    bool landmarks_replaced = false;
+    uint64_t target_landmarks = base_landmarks;
+
+    if (!upserts.empty() || !removed_landmarks.empty() || !updates.empty()) {
+        const std::unordered_set<size_t> removed(removed_landmarks.begin(), removed_landmarks.end());
+        std::unordered_set<size_t> replaced;
+        for (const lar::Landmark& landmark : upserts) replaced.insert(landmark.id);
+        std::unordered_map<size_t, const LandmarkUpdate*> updated;
+        for (const LandmarkUpdate& update : updates) updated.emplace(update.id, &update);
+
+        std::vector<lar::Landmark> landmarks;
+        landmarks.reserve(info->target_landmark_count);
+        for (const lar::Landmark* landmark : map.landmarks.all()) {
+            if (removed.count(landmark->id)) continue;
+            if (replaced.count(landmark->id)) {
+                summary.replaced_landmarks++;
+                continue;
+            }
+            lar::Landmark& copy = landmarks.emplace_back(*landmark);
+            auto it = updated.find(copy.id);
+            if (it != updated.end()) applyUpdate(*it->second, copy);
+        }
+        summary.removed_landmarks = removed_landmarks.size();
+        summary.added_landmarks = upserts.size() - summary.replaced_landmarks;
+        summary.updated_landmarks = updates.size();
+        std::move(upserts.begin(), upserts.end(), std::back_inserter(landmarks));
+        target_landmarks = landmarksHash(landmarks);
+        landmarks_before = std::move(map.landmarks);
+        landmarks_replaced = true;
+        map.landmarks = decltype(map.landmarks)();
+        map.landmarks.insert(landmarks);
+    }
+
+    for (uint64_t id : removed_anchors) map.anchors.erase(id);
+    for (const AnchorRecord& record : anchors) {
+        Eigen::Transform<double,3,Eigen::Affine> transform;
+        transform.matrix() = Eigen::Map<const Eigen::Matrix4d>(record.transform);
+        map.anchors.erase(record.id);
+        map.anchors.emplace(record.id, lar::Anchor(record.id, transform));
+    }
+    summary.changed_anchors = anchors.size();
+    summary.removed_anchors = removed_anchors.size();
+
+    // lar::Map::addEdge and removeEdge notify the map's callbacks, so edges are edited on a
+    // scratch map first and the map itself only replays the edits once the result checks out.
+    lar::Map scratch;
+    scratch.setDidAddEdgeCallback([](std::size_t, std::size_t) {});
+    scratch.setDidRemoveEdgeCallback([](std::size_t, std::size_t) {});
+    scratch.anchors = map.anchors;
+    scratch.edges = map.edges;
+    std::vector<EdgeRecord> edge_removals, edge_additions;
+    for (const EdgeRecord& edge : removed_edges) {
+        if (!hasEdge(scratch, edge.from, edge.to)) continue;
+        scratch.removeEdge(edge.from, edge.to);
+        edge_removals.push_back(edge);
+    }
+    for (const EdgeRecord& edge : added_edges) {
+        if (hasEdge(scratch, edge.from, edge.to)) continue;
+        scratch.addEdge(edge.from, edge.to);
+        edge_additions.push_back(edge);
+    }
+    map.edges = std::move(scratch.edges);
+    summary.added_edges = added_edges.size();
+    summary.removed_edges = removed_edges.size();
+
+    if (delta.hasSection(SectionKind::Origin)) {
+        delta.reloadMapData(map, kOriginPart);
+        summary.origin_changed = true;
+    }
+
+    if (map.landmarks.size() != info->target_landmark_count || mapHash(map, target_landmarks) != info->target_fingerprint) {
+        if (landmarks_replaced) map.landmarks = std::move(landmarks_before);
+        map.anchors = std::move(anchors_before);
+        map.edges = std::move(edges_before);
+        map.origin = origin_before;
+        map.origin_ready = origin_ready_before;
+        throw std::runtime_error("Map delta doesn't reproduce the map it was made from: " + path);
+    }
+
+    map.edges = std::move(edges_before);
+    for (const EdgeRecord& edge : edge_removals) map.removeEdge(edge.from, edge.to);
+    for (const EdgeRecord& edge : edge_additions) map.addEdge(edge.from, edge.to);
+    return summary;
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,62 @@
+//
+//  map_delta.h
+//  LocalizeAR
+//
+//  Binary difference between two versions of a map, for updating clients without resending
+//  the whole map.
+//
+//  A delta is a map archive (same container, see map_archive.h) whose landmark sections hold
+//  only added landmarks and landmarks whose descriptor changed. Removals are listed by
+//  Landmark::id, and landmarks that only moved or had their stats change are sent as compact
+//  update records without a descriptor. Anchors, edges and origin are diffed the same way.
+//  Fingerprints of the base and target maps guard against applying a delta to the wrong
+//  version and against a delta that doesn't reproduce the map it was made from.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lar {
+    class Map;
+}
+
+namespace lar::bridge {
+
+class MapDelta {
+public:
+    struct Summary {
+        size_t added_landmarks = 0;
+        size_t replaced_landmarks = 0;  // descriptor changed
+        size_t updated_landmarks = 0;   // moved or stats changed, descriptor unchanged
+        size_t removed_landmarks = 0;
+        size_t changed_anchors = 0;
+        size_t removed_anchors = 0;
+        size_t added_edges = 0;
+        size_t removed_edges = 0;
+        bool origin_changed = false;
+
+        bool empty() const;
+    };
+
+    // Writes the delta that turns `from` into `to` to `path`.
+    static Summary write(const lar::Map& from, const lar::Map& to, const std::string& path);
+
+    // Applies the delta at `path` to `map`. Anchors, edges and origin are edited in place; the
+    // landmark database is rebuilt once if any landmark changed (invalidating landmark
+    // pointers). Added landmarks own copies of their descriptors, so the delta file isn't
+    // needed afterwards. Throws std::runtime_error if the file isn't a delta, `map` isn't the
+    // version it was made from, or the result doesn't match the delta's target fingerprint;
+    // in every case `map` is left unchanged. Edge callbacks of `map` hear about added and
+    // removed edges only after the result has been checked, so they never see a rejected delta.
+    static Summary apply(const std::string& path, lar::Map& map);
+
+    // Order-independent hash of everything a delta carries: every landmark's id, position,
+    // orientation, bounds, stats and descriptor bytes, anchor ids and transforms, edges and the
+    // origin. Used to identify map versions. Hashes descriptors, so it reads every one of them.
+    static uint64_t fingerprint(const lar::Map& map);
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,425 @@
+//
+//  map_journal.cpp
+//  LocalizeAR
+//
+
+#include "map_journal.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <lar/core/map.h>
+#include <lar/core/utils/json.h>
+
+#include "map_archive.h"
+
+namespace fs = std::filesystem;
+
+namespace lar::bridge {
+
+namespace {
+
+using json = nlohmann::json;
+
+constexpr const char* kJournalPrefix = "map.journal.";
+
+std::vector<double> transformValues(const MapJournal::Transform& transform) {
+    const double* data = transform.matrix().data();
+    return std::vector<double>(data, data + 16);
+}
+
+MapJournal::Transform transformFrom(const json& values) {
+    MapJournal::Transform transform;
+    for (int i = 0; i < 16; i++) {
+        transform.matrix().data()[i] = values.at(i).get<double>();
+    }
+    return transform;
+}
+
+// Journal generations present in `directory`, ascending.
+std::vector<uint64_t> journalGenerations(const fs::path& directory) {
+    std::vector<uint64_t> generations;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind(kJournalPrefix, 0) != 0) continue;
+        const std::string suffix = name.substr(std::strlen(kJournalPrefix));
+        if (suffix.empty() || !std::all_of(suffix.begin(), suffix.end(), [](unsigned char c) { return std::isdigit(c); })) continue;
+        generations.push_back(std::stoull(suffix));
+    }
+    std::sort(generations.begin(), generations.end());
+    return generations;
+}
+
+fs::path journalPath(const fs::path& directory, uint64_t generation) {
+    return directory / (kJournalPrefix + std::to_string(generation));
+}
+
+// Last generation contained in the snapshot, 0 if there is no manifest.
+uint64_t coveredGeneration(const fs::path& directory, std::string* snapshot = nullptr) {
+    std::ifstream in(directory / MapJournal::kManifestName);
+    if (!in) return 0;
+    try {
+        const json manifest = json::parse(in);
+        const uint32_t version = manifest.at("version").get<uint32_t>();
+        if (version == 0 || version > MapJournal::kVersion) {
+            throw std::runtime_error("Unsupported journal manifest version " + std::to_string(version));
+        }
+        if (snapshot) *snapshot = manifest.at("snapshot").get<std::string>();
+        return manifest.at("generation").get<uint64_t>();
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Malformed journal manifest in " + directory.string() + ": " + e.what());
+    }
+}
+
+bool hasEdge(const lar::Map& map, size_t from, size_t to) {
+    auto it = map.edges.find(from);
+    return it != map.edges.end() && std::find(it->second.begin(), it->second.end(), to) != it->second.end();
+}
+
+uint64_t fingerprint(const lar::Landmark& landmark) {
+    // FNV-1a over the fields the core mutates after a landmark is created.
+    uint64_t hash = 1469598103934665603ull;
+    const auto mix = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    mix(landmark.position.data(), 3 * sizeof(double));
+    mix(landmark.orientation.data(), 3 * sizeof(float));
+    mix(&landmark.bounds, sizeof(landmark.bounds));
+    mix(&landmark.last_seen, sizeof(landmark.last_seen));
+    mix(&landmark.sightings, sizeof(landmark.sightings));
+    mix(&landmark.is_matched, sizeof(landmark.is_matched));
+    // The descriptor bytes rather than its data pointer: the core may rewrite a descriptor in
+    // place, and a freed buffer may be reused for another landmark.
+    if (!landmark.desc.empty()) {
+        const int type = landmark.desc.type();
+        mix(&type, sizeof(type));
+        mix(&landmark.desc.rows, sizeof(landmark.desc.rows));
+        const size_t row_bytes = size_t(landmark.desc.cols) * landmark.desc.elemSize();
+        for (int row = 0; row < landmark.desc.rows; row++) mix(landmark.desc.ptr(row), row_bytes);
+    }
+    return hash;
+}
+
+class Replayer {
+public:
+    explicit Replayer(lar::Map& map) : map_(map) {}
+
+    void apply(const json& record) {
+        const std::string op = record.at("op").get<std::string>();
+        if (op == "anchor") {
+            const size_t id = record.at("id").get<size_t>();
+            map_.anchors.erase(id);
+            map_.anchors.emplace(id, lar::Anchor(id, transformFrom(record.at("transform"))));
+        } else if (op == "anchor_remove") {
+            map_.anchors.erase(record.at("id").get<size_t>());
+        } else if (op == "edge") {
+            const size_t from = record.at("from").get<size_t>(), to = record.at("to").get<size_t>();
+            if (!hasEdge(map_, from, to)) map_.addEdge(from, to);
+        } else if (op == "edge_remove") {
+            const size_t from = record.at("from").get<size_t>(), to = record.at("to").get<size_t>();
+            if (hasEdge(map_, from, to)) map_.removeEdge(from, to);
+        } else if (op == "origin") {
+            map_.origin = transformFrom(record.at("transform"));
+            map_.origin_ready = record.at("ready").get<bool>();
+        } else if (op == "landmark") {
+            lar::Landmark landmark;
+            lar::from_json(record.at("landmark"), landmark);
+            landmarks_[landmark.id] = std::move(landmark);
+        } else if (op == "landmark_remove") {
+            landmarks_[record.at("id").get<size_t>()] = std::nullopt;
+        } else {
+            throw std::runtime_error("Unknown journal record: " + op);
+        }
+    }
+
+    // Landmark records are applied in one rebuild of the landmark database.
+    void finish() {
+        if (landmarks_.empty()) return;
+        std::vector<lar::Landmark> landmarks;
+        landmarks.reserve(map_.landmarks.size() + landmarks_.size());
+        for (const lar::Landmark* landmark : map_.landmarks.all()) {
+            if (!landmarks_.count(landmark->id)) landmarks.push_back(*landmark);
+        }
+        for (auto& [id, landmark] : landmarks_) {
+            if (landmark) landmarks.push_back(std::move(*landmark));
+        }
+        map_.landmarks = decltype(map_.landmarks)();
+        map_.landmarks.insert(landmarks);
+        landmarks_.clear();
+    }
+
+private:
+    lar::Map& map_;
+    std::map<size_t, std::optional<lar::Landmark>> landmarks_;
+};
+
+void replayJournal(const fs::path& path, Replayer& replayer) {
+    std::ifstream in(path);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (line.empty()) continue;
+        json record;
+        try {
+            record = json::parse(line);
+        } catch (const json::parse_error&) {
+            // A torn final record is what a crash mid-append leaves behind; anything else is corruption.
+            std::string rest;
+            while (std::getline(in, rest)) {
+                if (!rest.empty()) {
+                    throw std::runtime_error("Corrupt journal record at " + path.string() + ":" + std::to_string(line_number));
+                }
+            }
+            break;
+        }
+        replayer.apply(record);
+    }
+}
+
+} // namespace
+
+std::shared_ptr<MapArchive> MapJournal::restore(const std::string& directory, lar::Map& map) {
+    const fs::path root(directory);
+    std::string snapshot_name;
+    const uint64_t covered = coveredGeneration(root, &snapshot_name);
+
+    std::shared_ptr<MapArchive> snapshot;
+    if (!snapshot_name.empty()) {
+        snapshot = std::make_shared<MapArchive>((root / snapshot_name).string());
+        std::vector<lar::Landmark> landmarks;
+        snapshot->appendLandmarks(landmarks);
+        map.landmarks = decltype(map.landmarks)();
+        map.landmarks.insert(landmarks);
+        map.anchors.clear();
+        map.edges.clear();
+        snapshot->loadMapData(map);
+    }
+
+    Replayer replayer(map);
+    try {
+        for (uint64_t generation : journalGenerations(root)) {
+            if (generation > covered) replayJournal(journalPath(root, generation), replayer);
+        }
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Malformed journal record in " + directory + ": " + e.what());
+    }
+    replayer.finish();
+    return snapshot;
+}
+
+MapJournal::MapJournal(const std::string& directory, const lar::Map& map) : directory_(directory) {
+    const fs::path root(directory);
+    fs::create_directories(root);
+    const uint64_t covered = coveredGeneration(root);
+    uint64_t latest = covered;
+    for (uint64_t generation : journalGenerations(root)) {
+        latest = std::max(latest, generation);
+        // Journals left by earlier sessions count as pending from now on.
+        std::error_code error;
+        const uint64_t size = fs::file_size(journalPath(root, generation), error);
+        if (generation > covered && !error) wrote(size);
+    }
+    // Every session starts a fresh journal so a torn record from a crash is always the last
+    // one of its file.
+    openGeneration(latest + 1);
+    seedFingerprints(map);
+}
+
+MapJournal::~MapJournal() {
+    waitForCompaction();
+}
+
+void MapJournal::openGeneration(uint64_t generation) {
+    if (out_.is_open()) out_.close();
+    const fs::path path = journalPath(directory_, generation);
+    out_.open(path, std::ios::app);
+    if (!out_) {
+        throw std::runtime_error("Failed to open map journal: " + path.string());
+    }
+    generation_ = generation;
+}
+
+void MapJournal::seedFingerprints(const lar::Map& map) {
+    fingerprints_.clear();
+    for (const lar::Landmark* landmark : map.landmarks.all()) {
+        fingerprints_[landmark->id] = fingerprint(*landmark);
+    }
+}
+
+void MapJournal::wrote(size_t bytes) {
+    if (bytes == 0) return;
+    if (pending_bytes_ == 0) oldest_pending_ = std::chrono::steady_clock::now();
+    pending_bytes_ += bytes;
+}
+
+void MapJournal::append(const std::string& line) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ << line << '\n';
+    wrote(line.size() + 1);
+}
+
+void MapJournal::recordAnchor(const lar::Anchor& anchor) {
+    append(json{ { "op", "anchor" }, { "id", anchor.id }, { "transform", transformValues(anchor.transform) } }.dump());
+}
+
+void MapJournal::recordAnchorRemoval(size_t id) {
+    append(json{ { "op", "anchor_remove" }, { "id", id } }.dump());
+}
+
+void MapJournal::recordEdge(size_t from, size_t to) {
+    append(json{ { "op", "edge" }, { "from", from }, { "to", to } }.dump());
+}
+
+void MapJournal::recordEdgeRemoval(size_t from, size_t to) {
+    append(json{ { "op", "edge_remove" }, { "from", from }, { "to", to } }.dump());
+}
+
+void MapJournal::recordOrigin(const Transform& origin, bool ready) {
+    append(json{ { "op", "origin" }, { "transform", transformValues(origin) }, { "ready", ready } }.dump());
+}
+
+size_t MapJournal::recordLandmarks(const lar::Map& map) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<size_t, uint64_t> current;
+    size_t written = 0;
+    for (const lar::Landmark* landmark : map.landmarks.all()) {
+        const uint64_t hash = fingerprint(*landmark);
+        current[landmark->id] = hash;
+        auto previous = fingerprints_.find(landmark->id);
+        if (previous != fingerprints_.end() && previous->second == hash) continue;
+
+        json serialized;
+        lar::to_json(serialized, *landmark);
+        const std::string line = json{ { "op", "landmark" }, { "landmark", std::move(serialized) } }.dump();
+        out_ << line << '\n';
+        wrote(line.size() + 1);
+        written++;
+    }
+    for (const auto& [id, hash] : fingerprints_) {
+        if (current.count(id)) continue;
+        const std::string line = json{ { "op", "landmark_remove" }, { "id", id } }.dump();
+        out_ << line << '\n';
+        wrote(line.size() + 1);
+        written++;
+    }
+    fingerprints_ = std::move(current);
+    return written;
+}
+
+void MapJournal::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_.flush();
+    if (!out_) {
+        throw std::runtime_error("Failed to write map journal in " + directory_);
+    }
+}
+
+uint64_t MapJournal::pendingBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_bytes_;
+}
+
+MapJournal::CompactionPolicy MapJournal::compactionPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+void MapJournal::setCompactionPolicy(const CompactionPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+}
+
+bool MapJournal::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (compacting_ || pending_bytes_ == 0) return false;
+    const std::chrono::duration<double> age = std::chrono::steady_clock::now() - oldest_pending_;
+    return pending_bytes_ >= policy_.max_bytes || age.count() >= policy_.max_age_seconds;
+}
+
+bool MapJournal::compact(const lar::Map& map) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (compacting_) return false;
+    if (compaction_.joinable()) compaction_.join();
+
+    // Copy on the calling thread; descriptors are shared (cv::Mat is reference counted).
+    auto snapshot = std::make_shared<lar::Map>();
+    std::vector<lar::Landmark> landmarks;
+    landmarks.reserve(map.landmarks.size());
+    for (const lar::Landmark* landmark : map.landmarks.all()) {
+        landmarks.push_back(*landmark);
+    }
+    snapshot->landmarks.insert(landmarks);
+    for (const auto& [id, anchor] : map.anchors) {
+        snapshot->anchors.emplace(id, anchor);
+    }
+    snapshot->edges = map.edges;
+    snapshot->origin = map.origin;
+    snapshot->origin_ready = map.origin_ready;
+    // Landmarks changed since the last recordLandmarks are saved by the snapshot itself.
+    seedFingerprints(map);
+
+    // Everything recorded so far is in the snapshot; new records go to the next generation.
+    out_.flush();
+    const uint64_t covered = generation_;
+    openGeneration(covered + 1);
+    pending_bytes_ = 0;
+    compacting_ = true;
+    last_error_.clear();
+
+    compaction_ = std::thread([this, snapshot, covered] {
+        std::string error;
+        try {
+            const fs::path root(directory_);
+            MapArchive::write(*snapshot, (root / kSnapshotName).string());
+
+            // The manifest switch is what makes the snapshot authoritative.
+            const fs::path manifest_path = root / kManifestName;
+            const fs::path temporary = manifest_path.string() + ".tmp";
+            {
+                std::ofstream manifest(temporary);
+                manifest << json{ { "version", kVersion }, { "snapshot", kSnapshotName }, { "generation", covered } }.dump(2);
+                if (!manifest) throw std::runtime_error("Failed to write journal manifest: " + temporary.string());
+            }
+            fs::rename(temporary, manifest_path);
+
+            for (uint64_t generation : journalGenerations(root)) {
+                if (generation <= covered) fs::remove(journalPath(root, generation));
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = error;
+        compacting_ = false;
+    });
+    return true;
+}
+
+bool MapJournal::isCompacting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return compacting_;
+}
+
+void MapJournal::waitForCompaction() {
+    if (compaction_.joinable()) compaction_.join();
+}
+
+std::string MapJournal::lastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
+
+} // namespace lar::bridge
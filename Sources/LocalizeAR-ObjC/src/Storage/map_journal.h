@@ -0,0 +1,119 @@
+//
+//  map_journal.h
+//  LocalizeAR
+//
+//  Append-only journal of map mutations, for saves that don't rewrite the whole map.
+//
+//  A journal directory holds numbered JSON-lines journals (map.journal.<generation>), one
+//  record per anchor, edge, origin or landmark change, and optionally a compacted snapshot
+//  (journal.larmap, named apart from the map.larmap the map processor writes) plus a manifest
+//  (journal.json) naming the last generation the snapshot contains. Compaction rotates to a new
+//  generation, writes the snapshot in the background and then deletes the journals it covers.
+//  Every record is idempotent, so replaying a journal that the snapshot already contains (after
+//  a crash mid-compaction) is harmless. Saves only append; callers compact when
+//  `needsCompaction` says the uncompacted journals got too large or too old.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <Eigen/Geometry>
+
+namespace lar {
+    class Map;
+    class Anchor;
+}
+
+namespace lar::bridge {
+
+class MapArchive;
+
+class MapJournal {
+public:
+    using Transform = Eigen::Transform<double,3,Eigen::Affine>;
+
+    static constexpr const char* kManifestName = "journal.json";
+    static constexpr const char* kSnapshotName = "journal.larmap";
+    static constexpr uint32_t kVersion = 1;
+
+    // When the journals written since the last snapshot are worth compacting.
+    struct CompactionPolicy {
+        uint64_t max_bytes = 32ull << 20;
+        double max_age_seconds = 10 * 60;
+    };
+
+    // Brings `map` up to date with the journal directory: loads the compacted snapshot if there
+    // is one (replacing the map's contents) and replays every newer journal. Returns the
+    // snapshot archive, which landmark descriptors alias, or nullptr if there is none.
+    // Throws std::runtime_error if the manifest or snapshot is unreadable.
+    static std::shared_ptr<MapArchive> restore(const std::string& directory, lar::Map& map);
+
+    // Starts journaling into `directory`, treating the current contents of `map` as saved.
+    explicit MapJournal(const std::string& directory, const lar::Map& map);
+    // Waits for a running compaction.
+    ~MapJournal();
+
+    MapJournal(const MapJournal&) = delete;
+    MapJournal& operator=(const MapJournal&) = delete;
+
+    void recordAnchor(const lar::Anchor& anchor);
+    void recordAnchorRemoval(size_t id);
+    void recordEdge(size_t from, size_t to);
+    void recordEdgeRemoval(size_t from, size_t to);
+    void recordOrigin(const Transform& origin, bool ready);
+
+    // Landmarks change inside the core (mapping, processing) without notifications, so they are
+    // diffed against a per-landmark fingerprint of the last save instead. Appends a record for
+    // every added, changed or removed landmark and returns how many were written.
+    size_t recordLandmarks(const lar::Map& map);
+
+    // Flushes buffered records to disk. Throws std::runtime_error on write failure.
+    void flush();
+
+    // Bytes of journal records not yet in the snapshot.
+    uint64_t pendingBytes() const;
+    CompactionPolicy compactionPolicy() const;
+    void setCompactionPolicy(const CompactionPolicy& policy);
+    // True once the pending records exceed the policy's size, or the oldest of them its age.
+    bool needsCompaction() const;
+
+    // Rotates to a new journal and writes a snapshot of `map` in the background. The map is
+    // copied on the calling thread first, so it can keep changing. Returns false if a previous
+    // compaction is still running.
+    bool compact(const lar::Map& map);
+    bool isCompacting() const;
+    void waitForCompaction();
+    // Error message of the last failed background compaction, empty if it succeeded.
+    std::string lastError() const;
+
+private:
+    void append(const std::string& line);
+    void openGeneration(uint64_t generation);
+    void seedFingerprints(const lar::Map& map);
+    void wrote(size_t bytes);
+
+    std::string directory_;
+    mutable std::mutex mutex_;
+    std::ofstream out_;
+    uint64_t generation_ = 0;
+    std::unordered_map<size_t, uint64_t> fingerprints_;
+
+    CompactionPolicy policy_;
+    uint64_t pending_bytes_ = 0;
+    std::chrono::steady_clock::time_point oldest_pending_;
+
+    std::thread compaction_;
+    bool compacting_ = false;
+    std::string last_error_;
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,211 @@
+//
+//  map_json_reader.cpp
+//  LocalizeAR
+//
+
+#include "map_json_reader.h"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <lar/core/map.h>
+#include <lar/core/utils/json.h>
+
+namespace lar::bridge {
+
+namespace {
+
+using json = nlohmann::json;
+
+// Assembles a json value from SAX events. Mirrors nlohmann's internal DOM parser, which isn't
+// part of its public API.
+class DomBuilder {
+public:
+    bool empty() const { return stack_.empty(); }
+    json& root() { return root_; }
+
+    void reset() {
+        root_ = json();
+        stack_.clear();
+    }
+
+    void key(std::string& key) { key_ = std::move(key); }
+
+    void value(json&& value) { insert(std::move(value)); }
+
+    void startContainer(json&& container) { stack_.push_back(insert(std::move(container))); }
+
+    // Returns true when the closed container was the root, i.e. the value is complete.
+    bool endContainer() {
+        stack_.pop_back();
+        return stack_.empty();
+    }
+
+private:
+    json* insert(json&& value) {
+        if (stack_.empty()) {
+            root_ = std::move(value);
+            return &root_;
+        }
+        json& parent = *stack_.back();
+        if (parent.is_array()) {
+            parent.push_back(std::move(value));
+            return &parent.back();
+        }
+        json& slot = parent[key_];
+        slot = std::move(value);
+        return &slot;
+    }
+
+    json root_;
+    std::vector<json*> stack_;
+    std::string key_;
+};
+
+class MapSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit MapSaxHandler(const MapJsonReader::LandmarkHandler& on_landmark) : on_landmark_(on_landmark) {}
+
+    json takeDocument() { return std::move(document_.root()); }
+    const std::string& error() const { return error_; }
+
+    bool null() override { return value(json(nullptr)); }
+    bool boolean(bool val) override { return value(json(val)); }
+    bool number_integer(number_integer_t val) override { return value(json(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return value(json(val)); }
+    bool number_float(number_float_t val, const string_t&) override { return value(json(val)); }
+    bool string(string_t& val) override { return value(json(std::move(val))); }
+    bool binary(binary_t& val) override { return value(json::binary(std::move(val))); }
+
+    bool key(string_t& val) override {
+        if (state_ == State::Document) {
+            // A "landmarks" array directly under the root is streamed instead of stored.
+            pending_landmarks_ = depth_ == 1 && val == "landmarks";
+            document_.key(val);
+        } else {
+            landmark_.key(val);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        return startContainer(json::object());
+    }
+
+    bool start_array(std::size_t) override {
+        if (state_ == State::Document && pending_landmarks_) {
+            pending_landmarks_ = false;
+            state_ = State::Landmarks;
+            document_.startContainer(json::array());
+            depth_++;
+            return true;
+        }
+        return startContainer(json::array());
+    }
+
+    bool end_object() override { return endContainer(); }
+
+    bool end_array() override {
+        if (state_ == State::Landmarks && landmark_.empty()) {
+            state_ = State::Document;
+            document_.endContainer();
+            depth_--;
+            return true;
+        }
+        return endContainer();
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+
+private:
+    enum class State { Document, Landmarks };
+
+    bool value(json&& val) {
+        if (state_ == State::Document) {
+            pending_landmarks_ = false;
+            document_.value(std::move(val));
+        } else if (landmark_.empty()) {
+            // Scalar element in the landmark array: not a landmark, hand it over as-is.
+            json element = std::move(val);
+            on_landmark_(element);
+        } else {
+            landmark_.value(std::move(val));
+        }
+        return true;
+    }
+
+    bool startContainer(json&& container) {
+        if (state_ == State::Document) {
+            pending_landmarks_ = false;
+            document_.startContainer(std::move(container));
+            depth_++;
+        } else {
+            landmark_.startContainer(std::move(container));
+        }
+        return true;
+    }
+
+    bool endContainer() {
+        if (state_ == State::Document) {
+            document_.endContainer();
+            depth_--;
+        } else if (landmark_.endContainer()) {
+            on_landmark_(landmark_.root());
+            landmark_.reset();
+        }
+        return true;
+    }
+
+    const MapJsonReader::LandmarkHandler& on_landmark_;
+    DomBuilder document_;
+    DomBuilder landmark_;
+    State state_ = State::Document;
+    bool pending_landmarks_ = false;
+    int depth_ = 0;
+    std::string error_;
+};
+
+} // namespace
+
+json MapJsonReader::read(std::istream& in, const LandmarkHandler& on_landmark) {
+    MapSaxHandler handler(on_landmark);
+    if (!json::sax_parse(in, &handler)) {
+        throw std::runtime_error("Failed to parse map JSON: " + handler.error());
+    }
+    return handler.takeDocument();
+}
+
+void MapJsonReader::load(const std::string& path, lar::Map& map) {
+    std::ifstream in;
+    std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+    in.rdbuf()->pubsetbuf(buffer.get(), kBufferSize);
+    in.open(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    // The rest of the document is only complete at the end, so landmarks are collected in a
+    // database of their own and moved into the map after the other members.
+    decltype(map.landmarks) database;
+    std::vector<lar::Landmark> batch;
+    batch.reserve(kInsertBatch);
+    json document = read(in, [&](json& element) {
+        element.get_to(batch.emplace_back());
+        if (batch.size() == kInsertBatch) {
+            database.insert(batch);
+            batch.clear();
+        }
+    });
+    if (!batch.empty()) database.insert(batch);
+    std::vector<lar::Landmark>().swap(batch);
+
+    lar::from_json(document, map);
+    map.landmarks = std::move(database);
+}
+
+} // namespace lar::bridge
@@ -0,0 +1,49 @@
+//
+//  map_json_reader.h
+//  LocalizeAR
+//
+//  Streaming (SAX) reader for map.json.
+//
+//  nlohmann::json::parse builds a DOM of the entire document before lar::from_json copies it
+//  into the map, so peak memory during load is the DOM plus the map. This reader walks the
+//  token stream once instead: each element of "landmarks" is materialized on its own and
+//  converted right away, so at most one landmark's DOM exists at a time. Converted landmarks
+//  go into the landmark database in batches of kInsertBatch, so they never wait in a second
+//  full-size copy either. The remaining top-level members (anchors, edges, origin, ...) are
+//  small and are collected as usual.
+//
+
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace lar {
+    class Map;
+}
+
+namespace lar::bridge {
+
+class MapJsonReader {
+public:
+    using LandmarkHandler = std::function<void(nlohmann::json& landmark)>;
+
+    // Reads a map document from `in`, passing each element of the top-level "landmarks" array
+    // to `on_landmark` as soon as it has been parsed. Returns the document without its
+    // landmarks (the "landmarks" member is left as an empty array). Throws
+    // std::runtime_error on malformed input.
+    static nlohmann::json read(std::istream& in, const LandmarkHandler& on_landmark);
+
+    // Size of the read buffer used by `load`; this bounds the I/O side of peak memory.
+    static constexpr size_t kBufferSize = 1 << 20;
+    // Converted landmarks held back before they are inserted into the database.
+    static constexpr size_t kInsertBatch = 1024;
+
+    // Streams the map.json at `path` into `map`.
+    static void load(const std::string& path, lar::Map& map);
+};
+
+} // namespace lar::bridge
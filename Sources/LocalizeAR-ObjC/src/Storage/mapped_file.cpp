@@ -0,0 +1,91 @@
+//
+//  mapped_file.cpp
+//  LocalizeAR
+//
+
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace lar::bridge {
+
+MappedFile::MappedFile(const std::string& path) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    if (size_ > 0) {
+        // MAP_SHARED so that concurrent readers share the page-cached copy.
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to mmap " + path);
+        }
+        data_ = static_cast<const uint8_t*>(addr);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+void MappedFile::adviseRandom(size_t offset, size_t length) const {
+    advise(offset, length, MADV_RANDOM);
+}
+
+void MappedFile::adviseSequential(size_t offset, size_t length) const {
+    advise(offset, length, MADV_SEQUENTIAL);
+}
+
+void MappedFile::adviseWillNeed(size_t offset, size_t length) const {
+    advise(offset, length, MADV_WILLNEED);
+}
+
+size_t MappedFile::residentBytes(size_t offset, size_t length) const {
+    if (!data_ || length == 0 || offset >= size_) return 0;
+    const size_t page = static_cast<size_t>(::getpagesize());
+    const size_t start = offset - offset % page;
+    const size_t end = std::min(size_, offset + length);
+    const size_t pages = (end - start + page - 1) / page;
+
+    // mincore's vector is `char` on Darwin and `unsigned char` on Linux.
+    std::vector<std::conditional_t<std::is_invocable_v<decltype(::mincore), void*, size_t, char*>, char, unsigned char>> residency(pages);
+    if (::mincore(const_cast<uint8_t*>(data_) + start, end - start, residency.data()) != 0) return 0;
+
+    size_t resident = 0;
+    for (size_t i = 0; i < pages; i++) {
+        if (residency[i] & 1) resident += page;
+    }
+    return resident;
+}
+
+void MappedFile::advise(size_t offset, size_t length, int advice) const {
+    if (!data_ || length == 0 || offset >= size_) return;
+    // madvise requires a page-aligned start address.
+    const size_t page = static_cast<size_t>(::getpagesize());
+    const size_t start = offset - offset % page;
+    const size_t end = std::min(size_, offset + length);
+    ::madvise(const_cast<uint8_t*>(data_) + start, end - start, advice);
+}
+
+} // namespace lar::bridge
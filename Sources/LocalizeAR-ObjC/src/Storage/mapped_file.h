@@ -0,0 +1,46 @@
+//
+//  mapped_file.h
+//  LocalizeAR
+//
+//  Read-only memory mapping of a file. Pages are shared through the OS page cache, so
+//  every process (and every LARMap) mapping the same file shares one physical copy.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lar::bridge {
+
+class MappedFile {
+public:
+    // Maps the whole file read-only. Throws std::runtime_error if it can't be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+    // Access pattern hints for a byte range of the mapping (no-ops if unsupported).
+    void adviseRandom(size_t offset, size_t length) const;
+    void adviseSequential(size_t offset, size_t length) const;
+    void adviseWillNeed(size_t offset, size_t length) const;
+
+    // Bytes of the range backed by pages currently in memory (page granularity).
+    size_t residentBytes(size_t offset, size_t length) const;
+
+private:
+    void advise(size_t offset, size_t length, int advice) const;
+
+    std::string path_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace lar::bridge
@@ -0,0 +1,158 @@
+//
+//  parallel_map_loader.cpp
+//  LocalizeAR
+//
+
+#include "parallel_map_loader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <lar/core/map.h>
+#include <lar/core/utils/json.h>
+
+#include "map_archive.h"
+#include "map_json_reader.h"
+#include "../Concurrency/thread_pool.h"
+
+using json = nlohmann::json;
+
+namespace lar::bridge {
+
+namespace {
+
+// Inserts a chunk into the database and releases its storage.
+template <typename Database>
+void insertChunk(Database& database, std::vector<lar::Landmark>& chunk) {
+    database.insert(chunk);
+    std::vector<lar::Landmark>().swap(chunk);
+}
+
+} // namespace
+
+ParallelMapLoader::ParallelMapLoader(size_t threads)
+    : threads_(threads == 0 ? ThreadPool::hardwareThreads() : threads) {}
+
+std::shared_ptr<MapArchive> ParallelMapLoader::load(const std::string& path, lar::Map& map) const {
+    if (MapArchive::isArchive(path)) {
+        return loadArchive(path, map);
+    }
+    loadJson(path, map);
+    return nullptr;
+}
+
+std::shared_ptr<MapArchive> ParallelMapLoader::loadArchive(const std::string& path, lar::Map& map) const {
+    auto archive = std::make_shared<MapArchive>(path);
+    if (archive->isDelta()) {
+        throw std::runtime_error("Map delta can't be loaded as a map: " + path);
+    }
+    const size_t n = archive->landmarkCount();
+    const size_t chunk_count = (n + kArchiveChunk - 1) / kArchiveChunk;
+    std::vector<std::vector<lar::Landmark>> chunks(chunk_count);
+
+    ThreadPool pool(threads_);
+    // The last task decodes anchors, edges and origin; it is the only one that touches `map`.
+    pool.parallelFor(chunk_count + 1, [&](size_t task) {
+        if (task == chunk_count) {
+            archive->loadMapData(map);
+            return;
+        }
+        const size_t first = task * kArchiveChunk;
+        const size_t last = std::min(n, first + kArchiveChunk);
+        archive->touchDescriptors(first, last);
+        archive->appendLandmarks(chunks[task], first, last);
+    });
+
+    for (auto& chunk : chunks) insertChunk(map.landmarks, chunk);
+    return archive;
+}
+
+void ParallelMapLoader::loadJson(const std::string& path, lar::Map& map) const {
+    std::ifstream in;
+    std::unique_ptr<char[]> buffer(new char[MapJsonReader::kBufferSize]);
+    in.rdbuf()->pubsetbuf(buffer.get(), MapJsonReader::kBufferSize);
+    in.open(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    ThreadPool pool(threads_);
+    std::mutex chunks_mutex;
+    std::vector<std::vector<lar::Landmark>> chunks;
+    std::vector<char> converted_chunks;
+    std::vector<json> batch;
+
+    // Chunks convert out of order; the parsing thread inserts the finished prefix in file order
+    // as it goes, so converted landmarks don't pile up until the end of the file. The other
+    // members are only complete at the end, so landmarks go into a database of their own.
+    decltype(map.landmarks) database;
+    size_t next_insert = 0;
+    auto insertConverted = [&] {
+        for (;;) {
+            std::vector<lar::Landmark> chunk;
+            {
+                std::lock_guard<std::mutex> lock(chunks_mutex);
+                if (next_insert == chunks.size() || !converted_chunks[next_insert]) return;
+                chunk = std::move(chunks[next_insert++]);
+            }
+            insertChunk(database, chunk);
+        }
+    };
+
+    // Converts on the pool, unless the pool is saturated: then the parsing thread converts the
+    // batch itself, which bounds how many parsed elements wait in memory.
+    auto dispatch = [&] {
+        if (batch.empty()) return;
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            index = chunks.size();
+            chunks.emplace_back();
+            converted_chunks.push_back(0);
+        }
+        auto convert = [&chunks, &converted_chunks, &chunks_mutex, index](std::vector<json>& elements) {
+            std::vector<lar::Landmark> converted(elements.size());
+            for (size_t i = 0; i < elements.size(); i++) {
+                elements[i].get_to(converted[i]);
+                elements[i] = nullptr;
+            }
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            chunks[index] = std::move(converted);
+            converted_chunks[index] = 1;
+        };
+        if (pool.size() == 1 || pool.pending() >= 2 * pool.size()) {
+            convert(batch);
+        } else {
+            pool.submit([convert, elements = std::make_shared<std::vector<json>>(std::move(batch))]() mutable {
+                convert(*elements);
+            });
+        }
+        batch.clear();
+        batch.reserve(kJsonBatch);
+        insertConverted();
+    };
+
+    json document;
+    try {
+        document = MapJsonReader::read(in, [&](json& element) {
+            batch.push_back(std::move(element));
+            if (batch.size() == kJsonBatch) dispatch();
+        });
+        dispatch();
+    } catch (...) {
+        // Let running tasks finish before the state they reference goes away.
+        try { pool.wait(); } catch (...) {}
+        throw;
+    }
+    pool.wait();
+    insertConverted();
+
+    lar::from_json(document, map);
+    map.landmarks = std::move(database);
+}
+
+} // namespace lar::bridge
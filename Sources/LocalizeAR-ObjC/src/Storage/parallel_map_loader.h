@@ -0,0 +1,54 @@
+//
+//  parallel_map_loader.h
+//  LocalizeAR
+//
+//  Map loading split into chunks that decode on a thread pool.
+//
+//  Archives are cut into fixed row ranges: each task decodes its landmarks into its own vector
+//  and faults in its descriptor pages, while another task decodes anchors, edges and origin.
+//  map.json is still tokenized by one SAX pass, but the parsed landmark elements are handed to
+//  the pool in batches, so conversion (including descriptor decoding) overlaps with parsing.
+//  JSON chunks are inserted into the landmark database in file order as soon as every earlier
+//  chunk is in; archive chunks are inserted one after another once decoded, each released as it
+//  goes. Either way the result is identical to a single-threaded load and decoded landmarks
+//  never wait in a second full-size copy.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace lar {
+    class Map;
+}
+
+namespace lar::bridge {
+
+class MapArchive;
+
+class ParallelMapLoader {
+public:
+    // Landmarks per archive task and per batch of parsed JSON elements.
+    static constexpr size_t kArchiveChunk = 4096;
+    static constexpr size_t kJsonBatch = 512;
+
+    // `threads` includes the calling thread; 0 uses one per hardware thread.
+    explicit ParallelMapLoader(size_t threads = 0);
+
+    size_t threads() const { return threads_; }
+
+    // Loads the archive or map.json at `path` into `map`, detected from the file contents.
+    // Returns the archive, which landmark descriptors alias, or nullptr for JSON. Throws
+    // std::runtime_error on unreadable or malformed input.
+    std::shared_ptr<MapArchive> load(const std::string& path, lar::Map& map) const;
+
+    std::shared_ptr<MapArchive> loadArchive(const std::string& path, lar::Map& map) const;
+    void loadJson(const std::string& path, lar::Map& map) const;
+
+private:
+    size_t threads_;
+};
+
+} // namespace lar::bridge
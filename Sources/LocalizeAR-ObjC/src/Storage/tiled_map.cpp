@@ -0,0 +1,260 @@
+//
+//  tiled_map.cpp
+//  LocalizeAR
+//
+
+#include "tiled_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+#include <lar/core/map.h>
+
+namespace fs = std::filesystem;
+
+namespace lar::bridge {
+
+namespace {
+
+constexpr const char* kBaseName = "base.larmap";
+constexpr const char* kTileDirectory = "tiles";
+
+// Casting a value outside the int32_t range (or NaN) is undefined, so those are rejected.
+int32_t tileIndex(double coordinate, double tile_size) {
+    const double index = std::floor(coordinate / tile_size);
+    if (!(index >= std::numeric_limits<int32_t>::min() && index <= std::numeric_limits<int32_t>::max())) {
+        throw std::runtime_error("Landmark position " + std::to_string(coordinate) + " is outside the tile grid");
+    }
+    return static_cast<int32_t>(index);
+}
+
+std::string tileFileName(int32_t x, int32_t z) {
+    return std::string(kTileDirectory) + "/tile_" + std::to_string(x) + "_" + std::to_string(z) + ".larmap";
+}
+
+} // namespace
+
+void TiledMap::write(const lar::Map& map, const std::string& directory, double tile_size) {
+    if (!(tile_size > 0)) {
+        throw std::runtime_error("Tile size must be positive");
+    }
+    const fs::path root(directory);
+    fs::create_directories(root / kTileDirectory);
+
+    // Ordered so the manifest lists tiles row by row.
+    std::map<std::pair<int32_t, int32_t>, std::vector<lar::Landmark*>> groups;
+    for (lar::Landmark* landmark : map.landmarks.all()) {
+        groups[{ tileIndex(landmark->position.x(), tile_size), tileIndex(landmark->position.z(), tile_size) }].push_back(landmark);
+    }
+
+    nlohmann::json tiles = nlohmann::json::array();
+    for (const auto& [key, landmarks] : groups) {
+        double lower_x = std::numeric_limits<double>::infinity(), lower_z = lower_x;
+        double upper_x = -lower_x, upper_z = -lower_x;
+        for (const lar::Landmark* landmark : landmarks) {
+            lower_x = std::min(lower_x, landmark->bounds.lower.x);
+            lower_z = std::min(lower_z, landmark->bounds.lower.y);
+            upper_x = std::max(upper_x, landmark->bounds.upper.x);
+            upper_z = std::max(upper_z, landmark->bounds.upper.y);
+        }
+
+        const std::string file = tileFileName(key.first, key.second);
+        MapArchive::writeLandmarks(landmarks, (root / file).string());
+        tiles.push_back({
+            { "x", key.first },
+            { "z", key.second },
+            { "file", file },
+            { "landmarks", landmarks.size() },
+            { "bytes", fs::file_size(root / file) },
+            { "bounds", { lower_x, lower_z, upper_x, upper_z } },
+        });
+    }
+
+    MapArchive::writeMapData(map, (root / kBaseName).string());
+
+    // The manifest goes last: a directory without one is never picked up as a tiled map.
+    nlohmann::json manifest = {
+        { "version", kManifestVersion },
+        { "tile_size", tile_size },
+        { "tiles", tiles },
+    };
+    const fs::path manifest_path = root / kManifestName;
+    const fs::path temporary = manifest_path.string() + ".tmp";
+    {
+        std::ofstream out(temporary);
+        out << manifest.dump(2);
+        if (!out) throw std::runtime_error("Failed to write tile manifest: " + temporary.string());
+    }
+    fs::rename(temporary, manifest_path);
+}
+
+bool TiledMap::isTiledMap(const std::string& directory) {
+    std::error_code error;
+    return fs::is_regular_file(fs::path(directory) / kManifestName, error);
+}
+
+TiledMap::TiledMap(const std::string& directory, uint64_t memory_budget)
+    : directory_(directory), memory_budget_(memory_budget) {
+    const fs::path root(directory);
+    std::ifstream in(root / kManifestName);
+    if (!in) {
+        throw std::runtime_error("Missing tile manifest in " + directory);
+    }
+
+    try {
+        nlohmann::json manifest = nlohmann::json::parse(in);
+        const uint32_t version = manifest.at("version").get<uint32_t>();
+        if (version == 0 || version > kManifestVersion) {
+            throw std::runtime_error("Unsupported tile manifest version " + std::to_string(version));
+        }
+        tile_size_ = manifest.at("tile_size").get<double>();
+        for (const nlohmann::json& entry : manifest.at("tiles")) {
+            Tile tile;
+            tile.x = entry.at("x").get<int32_t>();
+            tile.z = entry.at("z").get<int32_t>();
+            tile.file = entry.at("file").get<std::string>();
+            tile.landmarks = entry.at("landmarks").get<size_t>();
+            tile.bytes = entry.at("bytes").get<uint64_t>();
+            const nlohmann::json& bounds = entry.at("bounds");
+            tile.lower_x = bounds.at(0).get<double>();
+            tile.lower_z = bounds.at(1).get<double>();
+            tile.upper_x = bounds.at(2).get<double>();
+            tile.upper_z = bounds.at(3).get<double>();
+            tiles_.push_back(std::move(tile));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error("Malformed tile manifest in " + directory + ": " + e.what());
+    }
+
+    base_ = std::make_unique<MapArchive>((root / kBaseName).string());
+}
+
+void TiledMap::loadBase(lar::Map& map) const {
+    base_->loadMapData(map);
+}
+
+// Descriptors alias the mapping, so decoding adds the landmark objects and their index entries,
+// in the core map and again in the query snapshot.
+uint64_t TiledMap::Tile::decodedBytes() const {
+    return 2 * landmarks * (sizeof(lar::Landmark) + kIndexBytesPerLandmark);
+}
+
+bool TiledMap::page(double x, double z, double diameter) {
+    return pageTiles(x, z, diameter, false);
+}
+
+bool TiledMap::pagePositions(double x, double z, double diameter) {
+    return pageTiles(x, z, diameter, true);
+}
+
+bool TiledMap::pageTiles(double x, double z, double diameter, bool by_position) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const double radius = diameter / 2;
+    const double lower_x = x - radius, upper_x = x + radius;
+    const double lower_z = z - radius, upper_z = z + radius;
+
+    const uint64_t now = ++clock_;
+    bool changed = false;
+    for (Tile& tile : tiles_) {
+        const bool outside = by_position
+            ? (tile.x + 1) * tile_size_ < lower_x || tile.x * tile_size_ > upper_x ||
+              (tile.z + 1) * tile_size_ < lower_z || tile.z * tile_size_ > upper_z
+            : tile.upper_x < lower_x || tile.lower_x > upper_x || tile.upper_z < lower_z || tile.lower_z > upper_z;
+        if (outside) continue;
+        tile.last_used = now;
+        if (!tile.archive) {
+            tile.archive = std::make_shared<MapArchive>((fs::path(directory_) / tile.file).string());
+            stats_.resident_bytes += tile.bytes + tile.decodedBytes();
+            stats_.decoded_bytes += tile.decodedBytes();
+            stats_.resident_tiles++;
+            stats_.page_ins++;
+            changed = true;
+        }
+    }
+
+    // Evict least recently used first; anything touched by this query has last_used == now.
+    std::vector<Tile*> evictable;
+    for (Tile& tile : tiles_) {
+        if (tile.archive && tile.last_used != now) evictable.push_back(&tile);
+    }
+    std::sort(evictable.begin(), evictable.end(), [](const Tile* a, const Tile* b) { return a->last_used < b->last_used; });
+
+    // A map built from an evicted tile keeps its archive alive through map_archives_.
+    for (Tile* tile : evictable) {
+        if (stats_.resident_bytes <= memory_budget_) break;
+        tile->archive = nullptr;
+        stats_.resident_bytes -= tile->bytes + tile->decodedBytes();
+        stats_.decoded_bytes -= tile->decodedBytes();
+        stats_.resident_tiles--;
+        stats_.evictions++;
+        changed = true;
+    }
+    return changed;
+}
+
+bool TiledMap::prepare(double x, double z, double diameter, lar::Map& map) {
+    page(x, z, diameter);
+    std::vector<std::shared_ptr<MapArchive>> archives = residentArchives();
+    std::vector<std::shared_ptr<MapArchive>> built;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (archives == map_archives_) return false;
+        built = map_archives_;
+    }
+
+    // Tiles only paged in are decoded and inserted on their own. The core's database has no
+    // way to erase landmarks, so once a tile is paged out it is rebuilt from the resident ones.
+    const auto resident = [&archives](const std::shared_ptr<MapArchive>& archive) {
+        return std::find(archives.begin(), archives.end(), archive) != archives.end();
+    };
+    const bool evicted = !std::all_of(built.begin(), built.end(), resident);
+    std::vector<std::shared_ptr<MapArchive>> decode;
+    for (const auto& archive : archives) {
+        if (evicted || std::find(built.begin(), built.end(), archive) == built.end()) decode.push_back(archive);
+    }
+
+    size_t count = 0;
+    for (const auto& archive : decode) count += archive->landmarkCount();
+    std::vector<lar::Landmark> landmarks;
+    landmarks.reserve(count);
+    for (const auto& archive : decode) archive->appendLandmarks(landmarks);
+    if (evicted) map.landmarks = decltype(map.landmarks)();
+    map.landmarks.insert(landmarks);
+
+    // The previous archives are released only now that the database stops aliasing them.
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_archives_ = std::move(archives);
+    return true;
+}
+
+std::vector<std::shared_ptr<MapArchive>> TiledMap::residentArchives() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<MapArchive>> archives;
+    for (const Tile& tile : tiles_) {
+        if (tile.archive) archives.push_back(tile.archive);
+    }
+    return archives;
+}
+
+uint64_t TiledMap::memoryBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_budget_;
+}
+
+void TiledMap::setMemoryBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memory_budget_ = bytes;
+}
+
+TiledMap::Stats TiledMap::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace lar::bridge
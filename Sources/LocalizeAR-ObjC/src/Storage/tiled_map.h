@@ -0,0 +1,122 @@
+//
+//  tiled_map.h
+//  LocalizeAR
+//
+//  Map split into square tiles on the ground (x/z) plane, paged in on demand.
+//
+//  A tile directory holds a manifest (tiles.json), base.larmap with anchors, edges and origin,
+//  and one landmark-only archive per tile under tiles/. Landmarks are assigned to the tile
+//  containing their position; the manifest records each tile's extent as the union of its
+//  landmarks' visibility bounds, which is what spatial queries are matched against. Only the
+//  tiles a query touches are mapped, and the least recently used ones are dropped once the
+//  resident size goes over the memory budget. A tile's resident size is its mapped file plus
+//  the landmarks decoded from it and their index entries, counted twice: once for the core
+//  map `prepare` fills, once for the immutable snapshot queries run on.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "map_archive.h"
+
+namespace lar {
+    class Map;
+}
+
+namespace lar::bridge {
+
+class TiledMap {
+public:
+    static constexpr const char* kManifestName = "tiles.json";
+    static constexpr uint32_t kManifestVersion = 1;
+    // Estimated index overhead per landmark (spatial index node and id lookup), in the core's
+    // landmark database and in a query snapshot alike.
+    static constexpr uint64_t kIndexBytesPerLandmark = 96;
+
+    struct Stats {
+        size_t resident_tiles = 0;
+        // Mapped plus decoded bytes of the resident tiles; this is what the budget applies to.
+        uint64_t resident_bytes = 0;
+        uint64_t decoded_bytes = 0;
+        uint64_t page_ins = 0;
+        uint64_t evictions = 0;
+    };
+
+    // Splits `map` into tiles of `tile_size` meters and writes them to `directory`. Throws
+    // std::runtime_error if a landmark position is not finite or too far out for the grid.
+    static void write(const lar::Map& map, const std::string& directory, double tile_size);
+
+    // True if `directory` contains a tile manifest.
+    static bool isTiledMap(const std::string& directory);
+
+    // Reads the manifest and base archive of `directory`. No tile is mapped until `prepare`.
+    // Throws std::runtime_error if the manifest or base archive is missing or malformed.
+    TiledMap(const std::string& directory, uint64_t memory_budget);
+
+    // Loads anchors, edges and origin into `map`; its landmark database is owned by `prepare`.
+    void loadBase(lar::Map& map) const;
+
+    // Makes sure every tile intersecting the query square is resident, evicting the least
+    // recently used tiles that aren't needed while over budget. Tiles a query needs are never
+    // evicted, so the budget can be exceeded by a single oversized query. Returns true if the
+    // resident set changed. Doesn't touch any map, so any thread may page.
+    bool page(double x, double z, double diameter);
+
+    // Like `page`, but for queries on landmark positions rather than visibility: makes every
+    // tile whose grid cell intersects the square resident, so all landmarks positioned inside
+    // it are decoded.
+    bool pagePositions(double x, double z, double diameter);
+
+    // Pages for the query square, then brings `map.landmarks` up to date with the resident tiles
+    // if they differ from the ones it was last built from (returns true); call from the thread
+    // that localizes against `map`. Tiles paged in since are inserted; if any were paged out,
+    // the database is rebuilt, which invalidates landmark pointers taken from it. Tiles the
+    // map's landmarks alias stay mapped until the next rebuild, even if already evicted.
+    bool prepare(double x, double z, double diameter, lar::Map& map);
+
+    // Archives of the resident tiles, in manifest order. Landmarks decoded from them alias
+    // their mappings, so keep the archives alive with the landmarks.
+    std::vector<std::shared_ptr<MapArchive>> residentArchives() const;
+
+    uint64_t memoryBudget() const;
+    void setMemoryBudget(uint64_t bytes);
+
+    double tileSize() const { return tile_size_; }
+    size_t tileCount() const { return tiles_.size(); }
+    Stats stats() const;
+
+private:
+    struct Tile {
+        int32_t x, z;
+        std::string file;
+        size_t landmarks;
+        uint64_t bytes;
+        uint64_t decodedBytes() const;
+        double lower_x, lower_z, upper_x, upper_z;
+        std::shared_ptr<MapArchive> archive;
+        uint64_t last_used = 0;
+    };
+
+    // Pages tiles whose extent (or with `by_position`, whose grid cell) intersects the square.
+    bool pageTiles(double x, double z, double diameter, bool by_position);
+
+    std::string directory_;
+    double tile_size_ = 0;
+    std::unique_ptr<MapArchive> base_;
+    std::vector<Tile> tiles_;
+
+    mutable std::mutex mutex_;
+    // Tiles the landmarks of the map passed to `prepare` were last built from.
+    std::vector<std::shared_ptr<MapArchive>> map_archives_;
+    uint64_t memory_budget_;
+    uint64_t clock_ = 0;
+    Stats stats_;
+};
+
+} // namespace lar::bridge
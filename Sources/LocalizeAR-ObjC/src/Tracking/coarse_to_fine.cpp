@@ -0,0 +1,89 @@
+//
+//  coarse_to_fine.cpp
+//  LocalizeAR
+//
+
+#include "coarse_to_fine.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <opencv2/imgproc.hpp>
+
+namespace lar::bridge {
+
+CoarseToFineLocalizer::CoarseToFineLocalizer(lar::Tracker& fine, lar::Map& map, const Options& options)
+    : fine_(fine), map_(map), options_(options), last_(&fine) {
+    if (options.levels < 1) {
+        throw std::invalid_argument("Coarse-to-fine localization needs at least one coarse level");
+    }
+    if (options.min_coarse_side < 1) {
+        throw std::invalid_argument("Coarse image side must be positive");
+    }
+    if (!(options.min_inlier_ratio >= 0 && options.min_inlier_ratio <= 1)) {
+        throw std::invalid_argument("Coarse inlier ratio must be between 0 and 1");
+    }
+    options_.levels = std::min(options.levels, kMaxLevels);
+}
+
+int CoarseToFineLocalizer::levelsFor(int width, int height) const {
+    const int side = std::min(width, height);
+    int levels = options_.levels;
+    while (levels > 0 && (side >> levels) < options_.min_coarse_side) levels--;
+    return levels;
+}
+
+CoarseToFineLocalizer::~CoarseToFineLocalizer() = default;
+
+bool CoarseToFineLocalizer::accepts(const lar::Tracker& tracker) const {
+    const size_t inliers = tracker.inliers.size();
+    return inliers >= options_.min_inliers && !tracker.matches.empty() &&
+           double(inliers) >= options_.min_inlier_ratio * double(tracker.matches.size());
+}
+
+bool CoarseToFineLocalizer::localize(const LARImage& image, lar::Frame& frame, const LARSpatialQuery& query,
+                                     Eigen::Matrix4d& transform) {
+    stats_.frames++;
+    const int levels = levelsFor(image.width, image.height);
+    if (levels > 0) {
+        const cv::Size size(image.width >> levels, image.height >> levels);
+        if (!coarse_) {
+            coarse_ = std::make_unique<lar::Tracker>(map_, size);
+        } else if (size != coarse_size_) {
+            coarse_->configureImageSize(size);
+        }
+        coarse_size_ = size;
+
+        const cv::Mat full(image.height, image.width, CV_8UC1, const_cast<void*>(image.data), size_t(image.bytesPerRow));
+        cv::resize(full, coarse_image_, size, 0, 0, cv::INTER_AREA);
+        // Pixel centers map as x' = (x + 0.5) * scale - 0.5.
+        coarse_frame_ = frame;
+        const double sx = double(size.width) / image.width, sy = double(size.height) / image.height;
+        Eigen::Matrix3d& intrinsics = coarse_frame_.intrinsics;
+        intrinsics.row(0) *= sx;
+        intrinsics.row(1) *= sy;
+        intrinsics(0, 2) += 0.5 * sx - 0.5;
+        intrinsics(1, 2) += 0.5 * sy - 0.5;
+
+        const LARImage coarse{ coarse_image_.data, coarse_image_.cols, coarse_image_.rows, int32_t(coarse_image_.step[0]) };
+        Eigen::Matrix4d coarse_transform;
+        if (coarse_->localize(coarse, coarse_frame_, query, coarse_transform) && accepts(*coarse_)) {
+            last_ = coarse_.get();
+            const Eigen::Matrix3d intrinsics = frame.intrinsics;
+            frame = coarse_frame_;
+            frame.intrinsics = intrinsics;
+            transform = coarse_transform;
+            stats_.coarse_accepted++;
+            stats_.successes++;
+            return true;
+        }
+    }
+
+    stats_.fine_passes++;
+    last_ = &fine_;
+    const bool success = fine_.localize(image, frame, query, transform);
+    if (success) stats_.successes++;
+    return success;
+}
+
+} // namespace lar::bridge
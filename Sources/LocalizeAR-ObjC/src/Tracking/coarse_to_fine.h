@@ -0,0 +1,83 @@
+//
+//  coarse_to_fine.h
+//  LocalizeAR
+//
+//  Localizes on a downsampled copy of the image first and only falls back to the full image
+//  when the coarse pose is weak.
+//
+//  Frames with enough texture usually localize on the coarse octaves alone, and the
+//  downsampled image has a fraction of the pixels and keypoints, so extraction, matching and
+//  PnP all get cheaper. A coarse result is accepted if it has enough inliers and enough of its matches
+//  are inliers; otherwise the frame is localized again at full resolution by the tracker the
+//  caller owns, so frames the coarse pass can't settle still get the full pipeline. The
+//  coarse pass has its own tracker, sized for the downsampled image, so switching between the
+//  two never reconfigures either.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <Eigen/Core>
+#include <opencv2/core/mat.hpp>
+
+#include <lar/tracking/tracker.h>
+
+namespace lar::bridge {
+
+class CoarseToFineLocalizer {
+public:
+    struct Options {
+        int levels = 1;                  // the coarse image is halved this many times
+        int min_coarse_side = 120;       // pixels; fewer levels are used where this needs it
+        size_t min_inliers = 40;         // for a coarse result to be accepted
+        double min_inlier_ratio = 0.25;  // inliers per match
+    };
+
+    struct Stats {
+        size_t frames = 0;
+        size_t coarse_accepted = 0;  // frames settled by the coarse pass
+        size_t fine_passes = 0;      // frames localized again at full resolution
+        size_t successes = 0;
+    };
+
+    static constexpr int kMaxLevels = 8;
+
+    // `fine` localizes full-resolution images and must outlive the localizer, as must `map`.
+    // `levels` is clamped to kMaxLevels. Throws std::invalid_argument if `levels` or
+    // `min_coarse_side` isn't positive or `min_inlier_ratio` isn't in [0, 1].
+    CoarseToFineLocalizer(lar::Tracker& fine, lar::Map& map, const Options& options);
+    ~CoarseToFineLocalizer();
+
+    // As lar::Tracker::localize. `image` must be 8-bit grayscale. Images too small for a coarse
+    // level of at least `min_coarse_side` go straight to the fine tracker. When the coarse
+    // result is accepted, `frame` receives what the coarse pass wrote to its copy, with the
+    // caller's intrinsics.
+    bool localize(const LARImage& image, lar::Frame& frame, const LARSpatialQuery& query, Eigen::Matrix4d& transform);
+
+    // The tracker that produced the last result, whose matches and inliers describe it.
+    // Keypoints of coarse results are in coarse image pixels.
+    lar::Tracker& last() { return *last_; }
+    bool lastWasCoarse() const { return last_ != &fine_; }
+
+    const Options& options() const { return options_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool accepts(const lar::Tracker& tracker) const;
+    // Levels to halve a `width` x `height` image by, 0 for no coarse pass.
+    int levelsFor(int width, int height) const;
+
+    lar::Tracker& fine_;
+    lar::Map& map_;
+    Options options_;
+    std::unique_ptr<lar::Tracker> coarse_;  // created for the first image's size
+    cv::Size coarse_size_;
+    cv::Mat coarse_image_;
+    lar::Frame coarse_frame_;
+    lar::Tracker* last_;
+    Stats stats_;
+};
+
+} // namespace lar::bridge
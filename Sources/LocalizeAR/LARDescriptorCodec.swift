@@ -0,0 +1,14 @@
+//
+//  LARDescriptorCodec.swift
+//  LocalizeAR
+//
+
+import CoreGraphics
+
+public extension LARDescriptorRecallEvaluator {
+
+    /// Evaluates code vs. exact matching for the features of a CGImage.
+    func evaluate(_ image: CGImage, query: LARSpatialQuery) {
+        _ = image.withGrayscaleLARImage { evaluate(image: $0, query: query) }
+    }
+}
@@ -0,0 +1,15 @@
+//
+//  LARSIFTBenchmark.swift
+//  LocalizeAR
+//
+
+import CoreGraphics
+
+public extension LARSIFTBenchmark {
+
+    /// Runs every SIFT extractor on a CGImage.
+    @discardableResult
+    func add(_ image: CGImage) -> Bool {
+        image.withGrayscaleLARImage { add(image: $0) } ?? false
+    }
+}
@@ -0,0 +1,27 @@
+//
+//  LARSIFTExtractor.swift
+//  LocalizeAR
+//
+
+import CoreGraphics
+
+public extension LARSIFTExtractor {
+
+    /// Extracts SIFT features from a CGImage.
+    @discardableResult
+    func extract(_ image: CGImage) -> Bool {
+        image.withGrayscaleLARImage { extract(image: $0) } ?? false
+    }
+
+    /// Keypoints of the last extracted image.
+    var keypoints: [LARKeypoint] {
+        (0..<keypointCount).map { keypoint(at: $0) }
+    }
+
+    /// The 128-value descriptor of the `index`-th keypoint of the last extracted image.
+    func descriptor(at index: Int) -> [Float] {
+        descriptors.withUnsafeBytes { bytes in
+            Array(bytes.bindMemory(to: Float.self)[(index * 128)..<((index + 1) * 128)])
+        }
+    }
+}
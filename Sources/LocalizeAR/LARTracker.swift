@@ -64,35 +64,11 @@ public extension LARTracker {
         queryZ: Double,
         queryDiameter: Double
     ) -> (success: Bool, transform: [[Double]]?) {
-        let width = image.width
-        let height = image.height
-
-        // Render to grayscale bytes (CoreGraphics only — no opencv). Pad each row to a
-        // 4-byte boundary: CGContext can return nil for an unaligned bytesPerRow (e.g.
-        // odd widths), which would otherwise make every localize silently fail.
-        let bytesPerRow = (width + 3) & ~3
-        var pixelData = [UInt8](repeating: 0, count: bytesPerRow * height)
-        guard let context = CGContext(
-            data: &pixelData,
-            width: width,
-            height: height,
-            bitsPerComponent: 8,
-            bytesPerRow: bytesPerRow,
-            space: CGColorSpaceCreateDeviceGray(),
-            bitmapInfo: CGImageAlphaInfo.none.rawValue
-        ) else {
-            return (false, nil)
-        }
-        context.draw(image, in: CGRect(x: 0, y: 0, width: width, height: height))
-
         var transform = matrix_identity_double4x4
         let query = LARSpatialQuery(x: queryX, z: queryZ, diameter: queryDiameter)
-        let success = pixelData.withUnsafeBytes { raw -> Bool in
-            let image = LARImage(data: raw.baseAddress!, width: Int32(width),
-                                      height: Int32(height), bytesPerRow: Int32(bytesPerRow))
-            return self.localize(image: image, frame: frame, query: query,
-                                 outputTransform: &transform)
-        }
+        let success = image.withGrayscaleLARImage { image in
+            self.localize(image: image, frame: frame, query: query, outputTransform: &transform)
+        } ?? false
         guard success else { return (false, nil) }
 
         // [[Double]] is row-major; simd is column-major (transform[col][row]).
@@ -0,0 +1,35 @@
+//
+//  CGImage+LARImage.swift
+//  LocalizeAR
+//
+
+import CoreGraphics
+
+extension CGImage {
+
+    /// Renders the image to 8-bit grayscale and passes it to `body` as a `LARImage`.
+    /// Returns nil if the grayscale context can't be created.
+    func withGrayscaleLARImage<Result>(_ body: (LARImage) -> Result) -> Result? {
+        // CoreGraphics only — no opencv. Pad each row to a 4-byte boundary: CGContext can
+        // return nil for an unaligned bytesPerRow (e.g. odd widths).
+        let bytesPerRow = (width + 3) & ~3
+        var pixelData = [UInt8](repeating: 0, count: bytesPerRow * height)
+        guard let context = CGContext(
+            data: &pixelData,
+            width: width,
+            height: height,
+            bitsPerComponent: 8,
+            bytesPerRow: bytesPerRow,
+            space: CGColorSpaceCreateDeviceGray(),
+            bitmapInfo: CGImageAlphaInfo.none.rawValue
+        ) else {
+            return nil
+        }
+        context.draw(self, in: CGRect(x: 0, y: 0, width: width, height: height))
+
+        return pixelData.withUnsafeBytes { raw in
+            body(LARImage(data: raw.baseAddress!, width: Int32(width),
+                          height: Int32(height), bytesPerRow: Int32(bytesPerRow)))
+        }
+    }
+}
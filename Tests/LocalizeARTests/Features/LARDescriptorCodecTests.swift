@@ -0,0 +1,197 @@
+//
+//  LARDescriptorCodecTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for the Scalar8 and Product descriptor codecs and the compressed index archives carry
+/// Validates round-trip error, codebook serialization, and search recall against exact
+/// brute-force matching
+final class LARDescriptorCodecTests: XCTestCase {
+    private var directory: URL!
+    private var source: SyntheticMap!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+        source = SyntheticMap(count: 1000)
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    private func codec(_ kind: LARDescriptorCodecKind) throws -> LARDescriptorCodec {
+        try XCTUnwrap(LARDescriptorCodec(map: source.makeMap(), kind: kind, subspaces: kind == .product ? 32 : 0))
+    }
+
+    private func floats(_ data: Data) -> [Float] {
+        data.withUnsafeBytes { Array($0.bindMemory(to: Float.self)) }
+    }
+
+    private func squaredDistance(_ a: Data, _ b: [Float]) -> Float {
+        zip(a, b).reduce(0) { sum, pair in
+            let difference = Float(pair.0) - pair.1
+            return sum + difference * difference
+        }
+    }
+
+    /// A landmark's descriptor with every byte moved by up to `noise`
+    private func noisyQuery(near descriptor: Data, noise: Int, using rng: inout SplitMix64) -> Data {
+        Data(descriptor.map { UInt8(clamping: Int($0) + Int.random(in: -noise...noise, using: &rng)) })
+    }
+
+    /// Id of the landmark whose exact descriptor is nearest to `query`
+    private func exactNearest(to query: Data) -> Int {
+        let values = query.map(Float.init)
+        return source.landmarks.min { squaredDistance($0.descriptor, values) < squaredDistance($1.descriptor, values) }!.id
+    }
+
+    private func writeArchive(with codec: LARDescriptorCodec) -> String {
+        let path = directory.appendingPathComponent("map.larmap").path
+        XCTAssertTrue(codec.writeArchive(of: source.makeMap(), to: path))
+        return path
+    }
+
+    /// Fraction of noisy queries whose exact nearest landmark is among the `count` returned
+    private func recall(of codec: LARDescriptorCodec, count: Int, rerank: Int, queries: Int = 100) throws -> Double {
+        let path = writeArchive(with: codec)
+        var rng = SplitMix64(seed: 9)
+        var hits = 0
+        for _ in 0..<queries {
+            let target = source.landmarks[Int.random(in: 0..<source.landmarks.count, using: &rng)]
+            let query = noisyQuery(near: target.descriptor, noise: 20, using: &rng)
+            let found = try XCTUnwrap(LARDescriptorCodec.nearestLandmarks(to: query, inArchiveAt: path, count: count,
+                                                                         rerank: rerank, rows: nil))
+            XCTAssertLessThanOrEqual(found.count, count)
+            if found.map(\.intValue).contains(exactNearest(to: query)) { hits += 1 }
+        }
+        return Double(hits) / Double(queries)
+    }
+
+    // MARK: - Round-Trip Tests
+
+    func testScalar8_RoundTrip_ErrorWithinHalfAStep() throws {
+        // Given
+        let codec = try codec(.scalar8)
+        XCTAssertEqual(codec.codeSize, 128)
+
+        for landmark in source.landmarks[..<200] {
+            // When
+            let code = try XCTUnwrap(codec.encode(landmark.descriptor))
+            let decoded = floats(try XCTUnwrap(codec.decode(code)))
+
+            // Then
+            // Byte descriptors span at most 0...255, so a step is at most 1
+            XCTAssertEqual(code.count, codec.codeSize)
+            let error = zip(landmark.descriptor, decoded).map { abs(Float($0) - $1) }.max()!
+            XCTAssertLessThanOrEqual(error, 0.5 + 1e-3, "Landmark \(landmark.id)")
+        }
+    }
+
+    func testProduct_RoundTrip_ErrorWellBelowDescriptorVariance() throws {
+        // Given
+        let codec = try codec(.product)
+        XCTAssertEqual(codec.codeSize, 32)
+        let all = source.landmarks.flatMap { $0.descriptor.map(Float.init) }
+        let mean = all.reduce(0, +) / Float(all.count)
+        let variance = all.reduce(0) { $0 + ($1 - mean) * ($1 - mean) } / Float(all.count)
+
+        // When
+        var error: Float = 0
+        for landmark in source.landmarks {
+            let decoded = floats(try XCTUnwrap(codec.decode(try XCTUnwrap(codec.encode(landmark.descriptor)))))
+            error += squaredDistance(landmark.descriptor, decoded)
+        }
+
+        // Then
+        XCTAssertLessThan(error / Float(all.count), variance / 2)
+    }
+
+    func testEncode_WrongLength_ReturnsNil() throws {
+        // Given
+        let codec = try codec(.scalar8)
+
+        // Then
+        XCTAssertNil(codec.encode(Data(count: 100)))
+        XCTAssertNil(codec.decode(Data(count: codec.codeSize + 1)))
+    }
+
+    // MARK: - Serialization Tests
+
+    func testSerializedCodebook_ReadBack_EncodesIdentically() throws {
+        for kind in [LARDescriptorCodecKind.scalar8, .product] {
+            // Given
+            let codec = try codec(kind)
+
+            // When
+            let restored = try XCTUnwrap(LARDescriptorCodec(serializedCodebook: codec.serializedCodebook))
+
+            // Then
+            XCTAssertEqual(restored.kind, codec.kind)
+            XCTAssertEqual(restored.codeSize, codec.codeSize)
+            XCTAssertEqual(restored.subspaces, codec.subspaces)
+            XCTAssertEqual(restored.serializedCodebook, codec.serializedCodebook)
+            for landmark in source.landmarks[..<50] {
+                XCTAssertEqual(restored.encode(landmark.descriptor), codec.encode(landmark.descriptor), "Kind: \(kind)")
+            }
+        }
+    }
+
+    func testSerializedCodebook_Truncated_ReturnsNil() throws {
+        for kind in [LARDescriptorCodecKind.scalar8, .product] {
+            // Given
+            let codebook = try codec(kind).serializedCodebook
+
+            // Then
+            XCTAssertNil(LARDescriptorCodec(serializedCodebook: codebook.prefix(codebook.count - 1)), "Kind: \(kind)")
+            XCTAssertNil(LARDescriptorCodec(serializedCodebook: codebook.prefix(8)), "Kind: \(kind)")
+        }
+    }
+
+    // MARK: - Search Tests
+
+    func testScalar8Search_MatchesExactNearest() throws {
+        XCTAssertGreaterThanOrEqual(try recall(of: codec(.scalar8), count: 1, rerank: 0), 0.99)
+    }
+
+    func testProductSearch_ExactNearestAmongTopCandidates() throws {
+        XCTAssertGreaterThanOrEqual(try recall(of: codec(.product), count: 10, rerank: 0), 0.9)
+    }
+
+    func testProductSearch_Reranked_MatchesExactNearest() throws {
+        XCTAssertGreaterThanOrEqual(try recall(of: codec(.product), count: 1, rerank: 50), 0.99)
+    }
+
+    func testSearch_CandidatesPastLastRow_AreSkipped() throws {
+        // Given
+        let path = writeArchive(with: try codec(.scalar8))
+        let query = source.landmarks[123].descriptor
+        let rows = (0..<source.landmarks.count).map { NSNumber(value: $0) }
+
+        // When
+        let unrestricted = LARDescriptorCodec.nearestLandmarks(to: query, inArchiveAt: path, count: 5, rerank: 20, rows: nil)
+        let padded = LARDescriptorCodec.nearestLandmarks(to: query, inArchiveAt: path, count: 5, rerank: 20,
+                                                         rows: rows + [1000, 5000, NSNumber(value: UInt32.max)])
+        let outOfRange = LARDescriptorCodec.nearestLandmarks(to: query, inArchiveAt: path, count: 5, rerank: 20,
+                                                             rows: [1000, 5000])
+
+        // Then
+        XCTAssertEqual(unrestricted?.first, 123)
+        XCTAssertEqual(padded, unrestricted)
+        XCTAssertEqual(outOfRange, [])
+    }
+
+    func testSearch_ArchiveWithoutCodes_ReturnsNil() throws {
+        // Given
+        let path = directory.appendingPathComponent("plain.larmap").path
+        XCTAssertTrue(source.makeMap().writeArchive(to: path))
+
+        // Then
+        XCTAssertNil(LARDescriptorCodec.nearestLandmarks(to: source.landmarks[0].descriptor, inArchiveAt: path,
+                                                         count: 1, rerank: 0, rows: nil))
+    }
+}
@@ -0,0 +1,210 @@
+//
+//  LARSIFTExtractorTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import CoreGraphics
+@testable import LocalizeAR
+
+/// Tests for LARSIFTExtractor
+/// Validates that frames of the configured size reuse the scratch buffers, and that keypoints
+/// and descriptors agree with OpenCV's SIFT
+final class LARSIFTExtractorTests: XCTestCase {
+    private let width = 320
+    private let height = 240
+
+    // MARK: - Helpers
+
+    /// Grayscale test pattern with corners and blobs at several scales
+    private func makeImage() -> CGImage {
+        let context = CGContext(data: nil, width: width, height: height, bitsPerComponent: 8, bytesPerRow: 0,
+                                space: CGColorSpaceCreateDeviceGray(), bitmapInfo: CGImageAlphaInfo.none.rawValue)!
+        context.setFillColor(gray: 0.2, alpha: 1)
+        context.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        for i in 0..<24 {
+            let size = CGFloat(6 + (i * 7) % 30)
+            let rect = CGRect(x: CGFloat((i * 53) % (width - 40)), y: CGFloat((i * 37) % (height - 40)), width: size, height: size)
+            context.setFillColor(gray: CGFloat((i * 29) % 10) / 10, alpha: 1)
+            if i.isMultiple(of: 2) {
+                context.fill(rect)
+            } else {
+                context.fillEllipse(in: rect)
+            }
+        }
+        return context.makeImage()!
+    }
+
+    private func assertSteadyStateReusesScratchBuffers(threads: Int) {
+        // Given
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: threads)
+        let image = makeImage()
+        XCTAssertTrue(sut.extract(image))
+        XCTAssertGreaterThan(sut.keypointCount, 0)
+        let keypointCount = sut.keypointCount
+        let allocations = LARSIFTExtractor.scratchAllocationCount
+
+        // When
+        for _ in 0..<3 {
+            XCTAssertTrue(sut.extract(image))
+        }
+
+        // Then
+        XCTAssertEqual(LARSIFTExtractor.scratchAllocationCount, allocations)
+        XCTAssertEqual(sut.keypointCount, keypointCount)
+    }
+
+    /// Checks that `sut` found OpenCV's keypoints at the same position, size and angle, with
+    /// descriptors that differ by rounding noise only
+    private func assertMatchesOpenCV(_ sut: LARSIFTExtractor, _ reference: LARSIFTExtractor,
+                                     file: StaticString = #filePath, line: UInt = #line) {
+        let keypoints = sut.keypoints, expected = reference.keypoints
+        XCTAssertGreaterThan(expected.count, 0, file: file, line: line)
+        XCTAssertEqual(Double(keypoints.count), Double(expected.count), accuracy: 0.02 * Double(expected.count), file: file, line: line)
+
+        var matched = 0, totalDistance: Float = 0
+        for (j, keypoint) in expected.enumerated() {
+            let candidates = keypoints.indices.filter {
+                abs(keypoints[$0].x - keypoint.x) < 0.05 && abs(keypoints[$0].y - keypoint.y) < 0.05 &&
+                    abs(keypoints[$0].size - keypoint.size) < 0.05
+            }
+            // Angles wrap at 360°
+            let angle = { (i: Int) -> Float in abs(remainder(keypoints[i].angle - keypoint.angle, 360)) }
+            guard let i = candidates.min(by: { angle($0) < angle($1) }), angle(i) < 2 else { continue }
+            matched += 1
+            let difference = zip(sut.descriptor(at: i), reference.descriptor(at: j)).map { $0 - $1 }
+            let distance = difference.map { $0 * $0 }.reduce(0, +).squareRoot()
+            // Descriptors have an L2 norm of 512; a few units are rounding noise
+            XCTAssertLessThanOrEqual(distance, 8, "Keypoint at (\(keypoint.x), \(keypoint.y))", file: file, line: line)
+            totalDistance += distance
+        }
+        XCTAssertGreaterThanOrEqual(Double(matched), 0.98 * Double(expected.count), file: file, line: line)
+        XCTAssertLessThanOrEqual(totalDistance / Float(max(matched, 1)), 1, file: file, line: line)
+    }
+
+    // MARK: - Scratch Buffer Tests
+
+    func testExtract_SteadyState_ReusesScratchBuffers() {
+        assertSteadyStateReusesScratchBuffers(threads: 1)
+    }
+
+    func testExtract_SteadyStateOnThreads_ReusesScratchBuffers() {
+        assertSteadyStateReusesScratchBuffers(threads: 4)
+    }
+
+    // MARK: - Budget Tests
+
+    func testExtract_WithBudget_KeepsBudgetAndCountsDropped() {
+        // Given
+        let image = makeImage()
+        let full = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1)
+        XCTAssertTrue(full.extract(image))
+        let budget = full.keypointCount / 2
+        XCTAssertGreaterThan(budget, 0)
+
+        for selection in [LARKeypointSelection.strongest, .grid, .suppression] {
+            let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1,
+                                       keypointBudget: budget, selection: selection)
+
+            // When
+            XCTAssertTrue(sut.extract(image))
+
+            // Then
+            XCTAssertGreaterThanOrEqual(sut.keypointCount, budget)
+            XCTAssertEqual(sut.keypointCount + sut.droppedKeypointCount, full.keypointCount)
+            if selection != .strongest {
+                XCTAssertEqual(sut.keypointCount, budget)
+            }
+        }
+    }
+
+    func testExtract_WithBudget_SteadyStateReusesScratchBuffers() {
+        // Given
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1,
+                                   keypointBudget: 10, selection: .suppression)
+        let image = makeImage()
+        XCTAssertTrue(sut.extract(image))
+        let allocations = LARSIFTExtractor.scratchAllocationCount
+
+        // When
+        XCTAssertTrue(sut.extract(image))
+
+        // Then
+        XCTAssertEqual(LARSIFTExtractor.scratchAllocationCount, allocations)
+        XCTAssertEqual(sut.keypointCount, 10)
+    }
+
+    // MARK: - OpenCV Agreement Tests
+
+    func testExtract_MatchesOpenCVSIFT() {
+        // Given
+        let image = makeImage()
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1)
+        let reference = LARSIFTExtractor(openCVKeypointBudget: 0)
+
+        // When
+        XCTAssertTrue(sut.extract(image))
+        XCTAssertTrue(reference.extract(image))
+
+        // Then
+        XCTAssertTrue(reference.usesOpenCV)
+        assertMatchesOpenCV(sut, reference)
+    }
+
+    func testExtract_OnThreads_MatchesOpenCVSIFT() {
+        // Given
+        let image = makeImage()
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 4)
+        let reference = LARSIFTExtractor(openCVKeypointBudget: 0)
+
+        // When
+        XCTAssertTrue(sut.extract(image))
+        XCTAssertTrue(reference.extract(image))
+
+        // Then
+        assertMatchesOpenCV(sut, reference)
+    }
+
+    func testExtract_StrongestWithBudget_MatchesOpenCVBudget() {
+        // Given
+        let image = makeImage()
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1,
+                                   keypointBudget: 40, selection: .strongest)
+        let reference = LARSIFTExtractor(openCVKeypointBudget: 40)
+
+        // When
+        XCTAssertTrue(sut.extract(image))
+        XCTAssertTrue(reference.extract(image))
+
+        // Then
+        XCTAssertEqual(reference.keypointBudget, 40)
+        assertMatchesOpenCV(sut, reference)
+    }
+
+    func testDescriptors_OneRowPerKeypoint() {
+        // Given
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1)
+
+        // When
+        XCTAssertTrue(sut.extract(makeImage()))
+
+        // Then
+        XCTAssertEqual(sut.descriptors.count, sut.keypointCount * 128 * MemoryLayout<Float>.size)
+        XCTAssertEqual(sut.keypoint(at: sut.keypointCount).size, 0)
+        XCTAssertEqual(sut.keypoint(at: -1).size, 0)
+    }
+
+    // MARK: - Configuration Tests
+
+    func testConfigureImageSize_UpdatesSize() {
+        // Given
+        let sut = LARSIFTExtractor(imageWidth: Int32(width), imageHeight: Int32(height), threads: 1)
+
+        // When
+        sut.configureImageSize(withWidth: 640, height: 480)
+
+        // Then
+        XCTAssertEqual(sut.imageWidth, 640)
+        XCTAssertEqual(sut.imageHeight, 480)
+    }
+}
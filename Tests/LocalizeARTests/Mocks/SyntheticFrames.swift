@@ -0,0 +1,58 @@
+//
+//  SyntheticFrames.swift
+//  LocalizeARTests
+//
+
+import Foundation
+import simd
+@testable import LocalizeAR
+
+/// Mapping frames of a camera walking along x and looking down -z, with a reference for
+/// which landmarks each keyframe sees
+struct SyntheticFrames {
+    static let focalLength = 500.0
+    static let principalPoint = SIMD2(320.0, 240.0)
+
+    /// Camera positions as the frames store them (single precision)
+    let positions: [SIMD3<Double>]
+    let frames: [LARFrame]
+
+    init(from start: SIMD3<Float>, step: Float, count: Int) {
+        var positions: [SIMD3<Double>] = []
+        var frames: [LARFrame] = []
+        let intrinsics = simd_float3x3(columns: (SIMD3(Float(Self.focalLength), 0, 0),
+                                                 SIMD3(0, Float(Self.focalLength), 0),
+                                                 SIMD3(Float(Self.principalPoint.x), Float(Self.principalPoint.y), 1)))
+        for i in 0..<count {
+            let position = start + SIMD3(step * Float(i), 0, 0)
+            var extrinsics = matrix_identity_float4x4
+            extrinsics.columns.3 = SIMD4(position, 1)
+            positions.append(SIMD3<Double>(position))
+            frames.append(LARFrame(id: i, timestamp: i, intrinsics: intrinsics, extrinsics: extrinsics))
+        }
+        self.positions = positions
+        self.frames = frames
+    }
+
+    /// Frames picked as keyframes: the first, then each one at least `distance` meters from
+    /// the last pick (the camera never turns)
+    func keyframePositions(distance: Double = 0.5) -> [SIMD3<Double>] {
+        var picked: [SIMD3<Double>] = []
+        for position in positions where picked.last.map({ simd_distance($0, position) >= distance }) ?? true {
+            picked.append(position)
+        }
+        return picked
+    }
+
+    /// Whether a camera at `camera` sees `position` inside its frustum, padded by 15% of the
+    /// image and between 0.1 and 20 meters deep
+    static func sees(_ camera: SIMD3<Double>, _ position: SIMD3<Double>) -> Bool {
+        let point = position - camera
+        let depth = -point.z
+        guard depth >= 0.1 && depth <= 20 else { return false }
+        let size = 2 * principalPoint
+        let u = focalLength * point.x / depth + principalPoint.x
+        let v = -focalLength * point.y / depth + principalPoint.y
+        return u >= -0.15 * size.x && u <= 1.15 * size.x && v >= -0.15 * size.y && v <= 1.15 * size.y
+    }
+}
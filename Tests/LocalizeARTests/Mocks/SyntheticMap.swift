@@ -0,0 +1,91 @@
+//
+//  SyntheticMap.swift
+//  LocalizeARTests
+//
+
+import Foundation
+import simd
+@testable import LocalizeAR
+
+/// Seeded generator, so failures reproduce
+struct SplitMix64: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
+
+/// Maps of random landmarks, with the plain values they were built from as a reference
+struct SyntheticMap {
+    struct Landmark {
+        let id: Int
+        let position: SIMD3<Double>
+        let boundsLower: SIMD2<Double>
+        let boundsUpper: SIMD2<Double>
+        let descriptor: Data
+        let sightings: Int32
+        let lastSeen: Int64
+    }
+
+    let landmarks: [Landmark]
+
+    /// `count` landmarks spread over an `extent` meter square (x/z) and `heights` (y), each
+    /// visible from up to `reach` meters around it
+    init(count: Int, extent: Double = 100, heights: ClosedRange<Double> = 0...3, reach: Double = 5,
+         descriptorLength: Int = 128, seed: UInt64 = 1) {
+        var rng = SplitMix64(seed: seed)
+        landmarks = (0..<count).map { i in
+            let position = SIMD3(Double.random(in: 0..<extent, using: &rng),
+                                 Double.random(in: heights, using: &rng),
+                                 Double.random(in: 0..<extent, using: &rng))
+            let lower = SIMD2(position.x, position.z) - SIMD2(Double.random(in: 0...reach, using: &rng),
+                                                             Double.random(in: 0...reach, using: &rng))
+            let upper = SIMD2(position.x, position.z) + SIMD2(Double.random(in: 0...reach, using: &rng),
+                                                             Double.random(in: 0...reach, using: &rng))
+            let descriptor = Data((0..<descriptorLength).map { _ in UInt8.random(in: 0...255, using: &rng) })
+            return Landmark(id: i, position: position, boundsLower: lower, boundsUpper: upper, descriptor: descriptor,
+                            sightings: Int32.random(in: 1...50, using: &rng),
+                            lastSeen: Int64.random(in: 0...1_000_000, using: &rng))
+        }
+    }
+
+    init(landmarks: [Landmark]) {
+        self.landmarks = landmarks
+    }
+
+    func makeMap() -> LARMap {
+        let map = LARMap()
+        for landmark in landmarks {
+            let added = map.addLandmark(id: landmark.id, position: landmark.position, boundsLower: landmark.boundsLower,
+                                        boundsUpper: landmark.boundsUpper, descriptor: landmark.descriptor,
+                                        sightings: landmark.sightings, lastSeen: landmark.lastSeen)
+            precondition(added, "Empty maps take landmarks")
+        }
+        return map
+    }
+
+    /// Brute-force reference for spatial queries: landmarks whose bounds intersect the square
+    func idsIntersecting(_ query: LARSpatialQuery) -> Set<Int> {
+        let radius = query.diameter / 2
+        return Set(landmarks.filter {
+            $0.boundsLower.x <= query.x + radius && $0.boundsUpper.x >= query.x - radius &&
+                $0.boundsLower.y <= query.z + radius && $0.boundsUpper.y >= query.z - radius
+        }.map(\.id))
+    }
+}
+
+/// Scratch directory removed when the test ends
+func makeTemporaryDirectory() throws -> URL {
+    let url = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+    try FileManager.default.createDirectory(at: url, withIntermediateDirectories: true)
+    return url
+}
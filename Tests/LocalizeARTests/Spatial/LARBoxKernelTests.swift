@@ -0,0 +1,101 @@
+//
+//  LARBoxKernelTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for the SIMD box intersection kernels behind the packed R-tree
+/// Validates that the SIMD and scalar kernels agree with a linear scan, including at box edges
+/// closer together than single precision can tell apart
+final class LARBoxKernelTests: XCTestCase {
+
+    // MARK: - Helpers
+
+    private func landmark(_ id: Int, lower: SIMD2<Double>, upper: SIMD2<Double>) -> SyntheticMap.Landmark {
+        let center = (lower + upper) / 2
+        return SyntheticMap.Landmark(id: id, position: SIMD3(center.x, 0, center.y), boundsLower: lower, boundsUpper: upper,
+                                     descriptor: Data(), sightings: 1, lastSeen: 0)
+    }
+
+    // MARK: - Kernel Agreement Tests
+
+    func testBenchmark_KernelsAgreeWithScan() throws {
+        // Given
+        let map = SyntheticMap(count: 97, seed: 1).makeMap()
+
+        // Partial SIMD batches (1, 3, 5, 63 boxes) and several tree levels
+        for count in [1, 3, 5, 63, 64, 65, 4097, 50_000] {
+            // When
+            let benchmark = try XCTUnwrap(LARSpatialIndexBenchmark(map: map, landmarkCount: count, queryCount: 200, diameter: 20))
+
+            // Then
+            XCTAssertTrue(benchmark.resultsMatch, "Kernel \(benchmark.kernelName) disagrees at \(count) boxes")
+            XCTAssertEqual(benchmark.landmarkCount, count)
+            XCTAssertFalse(benchmark.kernelName.isEmpty)
+        }
+    }
+
+    func testBenchmark_LargeQueries_FindHitsAndAgree() throws {
+        // Given
+        let map = SyntheticMap(count: 200, seed: 2).makeMap()
+
+        // When
+        let benchmark = try XCTUnwrap(LARSpatialIndexBenchmark(map: map, landmarkCount: 20_000, queryCount: 50, diameter: 150))
+
+        // Then
+        XCTAssertTrue(benchmark.resultsMatch)
+        XCTAssertGreaterThan(benchmark.hitCount, 0)
+    }
+
+    func testBenchmark_EmptyMap_ReturnsNil() {
+        XCTAssertNil(LARSpatialIndexBenchmark(map: LARMap(), landmarkCount: 100, queryCount: 10, diameter: 10))
+    }
+
+    // MARK: - Edge Tests
+
+    func testLandmarksForQuery_TouchingEdges_Intersect() {
+        // Given
+        let source = SyntheticMap(landmarks: [
+            landmark(0, lower: SIMD2(0, 0), upper: SIMD2(1, 1)),
+            landmark(1, lower: SIMD2(0.25, 0.25), upper: SIMD2(0.5, 0.5)),
+        ])
+        let map = source.makeMap()
+
+        // When
+        // Lower edges of the queries at exactly 1.0 and 0.5
+        let touchingFirst = map.landmarks(for: LARSpatialQuery(x: 1.5, z: 0.5, diameter: 1)).map { Int($0.id) }
+        let touchingSecond = map.landmarks(for: LARSpatialQuery(x: 1, z: 1, diameter: 1)).map { Int($0.id) }
+
+        // Then
+        XCTAssertEqual(Set(touchingFirst), [0])
+        XCTAssertEqual(Set(touchingSecond), [0, 1])
+    }
+
+    func testLandmarksForQuery_GapsBelowFloatPrecision_AreExact() {
+        // Given
+        // Float rounds these edges together; only the exact check can separate them
+        let edge = 1000.1
+        let gap = 1e-9
+        var landmarks: [SyntheticMap.Landmark] = []
+        for i in 0..<64 {
+            let offset = Double(i) * 3
+            landmarks.append(landmark(i, lower: SIMD2(offset, 0), upper: SIMD2(offset + edge, 1)))
+        }
+        let source = SyntheticMap(landmarks: landmarks)
+        let map = source.makeMap()
+
+        for i in 0..<64 {
+            let upper = Double(i) * 3 + edge
+
+            // When
+            let missing = LARSpatialQuery(x: upper + gap + 0.5, z: 0.5, diameter: 1)
+            let touching = LARSpatialQuery(x: upper + 0.5, z: 0.5, diameter: 1)
+
+            // Then
+            XCTAssertEqual(Set(map.landmarks(for: missing).map { Int($0.id) }), source.idsIntersecting(missing))
+            XCTAssertEqual(Set(map.landmarks(for: touching).map { Int($0.id) }), source.idsIntersecting(touching))
+        }
+    }
+}
@@ -0,0 +1,134 @@
+//
+//  LARCovisibilityGraphTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for LARCovisibilityGraph
+/// Validates keyframes, visibility links and seed expansion against a brute-force frustum test
+final class LARCovisibilityGraphTests: XCTestCase {
+    private var source: SyntheticMap!
+    private var frames: SyntheticFrames!
+    private var sut: LARCovisibilityGraph!
+    /// Ids each reference keyframe sees
+    private var visible: [Set<Int>]!
+
+    override func setUpWithError() throws {
+        source = SyntheticMap(count: 3000, extent: 100, reach: 1)
+        frames = SyntheticFrames(from: SIMD3(20, 1.5, 60), step: 0.2, count: 300)
+        sut = try XCTUnwrap(LARCovisibilityGraph(map: source.makeMap(), frames: frames.frames))
+        visible = frames.keyframePositions().map { camera in
+            Set(source.landmarks.filter { SyntheticFrames.sees(camera, $0.position) }.map(\.id))
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func ids(_ landmarks: [LARLandmark]) -> Set<Int> {
+        Set(landmarks.map { Int($0.id) })
+    }
+
+    /// Keyframes that see `id`
+    private func keyframes(seeing id: Int) -> [Int] {
+        visible.indices.filter { visible[$0].contains(id) }
+    }
+
+    // MARK: - Construction Tests
+
+    func testInit_KeyframesAndVisibilityMatchFrustumScan() {
+        XCTAssertEqual(sut.keyframeCount, visible.count)
+        XCTAssertEqual(sut.visibilityCount, visible.reduce(0) { $0 + $1.count })
+        XCTAssertGreaterThan(sut.visibilityCount, 0)
+    }
+
+    func testInit_LinksMatchSharedLandmarkCounts() {
+        // Keyframes sharing at least 15 landmarks, at most 16 kept per keyframe
+        var expected = 0
+        for keyframe in visible.indices {
+            let linked = visible.indices.filter { $0 != keyframe && visible[$0].intersection(visible[keyframe]).count >= 15 }
+            expected += min(linked.count, 16)
+        }
+
+        XCTAssertEqual(sut.linkCount, expected)
+    }
+
+    func testInit_InvalidIntrinsics_ReturnsNil() {
+        // Given
+        let frame = LARFrame(id: 0, timestamp: 0, intrinsics: simd_float3x3(), extrinsics: matrix_identity_float4x4)
+
+        // Then
+        XCTAssertNil(LARCovisibilityGraph(map: source.makeMap(), frames: [frame]))
+    }
+
+    // MARK: - Expansion Tests
+
+    func testLandmarksCovisibleWith_EnoughKeyframes_ReturnsEverythingTheirKeyframesSee() throws {
+        // Given
+        let seed = try XCTUnwrap(source.landmarks.first { !keyframes(seeing: $0.id).isEmpty }).id
+        let seeing = keyframes(seeing: seed)
+
+        // When
+        // Exactly the keyframes that see the seed, so no neighbors are added
+        let found = ids(sut.landmarks(covisibleWith: [NSNumber(value: seed)], keyframeLimit: seeing.count))
+
+        // Then
+        let expected = seeing.reduce(into: Set([seed])) { $0.formUnion(visible[$1]) }
+        XCTAssertEqual(found, expected)
+    }
+
+    func testLandmarksCovisibleWith_OneKeyframe_PicksTheOneSeeingMostSeeds() throws {
+        // Given
+        let seeds = source.landmarks.filter { !keyframes(seeing: $0.id).isEmpty }.prefix(8).map(\.id)
+        XCTAssertFalse(seeds.isEmpty)
+        let counts = visible.map { view in seeds.filter { view.contains($0) }.count }
+        // Ties go to the earliest keyframe
+        let best = try XCTUnwrap(counts.indices.max { counts[$0] != counts[$1] ? counts[$0] < counts[$1] : $0 > $1 })
+
+        // When
+        let found = ids(sut.landmarks(covisibleWith: seeds.map { NSNumber(value: $0) }, keyframeLimit: 1))
+
+        // Then
+        XCTAssertEqual(found, visible[best].union(seeds))
+    }
+
+    func testLandmarksCovisibleWith_MoreKeyframes_OnlyGrows() throws {
+        // Given
+        let seed = try XCTUnwrap(source.landmarks.first { keyframes(seeing: $0.id).count >= 2 }).id
+
+        // When
+        let results = (1...6).map { ids(sut.landmarks(covisibleWith: [NSNumber(value: seed)], keyframeLimit: $0)) }
+
+        // Then
+        for (smaller, larger) in zip(results, results.dropFirst()) {
+            XCTAssertTrue(smaller.isSubset(of: larger))
+        }
+        let everything = visible.reduce(into: Set<Int>()) { $0.formUnion($1) }
+        XCTAssertTrue(results.last!.isSubset(of: everything.union([seed])))
+    }
+
+    func testLandmarksCovisibleWith_UnseenOrUnknownSeeds_AreKeptOrIgnored() throws {
+        // Given
+        // Behind the cameras, so inside the indexed region but in no frustum
+        let unseen = try XCTUnwrap(source.landmarks.first { $0.position.z > 70 && keyframes(seeing: $0.id).isEmpty }).id
+
+        // When
+        let found = ids(sut.landmarks(covisibleWith: [NSNumber(value: unseen), NSNumber(value: 999_999)], keyframeLimit: 4))
+
+        // Then
+        XCTAssertEqual(found, [unseen])
+    }
+
+    func testLandmarksCovisibleWith_ZeroKeyframes_ReturnsSeeds() throws {
+        // Given
+        let seed = try XCTUnwrap(source.landmarks.first { !keyframes(seeing: $0.id).isEmpty }).id
+
+        // When
+        let found = ids(sut.landmarks(covisibleWith: [NSNumber(value: seed)], keyframeLimit: 0))
+
+        // Then
+        XCTAssertEqual(found, [seed])
+    }
+}
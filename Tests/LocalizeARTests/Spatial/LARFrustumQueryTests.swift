@@ -0,0 +1,181 @@
+//
+//  LARFrustumQueryTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for frustum queries
+/// Validates that landmarks behind the camera, outside its padded view or facing away from it
+/// are dropped, against a brute-force projection of every landmark in the region
+final class LARFrustumQueryTests: XCTestCase {
+    private let camera = SIMD3(50.0, 1.5, 50.0)
+
+    // MARK: - Helpers
+
+    private var intrinsics: simd_float3x3 {
+        let f = Float(SyntheticFrames.focalLength), c = SIMD2<Float>(SyntheticFrames.principalPoint)
+        return simd_float3x3(columns: (SIMD3(f, 0, 0), SIMD3(0, f, 0), SIMD3(c.x, c.y, 1)))
+    }
+
+    /// Camera at `position` turned by `yaw` about y, then tilted by `pitch` about its x axis
+    private func pose(at position: SIMD3<Double>, yaw: Double = 0, pitch: Double = 0) -> simd_double4x4 {
+        let rotation = simd_quatd(angle: yaw, axis: SIMD3(0, 1, 0)) * simd_quatd(angle: pitch, axis: SIMD3(1, 0, 0))
+        var transform = simd_double4x4(rotation)
+        transform.columns.3 = SIMD4(position, 1)
+        return transform
+    }
+
+    private func ids(_ landmarks: [LARLandmark]) -> Set<Int> {
+        Set(landmarks.map { Int($0.id) })
+    }
+
+    /// Reference frustum test: projects the landmark into the camera as the query's
+    /// documentation describes it, with the far plane at the region's diameter
+    private func accepts(_ query: LARFrustumQuery, position: SIMD3<Double>, orientation: SIMD3<Float>) -> Bool {
+        let point = query.cameraTransform.inverse * SIMD4(position, 1)
+        let depth = -point.z
+        guard depth >= 0.1 && depth <= query.region.diameter else { return false }
+        let f = SIMD2(Double(query.intrinsics.columns.0.x), Double(query.intrinsics.columns.1.y))
+        let c = SIMD2(Double(query.intrinsics.columns.2.x), Double(query.intrinsics.columns.2.y))
+        let u = f.x * point.x / depth + c.x
+        let v = -f.y * point.y / depth + c.y
+        let size = 2 * c
+        guard u >= -query.padding * size.x && u <= (1 + query.padding) * size.x &&
+              v >= -query.padding * size.y && v <= (1 + query.padding) * size.y else { return false }
+        guard orientation != .zero else { return true }
+        let cameraPosition = SIMD3(query.cameraTransform.columns.3.x, query.cameraTransform.columns.3.y,
+                                   query.cameraTransform.columns.3.z)
+        let toCamera = simd_normalize(cameraPosition - position)
+        return simd_dot(toCamera, SIMD3<Double>(orientation)) >= cos(query.maxViewAngle) * Double(simd_length(orientation))
+    }
+
+    /// A map of `positions` with the matching orientations, ids in order
+    private func makeMap(_ landmarks: [(position: SIMD3<Double>, orientation: SIMD3<Float>)]) -> LARMap {
+        let map = LARMap()
+        for (id, landmark) in landmarks.enumerated() {
+            let center = SIMD2(landmark.position.x, landmark.position.z)
+            XCTAssertTrue(map.addLandmark(id: id, position: landmark.position, boundsLower: center - 0.5,
+                                          boundsUpper: center + 0.5, descriptor: Data(repeating: 1, count: 128),
+                                          sightings: 1, lastSeen: 0))
+            XCTAssertTrue(map.updateLandmark(id: id, orientation: landmark.orientation))
+        }
+        return map
+    }
+
+    /// Frustum query over a region centered `ahead` meters down -z from the camera
+    private func query(_ transform: simd_double4x4, diameter: Double = 20, ahead: Double = 0) -> LARFrustumQuery {
+        LARFrustumQuery(region: LARSpatialQuery(x: transform.columns.3.x, z: transform.columns.3.z - ahead, diameter: diameter),
+                        cameraTransform: transform, intrinsics: intrinsics)
+    }
+
+    // MARK: - Depth Tests
+
+    func testFrustumQuery_BehindCameraOrOutsideDepthRange_IsDropped() {
+        // Given
+        // Straight ahead at 5 m and just short of the far plane, just behind, closer than the
+        // near plane, just past the far plane, and to the side of the camera at zero depth; the
+        // region reaches from the camera to 30 m ahead, so every one of them is in it
+        let map = makeMap([
+            (camera + SIMD3(0, 0, -5), .zero),
+            (camera + SIMD3(0, 0, -29.5), .zero),
+            (camera + SIMD3(0, 0, 0.4), .zero),
+            (camera + SIMD3(0, 0, -0.05), .zero),
+            (camera + SIMD3(0, 0, -30.3), .zero),
+            (camera + SIMD3(3, 0, 0), .zero),
+        ])
+        let frustum = query(pose(at: camera), diameter: 30, ahead: 15)
+        XCTAssertEqual(ids(map.landmarks(for: frustum.region)), Set(0..<6))
+
+        // When
+        let found = map.landmarks(for: frustum)
+
+        // Then
+        XCTAssertEqual(ids(found), [0, 1])
+    }
+
+    func testFrustumQuery_CameraTurnedAround_SeesWhatWasBehind() {
+        // Given
+        let map = makeMap([(camera + SIMD3(0, 0, -5), .zero), (camera + SIMD3(0, 0, 5), .zero)])
+
+        // When
+        let found = map.landmarks(for: query(pose(at: camera, yaw: .pi)))
+
+        // Then
+        XCTAssertEqual(ids(found), [1])
+    }
+
+    // MARK: - View Angle Tests
+
+    func testFrustumQuery_LandmarkFacingAway_IsDropped() {
+        // Given
+        // All straight ahead; the default view angle is ~70°
+        let ahead = camera + SIMD3(0, 0, -5)
+        func facing(_ degrees: Float) -> SIMD3<Float> {
+            let radians = degrees * .pi / 180
+            return SIMD3(sin(radians), 0, cos(radians))
+        }
+        let map = makeMap([
+            (ahead, facing(0)),
+            (ahead, facing(60)),
+            (ahead, facing(80)),
+            (ahead, facing(180)),
+            (ahead, .zero),
+            (ahead, 3 * facing(-30)),
+        ])
+
+        // When
+        let found = map.landmarks(for: query(pose(at: camera)))
+
+        // Then
+        // A zero orientation was never set and passes; the length of the orientation doesn't matter
+        XCTAssertEqual(ids(found), [0, 1, 4, 5])
+    }
+
+    // MARK: - Brute-Force Tests
+
+    func testFrustumQuery_RandomPoses_MatchBruteForce() {
+        // Given
+        let source = SyntheticMap(count: 5000, heights: -2...6, reach: 0.5)
+        var rng = SplitMix64(seed: 7)
+        let orientations = source.landmarks.map { _ -> SIMD3<Float> in
+            // Every tenth landmark has no orientation
+            guard Int.random(in: 0..<10, using: &rng) > 0 else { return .zero }
+            return simd_normalize(SIMD3(Float.random(in: -1...1, using: &rng), Float.random(in: -0.3...0.3, using: &rng),
+                                        Float.random(in: -1...1, using: &rng)))
+        }
+        let map = makeMap(zip(source.landmarks, orientations).map { (position: $0.position, orientation: $1) })
+        var inRegion = 0, behind = 0, facingAway = 0
+
+        for _ in 0..<60 {
+            let transform = pose(at: SIMD3(Double.random(in: 10...90, using: &rng), Double.random(in: 0...3, using: &rng),
+                                           Double.random(in: 10...90, using: &rng)),
+                                 yaw: Double.random(in: -.pi...(.pi), using: &rng), pitch: Double.random(in: -0.3...0.3, using: &rng))
+            let frustum = query(transform, diameter: 25)
+
+            // When
+            let found = ids(map.landmarks(for: frustum))
+
+            // Then
+            let candidates = map.landmarks(for: frustum.region)
+            let expected = candidates.filter {
+                accepts(frustum, position: $0.position, orientation: orientations[Int($0.id)])
+            }
+            XCTAssertEqual(found, ids(expected))
+            inRegion += candidates.count
+            for landmark in candidates {
+                let point = transform.inverse * SIMD4(landmark.position, 1)
+                if point.z > 0 { behind += 1 }
+                if point.z < 0 && !accepts(frustum, position: landmark.position, orientation: orientations[Int(landmark.id)]) &&
+                    accepts(frustum, position: landmark.position, orientation: .zero) {
+                    facingAway += 1
+                }
+            }
+        }
+        // Both reasons to drop a landmark came up often enough to be checked
+        XCTAssertGreaterThan(behind, inRegion / 5)
+        XCTAssertGreaterThan(facingAway, 100)
+    }
+}
@@ -0,0 +1,157 @@
+//
+//  LARHeightLayerTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for height layer detection and floor queries
+/// Validates detected layers against the floors a map was generated with, and floor query
+/// results against a brute-force height filter
+final class LARHeightLayerTests: XCTestCase {
+
+    // MARK: - Helpers
+
+    /// Landmarks spread over the x/z extent of every floor, at heights within its range
+    private func landmarks(floors: [ClosedRange<Double>], perFloor: Int = 1500) -> [SyntheticMap.Landmark] {
+        floors.enumerated().flatMap { floor, heights in
+            SyntheticMap(count: perFloor, heights: heights, seed: UInt64(floor + 1)).landmarks.map {
+                SyntheticMap.Landmark(id: floor * perFloor + $0.id, position: $0.position, boundsLower: $0.boundsLower,
+                                      boundsUpper: $0.boundsUpper, descriptor: $0.descriptor, sightings: $0.sightings,
+                                      lastSeen: $0.lastSeen)
+            }
+        }
+    }
+
+    private func layers(of map: LARMap) -> [ClosedRange<Double>] {
+        (0..<map.heightLayerCount).map { layer in
+            var lower = 0.0, upper = 0.0
+            map.heightLayer(at: layer, lower: &lower, upper: &upper)
+            return lower...upper
+        }
+    }
+
+    /// Checks one layer per floor, each holding its floor's heights and no other floor's.
+    /// Percentile clipping may leave out a few of the lowest and highest landmarks.
+    private func assertLayers(_ map: LARMap, match floors: [ClosedRange<Double>], of source: SyntheticMap,
+                              file: StaticString = #filePath, line: UInt = #line) {
+        let detected = layers(of: map)
+        XCTAssertEqual(detected.count, floors.count, file: file, line: line)
+        let clipped = Int(0.001 * Double(source.landmarks.count))
+        for (layer, floor) in zip(detected, floors) {
+            let heights = source.landmarks.map(\.position.y).filter { floor.contains($0) }
+            XCTAssertGreaterThanOrEqual(heights.filter { layer.contains($0) }.count, heights.count - clipped, file: file, line: line)
+            for other in floors where other != floor {
+                XCTAssertFalse(layer.overlaps(other), "\(layer) reaches into \(other)", file: file, line: line)
+            }
+        }
+    }
+
+    // MARK: - Detection Tests
+
+    func testHeightLayers_TwoFloors_DetectsBoth() {
+        // Given
+        let floors = [0.2...2.6, 4.0...6.6]
+        let source = SyntheticMap(landmarks: landmarks(floors: floors))
+
+        // Then
+        assertLayers(source.makeMap(), match: floors, of: source)
+    }
+
+    func testHeightLayers_ThreeFloors_DetectsEachBottomToTop() {
+        // Given
+        let floors = [-4.0...(-1.5), 0.0...2.5, 4.0...6.5]
+        let source = SyntheticMap(landmarks: landmarks(floors: floors, perFloor: 1000))
+
+        // Then
+        assertLayers(source.makeMap(), match: floors, of: source)
+    }
+
+    func testHeightLayers_OutliersAndNonFiniteHeights_AreIgnored() {
+        // Given
+        let floors = [0.2...2.6, 4.0...6.6]
+        var all = landmarks(floors: floors)
+        for (i, y) in [1e9, -1e9, .nan, .infinity, -.infinity].enumerated() {
+            all.append(SyntheticMap.Landmark(id: 10_000 + i, position: SIMD3(50, y, 50), boundsLower: SIMD2(49, 49),
+                                             boundsUpper: SIMD2(51, 51), descriptor: Data(), sightings: 1, lastSeen: 0))
+        }
+        let source = SyntheticMap(landmarks: all)
+
+        // Then
+        assertLayers(source.makeMap(), match: floors, of: source)
+    }
+
+    func testHeightLayers_EmptyMap_HasNone() {
+        // Given
+        let map = LARMap()
+        var lower = 0.0, upper = 0.0
+
+        // When
+        map.heightLayer(at: 0, lower: &lower, upper: &upper)
+
+        // Then
+        XCTAssertEqual(map.heightLayerCount, 0)
+        XCTAssertEqual(lower, -.infinity)
+        XCTAssertEqual(upper, .infinity)
+    }
+
+    // MARK: - Floor Query Tests
+
+    func testFloorQuery_PicksLayerAtOrNearestCameraHeight() {
+        // Given
+        let map = SyntheticMap(landmarks: landmarks(floors: [0.2...2.6, 4.0...6.6])).makeMap()
+        let detected = layers(of: map)
+        XCTAssertEqual(detected.count, 2)
+        let region = LARSpatialQuery(x: 50, z: 50, diameter: 30)
+
+        for cameraHeight in [-10, 0.3, 1.5, 2.9, 3.7, 5.2, 40] {
+            // When
+            let query = map.floorQuery(for: region, cameraHeight: cameraHeight)
+
+            // Then
+            let distances = detected.map { max(0, $0.lowerBound - cameraHeight, cameraHeight - $0.upperBound) }
+            let nearest = detected[distances.firstIndex(of: distances.min()!)!]
+            XCTAssertEqual(query.minY, nearest.lowerBound - 0.3, accuracy: 1e-9, "Camera at \(cameraHeight)")
+            XCTAssertEqual(query.maxY, nearest.upperBound + 0.3, accuracy: 1e-9, "Camera at \(cameraHeight)")
+        }
+    }
+
+    func testFloorQuery_SingleFloor_IsUnbounded() {
+        // Given
+        let map = SyntheticMap(count: 2000, heights: 0...3).makeMap()
+
+        // When
+        let query = map.floorQuery(for: LARSpatialQuery(x: 50, z: 50, diameter: 30), cameraHeight: 1.5)
+
+        // Then
+        XCTAssertEqual(map.heightLayerCount, 1)
+        XCTAssertEqual(query.minY, -.infinity)
+        XCTAssertEqual(query.maxY, .infinity)
+    }
+
+    func testLandmarksForFloorQuery_MatchScanFilteredByHeight() {
+        // Given
+        let source = SyntheticMap(landmarks: landmarks(floors: [0.2...2.6, 4.0...6.6]))
+        let map = source.makeMap()
+        var rng = SplitMix64(seed: 5)
+
+        for _ in 0..<30 {
+            let region = LARSpatialQuery(x: Double.random(in: 0...100, using: &rng), z: Double.random(in: 0...100, using: &rng),
+                                         diameter: 20)
+            let query = map.floorQuery(for: region, cameraHeight: Double.random(in: 0...7, using: &rng))
+
+            // When
+            let found = Set(map.landmarks(for: query).map { Int($0.id) })
+
+            // Then
+            let inRegion = source.idsIntersecting(region)
+            let expected = source.landmarks.filter {
+                inRegion.contains($0.id) && $0.position.y >= query.minY && $0.position.y <= query.maxY
+            }
+            XCTAssertEqual(found, Set(expected.map(\.id)))
+            // The other floor is left out
+            XCTAssertLessThan(found.count, inRegion.count)
+        }
+    }
+}
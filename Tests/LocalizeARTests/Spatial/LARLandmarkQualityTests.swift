@@ -0,0 +1,140 @@
+//
+//  LARLandmarkQualityTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for ranking landmarks by quality score
+/// Validates per-cell selections against scores computed from sightings, recency and view spread
+final class LARLandmarkQualityTests: XCTestCase {
+
+    // MARK: - Helpers
+
+    /// Reference quality score; `spread` is nil until a covisibility graph scored the map
+    private func score(_ landmark: SyntheticMap.Landmark, in source: SyntheticMap, spread: Double? = nil) -> Double {
+        let lastSeen = source.landmarks.map(\.lastSeen)
+        let oldest = lastSeen.min()!, span = Double(lastSeen.max()! - oldest)
+        let sightings = 1 - exp(-Double(max(landmark.sightings, 0)) / 10)
+        let recency = span > 0 ? Double(landmark.lastSeen - oldest) / span : 1
+        guard let spread else { return (0.5 * sightings + 0.25 * recency) / 0.75 }
+        return 0.5 * sightings + 0.25 * recency + 0.25 * min(1, spread / 0.26)
+    }
+
+    private func cell(_ landmark: SyntheticMap.Landmark, size: Double) -> SIMD2<Int> {
+        SIMD2(Int(floor(landmark.position.x / size)), Int(floor(landmark.position.z / size)))
+    }
+
+    /// Checks that every cell kept `perCell` of its landmarks, and none scoring better than
+    /// the ones kept
+    private func assertBestPerCell(_ found: [LARLandmark], of candidates: [SyntheticMap.Landmark], perCell: Int, cellSize: Double,
+                                   score: (SyntheticMap.Landmark) -> Double, file: StaticString = #filePath, line: UInt = #line) {
+        let kept = Set(found.map { Int($0.id) })
+        XCTAssertEqual(kept.count, found.count, "Duplicates", file: file, line: line)
+        XCTAssertTrue(kept.isSubset(of: candidates.map(\.id)), file: file, line: line)
+        for (_, landmarks) in Dictionary(grouping: candidates, by: { cell($0, size: cellSize) }) {
+            let (inside, outside) = (landmarks.filter { kept.contains($0.id) }, landmarks.filter { !kept.contains($0.id) })
+            XCTAssertEqual(inside.count, min(landmarks.count, perCell), file: file, line: line)
+            // Scores are stored in single precision
+            if let worstKept = inside.map(score).min(), let bestDropped = outside.map(score).max() {
+                XCTAssertLessThanOrEqual(bestDropped, worstKept + 1e-6, file: file, line: line)
+            }
+        }
+    }
+
+    // MARK: - Ranking Tests
+
+    func testLandmarksPerCell_KeepBestScoringInEveryCell() {
+        // Given
+        let source = SyntheticMap(count: 3000)
+        let map = source.makeMap()
+
+        for (query, perCell, cellSize) in [(LARSpatialQuery(x: 50, z: 50, diameter: 40), 3, 5.0),
+                                           (LARSpatialQuery(x: 20, z: 70, diameter: 25), 1, 2.5),
+                                           (LARSpatialQuery(x: 50, z: 50, diameter: 120), 10, 20)] {
+            // When
+            let found = map.landmarks(for: query, perCell: perCell, cellSize: cellSize)
+
+            // Then
+            let candidates = source.landmarks.filter { source.idsIntersecting(query).contains($0.id) }
+            assertBestPerCell(found, of: candidates, perCell: perCell, cellSize: cellSize) { score($0, in: source) }
+        }
+    }
+
+    func testLandmarksPerCell_CellsAcrossZero_AreFloored() {
+        // Given
+        let landmarks = (0..<40).map { i in
+            let position = SIMD3(Double(i % 8) - 4.25, 0, Double(i / 8) - 2.5)
+            return SyntheticMap.Landmark(id: i, position: position, boundsLower: SIMD2(position.x, position.z) - 0.1,
+                                         boundsUpper: SIMD2(position.x, position.z) + 0.1, descriptor: Data(),
+                                         sightings: Int32(i % 13), lastSeen: Int64(i % 7))
+        }
+        let source = SyntheticMap(landmarks: landmarks)
+
+        // When
+        let found = source.makeMap().landmarks(for: LARSpatialQuery(x: 0, z: 0, diameter: 20), perCell: 2, cellSize: 2)
+
+        // Then
+        assertBestPerCell(found, of: landmarks, perCell: 2, cellSize: 2) { score($0, in: source) }
+    }
+
+    func testLandmarksPerCell_LargeBudget_ReturnsWholeQuery() {
+        // Given
+        let source = SyntheticMap(count: 500, seed: 2)
+        let query = LARSpatialQuery(x: 50, z: 50, diameter: 30)
+
+        // When
+        let found = source.makeMap().landmarks(for: query, perCell: 1000, cellSize: 10)
+
+        // Then
+        XCTAssertEqual(Set(found.map { Int($0.id) }), source.idsIntersecting(query))
+    }
+
+    func testLandmarksPerCell_InvalidArguments_ReturnNothing() {
+        // Given
+        let map = SyntheticMap(count: 100, seed: 3).makeMap()
+        let query = LARSpatialQuery(x: 50, z: 50, diameter: 100)
+
+        // Then
+        XCTAssertTrue(map.landmarks(for: query, perCell: 0, cellSize: 10).isEmpty)
+        XCTAssertTrue(map.landmarks(for: query, perCell: -1, cellSize: 10).isEmpty)
+        XCTAssertTrue(map.landmarks(for: query, perCell: 5, cellSize: 0).isEmpty)
+        XCTAssertTrue(LARMap().landmarks(for: query, perCell: 5, cellSize: 10).isEmpty)
+    }
+
+    // MARK: - View Spread Tests
+
+    func testScoreLandmarks_RanksByViewSpread() throws {
+        // Given
+        // Equal sightings and recency, so only the spread of the keyframes seeing them differs
+        let random = SyntheticMap(count: 2000, extent: 100, reach: 1, seed: 4)
+        let source = SyntheticMap(landmarks: random.landmarks.map {
+            SyntheticMap.Landmark(id: $0.id, position: $0.position, boundsLower: $0.boundsLower, boundsUpper: $0.boundsUpper,
+                                  descriptor: $0.descriptor, sightings: 5, lastSeen: 0)
+        })
+        let map = source.makeMap()
+        let frames = SyntheticFrames(from: SIMD3(20, 1.5, 60), step: 0.2, count: 300)
+        let graph = try XCTUnwrap(LARCovisibilityGraph(map: map, frames: frames.frames))
+        let keyframes = frames.keyframePositions()
+
+        // When
+        graph.scoreLandmarks()
+        let query = LARSpatialQuery(x: 50, z: 50, diameter: 60)
+        let found = map.landmarks(for: query, perCell: 2, cellSize: 5)
+
+        // Then
+        // The angular radius of the directions towards the keyframes that see a landmark
+        func spread(_ landmark: SyntheticMap.Landmark) -> Double {
+            let directions = keyframes.filter { SyntheticFrames.sees($0, landmark.position) }
+                .map { simd_normalize($0 - landmark.position) }
+            guard directions.count >= 2 else { return 0 }
+            let mean = directions.reduce(SIMD3<Double>(), +) / Double(directions.count)
+            return acos(min(1, simd_length(mean)))
+        }
+        let candidates = source.landmarks.filter { source.idsIntersecting(query).contains($0.id) }
+        XCTAssertTrue(candidates.contains { spread($0) > 0 })
+        assertBestPerCell(found, of: candidates, perCell: 2, cellSize: 5) { score($0, in: source, spread: spread($0)) }
+    }
+}
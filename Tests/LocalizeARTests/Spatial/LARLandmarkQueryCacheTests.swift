@@ -0,0 +1,156 @@
+//
+//  LARLandmarkQueryCacheTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for LARLandmarkQueryCache
+/// Validates results and enter/exit sets of a moving query against brute-force set differences
+final class LARLandmarkQueryCacheTests: XCTestCase {
+    private var source: SyntheticMap!
+    private var map: LARMap!
+    private var sut: LARLandmarkQueryCache!
+
+    override func setUp() {
+        source = SyntheticMap(count: 3000, extent: 200)
+        map = source.makeMap()
+        sut = LARLandmarkQueryCache(map: map)
+    }
+
+    // MARK: - Helpers
+
+    private func ids(_ landmarks: [LARLandmark]) -> Set<Int> {
+        Set(landmarks.map { Int($0.id) })
+    }
+
+    /// Moves the cache to `query` and checks it against the scan, returning whether the
+    /// update was incremental
+    @discardableResult
+    private func move(to query: LARSpatialQuery, from previous: LARSpatialQuery?,
+                      file: StaticString = #filePath, line: UInt = #line) -> Bool {
+        let incremental = sut.update(for: query)
+        let expected = source.idsIntersecting(query)
+        XCTAssertEqual(ids(sut.landmarks), expected, file: file, line: line)
+        XCTAssertEqual(sut.landmarkCount, expected.count, file: file, line: line)
+        XCTAssertEqual(sut.lastUpdateWasIncremental, incremental, file: file, line: line)
+        if incremental, let previous {
+            let before = source.idsIntersecting(previous)
+            XCTAssertEqual(ids(sut.addedLandmarks), expected.subtracting(before), "Entered", file: file, line: line)
+            XCTAssertEqual(ids(sut.removedLandmarks), before.subtracting(expected), "Exited", file: file, line: line)
+            XCTAssertEqual(sut.addedLandmarks.count, ids(sut.addedLandmarks).count, file: file, line: line)
+        } else {
+            XCTAssertEqual(ids(sut.addedLandmarks), expected, file: file, line: line)
+            XCTAssertTrue(sut.removedLandmarks.isEmpty, file: file, line: line)
+        }
+        return incremental
+    }
+
+    // MARK: - Incremental Update Tests
+
+    func testUpdate_Walking_EnterAndExitSetsMatchScan() {
+        // Given
+        var rng = SplitMix64(seed: 7)
+        var query = LARSpatialQuery(x: 100, z: 100, diameter: 25)
+        XCTAssertFalse(move(to: query, from: nil))
+
+        for _ in 0..<80 {
+            // When
+            let previous = query
+            query.x += Double.random(in: -3...3, using: &rng)
+            query.z += Double.random(in: -3...3, using: &rng)
+
+            // Then
+            XCTAssertTrue(move(to: query, from: previous))
+        }
+        XCTAssertEqual(sut.incrementalUpdateCount, 80)
+        XCTAssertEqual(sut.fullUpdateCount, 1)
+    }
+
+    func testUpdate_GrowingAndShrinking_EnterAndExitSetsMatchScan() {
+        // Given
+        var query = LARSpatialQuery(x: 60, z: 140, diameter: 10)
+        move(to: query, from: nil)
+
+        for diameter in [20.0, 40, 15, 5, 30, 30] {
+            // When
+            let previous = query
+            query.diameter = diameter
+
+            // Then
+            XCTAssertTrue(move(to: query, from: previous))
+        }
+    }
+
+    func testUpdate_OverlappingCorner_IsIncremental() {
+        // Given
+        let first = LARSpatialQuery(x: 50, z: 50, diameter: 20)
+        move(to: first, from: nil)
+
+        // When
+        let corner = LARSpatialQuery(x: 65, z: 65, diameter: 20)
+
+        // Then
+        XCTAssertTrue(move(to: corner, from: first))
+    }
+
+    // MARK: - Full Update Tests
+
+    func testUpdate_JumpWithoutOverlap_SearchesFromScratch() {
+        // Given
+        let first = LARSpatialQuery(x: 20, z: 20, diameter: 20)
+        move(to: first, from: nil)
+
+        // When
+        let incremental = move(to: LARSpatialQuery(x: 150, z: 150, diameter: 20), from: first)
+
+        // Then
+        XCTAssertFalse(incremental)
+        XCTAssertEqual(sut.fullUpdateCount, 2)
+    }
+
+    func testUpdate_AfterReset_SearchesFromScratch() {
+        // Given
+        let first = LARSpatialQuery(x: 100, z: 100, diameter: 20)
+        move(to: first, from: nil)
+
+        // When
+        sut.reset()
+        let incremental = move(to: LARSpatialQuery(x: 101, z: 100, diameter: 20), from: first)
+
+        // Then
+        XCTAssertFalse(incremental)
+    }
+
+    func testUpdate_AfterMapChanged_SearchesFromScratchAndSeesNewLandmark() {
+        // Given
+        let first = LARSpatialQuery(x: 100, z: 100, diameter: 20)
+        move(to: first, from: nil)
+        let added = SyntheticMap.Landmark(id: 50_000, position: SIMD3(100, 1, 100), boundsLower: SIMD2(99, 99),
+                                          boundsUpper: SIMD2(101, 101), descriptor: Data(), sightings: 1, lastSeen: 0)
+        XCTAssertTrue(map.addLandmark(id: added.id, position: added.position, boundsLower: added.boundsLower,
+                                      boundsUpper: added.boundsUpper, descriptor: nil, sightings: 1, lastSeen: 0))
+        source = SyntheticMap(landmarks: source.landmarks + [added])
+
+        // When
+        let incremental = move(to: LARSpatialQuery(x: 100.5, z: 100, diameter: 20), from: first)
+
+        // Then
+        XCTAssertFalse(incremental)
+        XCTAssertTrue(ids(sut.landmarks).contains(added.id))
+    }
+
+    func testUpdate_EmptyMap_ReturnsNothing() {
+        // Given
+        let sut = LARLandmarkQueryCache(map: LARMap())
+
+        // When
+        let incremental = sut.update(for: LARSpatialQuery(x: 0, z: 0, diameter: 10))
+
+        // Then
+        XCTAssertFalse(incremental)
+        XCTAssertTrue(sut.landmarks.isEmpty)
+        XCTAssertTrue(sut.addedLandmarks.isEmpty)
+    }
+}
@@ -0,0 +1,115 @@
+//
+//  LARLandmarkSnapshotTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for the immutable landmark snapshots queries are answered from
+/// Validates that landmarks a reader holds keep their version while a writer changes the map
+/// and publishes new ones
+final class LARLandmarkSnapshotTests: XCTestCase {
+
+    // MARK: - Helpers
+
+    private func ids(_ landmarks: [LARLandmark]) -> Set<Int> {
+        Set(landmarks.map { Int($0.id) })
+    }
+
+    private func locked<T>(_ lock: NSLock, _ body: () -> T) -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return body()
+    }
+
+    private func add(_ landmark: SyntheticMap.Landmark, id: Int? = nil, to map: LARMap) {
+        XCTAssertTrue(map.addLandmark(id: id ?? landmark.id, position: landmark.position, boundsLower: landmark.boundsLower,
+                                      boundsUpper: landmark.boundsUpper, descriptor: landmark.descriptor,
+                                      sightings: landmark.sightings, lastSeen: landmark.lastSeen))
+    }
+
+    // MARK: - Version Tests
+
+    func testHeldLandmarks_WriterChangesMap_KeepTheirVersion() {
+        // Given
+        let source = SyntheticMap(count: 1000)
+        let map = source.makeMap()
+        let query = LARSpatialQuery(x: 50, z: 50, diameter: 40)
+        let held = map.landmarks(for: query)
+        let heldVersion = map.publishedLandmarkVersion
+
+        // When
+        let added = SyntheticMap(count: 500, seed: 2)
+        for landmark in added.landmarks { add(landmark, id: 1000 + landmark.id, to: map) }
+        let rewritten = source.landmarks[Int(held[0].id)]
+        XCTAssertTrue(map.updateLandmark(id: rewritten.id, descriptor: Data(rewritten.descriptor.map { ~$0 })))
+        let current = map.landmarks(for: query)
+
+        // Then
+        XCTAssertGreaterThan(map.publishedLandmarkVersion, heldVersion)
+        XCTAssertEqual(ids(current), source.idsIntersecting(query).union(added.idsIntersecting(query).map { 1000 + $0 }))
+        XCTAssertEqual(ids(held), source.idsIntersecting(query))
+        for landmark in held {
+            XCTAssertEqual(landmark.position, source.landmarks[Int(landmark.id)].position)
+        }
+    }
+
+    func testDescriptorRewrittenInPlace_PublishesNewVersion() {
+        // Given
+        let source = SyntheticMap(count: 100, seed: 3)
+        let map = source.makeMap()
+        _ = map.landmark(id: 0)
+        let before = map.publishedLandmarkVersion
+
+        // When
+        // Same length and count, so only the change counter tells the versions apart
+        XCTAssertTrue(map.updateLandmark(id: 0, descriptor: Data(repeating: 7, count: source.landmarks[0].descriptor.count)))
+        _ = map.landmark(id: 0)
+
+        // Then
+        XCTAssertGreaterThan(map.publishedLandmarkVersion, before)
+    }
+
+    // MARK: - Concurrency Tests
+
+    func testReaders_WhileWriterAdds_SeeWholeVersions() {
+        // Given
+        // Landmarks are added in id order, so any whole version holds ids 0..<count
+        let source = SyntheticMap(count: 1500, seed: 4)
+        let map = LARMap()
+        for landmark in source.landmarks[..<100] { add(landmark, to: map) }
+        let everything = LARSpatialQuery(x: 50, z: 50, diameter: 200)
+        let lock = NSLock()
+        var done = false, failures: [String] = [], reads = 0
+
+        // When
+        let readers = DispatchGroup()
+        for _ in 0..<4 {
+            DispatchQueue.global().async(group: readers) {
+                var previous = 0
+                while !self.locked(lock, { done }) {
+                    let found = map.landmarks(for: everything)
+                    let seen = Set(found.map { Int($0.id) })
+                    let failure = seen != Set(0..<found.count) ? "Partial version of \(found.count) landmarks"
+                        : found.count < previous ? "Went back from \(previous) to \(found.count) landmarks" : nil
+                    let mismatched = found.first { $0.position != source.landmarks[Int($0.id)].position }
+                    previous = found.count
+                    self.locked(lock) {
+                        reads += 1
+                        if let failure { failures.append(failure) }
+                        if let mismatched { failures.append("Landmark \(mismatched.id) moved") }
+                    }
+                }
+            }
+        }
+        for landmark in source.landmarks[100...] { add(landmark, to: map) }
+        locked(lock) { done = true }
+        readers.wait()
+
+        // Then
+        XCTAssertEqual(failures, [])
+        XCTAssertGreaterThan(reads, 0)
+        XCTAssertEqual(map.landmarks(for: everything).count, source.landmarks.count)
+    }
+}
@@ -0,0 +1,134 @@
+//
+//  LARMortonOrderTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for the Morton (Z-order) layout of archived landmarks
+/// Validates archive row order against a reference Morton sort of the landmark positions
+final class LARMortonOrderTests: XCTestCase {
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    /// Reference order: x/z quantized to 32 bits over the points' extent with one scale for
+    /// both axes, x on the even bits of the code and z on the odd; ties keep input order
+    private func mortonOrder(_ landmarks: [SyntheticMap.Landmark]) -> [Int] {
+        let points = landmarks.map { SIMD2($0.position.x, $0.position.z) }
+        let lower = points.reduce(points[0]) { pointwiseMin($0, $1) }
+        let upper = points.reduce(points[0]) { pointwiseMax($0, $1) }
+        let scale = Double(UInt32.max) / max((upper - lower).max(), 1e-9)
+        func quantize(_ value: Double, _ lower: Double) -> UInt64 {
+            UInt64(min(max(((value - lower) * scale).rounded(.down), 0), Double(UInt32.max)))
+        }
+        let codes = points.map { point -> UInt64 in
+            let x = quantize(point.x, lower.x), z = quantize(point.y, lower.y)
+            return (0..<32).reduce(UInt64(0)) { code, bit in
+                code | (((x >> bit) & 1) << (2 * bit)) | (((z >> bit) & 1) << (2 * bit + 1))
+            }
+        }
+        let order = points.indices.sorted { codes[$0] != codes[$1] ? codes[$0] < codes[$1] : $0 < $1 }
+        return order.map { landmarks[$0].id }
+    }
+
+    /// Landmark ids in the order their descriptor rows appear in the archive
+    private func archivedOrder(of source: SyntheticMap) throws -> [Int] {
+        let path = directory.appendingPathComponent("map.larmap").path
+        XCTAssertTrue(source.makeMap().writeArchive(to: path))
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let offsets = try source.landmarks.map { try XCTUnwrap(data.range(of: $0.descriptor)).lowerBound }
+        return source.landmarks.indices.sorted { offsets[$0] < offsets[$1] }.map { source.landmarks[$0].id }
+    }
+
+    private func landmark(_ id: Int, x: Double, z: Double, descriptorByte: UInt8) -> SyntheticMap.Landmark {
+        SyntheticMap.Landmark(id: id, position: SIMD3(x, 0, z), boundsLower: SIMD2(x, z) - 1, boundsUpper: SIMD2(x, z) + 1,
+                              descriptor: Data(repeating: descriptorByte, count: 128), sightings: 1, lastSeen: 0)
+    }
+
+    // MARK: - Archive Order Tests
+
+    func testWriteArchive_RowsFollowMortonCurve() throws {
+        // Given
+        // Ids are assigned in random spatial order
+        let source = SyntheticMap(count: 2000)
+
+        // When
+        let order = try archivedOrder(of: source)
+
+        // Then
+        XCTAssertEqual(order, mortonOrder(source.landmarks))
+    }
+
+    func testWriteArchive_Quadrants_VisitedInZOrder() throws {
+        // Given
+        // The corners of a square, inserted in the reverse of curve order
+        let source = SyntheticMap(landmarks: [
+            landmark(0, x: 10, z: 10, descriptorByte: 1),
+            landmark(1, x: 0, z: 10, descriptorByte: 2),
+            landmark(2, x: 10, z: 0, descriptorByte: 3),
+            landmark(3, x: 0, z: 0, descriptorByte: 4),
+        ])
+
+        // When
+        let order = try archivedOrder(of: source)
+
+        // Then
+        XCTAssertEqual(order, [3, 2, 1, 0])
+    }
+
+    func testWriteArchive_QueriesTouchFewerPagesThanIdOrder() throws {
+        // Given
+        let source = SyntheticMap(count: 4000, extent: 200, reach: 2, seed: 2)
+        let rows = Dictionary(uniqueKeysWithValues: try archivedOrder(of: source).enumerated().map { ($1, $0) })
+        // 32 descriptor rows of 128 bytes per 4 KB page
+        func pages(_ ids: Set<Int>, row: (Int) -> Int) -> Int {
+            Set(ids.map { row($0) / 32 }).count
+        }
+
+        var rng = SplitMix64(seed: 2)
+        var mortonPages = 0, idPages = 0
+        for _ in 0..<100 {
+            // When
+            let query = LARSpatialQuery(x: Double.random(in: 0...200, using: &rng), z: Double.random(in: 0...200, using: &rng),
+                                        diameter: 15)
+            let hits = source.idsIntersecting(query)
+            mortonPages += pages(hits) { rows[$0]! }
+            idPages += pages(hits) { $0 }
+        }
+
+        // Then
+        XCTAssertLessThan(mortonPages, idPages / 2)
+    }
+
+    // MARK: - Query Tests
+
+    func testWriteArchive_LoadedBack_QueriesMatchScan() throws {
+        // Given
+        let source = SyntheticMap(count: 1500, seed: 3)
+        let path = directory.appendingPathComponent("map.larmap").path
+        XCTAssertTrue(source.makeMap().writeArchive(to: path))
+
+        for lazy in [false, true] {
+            let map = try XCTUnwrap(LARMap(contentsOf: path, lazy: lazy))
+            var rng = SplitMix64(seed: 3)
+            for _ in 0..<50 {
+                // When
+                let query = LARSpatialQuery(x: Double.random(in: 0...100, using: &rng), z: Double.random(in: 0...100, using: &rng),
+                                            diameter: Double.random(in: 1...30, using: &rng))
+
+                // Then
+                XCTAssertEqual(Set(map.landmarks(for: query).map { Int($0.id) }), source.idsIntersecting(query))
+            }
+        }
+    }
+}
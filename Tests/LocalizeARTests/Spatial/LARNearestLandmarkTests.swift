@@ -0,0 +1,130 @@
+//
+//  LARNearestLandmarkTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for nearest, radius and id lookups of landmarks
+/// Validates the k-d tree results against a brute-force scan of landmark positions
+final class LARNearestLandmarkTests: XCTestCase {
+
+    // MARK: - Helpers
+
+    private func randomPoints(count: Int, seed: UInt64) -> [SIMD3<Double>] {
+        var rng = SplitMix64(seed: seed)
+        return (0..<count).map { _ in
+            SIMD3(Double.random(in: -10...110, using: &rng), Double.random(in: -2...5, using: &rng),
+                  Double.random(in: -10...110, using: &rng))
+        }
+    }
+
+    /// Ids ordered by distance to `point`, the reference for both queries
+    private func idsByDistance(_ source: SyntheticMap, to point: SIMD3<Double>) -> [(id: Int, distance: Double)] {
+        source.landmarks.map { ($0.id, simd_distance($0.position, point)) }.sorted { $0.1 < $1.1 }
+    }
+
+    private func ids(_ landmarks: [LARLandmark]) -> [Int] {
+        landmarks.map { Int($0.id) }
+    }
+
+    // MARK: - Nearest Tests
+
+    func testNearestLandmarks_MatchScanInOrder() {
+        // Given
+        let source = SyntheticMap(count: 2000)
+        let map = source.makeMap()
+
+        for point in randomPoints(count: 50, seed: 1) {
+            for count in [1, 5, 32] {
+                // When
+                let found = ids(map.nearestLandmarks(to: point, count: count))
+
+                // Then
+                XCTAssertEqual(found, idsByDistance(source, to: point).prefix(count).map(\.id))
+            }
+        }
+    }
+
+    func testNearestLandmarks_CountBeyondSize_ReturnsEveryLandmark() {
+        // Given
+        let source = SyntheticMap(count: 10, seed: 2)
+        let map = source.makeMap()
+
+        // When
+        let found = map.nearestLandmarks(to: SIMD3(0, 0, 0), count: 100)
+
+        // Then
+        XCTAssertEqual(ids(found), idsByDistance(source, to: SIMD3(0, 0, 0)).map(\.id))
+        XCTAssertTrue(map.nearestLandmarks(to: SIMD3(0, 0, 0), count: 0).isEmpty)
+        XCTAssertTrue(LARMap().nearestLandmarks(to: SIMD3(0, 0, 0), count: 5).isEmpty)
+    }
+
+    // MARK: - Radius Tests
+
+    func testLandmarksWithinRadius_MatchScanInOrder() {
+        // Given
+        let source = SyntheticMap(count: 2000, seed: 3)
+        let map = source.makeMap()
+
+        for point in randomPoints(count: 50, seed: 3) {
+            for radius in [0.5, 4, 15] {
+                // When
+                let found = ids(map.landmarks(within: radius, of: point))
+
+                // Then
+                XCTAssertEqual(found, idsByDistance(source, to: point).filter { $0.distance <= radius }.map(\.id))
+            }
+        }
+    }
+
+    func testLandmarksWithinRadius_TiledMapWithColdTiles_FindsEveryLandmark() throws {
+        // Given
+        let directory = try makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let source = SyntheticMap(count: 3000, extent: 100, seed: 4)
+        XCTAssertTrue(source.makeMap().writeTiles(to: directory.path, tileSize: 10))
+
+        for point in randomPoints(count: 20, seed: 4) {
+            // A fresh map for every point, so no tile was paged in by an earlier query
+            let map = try XCTUnwrap(LARMap(tileDirectory: directory.path, memoryBudget: 1 << 30))
+
+            // When
+            let found = ids(map.landmarks(within: 12, of: point))
+
+            // Then
+            XCTAssertEqual(found, idsByDistance(source, to: point).filter { $0.distance <= 12 }.map(\.id))
+        }
+    }
+
+    // MARK: - Id Lookup Tests
+
+    func testLandmarkWithId_FindsEveryLandmarkAndNothingElse() {
+        // Given
+        let source = SyntheticMap(count: 500, seed: 5)
+        let map = source.makeMap()
+
+        // Then
+        for expected in source.landmarks {
+            let landmark = map.landmark(id: expected.id)
+            XCTAssertEqual(landmark?.position, expected.position)
+        }
+        XCTAssertNil(map.landmark(id: 500))
+        XCTAssertNil(map.landmark(id: -1))
+    }
+
+    func testLandmarkWithId_AfterAddingLandmark_FindsIt() {
+        // Given
+        let map = SyntheticMap(count: 100, seed: 6).makeMap()
+        XCTAssertNil(map.landmark(id: 1000))
+
+        // When
+        XCTAssertTrue(map.addLandmark(id: 1000, position: SIMD3(1, 2, 3), boundsLower: SIMD2(0, 0), boundsUpper: SIMD2(2, 4),
+                                      descriptor: nil, sightings: 1, lastSeen: 0))
+
+        // Then
+        XCTAssertEqual(map.landmark(id: 1000)?.position, SIMD3(1, 2, 3))
+    }
+}
@@ -0,0 +1,209 @@
+//
+//  LARSpatialQueryTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for landmark queries on the packed R-tree
+/// Validates query results against a brute-force scan of the landmark bounds
+final class LARSpatialQueryTests: XCTestCase {
+
+    // MARK: - Helpers
+
+    private func randomQueries(count: Int, extent: Double, seed: UInt64) -> [LARSpatialQuery] {
+        var rng = SplitMix64(seed: seed)
+        return (0..<count).map { _ in
+            LARSpatialQuery(x: Double.random(in: -10...(extent + 10), using: &rng),
+                            z: Double.random(in: -10...(extent + 10), using: &rng),
+                            diameter: Double.random(in: 0...30, using: &rng))
+        }
+    }
+
+    private func ids(_ landmarks: [LARLandmark]) -> [Int] {
+        landmarks.map { Int($0.id) }
+    }
+
+    private func assertMatchesScan(_ map: LARMap, _ source: SyntheticMap, queries: [LARSpatialQuery],
+                                   file: StaticString = #filePath, line: UInt = #line) {
+        for query in queries {
+            let found = ids(map.landmarks(for: query))
+            XCTAssertEqual(found.count, Set(found).count, "Duplicate results", file: file, line: line)
+            XCTAssertEqual(Set(found), source.idsIntersecting(query), file: file, line: line)
+        }
+    }
+
+    // MARK: - Query Tests
+
+    func testLandmarksForQuery_RandomQueries_MatchScan() {
+        for count in [1, 2, 17, 64, 1000, 5000] {
+            // Given
+            let source = SyntheticMap(count: count, seed: UInt64(count))
+            let map = source.makeMap()
+
+            // Then
+            assertMatchesScan(map, source, queries: randomQueries(count: 100, extent: 100, seed: UInt64(count)))
+        }
+    }
+
+    func testLandmarksForQuery_EmptyMap_FindsNothing() {
+        // Given
+        let map = LARMap()
+
+        // When
+        let found = map.landmarks(for: LARSpatialQuery(x: 0, z: 0, diameter: 1000))
+
+        // Then
+        XCTAssertTrue(found.isEmpty)
+    }
+
+    func testLandmarksForQuery_OutsideMap_FindsNothing() {
+        // Given
+        let map = SyntheticMap(count: 500).makeMap()
+
+        // When
+        let found = map.landmarks(for: LARSpatialQuery(x: 1000, z: -1000, diameter: 50))
+
+        // Then
+        XCTAssertTrue(found.isEmpty)
+    }
+
+    func testLandmarksForQuery_CoveringMap_FindsEveryLandmark() {
+        // Given
+        let source = SyntheticMap(count: 800, seed: 2)
+        let map = source.makeMap()
+
+        // When
+        let found = ids(map.landmarks(for: LARSpatialQuery(x: 50, z: 50, diameter: 200)))
+
+        // Then
+        XCTAssertEqual(found.sorted(), source.landmarks.map(\.id))
+    }
+
+    func testLandmarksForQuery_PointQueryInsideBounds_FindsLandmark() {
+        // Given
+        let source = SyntheticMap(count: 300, seed: 3)
+        let map = source.makeMap()
+
+        for landmark in source.landmarks.prefix(50) {
+            // When
+            let found = ids(map.landmarks(for: LARSpatialQuery(x: landmark.position.x, z: landmark.position.z, diameter: 0)))
+
+            // Then
+            XCTAssertTrue(found.contains(landmark.id))
+        }
+    }
+
+    func testLandmarksForQuery_AfterAddingLandmarks_SeesNewLandmarks() {
+        // Given
+        let source = SyntheticMap(count: 400, seed: 4)
+        let first = SyntheticMap(landmarks: Array(source.landmarks.prefix(200)))
+        let map = first.makeMap()
+        let queries = randomQueries(count: 50, extent: 100, seed: 4)
+        assertMatchesScan(map, first, queries: queries)
+
+        // When
+        for landmark in source.landmarks.dropFirst(200) {
+            XCTAssertTrue(map.addLandmark(id: landmark.id, position: landmark.position, boundsLower: landmark.boundsLower,
+                                          boundsUpper: landmark.boundsUpper, descriptor: landmark.descriptor,
+                                          sightings: landmark.sightings, lastSeen: landmark.lastSeen))
+        }
+
+        // Then
+        assertMatchesScan(map, source, queries: queries)
+    }
+
+    func testLandmarksForQuery_HeldResults_SurviveMapChanges() {
+        // Given
+        let source = SyntheticMap(count: 100, seed: 5)
+        let map = source.makeMap()
+        let held = map.landmarks(for: LARSpatialQuery(x: 50, z: 50, diameter: 200))
+        let positions = held.map(\.position)
+
+        // When
+        XCTAssertTrue(map.addLandmark(id: 1_000, position: SIMD3(1, 1, 1), boundsLower: SIMD2(0, 0), boundsUpper: SIMD2(2, 2),
+                                      descriptor: nil, sightings: 1, lastSeen: 0))
+        _ = map.landmarks(for: LARSpatialQuery(x: 50, z: 50, diameter: 200))
+
+        // Then
+        XCTAssertEqual(held.map(\.position), positions)
+    }
+
+    // MARK: - Tiled Map Tests
+
+    func testLandmarksForQuery_TiledMap_MatchesScan() throws {
+        // Given
+        let directory = try makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let source = SyntheticMap(count: 2000, extent: 200, seed: 6)
+        XCTAssertTrue(source.makeMap().writeTiles(to: directory.path, tileSize: 25))
+        let map = try XCTUnwrap(LARMap(tileDirectory: directory.path, memoryBudget: 1 << 30))
+
+        // Then
+        assertMatchesScan(map, source, queries: randomQueries(count: 100, extent: 200, seed: 6))
+    }
+
+    func testLandmarksForQuery_TiledMapUnderTightBudget_StillMatchesScan() throws {
+        // Given
+        let directory = try makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let source = SyntheticMap(count: 2000, extent: 200, seed: 7)
+        XCTAssertTrue(source.makeMap().writeTiles(to: directory.path, tileSize: 25))
+        let map = try XCTUnwrap(LARMap(tileDirectory: directory.path, memoryBudget: 1))
+
+        // Then
+        // Tiles a query needs are never evicted, so each result is complete
+        assertMatchesScan(map, source, queries: randomQueries(count: 50, extent: 200, seed: 7))
+        XCTAssertGreaterThan(map.tileEvictionCount, 0)
+    }
+
+    func testPrepare_Walking_CoreMapHoldsEveryPagedTileOnce() throws {
+        // Given
+        let directory = try makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let source = SyntheticMap(count: 2000, extent: 200, seed: 8)
+        XCTAssertTrue(source.makeMap().writeTiles(to: directory.path, tileSize: 25))
+        let map = try XCTUnwrap(LARMap(tileDirectory: directory.path, memoryBudget: 1 << 30))
+        // Tiles hold the landmarks positioned in their grid cell and extend over their bounds
+        let tiles = Dictionary(grouping: source.landmarks) {
+            SIMD2(Int(floor($0.position.x / 25)), Int(floor($0.position.z / 25)))
+        }.values.map { landmarks in
+            (count: landmarks.count,
+             lower: landmarks.map(\.boundsLower).reduce(landmarks[0].boundsLower) { pointwiseMin($0, $1) },
+             upper: landmarks.map(\.boundsUpper).reduce(landmarks[0].boundsUpper) { pointwiseMax($0, $1) })
+        }
+        var paged = Set<Int>()
+
+        for step in 0..<40 {
+            // When
+            // Each step pages in a few new tiles next to the ones already resident
+            let query = LARSpatialQuery(x: Double(step) * 5, z: 100, diameter: 20)
+            map.prepare(for: query)
+
+            // Then
+            for (index, tile) in tiles.enumerated() where
+                tile.upper.x >= query.x - 10 && tile.lower.x <= query.x + 10 &&
+                tile.upper.y >= query.z - 10 && tile.lower.y <= query.z + 10 {
+                paged.insert(index)
+            }
+            XCTAssertEqual(map.materializedLandmarkCount, paged.reduce(0) { $0 + tiles[$1].count }, "Step \(step)")
+        }
+        XCTAssertEqual(map.tileEvictionCount, 0)
+    }
+
+    func testWriteTiles_PositionOffTheGrid_Fails() throws {
+        // Given
+        let directory = try makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        for x in [Double.nan, .infinity, 1e300] {
+            let map = SyntheticMap(count: 10, seed: 9).makeMap()
+            XCTAssertTrue(map.addLandmark(id: 100, position: SIMD3(x, 0, 0), boundsLower: SIMD2(0, 0), boundsUpper: SIMD2(1, 1),
+                                          descriptor: nil, sightings: 1, lastSeen: 0))
+
+            // Then
+            XCTAssertFalse(map.writeTiles(to: directory.path, tileSize: 25), "x = \(x)")
+        }
+    }
+}
@@ -0,0 +1,146 @@
+//
+//  LARFrameIndexTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for the memory-mapped frame index (frames.larframes)
+/// Validates that frames written to an index read back field for field, and that the index
+/// converts to and from frames.json without changing a frame
+final class LARFrameIndexTests: XCTestCase {
+    private var directory: URL!
+    private var frames: [LARFrame]!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+        frames = makeFrames(count: 300)
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    /// SyntheticFrames positions, turned about random axes, with millisecond timestamps and
+    /// intrinsics that vary from frame to frame
+    private func makeFrames(count: Int) -> [LARFrame] {
+        let walk = SyntheticFrames(from: SIMD3(-12.5, 1.5, 40.25), step: 0.1, count: count)
+        var rng = SplitMix64(seed: 1)
+        return walk.frames.map { frame in
+            let axis = simd_normalize(SIMD3<Float>(Float.random(in: -1...1, using: &rng), 1, Float.random(in: -1...1, using: &rng)))
+            var extrinsics = simd_float4x4(simd_quatf(angle: Float.random(in: -.pi...(.pi), using: &rng), axis: axis))
+            extrinsics.columns.3 = frame.extrinsics.columns.3
+            var intrinsics = frame.intrinsics
+            intrinsics.columns.0.x += Float.random(in: -5...5, using: &rng)
+            intrinsics.columns.2.y += Float.random(in: -2...2, using: &rng)
+            return LARFrame(id: 1000 + frame.frameId, timestamp: 1_700_000_000_000 + 33 * frame.timestamp,
+                            intrinsics: intrinsics, extrinsics: extrinsics)
+        }
+    }
+
+    private func path(_ name: String) -> String {
+        directory.appendingPathComponent(name).path
+    }
+
+    private func assertEqual(_ frame: LARFrame, _ expected: LARFrame, file: StaticString = #filePath, line: UInt = #line) {
+        XCTAssertEqual(frame.frameId, expected.frameId, file: file, line: line)
+        XCTAssertEqual(frame.timestamp, expected.timestamp, file: file, line: line)
+        XCTAssertEqual(frame.intrinsics, expected.intrinsics, "Frame \(expected.frameId)", file: file, line: line)
+        XCTAssertEqual(frame.extrinsics, expected.extrinsics, "Frame \(expected.frameId)", file: file, line: line)
+    }
+
+    private func assertEqual(_ frames: [LARFrame], _ expected: [LARFrame], file: StaticString = #filePath, line: UInt = #line) {
+        XCTAssertEqual(frames.count, expected.count, file: file, line: line)
+        for (frame, expected) in zip(frames, expected) {
+            assertEqual(frame, expected, file: file, line: line)
+        }
+    }
+
+    private func writeIndex(_ frames: [LARFrame], to name: String = "frames.larframes") throws -> LARFrameIndex {
+        XCTAssertTrue(LARFrameIndex.write(frames, to: path(name)))
+        return try XCTUnwrap(LARFrameIndex(contentsOf: path(name)))
+    }
+
+    // MARK: - Round-Trip Tests
+
+    func testWrite_ReadBack_MatchesEveryField() throws {
+        // When
+        let index = try writeIndex(frames)
+
+        // Then
+        XCTAssertEqual(index.count, frames.count)
+        for (i, expected) in frames.enumerated() {
+            XCTAssertEqual(index.frameId(at: i), expected.frameId)
+            XCTAssertEqual(index.timestamp(at: i), expected.timestamp)
+            XCTAssertEqual(index.intrinsics(at: i), expected.intrinsics)
+            XCTAssertEqual(index.extrinsics(at: i), expected.extrinsics)
+            assertEqual(index.frame(at: i), expected)
+        }
+        assertEqual(index.frames(in: NSRange(location: 0, length: frames.count)), frames)
+    }
+
+    func testFramesInRange_PastTheEnd_IsClamped() throws {
+        // Given
+        let index = try writeIndex(frames)
+
+        // Then
+        assertEqual(index.frames(in: NSRange(location: 250, length: 100)), Array(frames[250...]))
+        XCTAssertEqual(index.frames(in: NSRange(location: 400, length: 10)).count, 0)
+    }
+
+    func testWrite_NoFrames_ReadsBackEmpty() throws {
+        XCTAssertEqual(try writeIndex([]).count, 0)
+    }
+
+    // MARK: - JSON Conversion Tests
+
+    func testWriteJSON_MatchesIndexAndLoadsTheSameFrames() throws {
+        // Given
+        let index = try writeIndex(frames)
+
+        // When
+        XCTAssertTrue(index.writeJSON(to: path("frames.json")))
+
+        // Then
+        XCTAssertFalse(LARFrameIndex.isFrameIndex(path("frames.json")))
+        let fromJSON = try XCTUnwrap(LARFrame.loadFrames(fromFile: path("frames.json")))
+        let fromIndex = try XCTUnwrap(LARFrame.loadFrames(fromFile: path("frames.larframes")))
+        assertEqual(fromJSON, frames)
+        assertEqual(fromIndex, frames)
+    }
+
+    func testConvertJSON_RoundTrip_WritesIdenticalIndex() throws {
+        // Given
+        _ = try writeIndex(frames)
+        XCTAssertTrue(try XCTUnwrap(LARFrameIndex(contentsOf: path("frames.larframes"))).writeJSON(to: path("frames.json")))
+
+        // When
+        XCTAssertTrue(LARFrameIndex.convertJSON(path("frames.json"), to: path("converted.larframes")))
+
+        // Then
+        XCTAssertTrue(LARFrameIndex.isFrameIndex(path("converted.larframes")))
+        let converted = try XCTUnwrap(LARFrameIndex(contentsOf: path("converted.larframes")))
+        assertEqual(converted.frames(in: NSRange(location: 0, length: converted.count)), frames)
+        XCTAssertEqual(try Data(contentsOf: URL(fileURLWithPath: path("converted.larframes"))),
+                       try Data(contentsOf: URL(fileURLWithPath: path("frames.larframes"))))
+    }
+
+    // MARK: - Validation Tests
+
+    func testOpen_JSONOrTruncatedIndex_ReturnsNil() throws {
+        // Given
+        let index = try writeIndex(frames)
+        XCTAssertTrue(index.writeJSON(to: path("frames.json")))
+        let data = try Data(contentsOf: URL(fileURLWithPath: path("frames.larframes")))
+        try data.prefix(data.count - 100).write(to: URL(fileURLWithPath: path("truncated.larframes")))
+
+        // Then
+        XCTAssertNil(LARFrameIndex(contentsOf: path("frames.json")))
+        XCTAssertNil(LARFrameIndex(contentsOf: path("truncated.larframes")))
+        XCTAssertNil(LARFrameIndex(contentsOf: path("missing.larframes")))
+    }
+}
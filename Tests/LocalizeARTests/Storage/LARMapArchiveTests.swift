@@ -0,0 +1,202 @@
+//
+//  LARMapArchiveTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+@testable import LocalizeAR
+
+/// Tests for the binary map archive (map.larmap)
+/// Validates that archives round-trip every landmark field and that corruption is detected
+final class LARMapArchiveTests: XCTestCase {
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    private func writeArchive(of source: SyntheticMap) -> String {
+        let path = directory.appendingPathComponent("map.larmap").path
+        XCTAssertTrue(source.makeMap().writeArchive(to: path))
+        return path
+    }
+
+    private func assertMatches(_ map: LARMap, _ source: SyntheticMap, file: StaticString = #filePath, line: UInt = #line) {
+        XCTAssertEqual(map.landmarks.count, source.landmarks.count, file: file, line: line)
+        for expected in source.landmarks {
+            guard let landmark = map.landmark(id: expected.id) else {
+                XCTFail("Landmark \(expected.id) is missing", file: file, line: line)
+                continue
+            }
+            XCTAssertEqual(landmark.position, expected.position, file: file, line: line)
+            XCTAssertEqual(landmark.boundsLower, expected.boundsLower, file: file, line: line)
+            XCTAssertEqual(landmark.boundsUpper, expected.boundsUpper, file: file, line: line)
+            XCTAssertEqual(landmark.sightings, expected.sightings, file: file, line: line)
+            XCTAssertEqual(landmark.lastSeen, expected.lastSeen, file: file, line: line)
+        }
+    }
+
+    /// Offset of the section table entry for `kind` (32-byte entries after the 64-byte header:
+    /// kind, flags, offset, size, checksum)
+    private func tableEntry(_ kind: UInt32, in data: Data) throws -> Int {
+        let count = Int(data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: 12, as: UInt32.self) })
+        let entry = (0..<count).map { 64 + 32 * $0 }.first { offset in
+            data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: offset, as: UInt32.self) } == kind
+        }
+        return try XCTUnwrap(entry, "No section \(kind)")
+    }
+
+    private func store<T>(_ value: T, at offset: Int, in data: inout Data) {
+        withUnsafeBytes(of: value) { data.replaceSubrange(offset..<offset + $0.count, with: $0) }
+    }
+
+    private func load<T>(_ type: T.Type, at offset: Int, in data: Data) -> T {
+        data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: offset, as: type) }
+    }
+
+    // MARK: - Round-Trip Tests
+
+    func testWriteArchive_LoadedBack_PreservesLandmarksAndFingerprint() throws {
+        // Given
+        let source = SyntheticMap(count: 500)
+        let path = writeArchive(of: source)
+
+        // When
+        let loaded = try XCTUnwrap(LARMap(contentsOf: path))
+
+        // Then
+        XCTAssertTrue(LARMap.verifyArchive(at: path))
+        assertMatches(loaded, source)
+        // The fingerprint covers descriptors too
+        XCTAssertEqual(loaded.fingerprint, source.makeMap().fingerprint)
+    }
+
+    func testWriteArchive_LoadedLazilyOrOnThreads_MatchesEagerLoad() throws {
+        // Given
+        let source = SyntheticMap(count: 300, seed: 2)
+        let path = writeArchive(of: source)
+        let expected = source.makeMap().fingerprint
+
+        // When
+        let lazy = try XCTUnwrap(LARMap(contentsOf: path, lazy: true))
+        let parallel = try XCTUnwrap(LARMap(contentsOf: path, threads: 4))
+
+        // Then
+        assertMatches(lazy, source)
+        assertMatches(parallel, source)
+        XCTAssertEqual(lazy.fingerprint, expected)
+        XCTAssertEqual(parallel.fingerprint, expected)
+    }
+
+    func testWriteArchive_EmptyMap_RoundTrips() throws {
+        // Given
+        let path = writeArchive(of: SyntheticMap(count: 0))
+
+        // When
+        let loaded = try XCTUnwrap(LARMap(contentsOf: path))
+
+        // Then
+        XCTAssertTrue(loaded.landmarks.isEmpty)
+        XCTAssertTrue(LARMap.verifyArchive(at: path))
+    }
+
+    // MARK: - Corruption Tests
+
+    func testVerifyArchive_FlippedDescriptorByte_FailsChecksum() throws {
+        // Given
+        let source = SyntheticMap(count: 200, seed: 3)
+        let path = writeArchive(of: source)
+        var data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let descriptor = try XCTUnwrap(data.range(of: source.landmarks[100].descriptor))
+
+        // When
+        data[descriptor.lowerBound + 7] ^= 0x40
+        try data.write(to: URL(fileURLWithPath: path))
+
+        // Then
+        XCTAssertFalse(LARMap.verifyArchive(at: path))
+    }
+
+    func testLoad_TruncatedArchive_ReturnsNil() throws {
+        // Given
+        let path = writeArchive(of: SyntheticMap(count: 200, seed: 4))
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+
+        // When
+        try data.prefix(data.count / 2).write(to: URL(fileURLWithPath: path))
+
+        // Then
+        XCTAssertNil(LARMap(contentsOf: path))
+        XCTAssertFalse(LARMap.verifyArchive(at: path))
+    }
+
+    func testLoad_NotAnArchive_ReturnsNil() throws {
+        // Given
+        let path = directory.appendingPathComponent("garbage.larmap").path
+        try Data(repeating: 0x5A, count: 4096).write(to: URL(fileURLWithPath: path))
+
+        // Then
+        XCTAssertNil(LARMap(contentsOf: path))
+        XCTAssertFalse(LARMap.verifyArchive(at: path))
+    }
+
+    func testLoad_FixedRecordOfWrongSize_ReturnsNil() throws {
+        // Section kinds: 6 DescriptorInfo, 10 Origin
+        for kind: UInt32 in [6, 10] {
+            // Given
+            let path = writeArchive(of: SyntheticMap(count: 50, seed: 5))
+            var data = try Data(contentsOf: URL(fileURLWithPath: path))
+            let entry = try tableEntry(kind, in: data)
+
+            // When
+            // One record short: reading it in place would run into the next section
+            store(load(UInt64.self, at: entry + 16, in: data) - 8, at: entry + 16, in: &data)
+            try data.write(to: URL(fileURLWithPath: path))
+
+            // Then
+            XCTAssertNil(LARMap(contentsOf: path), "Section \(kind)")
+            XCTAssertNil(LARMap(contentsOf: path, lazy: true), "Section \(kind)")
+        }
+    }
+
+    func testLoad_DescriptorInfoWithoutDescriptors_IsSizeChecked() throws {
+        // Given
+        let path = writeArchive(of: SyntheticMap(count: 50, seed: 6))
+        var data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let info = try tableEntry(6, in: data)
+        let descriptors = try tableEntry(7, in: data)
+
+        // When
+        // Descriptors renamed to an unknown kind, so only the layout info is left to read
+        store(UInt32(99), at: descriptors, in: &data)
+        store(UInt64(4), at: info + 16, in: &data)
+        try data.write(to: URL(fileURLWithPath: path))
+
+        // Then
+        XCTAssertNil(LARMap(contentsOf: path))
+    }
+
+    func testLoad_UnsupportedDescriptorType_ReturnsNil() throws {
+        // Given
+        let path = writeArchive(of: SyntheticMap(count: 50, seed: 7))
+        var data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let info = Int(load(UInt64.self, at: try tableEntry(6, in: data) + 8, in: data))
+        XCTAssertEqual(load(Int32.self, at: info, in: data), 0, "CV_8U")
+
+        for type: Int32 in [2, 6, 8, -1] {
+            // When
+            // CV_16U, CV_64F, CV_8UC2 and garbage
+            store(type, at: info, in: &data)
+            try data.write(to: URL(fileURLWithPath: path))
+
+            // Then
+            XCTAssertNil(LARMap(contentsOf: path), "Type \(type)")
+        }
+    }
+}
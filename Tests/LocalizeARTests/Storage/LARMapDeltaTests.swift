@@ -0,0 +1,259 @@
+//
+//  LARMapDeltaTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for map delta export and apply
+/// Validates that a delta turns its base into the target map and is rejected by any other map
+final class LARMapDeltaTests: XCTestCase {
+    private var directory: URL!
+    private var deltaPath: String!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+        deltaPath = directory.appendingPathComponent("update.larmap").path
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    /// The base with every tenth landmark removed, every seventh moved, every fifth seen again
+    /// and 30 new landmarks
+    private func makeTarget(from base: SyntheticMap) -> SyntheticMap {
+        var landmarks: [SyntheticMap.Landmark] = []
+        for landmark in base.landmarks where !landmark.id.isMultiple(of: 10) {
+            let moved = landmark.id.isMultiple(of: 7) ? landmark.position + SIMD3(0.5, -0.25, 1) : landmark.position
+            let seen = landmark.id.isMultiple(of: 5)
+            landmarks.append(SyntheticMap.Landmark(id: landmark.id, position: moved, boundsLower: landmark.boundsLower,
+                                                   boundsUpper: landmark.boundsUpper, descriptor: landmark.descriptor,
+                                                   sightings: landmark.sightings + (seen ? 1 : 0),
+                                                   lastSeen: landmark.lastSeen + (seen ? 100 : 0)))
+        }
+        let added = SyntheticMap(count: 30, seed: 99).landmarks.map {
+            SyntheticMap.Landmark(id: $0.id + 10_000, position: $0.position, boundsLower: $0.boundsLower,
+                                  boundsUpper: $0.boundsUpper, descriptor: $0.descriptor,
+                                  sightings: $0.sightings, lastSeen: $0.lastSeen)
+        }
+        return SyntheticMap(landmarks: landmarks + added)
+    }
+
+    private func assertLandmarks(of map: LARMap, equal reference: SyntheticMap, file: StaticString = #filePath, line: UInt = #line) {
+        XCTAssertEqual(Set(map.landmarks.map { Int($0.id) }), Set(reference.landmarks.map(\.id)), file: file, line: line)
+        for expected in reference.landmarks {
+            guard let landmark = map.landmark(id: expected.id) else { continue }
+            XCTAssertEqual(landmark.position, expected.position, file: file, line: line)
+            XCTAssertEqual(landmark.sightings, expected.sightings, file: file, line: line)
+            XCTAssertEqual(landmark.lastSeen, expected.lastSeen, file: file, line: line)
+        }
+    }
+
+    // MARK: - Apply Tests
+
+    func testApplyDelta_OnItsBase_ReproducesTarget() throws {
+        // Given
+        let baseSource = SyntheticMap(count: 300)
+        let targetSource = makeTarget(from: baseSource)
+        let base = baseSource.makeMap()
+        let target = targetSource.makeMap()
+        _ = target.createAnchor(matrix_identity_float4x4)
+        XCTAssertTrue(target.writeDelta(from: base, to: deltaPath))
+
+        // When
+        let applied = base.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertTrue(applied)
+        assertLandmarks(of: base, equal: targetSource)
+        XCTAssertEqual(base.anchors.count, 1)
+        XCTAssertEqual(base.fingerprint, target.fingerprint)
+    }
+
+    func testApplyDelta_OnArchiveLoadedBase_ReproducesTarget() throws {
+        // Given
+        let baseSource = SyntheticMap(count: 200, seed: 2)
+        let targetSource = makeTarget(from: baseSource)
+        let archivePath = directory.appendingPathComponent("map.larmap").path
+        XCTAssertTrue(baseSource.makeMap().writeArchive(to: archivePath))
+        let base = try XCTUnwrap(LARMap(contentsOf: archivePath, lazy: true))
+        let target = targetSource.makeMap()
+        XCTAssertTrue(target.writeDelta(from: base, to: deltaPath))
+
+        // When
+        let applied = base.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertTrue(applied)
+        assertLandmarks(of: base, equal: targetSource)
+        XCTAssertEqual(base.fingerprint, target.fingerprint)
+    }
+
+    func testApplyDelta_IdenticalMaps_IsANoOp() throws {
+        // Given
+        let source = SyntheticMap(count: 100, seed: 3)
+        let base = source.makeMap()
+        let fingerprint = base.fingerprint
+        XCTAssertTrue(source.makeMap().writeDelta(from: base, to: deltaPath))
+
+        // When
+        let applied = base.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertTrue(applied)
+        XCTAssertEqual(base.fingerprint, fingerprint)
+    }
+
+    // MARK: - Rejection Tests
+
+    func testApplyDelta_OnWrongBase_IsRejectedAndLeavesMapUnchanged() throws {
+        // Given
+        let baseSource = SyntheticMap(count: 200, seed: 4)
+        XCTAssertTrue(makeTarget(from: baseSource).makeMap().writeDelta(from: baseSource.makeMap(), to: deltaPath))
+        let otherSource = SyntheticMap(count: 200, seed: 5)
+        let other = otherSource.makeMap()
+        let fingerprint = other.fingerprint
+
+        // When
+        let applied = other.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertFalse(applied)
+        XCTAssertEqual(other.fingerprint, fingerprint)
+        assertLandmarks(of: other, equal: otherSource)
+    }
+
+    func testApplyDelta_Twice_SecondIsRejected() throws {
+        // Given
+        let baseSource = SyntheticMap(count: 150, seed: 6)
+        let base = baseSource.makeMap()
+        let target = makeTarget(from: baseSource).makeMap()
+        XCTAssertTrue(target.writeDelta(from: base, to: deltaPath))
+        XCTAssertTrue(base.applyDelta(at: deltaPath))
+
+        // When
+        let reapplied = base.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertFalse(reapplied)
+        XCTAssertEqual(base.fingerprint, target.fingerprint)
+    }
+
+    func testApplyDelta_CorruptedDelta_IsRejected() throws {
+        // Given
+        let baseSource = SyntheticMap(count: 150, seed: 7)
+        let base = baseSource.makeMap()
+        let fingerprint = base.fingerprint
+        let targetSource = makeTarget(from: baseSource)
+        XCTAssertTrue(targetSource.makeMap().writeDelta(from: base, to: deltaPath))
+        var data = try Data(contentsOf: URL(fileURLWithPath: deltaPath))
+        // A descriptor of one of the added landmarks, which the delta carries in full
+        let descriptor = try XCTUnwrap(data.range(of: try XCTUnwrap(targetSource.landmarks.last).descriptor))
+        data[descriptor.lowerBound + 3] ^= 0xFF
+        try data.write(to: URL(fileURLWithPath: deltaPath))
+
+        // When
+        let applied = base.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertFalse(applied)
+        XCTAssertEqual(base.fingerprint, fingerprint)
+    }
+
+    func testLoad_Delta_ReturnsNil() throws {
+        // Given
+        let baseSource = SyntheticMap(count: 50, seed: 8)
+        XCTAssertTrue(makeTarget(from: baseSource).makeMap().writeDelta(from: baseSource.makeMap(), to: deltaPath))
+
+        // Then
+        XCTAssertNil(LARMap(contentsOf: deltaPath))
+    }
+
+    // MARK: - Edge Callback Tests
+
+    /// A base with three anchors and an edge between the first two, and a target that moves
+    /// the edge to the last two
+    private func makeEdgeChange() throws -> (base: LARMap, target: LARMap) {
+        let source = SyntheticMap(count: 50, seed: 9)
+        let original = source.makeMap()
+        let anchors = (0..<3).map { i -> Int32 in
+            var transform = matrix_identity_float4x4
+            transform.columns.3 = SIMD4(Float(i), 0, 0, 1)
+            return original.createAnchor(transform).id
+        }
+        original.addEdge(from: anchors[0], to: anchors[1])
+        let archivePath = directory.appendingPathComponent("map.larmap").path
+        XCTAssertTrue(original.writeArchive(to: archivePath))
+        let base = try XCTUnwrap(LARMap(contentsOf: archivePath))
+        let target = try XCTUnwrap(LARMap(contentsOf: archivePath))
+        target.removeEdge(from: anchors[0], to: anchors[1])
+        target.addEdge(from: anchors[1], to: anchors[2])
+        XCTAssertTrue(target.writeDelta(from: base, to: deltaPath))
+        return (base, target)
+    }
+
+    func testApplyDelta_EdgeChanges_ReachDelegateOnceApplied() throws {
+        // Given
+        let (base, target) = try makeEdgeChange()
+        let recorder = EdgeRecorder()
+        base.delegate = recorder
+
+        // When
+        XCTAssertTrue(base.applyDelta(at: deltaPath))
+
+        // Then
+        XCTAssertEqual(base.edges, target.edges)
+        XCTAssertFalse(recorder.added.isEmpty)
+        XCTAssertFalse(recorder.removed.isEmpty)
+        for edge in recorder.added {
+            XCTAssertTrue(target.edges[NSNumber(value: edge.from)]?.contains(NSNumber(value: edge.to)) ?? false)
+        }
+    }
+
+    func testApplyDelta_TargetMismatch_SendsNoEdgeCallbacks() throws {
+        // Given
+        // The target fingerprint no longer matches what the delta produces; the section's
+        // checksum flag is cleared so the check that fails is the one after applying
+        let (base, _) = try makeEdgeChange()
+        let edges = base.edges
+        var data = try Data(contentsOf: URL(fileURLWithPath: deltaPath))
+        let sections = Int(data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: 12, as: UInt32.self) })
+        let entry = try XCTUnwrap((0..<sections).map { 64 + 32 * $0 }.first { offset in
+            data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: offset, as: UInt32.self) } == 13
+        })
+        let info = Int(data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: entry + 8, as: UInt64.self) })
+        data[entry + 4] = 0
+        data[info + 8] ^= 0x01
+        try data.write(to: URL(fileURLWithPath: deltaPath))
+        let recorder = EdgeRecorder()
+        base.delegate = recorder
+
+        // When
+        let applied = base.applyDelta(at: deltaPath)
+
+        // Then
+        XCTAssertFalse(applied)
+        XCTAssertEqual(base.edges, edges)
+        XCTAssertTrue(recorder.added.isEmpty, "\(recorder.added)")
+        XCTAssertTrue(recorder.removed.isEmpty, "\(recorder.removed)")
+    }
+}
+
+/// Records the edge callbacks a map sends its delegate
+private final class EdgeRecorder: NSObject, LARMapDelegate {
+    private(set) var added: [(from: Int32, to: Int32)] = []
+    private(set) var removed: [(from: Int32, to: Int32)] = []
+
+    func map(_ map: LARMap, didAddEdgeFrom fromId: Int32, to toId: Int32) {
+        added.append((fromId, toId))
+    }
+
+    func map(_ map: LARMap, didRemoveEdgeFrom fromId: Int32, to toId: Int32) {
+        removed.append((fromId, toId))
+    }
+}
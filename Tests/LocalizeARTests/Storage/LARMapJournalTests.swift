@@ -0,0 +1,237 @@
+//
+//  LARMapJournalTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for incremental saves through the map journal
+/// Validates that replaying the journal reproduces the saved map before and after compaction
+final class LARMapJournalTests: XCTestCase {
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    private func openJournaledMap() throws -> LARMap {
+        let map = LARMap()
+        XCTAssertTrue(map.openJournal(in: directory.path))
+        return map
+    }
+
+    /// A fresh map restored from the journal directory alone
+    private func replay() throws -> LARMap {
+        try openJournaledMap()
+    }
+
+    private func add(_ landmarks: ArraySlice<SyntheticMap.Landmark>, to map: LARMap) {
+        for landmark in landmarks {
+            XCTAssertTrue(map.addLandmark(id: landmark.id, position: landmark.position, boundsLower: landmark.boundsLower,
+                                          boundsUpper: landmark.boundsUpper, descriptor: landmark.descriptor,
+                                          sightings: landmark.sightings, lastSeen: landmark.lastSeen))
+        }
+    }
+
+    private func translation(_ x: Float, _ y: Float, _ z: Float) -> simd_float4x4 {
+        var transform = matrix_identity_float4x4
+        transform.columns.3 = SIMD4(x, y, z, 1)
+        return transform
+    }
+
+    private func waitForCompaction(of map: LARMap) {
+        let deadline = Date().addingTimeInterval(10)
+        while map.isCompactingJournal && Date() < deadline {
+            Thread.sleep(forTimeInterval: 0.01)
+        }
+        XCTAssertFalse(map.isCompactingJournal)
+    }
+
+    private func journalFiles() throws -> [String] {
+        try FileManager.default.contentsOfDirectory(atPath: directory.path).filter { $0.hasPrefix("map.journal.") }
+    }
+
+    // MARK: - Append and Replay Tests
+
+    func testSaveJournal_Replayed_ReproducesLandmarksAnchorsEdgesAndOrigin() throws {
+        // Given
+        let source = SyntheticMap(count: 120)
+        let map = try openJournaledMap()
+        add(source.landmarks[...], to: map)
+        let first = map.createAnchor(translation(1, 0, 2))
+        let second = map.createAnchor(translation(-3, 0, 4))
+        map.addEdge(from: first.id, to: second.id)
+        var origin = matrix_identity_double4x4
+        origin.columns.3 = SIMD4(10, 20, 30, 1)
+        map.updateOrigin(origin)
+
+        // When
+        XCTAssertTrue(map.saveJournal())
+        let replayed = try replay()
+
+        // Then
+        XCTAssertGreaterThan(map.pendingJournalBytes, 0)
+        XCTAssertEqual(replayed.landmarks.count, source.landmarks.count)
+        XCTAssertEqual(replayed.anchors.count, 2)
+        XCTAssertTrue(replayed.originReady)
+        XCTAssertEqual(replayed.fingerprint, map.fingerprint)
+    }
+
+    func testSaveJournal_SecondSave_AppendsOnlyChanges() throws {
+        // Given
+        let source = SyntheticMap(count: 200, seed: 2)
+        let map = try openJournaledMap()
+        add(source.landmarks[..<100], to: map)
+        XCTAssertTrue(map.saveJournal())
+        let afterFirstSave = map.pendingJournalBytes
+
+        // When
+        add(source.landmarks[100...], to: map)
+        let anchor = map.createAnchor(translation(0, 1, 0))
+        map.updateAnchor(anchor, transform: translation(0, 2, 0))
+        XCTAssertTrue(map.saveJournal())
+        XCTAssertTrue(map.saveJournal())
+
+        // Then
+        XCTAssertGreaterThan(map.pendingJournalBytes, afterFirstSave)
+        // An unchanged map appends nothing, so the second save adds about as much as the first
+        XCTAssertLessThan(map.pendingJournalBytes, afterFirstSave * 3)
+        let replayed = try replay()
+        XCTAssertEqual(replayed.landmarks.count, source.landmarks.count)
+        XCTAssertEqual(replayed.fingerprint, map.fingerprint)
+    }
+
+    func testSaveJournal_RemovedAnchor_IsGoneAfterReplay() throws {
+        // Given
+        let map = try openJournaledMap()
+        let kept = map.createAnchor(translation(1, 0, 0))
+        let removed = map.createAnchor(translation(2, 0, 0))
+        XCTAssertTrue(map.saveJournal())
+
+        // When
+        map.removeAnchor(removed)
+        XCTAssertTrue(map.saveJournal())
+
+        // Then
+        let replayed = try replay()
+        XCTAssertEqual(replayed.anchors.map(\.id), [kept.id])
+        XCTAssertEqual(replayed.fingerprint, map.fingerprint)
+    }
+
+    func testSaveJournal_DescriptorRewrittenInPlace_IsAppended() throws {
+        // Given
+        let source = SyntheticMap(count: 50, seed: 5)
+        let map = try openJournaledMap()
+        add(source.landmarks[...], to: map)
+        XCTAssertTrue(map.saveJournal())
+        let afterFirstSave = map.pendingJournalBytes
+
+        // When
+        // Same length, so the new bytes go into the landmark's existing buffer
+        let landmark = source.landmarks[7]
+        XCTAssertTrue(map.updateLandmark(id: landmark.id, descriptor: Data(landmark.descriptor.map { ~$0 })))
+        XCTAssertTrue(map.saveJournal())
+
+        // Then
+        XCTAssertGreaterThan(map.pendingJournalBytes, afterFirstSave)
+        let replayed = try replay()
+        XCTAssertEqual(replayed.fingerprint, map.fingerprint)
+        XCTAssertNotEqual(replayed.fingerprint, source.makeMap().fingerprint)
+    }
+
+    func testUpdateLandmark_UnknownIdOrOtherLength_IsRejected() throws {
+        // Given
+        let source = SyntheticMap(count: 10, seed: 6)
+        let map = try openJournaledMap()
+        add(source.landmarks[...], to: map)
+        let landmark = source.landmarks[0]
+
+        // Then
+        XCTAssertFalse(map.updateLandmark(id: 999_999, descriptor: landmark.descriptor))
+        XCTAssertFalse(map.updateLandmark(id: landmark.id, descriptor: landmark.descriptor.dropLast()))
+        XCTAssertEqual(map.fingerprint, source.makeMap().fingerprint)
+    }
+
+    // MARK: - Compaction Tests
+
+    func testCompactJournal_WritesSnapshotAndDropsCoveredJournals() throws {
+        // Given
+        let source = SyntheticMap(count: 150, seed: 3)
+        let map = try openJournaledMap()
+        add(source.landmarks[...], to: map)
+        XCTAssertTrue(map.saveJournal())
+        let covered = try journalFiles()
+
+        // When
+        XCTAssertTrue(map.compactJournal())
+        waitForCompaction(of: map)
+
+        // Then
+        XCTAssertEqual(map.pendingJournalBytes, 0)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: directory.appendingPathComponent("journal.larmap").path))
+        XCTAssertTrue(Set(try journalFiles()).isDisjoint(with: covered))
+        let replayed = try replay()
+        XCTAssertEqual(replayed.fingerprint, map.fingerprint)
+    }
+
+    func testCompactJournal_ChangesAfterCompaction_ReplayOnTopOfSnapshot() throws {
+        // Given
+        let source = SyntheticMap(count: 100, seed: 4)
+        let map = try openJournaledMap()
+        add(source.landmarks[..<60], to: map)
+        XCTAssertTrue(map.saveJournal())
+        XCTAssertTrue(map.compactJournal())
+        waitForCompaction(of: map)
+
+        // When
+        add(source.landmarks[60...], to: map)
+        _ = map.createAnchor(translation(5, 0, 5))
+        XCTAssertTrue(map.saveJournal())
+
+        // Then
+        let replayed = try replay()
+        XCTAssertEqual(replayed.landmarks.count, source.landmarks.count)
+        XCTAssertEqual(replayed.fingerprint, map.fingerprint)
+    }
+
+    func testSaveJournal_OverByteThreshold_Compacts() throws {
+        // Given
+        let source = SyntheticMap(count: 50, seed: 5)
+        let map = try openJournaledMap()
+        map.journalCompactionBytes = 1
+
+        // When
+        add(source.landmarks[...], to: map)
+        XCTAssertTrue(map.saveJournal())
+        waitForCompaction(of: map)
+
+        // Then
+        XCTAssertEqual(map.pendingJournalBytes, 0)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: directory.appendingPathComponent("journal.larmap").path))
+        XCTAssertEqual(try replay().fingerprint, map.fingerprint)
+    }
+
+    func testSaveJournal_UnderThresholds_DoesNotCompact() throws {
+        // Given
+        let map = try openJournaledMap()
+        map.journalCompactionBytes = 1 << 30
+        map.journalCompactionInterval = 3600
+
+        // When
+        add(SyntheticMap(count: 20, seed: 6).landmarks[...], to: map)
+        XCTAssertTrue(map.saveJournal())
+
+        // Then
+        XCTAssertFalse(map.isCompactingJournal)
+        XCTAssertGreaterThan(map.pendingJournalBytes, 0)
+        XCTAssertFalse(FileManager.default.fileExists(atPath: directory.appendingPathComponent("journal.larmap").path))
+    }
+}
@@ -0,0 +1,137 @@
+//
+//  LARMapJsonReaderTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for streaming map.json through the SAX reader
+/// Validates maps loaded by the streaming reader against the same file parsed as a whole DOM,
+/// including nested and escaped members, malformed files and landmark counts around the
+/// insert batch size
+final class LARMapJsonReaderTests: XCTestCase {
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    /// Landmarks are inserted in batches of this many while parsing
+    private let insertBatch = 1024
+
+    private func translation(_ x: Float, _ y: Float, _ z: Float) -> simd_float4x4 {
+        var transform = matrix_identity_float4x4
+        transform.columns.3 = SIMD4(x, y, z, 1)
+        return transform
+    }
+
+    /// map.json text for a synthetic map with two anchors joined by an edge
+    private func mapJSON(count: Int, seed: UInt64 = 1) throws -> String {
+        let map = SyntheticMap(count: count, seed: seed).makeMap()
+        let first = map.createAnchor(translation(1, 0, 2))
+        let second = map.createAnchor(translation(-3, 0, 4))
+        map.addEdge(from: first.id, to: second.id)
+        let path = directory.appendingPathComponent("source.json").path
+        XCTAssertTrue(map.writeJSON(to: path))
+        return try String(contentsOfFile: path, encoding: .utf8)
+    }
+
+    private func write(_ text: String, to name: String = "map.json") throws -> String {
+        let path = directory.appendingPathComponent(name).path
+        try text.write(toFile: path, atomically: true, encoding: .utf8)
+        return path
+    }
+
+    /// Loads `path` through both readers and checks they produce the same map
+    @discardableResult
+    private func assertStreamedMatchesDOM(_ path: String, landmarks count: Int,
+                                          file: StaticString = #filePath, line: UInt = #line) throws -> LARMap {
+        let streamed = try XCTUnwrap(LARMap(contentsOf: path), file: file, line: line)
+        let parsed = try XCTUnwrap(LARMap(parsingJSONAt: path), file: file, line: line)
+        XCTAssertEqual(streamed.landmarks.count, count, file: file, line: line)
+        XCTAssertEqual(parsed.landmarks.count, count, file: file, line: line)
+        XCTAssertEqual(Set(streamed.landmarks.map(\.id)), Set(parsed.landmarks.map(\.id)), file: file, line: line)
+        XCTAssertEqual(Set(streamed.anchors.map(\.id)), Set(parsed.anchors.map(\.id)), file: file, line: line)
+        XCTAssertEqual(streamed.edges, parsed.edges, file: file, line: line)
+        XCTAssertEqual(streamed.fingerprint, parsed.fingerprint, file: file, line: line)
+        return streamed
+    }
+
+    // MARK: - Equivalence Tests
+
+    func testLoad_LandmarkCountsAroundInsertBatch_MatchDOM() throws {
+        for count in [0, 1, insertBatch - 1, insertBatch, insertBatch + 1, 2 * insertBatch + 1] {
+            // Given
+            let path = try write(try mapJSON(count: count, seed: UInt64(count + 1)))
+
+            // Then
+            let map = try assertStreamedMatchesDOM(path, landmarks: count)
+            XCTAssertEqual(Set(map.landmarks.map { Int($0.id) }), Set(0..<count), "Count: \(count)")
+            XCTAssertEqual(map.anchors.count, 2, "Count: \(count)")
+        }
+    }
+
+    func testLoad_NestedAndEscapedMembers_MatchDOM() throws {
+        // Given
+        // "landmarks" keys and array-like text nested below the root or inside a landmark, and
+        // in escaped strings, are ordinary members rather than the landmark array
+        let count = insertBatch + 10
+        var text = try mapJSON(count: count)
+        let nested = #"{"metadata":{"landmarks":[[1,{"landmarks":[]}],{"note":"say \"landmarks\":[{\"}"}],"#
+            + #""path":"C:\\maps\\\"landmarks\"","name":"caf\u00e9 \ud83d\uddfa \/ \t"},"#
+        text = nested + text.dropFirst()
+        XCTAssertTrue(text.hasPrefix(#"{"metadata""#))
+        XCTAssertTrue(text.contains(#""landmarks":[{"#))
+        text = text.replacingOccurrences(
+            of: #""landmarks":[{"#,
+            with: #""landmarks":[{"extra":{"landmarks":[{"text":"]}, \"landmarks\":[\\"}],"depth":[[[{}]]]},"#)
+        text = String(text.dropLast(text.hasSuffix("\n") ? 2 : 1)) + #","zz":{"landmarks":"\\\"]}"}}"#
+
+        // Then
+        try assertStreamedMatchesDOM(try write(text), landmarks: count)
+    }
+
+    // MARK: - Malformed Input Tests
+
+    func testLoad_MalformedFile_Fails() throws {
+        // Given
+        let text = try mapJSON(count: 2 * insertBatch + 1)
+        let landmarks = try XCTUnwrap(text.range(of: #""landmarks":["#))
+        let malformed = [
+            // Cut off after the first batches were inserted
+            "truncated": String(text.prefix(text.count * 3 / 4)),
+            "unterminated string": String(text[..<landmarks.upperBound]) + #"{"id":"unterminated"#,
+            "trailing comma": String(text[..<landmarks.upperBound]) + String(text[landmarks.upperBound...])
+                .replacingOccurrences(of: "},{", with: "},,{", options: [], range: nil),
+            "trailing garbage": text + "}",
+            "wrong landmark type": text.replacingOccurrences(of: #""landmarks":["#, with: #""landmarks":[{"id":"x"},"#),
+            "empty": "",
+        ]
+
+        for (name, text) in malformed {
+            // When
+            let path = try write(text, to: "\(name).json")
+
+            // Then
+            XCTAssertNil(LARMap(contentsOf: path), name)
+            XCTAssertNil(LARMap(parsingJSONAt: path), name)
+        }
+    }
+
+    func testLoad_MissingFile_Fails() {
+        // Given
+        let path = directory.appendingPathComponent("missing.json").path
+
+        // Then
+        XCTAssertNil(LARMap(contentsOf: path))
+        XCTAssertNil(LARMap(parsingJSONAt: path))
+    }
+}
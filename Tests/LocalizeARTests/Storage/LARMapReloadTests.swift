@@ -0,0 +1,142 @@
+//
+//  LARMapReloadTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import simd
+@testable import LocalizeAR
+
+/// Tests for reloading a map from a newer version of its archive
+/// Validates that only the changed parts are replaced and that a corrupt update is rejected
+/// with the map left as it was
+final class LARMapReloadTests: XCTestCase {
+    private var directory: URL!
+    private var source: SyntheticMap!
+    /// The map the archives are written from, changed between versions
+    private var original: LARMap!
+
+    override func setUpWithError() throws {
+        directory = try makeTemporaryDirectory()
+        source = SyntheticMap(count: 300)
+        original = source.makeMap()
+        let first = original.createAnchor(translation(1, 0, 0))
+        let second = original.createAnchor(translation(0, 0, 1))
+        original.addEdge(from: first.id, to: second.id)
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Helpers
+
+    private func translation(_ x: Float, _ y: Float, _ z: Float) -> simd_float4x4 {
+        var transform = matrix_identity_float4x4
+        transform.columns.3 = SIMD4(x, y, z, 1)
+        return transform
+    }
+
+    private func write(_ map: LARMap, to name: String) -> String {
+        let path = directory.appendingPathComponent(name).path
+        XCTAssertTrue(map.writeArchive(to: path))
+        return path
+    }
+
+    /// The map loaded from the first version, with its snapshot built
+    private func loadFirstVersion(lazy: Bool = false) throws -> LARMap {
+        let map = try XCTUnwrap(LARMap(contentsOf: write(original, to: "v1.larmap"), lazy: lazy))
+        XCTAssertNotNil(map.landmark(id: 0))
+        return map
+    }
+
+    private func addLandmark(to map: LARMap) {
+        XCTAssertTrue(map.addLandmark(id: 10_000, position: SIMD3(5, 1, 5), boundsLower: SIMD2(4, 4), boundsUpper: SIMD2(6, 6),
+                                      descriptor: Data(repeating: 3, count: 128), sightings: 2, lastSeen: 0))
+    }
+
+    // MARK: - Partial Reload Tests
+
+    func testReload_OnlyEdgesChanged_KeepsLandmarks() throws {
+        // Given
+        let map = try loadFirstVersion()
+        let version = map.publishedLandmarkVersion
+        let edges = map.edges
+        let anchors = original.anchors.map(\.id).sorted()
+        original.removeEdge(from: anchors[0], to: anchors[1])
+
+        // When
+        XCTAssertTrue(map.reload(contentsOf: write(original, to: "v2.larmap")))
+
+        // Then
+        XCTAssertNotEqual(map.edges, edges)
+        XCTAssertEqual(map.edges, original.edges)
+        XCTAssertEqual(map.anchors.count, 2)
+        XCTAssertEqual(map.fingerprint, original.fingerprint)
+        // Landmark sections were unchanged, so the snapshot was never rebuilt
+        XCTAssertNotNil(map.landmark(id: 0))
+        XCTAssertEqual(map.publishedLandmarkVersion, version)
+    }
+
+    func testReload_OnlyLandmarksChanged_KeepsAnchorsAndEdges() throws {
+        for lazy in [false, true] {
+            // Given
+            original = source.makeMap()
+            let first = original.createAnchor(translation(1, 0, 0))
+            let second = original.createAnchor(translation(0, 0, 1))
+            original.addEdge(from: first.id, to: second.id)
+            let map = try loadFirstVersion(lazy: lazy)
+            let version = map.publishedLandmarkVersion
+            addLandmark(to: original)
+
+            // When
+            XCTAssertTrue(map.reload(contentsOf: write(original, to: "v2.larmap")))
+
+            // Then
+            XCTAssertEqual(map.landmarks.count, source.landmarks.count + 1, "Lazy: \(lazy)")
+            XCTAssertNotNil(map.landmark(id: 10_000), "Lazy: \(lazy)")
+            XCTAssertGreaterThan(map.publishedLandmarkVersion, version, "Lazy: \(lazy)")
+            XCTAssertEqual(Set(map.anchors.map(\.id)), Set(original.anchors.map(\.id)), "Lazy: \(lazy)")
+            XCTAssertEqual(map.edges, original.edges, "Lazy: \(lazy)")
+            XCTAssertEqual(map.isLazy, lazy)
+            XCTAssertEqual(map.fingerprint, original.fingerprint, "Lazy: \(lazy)")
+        }
+    }
+
+    func testReload_CorruptChangedSection_IsRejectedAndMapUnchanged() throws {
+        // Given
+        let map = try loadFirstVersion()
+        let fingerprint = map.fingerprint, edges = map.edges
+        addLandmark(to: original)
+        let third = original.createAnchor(translation(1, 0, 1))
+        original.addEdge(from: original.anchors[0].id, to: third.id)
+        let path = write(original, to: "v2.larmap")
+        var data = try Data(contentsOf: URL(fileURLWithPath: path))
+        let descriptor = try XCTUnwrap(data.range(of: source.landmarks[42].descriptor))
+
+        // When
+        data[descriptor.lowerBound + 3] ^= 0x10
+        try data.write(to: URL(fileURLWithPath: path))
+
+        // Then
+        XCTAssertFalse(map.reload(contentsOf: path))
+        XCTAssertEqual(map.fingerprint, fingerprint)
+        XCTAssertEqual(map.landmarks.count, source.landmarks.count)
+        XCTAssertNil(map.landmark(id: 10_000))
+        XCTAssertEqual(map.edges, edges)
+        XCTAssertEqual(map.anchors.count, 2)
+    }
+
+    func testReload_Unchanged_ReloadsNothing() throws {
+        // Given
+        let map = try loadFirstVersion()
+        let version = map.publishedLandmarkVersion
+
+        // When
+        XCTAssertTrue(map.reload(contentsOf: write(original, to: "v2.larmap")))
+
+        // Then
+        XCTAssertEqual(map.publishedLandmarkVersion, version)
+        XCTAssertEqual(map.fingerprint, original.fingerprint)
+    }
+}
@@ -0,0 +1,188 @@
+//
+//  LARCoarseToFineTests.swift
+//  LocalizeARTests
+//
+
+import XCTest
+import CoreGraphics
+import simd
+@testable import LocalizeAR
+
+/// Tests for coarse-to-fine localization
+/// Validates option checking, the early exit when the coarse pass settles a frame and the
+/// fallback to the full image when it doesn't, on a scene built from the SIFT features of a
+/// test pattern seen by a SyntheticFrames camera
+final class LARCoarseToFineTests: XCTestCase {
+    private let width = 640
+    private let height = 480
+    private var frames: SyntheticFrames!
+    private var image: CGImage!
+    private var map: LARMap!
+
+    override func setUpWithError() throws {
+        frames = SyntheticFrames(from: SIMD3(50, 1.5, 50), step: 0, count: 1)
+        image = makeImage()
+        map = try makeMap(seeing: image, from: frames.positions[0])
+    }
+
+    // MARK: - Helpers
+
+    /// Grayscale pattern of shapes from a few pixels to a tenth of the image across, so
+    /// features survive halving the image
+    private func makeImage(shapes: Int = 220) -> CGImage {
+        let context = CGContext(data: nil, width: width, height: height, bitsPerComponent: 8, bytesPerRow: 0,
+                                space: CGColorSpaceCreateDeviceGray(), bitmapInfo: CGImageAlphaInfo.none.rawValue)!
+        context.setFillColor(gray: 0.5, alpha: 1)
+        context.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        var rng = SplitMix64(seed: 1)
+        for i in 0..<shapes {
+            let size = CGFloat(Double.random(in: 6...64, using: &rng))
+            let rect = CGRect(x: CGFloat(Double.random(in: 0...Double(width) - 64, using: &rng)),
+                              y: CGFloat(Double.random(in: 0...Double(height) - 64, using: &rng)),
+                              width: size, height: size * CGFloat(Double.random(in: 0.5...1.5, using: &rng)))
+            context.setFillColor(gray: CGFloat(Double.random(in: 0...1, using: &rng)), alpha: 1)
+            if i.isMultiple(of: 2) {
+                context.fill(rect)
+            } else {
+                context.fillEllipse(in: rect)
+            }
+        }
+        return context.makeImage()!
+    }
+
+    private func blankImage() -> CGImage {
+        makeImage(shapes: 0)
+    }
+
+    /// A landmark for every SIFT keypoint of `image`, back-projected from a camera at `camera`
+    /// (as SyntheticFrames places it) to a random depth, so the camera sees each one where the
+    /// image has its feature
+    private func makeMap(seeing image: CGImage, from camera: SIMD3<Double>) throws -> LARMap {
+        let extractor = LARSIFTExtractor(openCVKeypointBudget: 0)
+        XCTAssertTrue(extractor.extract(image))
+        XCTAssertGreaterThan(extractor.keypointCount, 200)
+
+        let map = LARMap()
+        var rng = SplitMix64(seed: 2)
+        let focalLength = SyntheticFrames.focalLength, principalPoint = SyntheticFrames.principalPoint
+        for (i, keypoint) in extractor.keypoints.enumerated() {
+            let depth = Double.random(in: 4...8, using: &rng)
+            let offset = SIMD3((Double(keypoint.x) - principalPoint.x) * depth / focalLength,
+                               -(Double(keypoint.y) - principalPoint.y) * depth / focalLength, -depth)
+            let position = camera + offset
+            XCTAssertTrue(SyntheticFrames.sees(camera, position))
+            let descriptor = Data(extractor.descriptor(at: i).map { UInt8(clamping: Int($0.rounded())) })
+            let center = SIMD2(position.x, position.z)
+            XCTAssertTrue(map.addLandmark(id: i, position: position, boundsLower: center - 1, boundsUpper: center + 1,
+                                          descriptor: descriptor, sightings: 5, lastSeen: 0))
+        }
+        return map
+    }
+
+    private func makeTracker() -> LARTracker {
+        LARTracker(map: map, imageWidth: Int32(width), imageHeight: Int32(height))
+    }
+
+    /// Localizes `image` from the fixture's frame, returning the camera position found
+    private func localize(_ tracker: LARTracker, _ image: CGImage) -> SIMD3<Double>? {
+        let camera = frames.positions[0]
+        let query = LARSpatialQuery(x: camera.x, z: camera.z - 6, diameter: 20)
+        var transform = matrix_identity_double4x4
+        let success = image.withGrayscaleLARImage {
+            tracker.localize(image: $0, frame: frames.frames[0], query: query, outputTransform: &transform)
+        } ?? false
+        return success ? SIMD3(transform.columns.3.x, transform.columns.3.y, transform.columns.3.z) : nil
+    }
+
+    // MARK: - Option Tests
+
+    func testEnable_InvalidOptions_LeaveCoarseToFineDisabled() {
+        // Given
+        let sut = makeTracker()
+
+        for (levels, ratio) in [(0, 0.25), (-1, 0.25), (1, -0.1), (1, 1.5), (1, .nan)] {
+            // When
+            sut.enableCoarseToFine(levels: 1, minInliers: 20, minInlierRatio: 0.25)
+            XCTAssertTrue(sut.coarseToFineEnabled)
+            sut.enableCoarseToFine(levels: levels, minInliers: 20, minInlierRatio: ratio)
+
+            // Then
+            XCTAssertFalse(sut.coarseToFineEnabled, "Levels \(levels), ratio \(ratio)")
+            XCTAssertEqual(sut.coarseAcceptedCount, 0)
+            XCTAssertEqual(sut.finePassCount, 0)
+        }
+    }
+
+    func testEnable_ValidOptions_EnablesUntilDisabled() {
+        // Given
+        let sut = makeTracker()
+        XCTAssertFalse(sut.coarseToFineEnabled)
+
+        for (levels, ratio) in [(1, 0.0), (2, 1.0), (100, 0.25)] {
+            // When
+            sut.enableCoarseToFine(levels: levels, minInliers: 0, minInlierRatio: ratio)
+
+            // Then
+            // Levels past the limit are clamped rather than rejected
+            XCTAssertTrue(sut.coarseToFineEnabled, "Levels \(levels), ratio \(ratio)")
+            XCTAssertFalse(sut.lastLocalizationWasCoarse)
+        }
+        sut.disableCoarseToFine()
+        XCTAssertFalse(sut.coarseToFineEnabled)
+    }
+
+    // MARK: - Localization Tests
+
+    func testLocalize_CoarseResultAccepted_SkipsFinePass() throws {
+        // Given
+        let sut = makeTracker()
+        sut.enableCoarseToFine(levels: 1, minInliers: 12, minInlierRatio: 0)
+
+        // When
+        let position = try XCTUnwrap(localize(sut, image))
+
+        // Then
+        XCTAssertTrue(sut.lastLocalizationWasCoarse)
+        XCTAssertEqual(sut.coarseAcceptedCount, 1)
+        XCTAssertEqual(sut.finePassCount, 0)
+        XCTAssertGreaterThanOrEqual(sut.inlierCount, 12)
+        XCTAssertLessThan(simd_distance(position, frames.positions[0]), 0.25)
+    }
+
+    func testLocalize_WeakCoarseResult_FallsBackToFinePass() throws {
+        // Given
+        // No coarse result can have this many inliers
+        let sut = makeTracker()
+        sut.enableCoarseToFine(levels: 1, minInliers: 1_000_000, minInlierRatio: 0)
+        let full = makeTracker()
+
+        // When
+        let position = try XCTUnwrap(localize(sut, image))
+        let expected = try XCTUnwrap(localize(full, image))
+
+        // Then
+        XCTAssertFalse(sut.lastLocalizationWasCoarse)
+        XCTAssertEqual(sut.coarseAcceptedCount, 0)
+        XCTAssertEqual(sut.finePassCount, 1)
+        // The result is the full image's, as the tracker alone finds it
+        XCTAssertGreaterThan(sut.inlierCount, 0)
+        XCTAssertLessThan(simd_distance(position, expected), 0.05)
+        XCTAssertLessThan(simd_distance(position, frames.positions[0]), 0.1)
+    }
+
+    func testLocalize_CoarsePassFails_FallsBackAndCountsEachFrame() {
+        // Given
+        let sut = makeTracker()
+        sut.enableCoarseToFine(levels: 1, minInliers: 12, minInlierRatio: 0)
+
+        // When
+        XCTAssertNil(localize(sut, blankImage()))
+        XCTAssertNotNil(localize(sut, image))
+        XCTAssertNil(localize(sut, blankImage()))
+
+        // Then
+        XCTAssertFalse(sut.lastLocalizationWasCoarse)
+        XCTAssertEqual(sut.coarseAcceptedCount, 1)
+        XCTAssertEqual(sut.finePassCount, 2)
+    }
+}